@@ -114,8 +114,11 @@ add_route(char *pfx, struct ccnl_face_s *face, int suite, int mtu)
     }
 #endif
     fwd->suite = suite;
-    fwd->next = theRelay.fib;
-    theRelay.fib = fwd;
+    if (!fwd->prefix || ccnl_fib_link(&theRelay, fwd)) {
+        if (fwd->prefix)
+            ccnl_prefix_free(fwd->prefix);
+        ccnl_free(fwd);
+    }
 }
 
 JNIEXPORT void JNICALL
@@ -0,0 +1,780 @@
+/*
+ * @f ccnl_core_bench.c
+ * @b CCN lite, micro benchmarks of the forwarding plane
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+/*
+ * The names are a synthetic tree: DEPTH components, each of the first
+ * DEPTH-1 drawn from FANOUT values per level, the last one unique. Lookups
+ * follow a Zipf distribution of exponent ZIPF over the names (0: uniform).
+ * Every benchmark prints one JSON line with the time and the number of
+ * malloc calls per operation; the first line holds the parameters.
+ */
+
+#define _POSIX_C_SOURCE 200809L // clock_gettime, getopt, strdup
+
+#include <math.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ccnl-core.h"
+#include "ccnl-pkt-builder.h"
+#include "ccnl-pkt-ccnb.h"
+#include "ccnl-pkt-ccntlv.h"
+#include "ccnl-pkt-cistlv.h"
+#include "ccnl-pkt-iottlv.h"
+#include "ccnl-pkt-ndntlv.h"
+#include "ccnl-pkt-switch.h"
+#ifdef USE_NFN
+#include "ccnl-nfn-common.h"
+#include "ccnl-nfn-krivine.h"
+#endif
+
+// ----------------------------------------------------------------------
+// counting malloc calls, the libraries are linked with --wrap
+
+static unsigned long ccnl_bench_allocs;
+
+#ifdef CCNL_BENCH_WRAP_MALLOC
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *p, size_t size);
+
+void*
+__wrap_malloc(size_t size)
+{
+    ccnl_bench_allocs++;
+    return __real_malloc(size);
+}
+
+void*
+__wrap_calloc(size_t n, size_t size)
+{
+    ccnl_bench_allocs++;
+    return __real_calloc(n, size);
+}
+
+void*
+__wrap_realloc(void *p, size_t size)
+{
+    ccnl_bench_allocs++;
+    return __real_realloc(p, size);
+}
+#endif
+
+// ----------------------------------------------------------------------
+
+struct ccnl_bench_s {
+    const char *name;
+    const char *suite;
+    long ops;
+    double ns, t0;
+    unsigned long allocs, a0;
+};
+
+static int names = 10000, depth = 4, fanout = 8, quick;
+static long ops = 100000;
+static double zipf = 0.8;
+static unsigned int seed = 1;
+static char *filter;
+
+static char **uri;                      // the names
+static int *seq;                        // names in the order they are looked up
+
+static double
+ccnl_bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int
+ccnl_bench_begin(struct ccnl_bench_s *b, const char *name, const char *suite)
+{
+    memset(b, 0, sizeof(*b));
+    b->name = name;
+    b->suite = suite;
+    return !filter || strstr(name, filter);
+}
+
+// the measured part of a benchmark is between start and stop
+static void
+ccnl_bench_start(struct ccnl_bench_s *b)
+{
+    b->a0 = ccnl_bench_allocs;
+    b->t0 = ccnl_bench_now();
+}
+
+static void
+ccnl_bench_stop(struct ccnl_bench_s *b, long n)
+{
+    b->ns += ccnl_bench_now() - b->t0;
+    b->allocs += ccnl_bench_allocs - b->a0;
+    b->ops += n;
+}
+
+static void
+ccnl_bench_report(struct ccnl_bench_s *b, const char *extra)
+{
+    printf("{\"bench\": \"%s\", \"suite\": \"%s\", \"ops\": %ld, "
+           "\"ns_per_op\": %.1f, \"allocs_per_op\": %.2f%s}\n",
+           b->name, b->suite, b->ops, b->ops ? b->ns / b->ops : 0.0,
+           b->ops ? (double) b->allocs / b->ops : 0.0, extra ? extra : "");
+    fflush(stdout);
+}
+
+// ----------------------------------------------------------------------
+// synthetic names
+
+static void
+ccnl_bench_names(void)
+{
+    char s[CCNL_MAX_PREFIX_SIZE];
+    int i, l, len;
+
+    uri = (char**) malloc(names * sizeof(char*));
+    for (i = 0; i < names; i++) {
+        len = 0;
+        for (l = 0; l < depth - 1; l++)
+            len += snprintf(s + len, sizeof(s) - len, "/%c%d", 'a' + l % 26,
+                            rand() % fanout);
+        snprintf(s + len, sizeof(s) - len, "/n%d", i);
+        uri[i] = strdup(s);
+    }
+}
+
+// Zipf ranks are mapped to names by a random permutation
+static void
+ccnl_bench_sequence(void)
+{
+    double *cdf = (double*) malloc(names * sizeof(double)), sum = 0;
+    int *perm = (int*) malloc(names * sizeof(int));
+    long i;
+    int k, lo, hi;
+
+    for (k = 0; k < names; k++) {
+        sum += 1.0 / pow(k + 1, zipf);
+        cdf[k] = sum;
+        perm[k] = k;
+    }
+    for (k = names - 1; k > 0; k--) {
+        int j = rand() % (k + 1), t = perm[k];
+        perm[k] = perm[j];
+        perm[j] = t;
+    }
+    seq = (int*) malloc(ops * sizeof(int));
+    for (i = 0; i < ops; i++) {
+        double u = (double) rand() / RAND_MAX * sum;
+        for (lo = 0, hi = names - 1; lo < hi; ) {
+            int mid = (lo + hi) / 2;
+            if (cdf[mid] < u)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        seq[i] = perm[lo];
+    }
+    free(perm);
+    free(cdf);
+}
+
+static struct ccnl_prefix_s*
+ccnl_bench_prefix(int k, int suite, int compcnt)
+{
+    char s[CCNL_MAX_PREFIX_SIZE];
+    struct ccnl_prefix_s *p;
+
+    strcpy(s, uri[k]);
+    p = ccnl_URItoPrefix(s, suite, NULL, NULL);
+    if (p && compcnt > 0 && compcnt < p->compcnt)
+        p->compcnt = compcnt;
+    return p;
+}
+
+static struct ccnl_prefix_s**
+ccnl_bench_prefixes(int suite, int compcnt)
+{
+    struct ccnl_prefix_s **p = (struct ccnl_prefix_s**)
+                                        malloc(names * sizeof(*p));
+    int k;
+
+    for (k = 0; k < names; k++)
+        p[k] = ccnl_bench_prefix(k, suite, compcnt);
+    return p;
+}
+
+static void
+ccnl_bench_prefixes_free(struct ccnl_prefix_s **p)
+{
+    int k;
+
+    for (k = 0; k < names; k++)
+        ccnl_prefix_free(p[k]);
+    free(p);
+}
+
+// ----------------------------------------------------------------------
+// packets
+
+static struct ccnl_buf_s*
+ccnl_bench_interest(struct ccnl_prefix_s *pfx)
+{
+    ccnl_interest_opts_u opts;
+
+    memset(&opts, 0, sizeof(opts));
+#ifdef USE_SUITE_NDNTLV
+    opts.ndntlv.nonce = rand();
+#endif
+    return ccnl_mkSimpleInterest(pfx, &opts);
+}
+
+static struct ccnl_buf_s*
+ccnl_bench_content(struct ccnl_prefix_s *pfx)
+{
+    unsigned char payload[64];
+    ccnl_data_opts_u opts;
+
+    memset(payload, 'x', sizeof(payload));
+    memset(&opts, 0, sizeof(opts));
+#ifdef USE_SUITE_NDNTLV
+    opts.ndntlv.finalblockid = UINT32_MAX;
+#endif
+    return ccnl_mkSimpleContent(pfx, payload, sizeof(payload), NULL, &opts);
+}
+
+// the suite parsers, as a forwarder calls them for interests and data
+static struct ccnl_pkt_s*
+ccnl_bench_parse(struct ccnl_buf_s *buf)
+{
+    unsigned char *data = buf->data, *start;
+    int datalen = buf->datalen, suite, skip, len;
+    unsigned int typ;
+
+    (void) typ;
+    (void) len;
+    suite = ccnl_pkt2suite(data, datalen, &skip);
+    start = data += skip;
+    datalen -= skip;
+
+    switch (suite) {
+#ifdef USE_SUITE_CCNB
+    case CCNL_SUITE_CCNB:
+        if (ccnl_ccnb_dehead(&data, &datalen, &len, (int*) &typ) ||
+                                                        typ != CCN_TT_DTAG)
+            return NULL;
+        return ccnl_ccnb_bytes2pkt(start, &data, &datalen);
+#endif
+#ifdef USE_SUITE_CCNTLV
+    case CCNL_SUITE_CCNTLV:
+        len = ccnl_ccntlv_getHdrLen(data, datalen);
+        if (len <= 0)
+            return NULL;
+        data += len;
+        datalen -= len;
+        return ccnl_ccntlv_bytes2pkt(start, &data, &datalen);
+#endif
+#ifdef USE_SUITE_CISTLV
+    case CCNL_SUITE_CISTLV:
+        len = ccnl_cistlv_getHdrLen(data, datalen);
+        if (len <= 0)
+            return NULL;
+        data += len;
+        datalen -= len;
+        return ccnl_cistlv_bytes2pkt(start, &data, &datalen);
+#endif
+#ifdef USE_SUITE_IOTTLV
+    case CCNL_SUITE_IOTTLV:
+        if (ccnl_iottlv_dehead(&data, &datalen, &typ, &len))
+            return NULL;
+        return ccnl_iottlv_bytes2pkt(typ, start, &data, &datalen);
+#endif
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV:
+        if (ccnl_ndntlv_dehead(&data, &datalen, (int*) &typ, &len))
+            return NULL;
+        return ccnl_ndntlv_bytes2pkt(typ, start, &data, &datalen);
+#endif
+    default:
+        return NULL;
+    }
+}
+
+static struct ccnl_buf_s**
+ccnl_bench_packets(struct ccnl_prefix_s **pfx,
+                   struct ccnl_buf_s* (*mk)(struct ccnl_prefix_s*))
+{
+    struct ccnl_buf_s **p = (struct ccnl_buf_s**) malloc(names * sizeof(*p));
+    int k;
+
+    for (k = 0; k < names; k++)
+        p[k] = mk(pfx[k]);
+    return p;
+}
+
+static void
+ccnl_bench_packets_free(struct ccnl_buf_s **p)
+{
+    int k;
+
+    for (k = 0; k < names; k++)
+        ccnl_buf_free(p[k]);
+    free(p);
+}
+
+// ----------------------------------------------------------------------
+// packet formats: building and parsing
+
+static void
+ccnl_bench_suite(int suite)
+{
+    const char *sname = ccnl_suite2str(suite);
+    struct ccnl_prefix_s **pfx = ccnl_bench_prefixes(suite, 0);
+    struct ccnl_buf_s **interest, **content;
+    struct ccnl_bench_s b;
+    struct ccnl_pkt_s *pkt;
+    long i;
+
+    interest = ccnl_bench_packets(pfx, ccnl_bench_interest);
+    content = ccnl_bench_packets(pfx, ccnl_bench_content);
+
+    if (ccnl_bench_begin(&b, "mk_interest", sname)) {
+        ccnl_bench_start(&b);
+        for (i = 0; i < ops; i++)
+            ccnl_buf_free(ccnl_bench_interest(pfx[seq[i]]));
+        ccnl_bench_stop(&b, ops);
+        ccnl_bench_report(&b, NULL);
+    }
+    if (ccnl_bench_begin(&b, "mk_content", sname)) {
+        ccnl_bench_start(&b);
+        for (i = 0; i < ops; i++)
+            ccnl_buf_free(ccnl_bench_content(pfx[seq[i]]));
+        ccnl_bench_stop(&b, ops);
+        ccnl_bench_report(&b, NULL);
+    }
+    if (ccnl_bench_begin(&b, "parse_interest", sname)) {
+        ccnl_bench_start(&b);
+        for (i = 0; i < ops; i++) {
+            pkt = ccnl_bench_parse(interest[seq[i]]);
+            if (!pkt)
+                break;
+            ccnl_pkt_free(pkt);
+        }
+        ccnl_bench_stop(&b, i);
+        ccnl_bench_report(&b, NULL);
+    }
+    if (ccnl_bench_begin(&b, "parse_content", sname)) {
+        ccnl_bench_start(&b);
+        for (i = 0; i < ops; i++) {
+            pkt = ccnl_bench_parse(content[seq[i]]);
+            if (!pkt)
+                break;
+            ccnl_pkt_free(pkt);
+        }
+        ccnl_bench_stop(&b, i);
+        ccnl_bench_report(&b, NULL);
+    }
+
+    ccnl_bench_packets_free(interest);
+    ccnl_bench_packets_free(content);
+    ccnl_bench_prefixes_free(pfx);
+}
+
+// ----------------------------------------------------------------------
+// prefix comparison
+
+static void
+ccnl_bench_prefix_cmp(void)
+{
+    const char *sname = ccnl_suite2str(CCNL_SUITE_NDNTLV);
+    struct ccnl_prefix_s **pfx = ccnl_bench_prefixes(CCNL_SUITE_NDNTLV, 0);
+    struct ccnl_prefix_s **dup = ccnl_bench_prefixes(CCNL_SUITE_NDNTLV, 0);
+    struct ccnl_prefix_s **parent;
+    struct ccnl_bench_s b;
+    long i, matched = 0;
+    char extra[64];
+
+    parent = ccnl_bench_prefixes(CCNL_SUITE_NDNTLV, depth > 1 ? depth - 1 : 1);
+
+    if (ccnl_bench_begin(&b, "prefix_cmp_exact", sname)) {
+        ccnl_bench_start(&b);
+        for (i = 0; i < ops; i++)
+            matched += !ccnl_prefix_cmp(pfx[seq[i]], NULL, dup[seq[i]],
+                                        CMP_EXACT);
+        ccnl_bench_stop(&b, ops);
+        snprintf(extra, sizeof(extra), ", \"matched\": %ld", matched);
+        ccnl_bench_report(&b, extra);
+    }
+    // the parent of one name against another name
+    if (ccnl_bench_begin(&b, "prefix_cmp_match", sname)) {
+        matched = 0;
+        ccnl_bench_start(&b);
+        for (i = 0; i < ops; i++)
+            matched += ccnl_prefix_cmp(pfx[seq[i]], NULL,
+                                       parent[seq[ops - 1 - i]], CMP_MATCH) > 0;
+        ccnl_bench_stop(&b, ops);
+        snprintf(extra, sizeof(extra), ", \"matched\": %ld", matched);
+        ccnl_bench_report(&b, extra);
+    }
+    if (ccnl_bench_begin(&b, "prefix_cmp_longest", sname)) {
+        matched = 0;
+        ccnl_bench_start(&b);
+        for (i = 0; i < ops; i++)
+            matched += ccnl_prefix_cmp(parent[seq[ops - 1 - i]], NULL,
+                                       pfx[seq[i]], CMP_LONGEST) > 0;
+        ccnl_bench_stop(&b, ops);
+        snprintf(extra, sizeof(extra), ", \"matched\": %ld", matched);
+        ccnl_bench_report(&b, extra);
+    }
+
+    ccnl_bench_prefixes_free(parent);
+    ccnl_bench_prefixes_free(dup);
+    ccnl_bench_prefixes_free(pfx);
+}
+
+// ----------------------------------------------------------------------
+// CS, PIT and FIB of a relay
+
+static struct ccnl_relay_s*
+ccnl_bench_relay(int max_cache_entries)
+{
+    struct ccnl_relay_s *r = ccnl_calloc(1, sizeof(struct ccnl_relay_s));
+
+    r->max_cache_entries = max_cache_entries;
+    r->max_pit_entries = -1;
+    ccnl_cache_set_policy(r, CCNL_CACHE_LRU);
+    return r;
+}
+
+static void
+ccnl_bench_relay_free(struct ccnl_relay_s *r)
+{
+    ccnl_core_cleanup(r);
+    ccnl_timer_cleanup();
+    ccnl_free(r);
+}
+
+static struct ccnl_content_s*
+ccnl_bench_content_new(struct ccnl_buf_s *buf)
+{
+    struct ccnl_pkt_s *pkt = ccnl_bench_parse(buf);
+
+    return pkt ? ccnl_content_new(&pkt) : NULL;
+}
+
+static void
+ccnl_bench_cs(struct ccnl_buf_s **content, struct ccnl_buf_s **interest)
+{
+    const char *sname = ccnl_suite2str(CCNL_SUITE_NDNTLV);
+    struct ccnl_content_s **c = (struct ccnl_content_s**)
+                                        malloc(names * sizeof(*c));
+    struct ccnl_pkt_s **ipkt = (struct ccnl_pkt_s**)
+                                        malloc(names * sizeof(*ipkt));
+    struct ccnl_relay_s *r;
+    struct ccnl_bench_s b;
+    long i, hits = 0, rounds;
+    char extra[64];
+    int k;
+
+    // half of the names fit, so inserting replaces content
+    if (ccnl_bench_begin(&b, "cs_insert", sname)) {
+        r = ccnl_bench_relay(names / 2);
+        for (rounds = (ops + names - 1) / names; rounds > 0; rounds--) {
+            for (k = 0; k < names; k++)
+                c[k] = ccnl_bench_content_new(content[k]);
+            ccnl_bench_start(&b);
+            for (k = 0; k < names; k++) {
+                if (ccnl_content_add2cache(r, c[k]) < 0)
+                    ccnl_content_free(c[k]);
+            }
+            ccnl_bench_stop(&b, names);
+        }
+        ccnl_bench_relay_free(r);
+        ccnl_bench_report(&b, NULL);
+    }
+
+    if (ccnl_bench_begin(&b, "cs_lookup", sname)) {
+        r = ccnl_bench_relay(names / 2);
+        for (k = 0; k < names; k++) {
+            struct ccnl_content_s *cc = ccnl_bench_content_new(content[k]);
+            if (ccnl_content_add2cache(r, cc) < 0)
+                ccnl_content_free(cc);
+            ipkt[k] = ccnl_bench_parse(interest[k]);
+        }
+        ccnl_bench_start(&b);
+        for (i = 0; i < ops; i++)
+            hits += ccnl_content_lookup(r, ipkt[seq[i]],
+                                        ccnl_ndntlv_cMatch) != NULL;
+        ccnl_bench_stop(&b, ops);
+        for (k = 0; k < names; k++)
+            ccnl_pkt_free(ipkt[k]);
+        ccnl_bench_relay_free(r);
+        snprintf(extra, sizeof(extra), ", \"hit_ratio\": %.3f",
+                 (double) hits / ops);
+        ccnl_bench_report(&b, extra);
+    }
+
+    free(ipkt);
+    free(c);
+}
+
+static void
+ccnl_bench_pit(struct ccnl_buf_s **content, struct ccnl_buf_s **interest)
+{
+    const char *sname = ccnl_suite2str(CCNL_SUITE_NDNTLV);
+    struct ccnl_pkt_s **ipkt = (struct ccnl_pkt_s**)
+                                        malloc(names * sizeof(*ipkt));
+    struct ccnl_content_s **c = (struct ccnl_content_s**)
+                                        malloc(names * sizeof(*c));
+    struct ccnl_bench_s bi, bs;
+    struct ccnl_relay_s *r = ccnl_bench_relay(0);
+    struct ccnl_face_s *face = ccnl_get_face_or_create(r, -1, NULL, 0);
+    struct ccnl_interest_s *in;
+    long rounds, served = 0;
+    int k, run_i, run_s;
+    char extra[64];
+
+    run_i = ccnl_bench_begin(&bi, "pit_insert", sname);
+    run_s = ccnl_bench_begin(&bs, "pit_satisfy", sname);
+    if (!run_i && !run_s)
+        goto Done;
+    for (rounds = (ops + names - 1) / names; rounds > 0; rounds--) {
+        for (k = 0; k < names; k++) {
+            ipkt[k] = ccnl_bench_parse(interest[k]);
+            c[k] = ccnl_bench_content_new(content[k]);
+        }
+        ccnl_bench_start(&bi);
+        for (k = 0; k < names; k++) {
+            in = ccnl_interest_new(r, face, ipkt + k);
+            if (in)
+                ccnl_interest_append_pending(in, face);
+        }
+        ccnl_bench_stop(&bi, names);
+        ccnl_bench_start(&bs);
+        for (k = 0; k < names; k++)
+            served += ccnl_content_serve_pending(r, c[k]);
+        ccnl_bench_stop(&bs, names);
+        for (k = 0; k < names; k++) {
+            ccnl_pkt_free(ipkt[k]);
+            ccnl_content_free(c[k]);
+        }
+    }
+    if (run_i)
+        ccnl_bench_report(&bi, NULL);
+    if (run_s) {
+        snprintf(extra, sizeof(extra), ", \"served\": %ld", served);
+        ccnl_bench_report(&bs, extra);
+    }
+Done:
+    ccnl_bench_relay_free(r);
+    free(c);
+    free(ipkt);
+}
+
+static void
+ccnl_bench_fib(void)
+{
+    const char *sname = ccnl_suite2str(CCNL_SUITE_NDNTLV);
+    struct ccnl_prefix_s **pfx = ccnl_bench_prefixes(CCNL_SUITE_NDNTLV, 0);
+    struct ccnl_relay_s *r;
+    struct ccnl_face_s *face;
+    struct ccnl_bench_s b;
+    long i, found = 0;
+    char extra[64];
+    int k;
+
+    if (!ccnl_bench_begin(&b, "fib_lpm", sname))
+        goto Done;
+    r = ccnl_bench_relay(0);
+    face = ccnl_get_face_or_create(r, -1, NULL, 0);
+    // a route for every first component, and for the parents of half
+    // of the names
+    for (k = 0; k < names; k++) {
+        ccnl_fib_add_entry(r, ccnl_bench_prefix(k, CCNL_SUITE_NDNTLV, 1),
+                           face);
+        if (depth > 2 && k % 2)
+            ccnl_fib_add_entry(r, ccnl_bench_prefix(k, CCNL_SUITE_NDNTLV,
+                                                    depth - 1), face);
+    }
+    ccnl_bench_start(&b);
+    for (i = 0; i < ops; i++)
+        found += ccnl_fib_lookup(r, pfx[seq[i]]) != NULL;
+    ccnl_bench_stop(&b, ops);
+    ccnl_bench_relay_free(r);
+    snprintf(extra, sizeof(extra), ", \"found\": %ld", found);
+    ccnl_bench_report(&b, extra);
+Done:
+    ccnl_bench_prefixes_free(pfx);
+}
+
+#ifdef USE_NFN
+// whole local NFN computations, from the expression to the exported result
+static void
+ccnl_bench_nfn(void)
+{
+    static char *expr[] = {
+        "add 1 2",
+        "ifelse (leq 3 4) (mult 6 7) 0",
+        "(@f@x f (f (f x))) (@y mult (add y 1) 2) 3",
+        "(@c c (@n sub n 1) (c (@n add n 2) 10)) (@f@x f (f (f x)))",
+    };
+    const char *sname = ccnl_suite2str(CCNL_SUITE_NDNTLV);
+    struct ccnl_prefix_s *pfx = ccnl_bench_prefix(0, CCNL_SUITE_NDNTLV, 0);
+    struct ccnl_relay_s *r = ccnl_bench_relay(0);
+    struct ccnl_bench_s b;
+    long i, n = ops / 100 > 0 ? ops / 100 : 1;
+    char extra[128];
+    unsigned int e;
+
+    r->km = ccnl_calloc(1, sizeof(struct ccnl_krivine_s));
+    r->km->configid = -1;
+    ZAM_init();
+    for (e = 0; e < sizeof(expr) / sizeof(*expr); e++) {
+        struct ccnl_buf_s *res = NULL;
+
+        if (!ccnl_bench_begin(&b, "nfn_reduce", sname))
+            break;
+        ccnl_bench_start(&b);
+        for (i = 0; i < n; i++) {
+            struct configuration_s *config = NULL;
+
+            ccnl_free(res);
+            res = Krivine_reduction(r, expr[e], 1, &config,
+                                    ccnl_prefix_dup(pfx), CCNL_SUITE_NDNTLV);
+            DBL_LINKED_LIST_REMOVE(r->km->configuration_list, config);
+            ccnl_nfn_freeConfiguration(config);
+        }
+        ccnl_bench_stop(&b, n);
+        snprintf(extra, sizeof(extra), ", \"expr\": %u, \"result\": \"%.*s\"",
+                 e, res ? (int) res->datalen : 0, res ? (char*) res->data : "");
+        ccnl_free(res);
+        ccnl_bench_report(&b, extra);
+    }
+    ccnl_bench_relay_free(r);
+    ccnl_prefix_free(pfx);
+}
+#endif
+
+// ----------------------------------------------------------------------
+
+int
+main(int argc, char *argv[])
+{
+    struct ccnl_prefix_s **pfx;
+    struct ccnl_buf_s **interest, **content;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "b:d:f:hn:o:qs:z:")) != -1) {
+        switch (opt) {
+        case 'b':
+            filter = optarg;
+            break;
+        case 'd':
+            depth = atoi(optarg);
+            break;
+        case 'f':
+            fanout = atoi(optarg);
+            break;
+        case 'n':
+            names = atoi(optarg);
+            break;
+        case 'o':
+            ops = atol(optarg);
+            break;
+        case 'q':
+            quick = 1;
+            break;
+        case 's':
+            seed = atoi(optarg);
+            break;
+        case 'z':
+            zipf = atof(optarg);
+            break;
+        case 'h':
+        default:
+            fprintf(stderr, "usage: %s [options]\n"
+                    "  -b NAME (only benchmarks whose name contains NAME)\n"
+                    "  -d DEPTH (name components, default 4)\n"
+                    "  -f FANOUT (values per component, default 8)\n"
+                    "  -n NAMES (default 10000)\n"
+                    "  -o OPS (operations per benchmark, default 100000)\n"
+                    "  -q (quick run with few names and operations)\n"
+                    "  -s SEED\n"
+                    "  -z ZIPF (exponent of the popularity, default 0.8, 0: uniform)\n",
+                    argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (quick) {
+        names = 200;
+        ops = 1000;
+    }
+    if (names < 2 || ops < 1 || depth < 1 || fanout < 1) {
+        fprintf(stderr, "invalid parameters\n");
+        return 1;
+    }
+    srand(seed);
+    ccnl_bench_names();
+    ccnl_bench_sequence();
+    printf("{\"names\": %d, \"depth\": %d, \"fanout\": %d, \"zipf\": %.2f, "
+           "\"ops\": %ld, \"seed\": %u}\n", names, depth, fanout, zipf, ops,
+           seed);
+
+#ifdef USE_SUITE_NDNTLV
+    ccnl_bench_suite(CCNL_SUITE_NDNTLV);
+#endif
+#ifdef USE_SUITE_CCNB
+    ccnl_bench_suite(CCNL_SUITE_CCNB);
+#endif
+#ifdef USE_SUITE_CCNTLV
+    ccnl_bench_suite(CCNL_SUITE_CCNTLV);
+#endif
+#ifdef USE_SUITE_CISTLV
+    ccnl_bench_suite(CCNL_SUITE_CISTLV);
+#endif
+#ifdef USE_SUITE_IOTTLV
+    ccnl_bench_suite(CCNL_SUITE_IOTTLV);
+#endif
+
+#ifdef USE_SUITE_NDNTLV
+    ccnl_bench_prefix_cmp();
+    pfx = ccnl_bench_prefixes(CCNL_SUITE_NDNTLV, 0);
+    interest = ccnl_bench_packets(pfx, ccnl_bench_interest);
+    content = ccnl_bench_packets(pfx, ccnl_bench_content);
+    ccnl_bench_cs(content, interest);
+    ccnl_bench_pit(content, interest);
+    ccnl_bench_fib();
+#ifdef USE_NFN
+    ccnl_bench_nfn();
+#endif
+    ccnl_bench_packets_free(interest);
+    ccnl_bench_packets_free(content);
+    ccnl_bench_prefixes_free(pfx);
+#else
+    (void) pfx;
+    (void) interest;
+    (void) content;
+#endif
+
+    ccnl_pool_cleanup();
+    return 0;
+}
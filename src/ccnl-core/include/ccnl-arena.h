@@ -0,0 +1,66 @@
+/*
+ * @f ccnl-arena.h
+ * @b CCN lite (CCNL), bump allocator released in one operation
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_ARENA_H
+#define CCNL_ARENA_H
+
+#ifndef CCNL_LINUXKERNEL
+#include <stddef.h>
+#else
+#include <linux/types.h>
+#endif
+
+/**
+ * An arena hands out objects which all live until the arena is released,
+ * e.g. those of one NFN computation. Objects are cut from chunks of
+ * CCNL_ARENA_CHUNK bytes, larger ones get a chunk of their own; there is
+ * no way to free a single object. A zeroed arena is an empty one.
+ */
+
+struct ccnl_arena_chunk_s {
+    struct ccnl_arena_chunk_s *next;
+    size_t size;                /**< bytes after the header */
+};
+
+struct ccnl_arena_s {
+    struct ccnl_arena_chunk_s *chunks;  /**< the one being cut first */
+    size_t left;                /**< bytes left in the first chunk */
+    size_t used;                /**< bytes handed out */
+    int chunkcnt;
+};
+
+/**
+ * @brief A zeroed object of @p size bytes from @p arena, aligned for any
+ * of the core data types
+ *
+ * @return the object, NULL if out of memory
+ */
+void*
+ccnl_arena_alloc(struct ccnl_arena_s *arena, size_t size);
+
+/**
+ * @brief Frees all objects of @p arena, which is empty afterwards
+ */
+void
+ccnl_arena_release(struct ccnl_arena_s *arena);
+
+#endif // CCNL_ARENA_H
@@ -28,18 +28,67 @@
 
 struct ccnl_relay_s;
 
+/**
+ * Buffers are reference counted. A slice is a buffer whose bytes lie in
+ * another buffer (its parent), which it keeps alive; slices are used to
+ * keep a packet in the buffer it was received into and to put the same
+ * packet on several queues without copying it. Buffers which may be
+ * slices or shared must be released with @ref ccnl_buf_free.
+ */
 struct ccnl_buf_s {
     struct ccnl_buf_s *next;
     ssize_t datalen;
-    unsigned char data[1];
+    unsigned char *data;        /**< own bytes (behind the struct) or the parent's */
+    struct ccnl_buf_s *parent;  /**< buffer holding the bytes of a slice */
+    int refcnt;
 };
 
 /**
- * 
+ * @brief Allocate a buffer of @p len bytes, filled from @p data if not NULL
  */
 struct ccnl_buf_s*
 ccnl_buf_new(void *data, int len);
 
+/**
+ * @brief A new buffer for the @p len bytes at @p data, which lie in @p buf
+ */
+struct ccnl_buf_s*
+ccnl_buf_slice(struct ccnl_buf_s *buf, unsigned char *data, int len);
+
+/**
+ * @brief Another reference to the bytes of @p buf which can be queued
+ *        independently of @p buf
+ */
+struct ccnl_buf_s*
+ccnl_buf_share(struct ccnl_buf_s *buf);
+
+/**
+ * @brief Drop a reference to @p buf (may be NULL)
+ */
+void
+ccnl_buf_free(struct ccnl_buf_s *buf);
+
+/**
+ * @brief Announce the buffer a datagram was received into
+ *
+ * Until called again with NULL, @ref ccnl_buf_rx slices packets out of
+ * @p buf instead of copying them. The IO loop must not reuse @p buf for
+ * the next datagram if its refcnt is above 1 afterwards.
+ *
+ * @return the buffer announced before
+ */
+struct ccnl_buf_s*
+ccnl_buf_set_rx(struct ccnl_buf_s *buf);
+
+/**
+ * @brief A buffer holding the received packet at @p data
+ *
+ * A slice of the receive buffer if @p data lies within it and the
+ * datagram is at least CCNL_BUF_SLICE_MIN bytes long, a copy otherwise.
+ */
+struct ccnl_buf_s*
+ccnl_buf_rx(unsigned char *data, int len);
+
 #define buf_dup(B)      (B) ? ccnl_buf_new(B->data, B->datalen) : NULL
 #define buf_equal(X,Y)  ((X) && (Y) && (X->datalen==Y->datalen) &&\
                          !memcmp(X->data,Y->data,X->datalen))
@@ -0,0 +1,119 @@
+/*
+ * @f ccnl-cache.h
+ * @b CCN lite (CCNL), replacement policies of the content store
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_CACHE_H
+#define CCNL_CACHE_H
+
+#ifndef CCNL_LINUXKERNEL
+#include <stddef.h>
+#include <stdint.h>
+#else
+#include <linux/types.h>
+#endif
+
+struct ccnl_relay_s;
+struct ccnl_content_s;
+
+/**
+ * The content store is limited by a number of entries
+ * (ccnl_relay_s.max_cache_entries) and a number of bytes of cached packets
+ * (ccnl_cache_s.max_bytes). Which entry makes room for new content is
+ * decided by a replacement policy, all of which work in constant time.
+ * Static content (CCNL_CONTENT_FLAGS_STATIC) is never replaced.
+ */
+
+#define CCNL_CACHE_LRU          0 // least recently used
+#define CCNL_CACHE_SLRU         1 // segmented LRU: probation and protected
+#define CCNL_CACHE_LFU          2 // least frequently used, LRU among equals
+#define CCNL_CACHE_POLICIES     3
+
+// share of the byte budget (or entries) the protected segment of SLRU may use
+#define CCNL_CACHE_SLRU_PROTECTED(n)    ((n) / 5 * 4)
+
+/**
+ * @brief Entries with the same use count (LFU), in LRU order
+ */
+struct ccnl_cache_freq_s {
+    struct ccnl_cache_freq_s *next, *prev;
+    uint32_t count;
+    struct ccnl_content_s *head, *tail;
+};
+
+struct ccnl_cache_s {
+    int policy;                 /**< CCNL_CACHE_* */
+    size_t bytes;               /**< size of all cached packets */
+    size_t max_bytes;           /**< byte budget, 0: unlimited */
+    struct ccnl_content_s *head[2], *tail[2]; /**< LRU lists, most recent first: LRU uses [0], SLRU [0] probation and [1] protected */
+    size_t segbytes[2];         /**< bytes in each list */
+    int segcnt[2];              /**< entries in each list */
+    struct ccnl_cache_freq_s *freq; /**< LFU buckets, ascending use count */
+    /**
+     * Called when room is needed for @p c; returns 1 if it removed at least
+     * one entry, 0 to let the policy choose
+     */
+    int (*remove_func)(struct ccnl_relay_s *relay, struct ccnl_content_s *c);
+};
+
+/**
+ * @brief Policy of the given name (lru, slru, lfu), -1 if unknown
+ */
+int
+ccnl_cache_str2policy(const char *name);
+
+const char*
+ccnl_cache_policy2str(int policy);
+
+/**
+ * @brief Switch the replacement policy, keeping the cached content
+ *
+ * @return 0 on success, -1 if @p policy is unknown
+ */
+int
+ccnl_cache_set_policy(struct ccnl_relay_s *ccnl, int policy);
+
+/**
+ * @brief Remove replaceable content until @p c fits into the limits
+ *
+ * @return 0 if @p c fits, -1 if not enough content could be removed
+ */
+int
+ccnl_cache_make_room(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c);
+
+/**
+ * @brief Account for @p c which was added to the content store
+ */
+void
+ccnl_cache_insert(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c);
+
+/**
+ * @brief Account for @p c which is being removed from the content store
+ */
+void
+ccnl_cache_remove(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c);
+
+/**
+ * @brief Record that @p c was found by a lookup
+ */
+void
+ccnl_cache_hit(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c);
+
+#endif // CCNL_CACHE_H
@@ -26,25 +26,39 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "ccnl-os-time.h"
+
 struct ccnl_pkt_s;
 struct ccnl_prefix_s;
+struct ccnl_nametree_node_s;
+struct ccnl_cache_freq_s;
 
 struct ccnl_content_s {
     struct ccnl_content_s *next, *prev;
+    struct ccnl_nametree_node_s *node; // CS index entry, NULL if not cached
+    struct ccnl_content_s *samename_next, *samename_prev;
     struct ccnl_pkt_s *pkt;
     unsigned short flags;
 #define CCNL_CONTENT_FLAGS_STATIC  0x01
 #define CCNL_CONTENT_FLAGS_STALE   0x02
+#define CCNL_CONTENT_FLAGS_UNCACHED 0x04 // from the store, not in the CS
     // NON-CONFORM: "The [ContentSTore] MUST also implement the Staleness Bit."
     // >> CCNL: currently no stale bit, old content is fully removed <<
     uint32_t last_used;
+    void *timer;                // removes the content from the cache
 
 #ifdef USE_SUITE_NDNTLV
-    uint32_t freshnessperiod;
+    struct timeval freshness;   // end of the freshness period
     bool stale;
 #endif
 
     int served_cnt;
+
+    // replacement policy, see ccnl-cache.h
+    struct ccnl_content_s *cache_next, *cache_prev;
+    struct ccnl_cache_freq_s *freq;     // LFU bucket
+    int bytes;                  // counted against the byte budget
+    unsigned char segment;      // policy list the entry is on, 0: none
 };
 
 struct ccnl_content_s*
@@ -53,6 +67,14 @@ ccnl_content_new(struct ccnl_pkt_s **pkt);
 void
 ccnl_content_free(struct ccnl_content_s *content);
 
+#ifdef USE_SUITE_NDNTLV
+/**
+ * @brief Checks whether the freshness period of @p c has passed
+ */
+bool
+ccnl_content_is_stale(struct ccnl_content_s *c);
+#endif
+
 
 
 #endif // EOF
@@ -23,15 +23,19 @@
 #ifndef CCNL_CORE_H
 #define CCNL_CORE_H
 
+#include "ccnl-arena.h"
 #include "ccnl-array.h"
+#include "ccnl-cache.h"
 #include "ccnl-content.h"
 #include "ccnl-defs.h"
 #include "ccnl-face.h"
 #include "ccnl-frag.h"
 #include "ccnl-interest.h"
 #include "ccnl-malloc.h"
+#include "ccnl-nametree.h"
 #include "ccnl-os-time.h"
 #include "ccnl-pkt.h"
+#include "ccnl-pool.h"
 #include "ccnl-relay.h"
 #include "ccnl-sockunion.h"
 #include "ccnl-buf.h"
@@ -44,5 +48,7 @@
 #include "ccnl-pkt-util.h"
 #include "ccnl-prefix.h"
 #include "ccnl-sched.h"
+#include "ccnl-stats.h"
+#include "ccnl-txq.h"
 
 #endif // CCNL_CORE_H
@@ -53,6 +53,14 @@
 # define CCNL_MAX_ADDRESS_LEN            8
 # define CCNL_MAX_NAME_COMP              8
 # define CCNL_DEFAULT_MAX_PIT_ENTRIES    20
+# define CCNL_NAMETREE_BUCKETS           8
+# define CCNL_FACE_BUCKETS               4
+# define CCNL_TXQ_BUCKETS                4
+# define CCNL_TIMER_WHEEL_BITS           4
+# define CCNL_TIMER_WHEEL_LEVELS         4
+# define CCNL_TIMER_POOL                 4
+# define CCNL_OBJECT_POOL                4
+# define CCNL_ARENA_CHUNK                256
 #elif defined(CCNL_ANDROID) // max of BTLE and 2xUDP
 # define CCNL_MAX_INTERFACES             3
 # define CCNL_MAX_IF_QLEN                10
@@ -61,29 +69,76 @@
 # define CCNL_MAX_NAME_COMP              16
 # define CCNL_DEFAULT_MAX_PIT_ENTRIES    100
 # define CCNL_MAX_PREFIX_SIZE            2048
+# define CCNL_NAMETREE_BUCKETS           32
+# define CCNL_FACE_BUCKETS               16
+# define CCNL_TXQ_BUCKETS                16
+# define CCNL_TIMER_WHEEL_BITS           6
+# define CCNL_TIMER_WHEEL_LEVELS         4
+# define CCNL_TIMER_POOL                 64
+# define CCNL_OBJECT_POOL                64
+# define CCNL_ARENA_CHUNK                1024
 #else
 # define CCNL_MAX_INTERFACES             10
-# define CCNL_MAX_IF_QLEN                64
+# define CCNL_MAX_IF_QLEN                1024 // packets queued per interface, allocated on demand
 # define CCNL_MAX_PACKET_SIZE            8096
 # define CCNL_MAX_ADDRESS_LEN            6
 # define CCNL_MAX_NAME_COMP              64
 # define CCNL_MAX_PREFIX_SIZE            2048
 # define CCNL_DEFAULT_MAX_PIT_ENTRIES    (-1)
+# define CCNL_NAMETREE_BUCKETS           256 // initial size, grows on demand
+# define CCNL_FACE_BUCKETS               1024 // faces hashed by peer address
+# define CCNL_TXQ_BUCKETS                256 // queued packets hashed to find duplicates
+# define CCNL_TIMER_WHEEL_BITS           6   // 64 slots per level (max 6)
+# define CCNL_TIMER_WHEEL_LEVELS         4   // 1 msec ticks, 4.6 h reach
+# define CCNL_TIMER_POOL                 1024 // free timers kept for reuse
+# define CCNL_OBJECT_POOL                1024 // free objects per type kept for reuse
+# define CCNL_ARENA_CHUNK                4096 // bytes an arena asks ccnl_malloc for at once
+# define CCNL_IO_BATCH                   16  // datagrams per recvmmsg/sendmmsg
+# define CCNL_STORE_SEGMENT_SIZE         (64 * 1024 * 1024) // bytes per segment file of the store
+# define CCNL_STORE_MAX_SEGMENTS         1024
+# define CCNL_STORE_INDEX_SLOTS          4096 // initial size of the store index, doubles when half full
+# define CCNL_MAX_SHARDS                 64
+# define CCNL_PRELOAD_LOADERS            4   // threads loading the data directory
+# define CCNL_PRELOAD_BATCH              64  // content objects passed to a shard at once
+# define CCNL_MALLOC_SITES               1024 // allocation call sites counted (USE_MALLOC_ACCT)
+# define CCNL_MALLOC_SAMPLES             64  // sampled allocation backtraces kept
+// number of leading name components which select the shard of a name; an
+// interest with prefix matching must have at least that many components
+# define CCNL_SHARD_PREFIX_DEPTH         1
 #endif
 
+// state which is per relay thread when running sharded
+#ifdef USE_SHARDS
+# define CCNL_THREAD_LOCAL               __thread
+#else
+# define CCNL_THREAD_LOCAL
+#endif
+
+// received packets of at least that size stay in their receive buffer,
+// smaller ones are copied out (see ccnl_buf_rx)
+#define CCNL_BUF_SLICE_MIN              (CCNL_MAX_PACKET_SIZE / 4)
+
+// active queue management of the interface queues (CoDel, RFC 8289)
+#define CCNL_TXQ_TARGET                 5000   // usec a packet may wait
+#define CCNL_TXQ_INTERVAL               100000 // usec above the target before dropping
+
 #define CCNL_CONTENT_TIMEOUT            300 // sec
 #define CCNL_INTEREST_TIMEOUT           10  // sec
+#define CCNL_INTEREST_RETRANSMIT        1000 // msec between retransmissions
 #define CCNL_MAX_INTEREST_RETRANSMIT    7
 
 // #define CCNL_FACE_TIMEOUT    60 // sec
 #define CCNL_FACE_TIMEOUT       30 // sec
 
 #define CCNL_DEFAULT_MAX_CACHE_ENTRIES  0   // means: no content caching
+// slots of the nonce table (power of two), a nonce is remembered for the
+// lifetime of its interest or until its slot is needed for a newer one
 #ifdef CCNL_RIOT
-#define CCNL_MAX_NONCES                 -1 // -1 --> detect dups by PIT
+#define CCNL_MAX_NONCES                 32
 #else //!CCNL_RIOT
-#define CCNL_MAX_NONCES                 256 // for detected dups
+#define CCNL_MAX_NONCES                 1024
 #endif //CCNL_RIOT
+#define CCNL_NONCE_PROBES               8 // slots searched per nonce
 
 enum {
 #ifdef USE_SUITE_CCNB
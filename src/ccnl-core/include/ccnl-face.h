@@ -24,9 +24,16 @@
 #define CCNL_FACE_H
 
 #include "ccnl-sockunion.h"
+#include "ccnl-txq.h"
+#include "ccnl-stats.h"
+
+struct ccnl_interest_s;
+struct ccnl_pendint_s;
+struct ccnl_forward_s;
 
 struct ccnl_face_s {
     struct ccnl_face_s *next, *prev;
+    struct ccnl_face_s *hash_next; // same bucket of the face table
     int faceid;
     int ifndx;
     sockunion peer;
@@ -35,6 +42,14 @@ struct ccnl_face_s {
     struct ccnl_buf_s *outq, *outqend; // queue of packets to send
     struct ccnl_frag_s *frag;  // which special datagram armoring
     struct ccnl_sched_s *sched;
+    struct ccnl_txflow_s txflow; // its packets in an interface queue
+    // entries referring to this face, cleared when the face is removed
+    struct ccnl_interest_s *interests; // PIT entries received from it
+    struct ccnl_pendint_s *pending;    // PIT entries waiting for content
+    struct ccnl_forward_s *fwds;       // FIB entries forwarding to it
+#ifdef USE_STATS
+    struct ccnl_face_stats_s stats;
+#endif
 };
 
 void
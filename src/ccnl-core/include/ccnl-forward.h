@@ -31,12 +31,24 @@
 typedef void (*tapCallback)(struct ccnl_relay_s *, struct ccnl_face_s *,
                             struct ccnl_prefix_s *, struct ccnl_buf_s *);
 
+struct ccnl_nametree_node_s;
+struct ccnl_interest_s;
+
 struct ccnl_forward_s {
-    struct ccnl_forward_s *next;
+    struct ccnl_forward_s *next, *prev;
+    struct ccnl_nametree_node_s *node; // FIB index entry
+    // same name in the order of adding, the first's samename_prev is the last
+    struct ccnl_forward_s *samename_next, *samename_prev;
     struct ccnl_prefix_s *prefix;
     tapCallback tap;
-    struct ccnl_face_s *face;
+    struct ccnl_face_s *face;      // fixed while linked, see ccnl_fib_link
+    struct ccnl_forward_s *face_next, *face_prev; // same face
     char suite;
+#ifdef USE_STATS
+    struct ccnl_forward_stats_s stats;
+    int pit_refs;                  // PIT entries sent on it, see ccnl_interest_s
+    struct ccnl_interest_s *interests; // these PIT entries, by fwd_next
+#endif
 };
 
 #endif //CCNL_FORWARD_H
@@ -48,6 +48,20 @@ int
 ccnl_http_postselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
                      fd_set *readfs, fd_set *writefs);
 
+/**
+ * @brief Serves the status page, independent of the polling mechanism
+ *
+ * At most one client is accepted at a time. A write is only attempted when
+ * there is pending output and does not block.
+ *
+ * @param[in] server_readable  a connection is waiting on http->server
+ * @param[in] client_readable  http->client has input
+ * @param[in] client_writable  output may be sent to http->client
+ */
+int
+ccnl_http_io(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
+             int server_readable, int client_readable, int client_writable);
+
 int
 ccnl_cmpfaceid(const void *a, const void *b);
 
@@ -29,16 +29,9 @@
 
 #include "ccnl-sched.h"
 #include "ccnl-face.h"
+#include "ccnl-txq.h"
 
 
-
-struct ccnl_txrequest_s {
-    struct ccnl_buf_s *buf;
-    sockunion dst;
-    void (*txdone)(void*, int, int);
-    struct ccnl_face_s* txdone_face;
-};
-
 struct ccnl_if_s { // interface for packet IO
     sockunion addr;
 #ifdef CCNL_LINUXKERNEL
@@ -61,13 +54,15 @@ struct ccnl_if_s { // interface for packet IO
     int fwdalli; // whether to forward all I packets rcvd on this interface
     int mtu;
 
-    int qlen;  // number of pending sends
-    int qfront; // index of next packet to send
-    struct ccnl_txrequest_s queue[CCNL_MAX_IF_QLEN];
+    struct ccnl_txq_s txq; // pending sends
     struct ccnl_sched_s *sched;
 
 #ifdef USE_STATS
     uint32_t rx_cnt, tx_cnt;
+#ifdef USE_BATCH_IO
+    uint32_t rx_batches, tx_batches; // number of recvmmsg/sendmmsg calls
+    int rx_batch_max, tx_batch_max;  // largest batch seen
+#endif
 #endif
 };
 
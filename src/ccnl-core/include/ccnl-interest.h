@@ -27,23 +27,40 @@
 #include "ccnl-face.h"
 
 
+struct ccnl_interest_s;
+struct ccnl_forward_s;
+
 struct ccnl_pendint_s { // pending interest
     struct ccnl_pendint_s *next; // , *prev;
     struct ccnl_face_s *face;
     uint32_t last_used;
+    struct ccnl_interest_s *interest;
+    struct ccnl_pendint_s *face_next, *face_prev; // pending on the same face
 };
 
+struct ccnl_nametree_node_s;
+
 struct ccnl_interest_s {
     struct ccnl_interest_s *next, *prev;
+    struct ccnl_nametree_node_s *node; // PIT index entry
+    struct ccnl_interest_s *samename_next, *samename_prev;
     struct ccnl_pkt_s *pkt;
-    struct ccnl_face_s *from;
+    struct ccnl_face_s *from;      // set by ccnl_interest_set_from
+    struct ccnl_interest_s *from_next, *from_prev; // same from face
     struct ccnl_pendint_s *pending; // linked list of faces wanting that content
     unsigned short flags;
-    uint32_t lifetime;
+    uint32_t lifetime;              // msec
 #define CCNL_PIT_COREPROPAGATES    0x01
 #define CCNL_PIT_TRACED            0x02
     uint32_t last_used;
+    struct timeval expires;         // last_used + lifetime, at usec resolution
+    void *timer;                    // next retransmission or expiry
     int retries;
+#ifdef USE_STATS
+    struct timeval created;
+    struct ccnl_forward_s *fwd;     // set by ccnl_interest_set_fwd
+    struct ccnl_interest_s *fwd_next, *fwd_prev; // same route
+#endif
 #ifdef USE_NFN_REQUESTS
     struct ccnl_interest_s *keepalive; // the keepalive interest dispatched for this interest
     struct ccnl_interest_s *keepalive_origin; // the interest that dispatched this keepalive interest 
@@ -53,6 +70,32 @@ struct ccnl_interest_s {
 //struct ccnl_interest_s*
 //ccnl_interest_new(struct ccnl_face_s *from, struct ccnl_pkt_s **pkt);
 
+/**
+ * @brief Restarts the lifetime and the retransmissions of @p i
+ */
+void
+ccnl_interest_refresh(struct ccnl_interest_s *i);
+
+/**
+ * @brief Sets the face @p i was received from, NULL if none
+ */
+void
+ccnl_interest_set_from(struct ccnl_interest_s *i, struct ccnl_face_s *from);
+
+#ifdef USE_STATS
+/**
+ * @brief Sets the route @p i was sent on first, for its counters, NULL if none
+ */
+void
+ccnl_interest_set_fwd(struct ccnl_interest_s *i, struct ccnl_forward_s *fwd);
+#endif
+
+/**
+ * @brief Frees @p pend which was unlinked from the pending list of its interest
+ */
+void
+ccnl_pendint_free(struct ccnl_pendint_s *pend);
+
 int
 ccnl_interest_isSame(struct ccnl_interest_s *i, struct ccnl_pkt_s *pkt);
 
@@ -79,7 +79,48 @@ debug_strdup(const char *s, const char *fn, int lno, char *tstamp);
 
 #endif // CCNL_ARDUINO
 
-#else // !USE_DEBUG_MALLOC
+#elif defined(USE_MALLOC_ACCT)
+
+/**
+ * Allocation accounting: every block carries a small header naming its call
+ * site, whose counters (allocations, frees, bytes) live in a fixed table.
+ * There is no list of blocks and no per block bookkeeping beyond the header,
+ * so it is cheap enough for production. With acct_sample set, a backtrace
+ * is taken of every acct_sample-th allocation of a thread.
+ */
+
+#include <stddef.h>
+
+extern int acct_sample;
+
+void *acct_malloc(size_t s, const char *fn, int lno);
+void *acct_calloc(size_t n, size_t s, const char *fn, int lno);
+void *acct_realloc(void *p, size_t s, const char *fn, int lno);
+char *acct_strdup(const char *s, const char *fn, int lno);
+void acct_free(void *p);
+
+/**
+ * @brief Writes the call site table and the sampled backtraces as text
+ *
+ * @return the length of the whole text, which is cut short if it is not
+ *         less than @p size (as with snprintf)
+ */
+int
+acct_memdump(char *buf, int size);
+
+/**
+ * @brief Prints the table to the console
+ */
+void
+acct_memprint(void);
+
+#  define ccnl_malloc(s)        acct_malloc(s, __FILE__, __LINE__)
+#  define ccnl_calloc(n,s)      acct_calloc(n, s, __FILE__, __LINE__)
+#  define ccnl_realloc(p,s)     acct_realloc(p, s, __FILE__, __LINE__)
+#  define ccnl_strdup(s)        acct_strdup(s, __FILE__, __LINE__)
+#  define ccnl_free(p)          acct_free(p)
+
+#else // !USE_DEBUG_MALLOC && !USE_MALLOC_ACCT
 
 
 # ifndef CCNL_LINUXKERNEL
@@ -95,7 +136,7 @@ debug_strdup(const char *s, const char *fn, int lno, char *tstamp);
 #  define ccnl_free(p)          free(p)
 # endif
 
-#endif// USE_DEBUG_MALLOC
+#endif// USE_DEBUG_MALLOC, USE_MALLOC_ACCT
 
 #ifdef CCNL_LINUXKERNEL
 
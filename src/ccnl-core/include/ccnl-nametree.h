@@ -0,0 +1,134 @@
+/*
+ * @f ccnl-nametree.h
+ * @b CCN lite (CCNL), hashed name tree for the CS, PIT and FIB indices
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_NAMETREE_H
+#define CCNL_NAMETREE_H
+
+#ifndef CCNL_LINUXKERNEL
+#include <stdint.h>
+#endif
+
+struct ccnl_prefix_s;
+
+/**
+ * @brief A node of the name tree, representing one name (prefix)
+ *
+ * Every node is reachable in two ways: as a member of a hash table keyed on
+ * the suite and the complete name up to and including this node (exact name
+ * lookup with a single probe), and through the parent/child links which form
+ * a component trie (prefix and subtree walks).
+ */
+struct ccnl_nametree_node_s {
+    struct ccnl_nametree_node_s *hnext;     /**< next node in the hash bucket */
+    struct ccnl_nametree_node_s *parent;    /**< name without the last component */
+    struct ccnl_nametree_node_s *child;     /**< first name one component longer */
+    struct ccnl_nametree_node_s *sibling, *sibprev; /**< other children of parent */
+    void *entries;      /**< owner specific list of entries with exactly this name */
+    uint32_t hash;      /**< hash over suite and all components up to this node */
+    int refs;           /**< number of attached entries plus number of children */
+    int depth;          /**< number of name components */
+    char suite;         /**< packet format of the name */
+    int complen;        /**< length of the last name component */
+    unsigned char comp[1]; /**< last name component (complen bytes) */
+};
+
+/**
+ * @brief Hash table of name tree nodes
+ *
+ * A zeroed struct is a valid, empty tree; the buckets are allocated on the
+ * first insertion.
+ */
+struct ccnl_nametree_s {
+    struct ccnl_nametree_node_s **buckets;
+    int size;           /**< number of buckets (power of two) */
+    int count;          /**< number of nodes */
+};
+
+/**
+ * @brief Start value of the name hash for @p suite (i.e. the empty name)
+ */
+uint32_t
+ccnl_nametree_seed(int suite);
+
+/**
+ * @brief Extend the name hash @p h by one component
+ */
+uint32_t
+ccnl_nametree_hash(uint32_t h, unsigned char *comp, int complen);
+
+/**
+ * @brief Find the node for the first @p depth components of @p pfx
+ *
+ * @return the node, NULL if no entry has this name or a name below it
+ */
+struct ccnl_nametree_node_s*
+ccnl_nametree_find(struct ccnl_nametree_s *t, struct ccnl_prefix_s *pfx,
+                   int depth);
+
+/**
+ * @brief Find the child of @p parent with the last component @p comp
+ *
+ * @return the node, NULL if not present
+ */
+struct ccnl_nametree_node_s*
+ccnl_nametree_child(struct ccnl_nametree_s *t,
+                    struct ccnl_nametree_node_s *parent,
+                    unsigned char *comp, int complen);
+
+/**
+ * @brief Find or create the node for the first @p depth components of @p pfx
+ *        and take a reference on it
+ *
+ * Every call must be balanced by a call to @ref ccnl_nametree_release.
+ *
+ * @return the node, NULL if out of memory
+ */
+struct ccnl_nametree_node_s*
+ccnl_nametree_get(struct ccnl_nametree_s *t, struct ccnl_prefix_s *pfx,
+                  int depth);
+
+/**
+ * @brief Drop a reference on @p n, freeing all nodes which became unused
+ */
+void
+ccnl_nametree_release(struct ccnl_nametree_s *t, struct ccnl_nametree_node_s *n);
+
+/**
+ * @brief Pre-order walk of the subtree below @p top
+ *
+ * @param[in] n         current node (start with @p top)
+ * @param[in] top       root of the subtree which is walked
+ * @param[in] maxdepth  do not descend below nodes of this depth
+ *
+ * @return next node, NULL when the subtree is exhausted
+ */
+struct ccnl_nametree_node_s*
+ccnl_nametree_next(struct ccnl_nametree_node_s *n,
+                   struct ccnl_nametree_node_s *top, int maxdepth);
+
+/**
+ * @brief Free the hash table of an (empty) name tree
+ */
+void
+ccnl_nametree_cleanup(struct ccnl_nametree_s *t);
+
+#endif // CCNL_NAMETREE_H
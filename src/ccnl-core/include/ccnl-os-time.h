@@ -75,7 +75,9 @@ timestamp(void);
 // ----------------------------------------------------------------------
 
 struct ccnl_timer_s {
-    struct ccnl_timer_s *next;
+    struct ccnl_timer_s *next, *prev;
+    unsigned char pending;          // 0 once fired or removed
+    unsigned char level, slot;      // position in the timing wheel
     struct timeval timeout;
     void (*fct)(char,int);
     void (*fct2)(void*,void*);
@@ -92,13 +94,31 @@ ccnl_get_timeval(struct timeval *tv);
 long
 timevaldelta(struct timeval *a, struct timeval *b);
 
+/**
+ * @brief Calls @p fct after @p usec
+ *
+ * Timers are reused once they fired or were removed, so the returned handle
+ * must be forgotten then: @p fct clears the copy its owner keeps before it
+ * returns or sets another timer.
+ *
+ * @return a handle for @ref ccnl_rem_timer, NULL if out of memory
+ */
 void*
 ccnl_set_timer(uint64_t usec, void (*fct)(void *aux1, void *aux2),
                  void *aux1, void *aux2);
 
+/**
+ * @brief Cancels the pending timer @p h, see @ref ccnl_set_timer
+ */
 void
 ccnl_rem_timer(void *h);
 
+/**
+ * @brief Removes all pending timers and frees the timers kept for reuse
+ */
+void
+ccnl_timer_cleanup(void);
+
 #endif
 
 #ifdef CCNL_LINUXKERNEL
@@ -141,7 +161,7 @@ ccnl_run_events(void);
 
 void*
 ccnl_set_absolute_timer(struct timeval abstime, void (*fct)(void *aux1, void *aux2),
-         void *aux1, void *aux2)
+         void *aux1, void *aux2);
 
 #endif
 
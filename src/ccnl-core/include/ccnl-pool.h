@@ -0,0 +1,86 @@
+/*
+ * @f ccnl-pool.h
+ * @b CCN lite (CCNL), per-type pools of fixed-size objects
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_POOL_H
+#define CCNL_POOL_H
+
+#ifndef CCNL_LINUXKERNEL
+#include <stdint.h>
+#else
+#include <linux/types.h>
+#endif
+
+/**
+ * The objects created and destroyed for every packet (packets, prefixes,
+ * PIT and CS entries, buffer slices, queued packets) are taken from
+ * per-type pools. A pool keeps up to CCNL_OBJECT_POOL released objects in a
+ * free list and hands them out again before asking ccnl_malloc for more. Every
+ * pooled object is a block of its own, so one which is released with ccnl_free
+ * instead of @ref ccnl_pool_free is not lost. Pools are per relay thread.
+ */
+
+#define CCNL_POOL_PKT           0
+#define CCNL_POOL_PREFIX        1 // prefix with CCNL_MAX_NAME_COMP inline components
+#define CCNL_POOL_INTEREST      2
+#define CCNL_POOL_PENDINT       3
+#define CCNL_POOL_CONTENT       4
+#define CCNL_POOL_SLICE         5 // buffer referring to the bytes of another
+#define CCNL_POOL_TXREQ         6 // packet waiting in an interface queue
+#define CCNL_POOL_TYPES         7
+
+struct ccnl_pool_s {
+    const char *name;
+    int size;                   /**< object size in bytes */
+    void *free;                 /**< released objects, linked by their first word */
+    int freecnt;                /**< length of the free list */
+    int inuse;                  /**< objects handed out and not yet released */
+    uint32_t hits;              /**< allocations served from the free list */
+    uint32_t misses;            /**< allocations which needed ccnl_malloc */
+};
+
+/**
+ * @brief Take a zeroed object from pool @p type
+ *
+ * @return the object, NULL if out of memory
+ */
+void*
+ccnl_pool_alloc(int type);
+
+/**
+ * @brief Return @p p (may be NULL) to pool @p type
+ */
+void
+ccnl_pool_free(int type, void *p);
+
+/**
+ * @brief Occupancy and hit counters of pool @p type of the calling thread
+ */
+const struct ccnl_pool_s*
+ccnl_pool_stats(int type);
+
+/**
+ * @brief Free the objects cached by the pools of the calling thread
+ */
+void
+ccnl_pool_cleanup(void);
+
+#endif // CCNL_POOL_H
@@ -26,27 +26,51 @@
 #include "ccnl-defs.h"
 #include "ccnl-face.h"
 #include "ccnl-if.h"
+#include "ccnl-nametree.h"
 #include "ccnl-pkt.h"
 #include "ccnl-sched.h"
+#include "ccnl-cache.h"
+#include "ccnl-stats.h"
+
+/**
+ * @brief Slot of the nonce table, an open addressing hash set
+ */
+struct ccnl_nonce_s {
+    uint64_t hash;              /**< hash of the nonce, 0: empty slot */
+    uint32_t expires;           /**< msec clock, see ccnl_nonce_find_or_append */
+};
 
 
 struct ccnl_relay_s {
     void (*ccnl_ll_TX_ptr)(struct ccnl_relay_s*, struct ccnl_if_s*,
         sockunion*, struct ccnl_buf_s*);
+#ifdef USE_BATCH_IO
+    void (*ccnl_ll_TX_batch_ptr)(struct ccnl_relay_s*, struct ccnl_if_s*); /**< sends an interface's whole queue, if set the queue is flushed by the IO loop */
+#endif
+    struct ccnl_content_s* (*ccnl_store_lookup_ptr)(struct ccnl_relay_s*,
+        struct ccnl_pkt_s*, int (*cMatch)(struct ccnl_pkt_s*, struct ccnl_content_s*)); /**< finds content below the CS on a miss, NULL if there is no store */
 #ifndef CCNL_ARDUINO
     time_t startup_time;
 #endif
     int id;
     struct ccnl_face_s *faces;  /**< The existing forwarding faces */
+    struct ccnl_face_s *face_hash[CCNL_FACE_BUCKETS]; /**< faces by peer address, local faces in [0] */
     struct ccnl_forward_s *fib; /**< The Forwarding Information Base (FIB) */
+    struct ccnl_nametree_s fib_index; /**< name index over the FIB */
 
     struct ccnl_interest_s *pit; /**< The Pending Interest Table (PIT) */
+    struct ccnl_nametree_s pit_index; /**< name index over the PIT */
     struct ccnl_content_s *contents; /**< contentsend; */
-    struct ccnl_buf_s *nonces;  /**< The nonces that are currently in use */
+    struct ccnl_nametree_s cs_index; /**< name index over the contents */
+    struct ccnl_nonce_s nonces[CCNL_MAX_NONCES]; /**< recently seen nonces */
     int contentcnt;             /**< number of cached items */
     int max_cache_entries;      /**< max number of cached items -1: unlimited */
+    struct ccnl_cache_s cache;  /**< replacement policy and byte budget of the CS */
     int pitcnt;                 /**< Number of entries in the PIT */
     int max_pit_entries;        /**< max number of pit entries; -1: unlimited */ 
+#ifdef USE_STATS
+    struct ccnl_relay_stats_s stats; /**< counters not kept per face or route */
+#endif
     struct ccnl_if_s ifs[CCNL_MAX_INTERFACES];
     int ifcount;               /**< number of active interfaces */
     char halt_flag;            /**< Flag to interrupt the IO_Loop and to exit the relay */
@@ -62,6 +86,12 @@ struct ccnl_relay_s {
 #ifdef USE_NFN
     struct ccnl_krivine_s *km;  /**< Krivine Abstract Machine for NFN*/
 #endif
+#ifdef USE_SHARDS
+    struct ccnl_shardset_s *shards; /**< relays sharing PIT and CS by name, NULL if not sharded */
+    int shard;                  /**< index of this relay in shards */
+    int fib_gen;                /**< incremented on every FIB change */
+    int (*shard_handoff)(struct ccnl_relay_s*, struct ccnl_interest_s*); /**< passes an interest to the shard owning its name, returns 1 if it did */
+#endif
 
    // struct ccnl_buf_s *bufCleanUpList;
   /*
@@ -141,6 +171,17 @@ ccnl_interest_remove(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i);
  * @param[in] ccnl  pointer to current ccnl relay
  * @param[in] i     interest message to be forwarded
 */
+/**
+ * @brief Looks up a PIT entry which an interest can be aggregated with
+ *
+ * @param[in] ccnl  pointer to current ccnl relay
+ * @param[in] pkt   the interest
+ *
+ * @return the PIT entry (see @ref ccnl_interest_isSame), NULL if none
+ */
+struct ccnl_interest_s*
+ccnl_interest_lookup(struct ccnl_relay_s *ccnl, struct ccnl_pkt_s *pkt);
+
 void
 ccnl_interest_propagate(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i);
 
@@ -148,9 +189,40 @@ ccnl_interest_propagate(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i);
 struct ccnl_content_s*
 ccnl_content_remove(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c);
 
-struct ccnl_content_s*
+/**
+ * @brief Adds @p c to the content store, replacing content if needed
+ *
+ * @return 0 if @p c is cached (or was already), -1 if not (no room, out of
+ *         memory, a NACK): the caller still owns it then
+ */
+int
 ccnl_content_add2cache(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c);
 
+/**
+ * @brief Looks up a cached content object matching an interest
+ *
+ * Only contents with the interest's name, names below it (NDN and CCNB
+ * prefix matching) or the name without its last component (implicit digest)
+ * are passed to @p cMatch, which has the final say.
+ *
+ * @param[in] ccnl    pointer to current ccnl relay
+ * @param[in] pkt     the interest
+ * @param[in] cMatch  suite specific match function, returns 0 on a match
+ *
+ * @return the first matching content, NULL if there is none
+ */
+struct ccnl_content_s*
+ccnl_content_lookup(struct ccnl_relay_s *ccnl, struct ccnl_pkt_s *pkt,
+                    int (*cMatch)(struct ccnl_pkt_s*, struct ccnl_content_s*));
+
+/**
+ * @brief Looks up a cached content object with the same bytes as @p pkt
+ *
+ * @return the cached duplicate, NULL if there is none
+ */
+struct ccnl_content_s*
+ccnl_content_find_dup(struct ccnl_relay_s *ccnl, struct ccnl_pkt_s *pkt);
+
 /**
  * @brief deliver new content @p c to all clients with (loosely) matching interest 
  *
@@ -165,8 +237,16 @@ ccnl_content_serve_pending(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c);
 void
 ccnl_do_ageing(void *ptr, void *dummy);
 
+/**
+ * @brief Checks whether @p nonce was seen before, remembers it otherwise
+ *
+ * @param[in] lifetime  time in msec for which the nonce is remembered
+ *
+ * @return -1 if @p nonce is known, 0 if it was added
+ */
 int
-ccnl_nonce_find_or_append(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *nonce);
+ccnl_nonce_find_or_append(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *nonce,
+                          uint32_t lifetime);
 
 int
 ccnl_nonce_isDup(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt);
@@ -174,6 +254,53 @@ ccnl_nonce_isDup(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt);
 void
 ccnl_core_cleanup(struct ccnl_relay_s *ccnl);
 
+/**
+ * @brief Insert an allocated entry into the FIB
+ *
+ * Entries with the same prefix are kept in the order they were linked.
+ *
+ * @par[in] relay   Local relay struct
+ * @par[in] fwd     FIB entry, with prefix, suite and face set; the face must
+ *                  not change until the entry is unlinked
+ *
+ * @return 0    on success
+ * @return -1   on error (out of memory), @p fwd is not linked
+ */
+int
+ccnl_fib_link(struct ccnl_relay_s *relay, struct ccnl_forward_s *fwd);
+
+/**
+ * @brief Take an entry out of the FIB without freeing it
+ *
+ * @par[in] relay   Local relay struct
+ * @par[in] fwd     FIB entry
+ *
+ * @return the entry following @p fwd in relay->fib
+ */
+struct ccnl_forward_s*
+ccnl_fib_unlink(struct ccnl_relay_s *relay, struct ccnl_forward_s *fwd);
+
+/**
+ * @brief Longest prefix match of a name in the FIB
+ *
+ * @par[in] relay   Local relay struct
+ * @par[in] pfx     Name to look up
+ *
+ * @return first FIB entry with the longest prefix of @p pfx, further
+ *         entries with the same prefix follow via samename_next;
+ *         NULL if no prefix of @p pfx is registered
+ */
+struct ccnl_forward_s*
+ccnl_fib_lookup(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx);
+
+/**
+ * @brief Find the first FIB entry for exactly @p pfx
+ *
+ * @return the entry, NULL if @p pfx is not registered
+ */
+struct ccnl_forward_s*
+ccnl_fib_find(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx);
+
 #ifdef NEEDS_PREFIX_MATCHING
 /**
  * @brief Add entry to the FIB
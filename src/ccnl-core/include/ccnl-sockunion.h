@@ -117,6 +117,12 @@ ccnl_addr2ascii(sockunion *su);
 int
 ccnl_addr_cmp(sockunion *s1, sockunion *s2);
 
+/**
+ * @brief Hash over the parts of @p su compared by ccnl_addr_cmp()
+ */
+uint32_t
+ccnl_addr_hash(sockunion *su);
+
 char*
 ll2ascii(unsigned char *addr, size_t len);
 
@@ -0,0 +1,94 @@
+/*
+ * @f ccnl-stats.h
+ * @b CCN lite (CCNL), forwarding counters per face, per route and per relay
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_STATS_H
+#define CCNL_STATS_H
+
+#ifndef CCNL_LINUXKERNEL
+#include <stdint.h>
+#else
+#include <linux/types.h>
+#endif
+
+/**
+ * With USE_STATS the forwarder counts what it does per face, per FIB entry
+ * and per relay. Counters are plain increments of fields of the structs
+ * the forwarder holds anyway, nothing is looked up or locked for them, so
+ * they can stay on in production. The HTTP status server exports them.
+ *
+ * Packets dropped because an interface queue was full are counted by the
+ * queue (ccnl_txq_s.drops), the other reasons here.
+ */
+
+#define CCNL_DROP_HOPLIMIT      0 // hop limit, scope or TTL exhausted
+#define CCNL_DROP_DUPNONCE      1 // interest looping, nonce seen before
+#define CCNL_DROP_UNSOLICITED   2 // data nobody asked for
+#define CCNL_DROP_REASONS       3
+
+/**
+ * Upper bounds of the buckets of the PIT residence histogram are
+ * CCNL_STATS_BUCKET_USEC << b for b < CCNL_STATS_BUCKETS - 1, from 64 us to
+ * about 2 s; the last bucket takes the rest.
+ */
+#define CCNL_STATS_BUCKET_USEC  64
+#define CCNL_STATS_BUCKETS      17
+
+struct ccnl_face_stats_s {
+    uint32_t interests_in, interests_out;
+    uint32_t data_in, data_out;
+    uint32_t cs_hits, cs_misses;    // for interests received on the face
+    uint32_t pit_aggregated;        // interests added to a pending entry
+    uint32_t drops[CCNL_DROP_REASONS];
+};
+
+struct ccnl_forward_stats_s {
+    uint32_t interests_out;
+    uint32_t data_in;               // satisfying an interest sent on the route
+    uint32_t aggregated;            // interests added to one sent on it
+    uint32_t expired;               // interests sent on it which timed out
+};
+
+struct ccnl_relay_stats_s {
+    uint32_t pit_satisfied, pit_expired;
+    uint32_t residence[CCNL_STATS_BUCKETS]; // satisfied entries by age
+    uint64_t residence_usec;        // sum of their ages
+};
+
+/**
+ * @brief The histogram bucket of a PIT residence time of @p usec
+ */
+int
+ccnl_stats_bucket(long usec);
+
+/**
+ * @brief The upper bound of bucket @p b in microseconds, -1 for the last
+ */
+long
+ccnl_stats_bucket_usec(int b);
+
+/**
+ * @brief The name of drop reason @p reason as used in the exports
+ */
+const char*
+ccnl_stats_drop2str(int reason);
+
+#endif // CCNL_STATS_H
@@ -0,0 +1,132 @@
+/*
+ * @f ccnl-txq.h
+ * @b CCN lite (CCNL), transmit queues of the interfaces
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_TXQ_H
+#define CCNL_TXQ_H
+
+#ifndef CCNL_LINUXKERNEL
+#include <stdint.h>
+#include "ccnl-defs.h"
+#include "ccnl-sockunion.h"
+#else
+#include <linux/types.h>
+#include <ccnl-defs.h>
+#include <ccnl-sockunion.h>
+#endif
+
+/**
+ * An interface queue holds one flow per face plus one for packets which
+ * are not sent on behalf of a face. Flows with packets take turns in deficit
+ * round robin order, so a busy face cannot starve the others, and each
+ * flow is kept short by CoDel (RFC 8289): once the packets of a flow have
+ * waited longer than CCNL_TXQ_TARGET for CCNL_TXQ_INTERVAL, packets are
+ * dropped at its head at an increasing rate until the delay is back below
+ * the target. The queue grows on demand up to CCNL_MAX_IF_QLEN packets, beyond
+ * that the head of the longest flow is dropped.
+ */
+
+struct ccnl_buf_s;
+struct ccnl_face_s;
+struct ccnl_txq_s;
+
+struct ccnl_txrequest_s {
+    struct ccnl_txrequest_s *next;     // in its flow
+    struct ccnl_txrequest_s *dup_next; // same bucket of the duplicate table
+    struct ccnl_buf_s *buf;
+    sockunion dst;
+    void (*txdone)(void*, int, int);
+    struct ccnl_face_s* txdone_face;
+    uint32_t hash;                     // of the packet and the face
+    uint64_t enqueued;                 // usec
+};
+
+struct ccnl_txflow_s {
+    struct ccnl_txrequest_s *head, *tail;
+    struct ccnl_txflow_s *next;        // next active flow
+    struct ccnl_txq_s *txq;            // which queue the packets are in
+    int qlen;
+    int deficit;                       // bytes it may still send this round
+    // CoDel state
+    int dropping;
+    uint32_t dropcnt;
+    uint64_t first_above, drop_next;   // usec
+};
+
+struct ccnl_txq_s {
+    int qlen;                          // packets in all flows
+    int qbytes;
+    int quantum;                       // bytes per round, 0 for the maximum packet size
+    struct ccnl_txflow_s flow;         // packets without a face
+    struct ccnl_txflow_s *active, *active_tail;
+    struct ccnl_txrequest_s *dups[CCNL_TXQ_BUCKETS];
+    // statistics
+    uint32_t drops;                    // because the queue was full
+    uint32_t aqm_drops;                // by CoDel
+    uint32_t sojourn, sojourn_max;     // usec, of the last packet sent
+};
+
+/**
+ * @brief Append @p buf (its reference is passed) for @p dst to the flow
+ * of face @p f (may be NULL), @p txdone is called with @p f once it is sent
+ *
+ * @return 0 on success, -1 if the packet was dropped
+ */
+int
+ccnl_txq_enqueue(struct ccnl_txq_s *q, struct ccnl_face_s *f,
+                 struct ccnl_buf_s *buf, sockunion *dst,
+                 void (*txdone)(void*, int, int));
+
+/**
+ * @brief Whether an equal packet for face @p f is already waiting in @p q
+ */
+int
+ccnl_txq_find(struct ccnl_txq_s *q, struct ccnl_face_s *f,
+              struct ccnl_buf_s *buf);
+
+/**
+ * @brief Remove the next packet to send, NULL if @p q is empty
+ *
+ * The request must be released with @ref ccnl_txq_release once it was sent.
+ */
+struct ccnl_txrequest_s*
+ccnl_txq_dequeue(struct ccnl_txq_s *q);
+
+/**
+ * @brief Free a request returned by @ref ccnl_txq_dequeue and its packet
+ */
+void
+ccnl_txq_release(struct ccnl_txrequest_s *r);
+
+/**
+ * @brief Move the packets in @p q of face @p f, which is going away, to the
+ * flow without a face, they are still sent
+ */
+void
+ccnl_txq_orphan(struct ccnl_txq_s *q, struct ccnl_face_s *f);
+
+/**
+ * @brief Drop all packets of @p q
+ */
+void
+ccnl_txq_cleanup(struct ccnl_txq_s *q);
+
+#endif // CCNL_TXQ_H
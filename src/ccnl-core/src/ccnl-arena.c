@@ -0,0 +1,99 @@
+/*
+ * @f ccnl-arena.c
+ * @b CCN lite (CCNL), bump allocator released in one operation
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_LINUXKERNEL
+#include "ccnl-arena.h"
+#include "ccnl-defs.h"
+#include "ccnl-malloc.h"
+#include <string.h>
+#else
+#include <ccnl-arena.h>
+#include <ccnl-defs.h>
+#include <ccnl-malloc.h>
+#endif
+
+#define ARENA_ALIGN(n)  (((n) + 7) & ~(size_t) 7)
+#define ARENA_HEADER    ARENA_ALIGN(sizeof(struct ccnl_arena_chunk_s))
+
+static struct ccnl_arena_chunk_s*
+arena_chunk(struct ccnl_arena_s *arena, size_t size)
+{
+    struct ccnl_arena_chunk_s *c = ccnl_malloc(ARENA_HEADER + size);
+
+    if (!c)
+        return NULL;
+    c->size = size;
+    arena->chunkcnt++;
+    return c;
+}
+
+void*
+ccnl_arena_alloc(struct ccnl_arena_s *arena, size_t size)
+{
+    struct ccnl_arena_chunk_s *c;
+    char *p;
+
+    size = ARENA_ALIGN(size ? size : 1);
+    if (size > arena->left) {
+        if (size > CCNL_ARENA_CHUNK / 4) {
+            // a chunk of its own, behind the one being cut
+            c = arena_chunk(arena, size);
+            if (!c)
+                return NULL;
+            if (arena->chunks) {
+                c->next = arena->chunks->next;
+                arena->chunks->next = c;
+            } else {
+                c->next = NULL;
+                arena->chunks = c;
+            }
+            arena->used += size;
+            p = (char*) c + ARENA_HEADER;
+            memset(p, 0, size);
+            return p;
+        }
+        c = arena_chunk(arena, CCNL_ARENA_CHUNK);
+        if (!c)
+            return NULL;
+        c->next = arena->chunks;
+        arena->chunks = c;
+        arena->left = CCNL_ARENA_CHUNK;
+    }
+    c = arena->chunks;
+    p = (char*) c + ARENA_HEADER + (c->size - arena->left);
+    arena->left -= size;
+    arena->used += size;
+    memset(p, 0, size);
+    return p;
+}
+
+void
+ccnl_arena_release(struct ccnl_arena_s *arena)
+{
+    while (arena->chunks) {
+        struct ccnl_arena_chunk_s *c = arena->chunks;
+        arena->chunks = c->next;
+        ccnl_free(c);
+    }
+    arena->left = arena->used = 0;
+    arena->chunkcnt = 0;
+}
@@ -32,6 +32,7 @@
 #include "ccnl-forward.h"
 #include "ccnl-prefix.h"
 #include "ccnl-malloc.h"
+#include "ccnl-pool.h"
 #else
 #include <ccnl-os-time.h>
 #include <ccnl-buf.h>
@@ -40,6 +41,7 @@
 #include <ccnl-forward.h>
 #include <ccnl-prefix.h>
 #include <ccnl-malloc.h>
+#include <ccnl-pool.h>
 #endif
 
 struct ccnl_buf_s*
@@ -51,12 +53,73 @@ ccnl_buf_new(void *data, int len)
         return NULL;
     b->next = NULL;
     b->datalen = len;
+    b->data = (unsigned char*) (b + 1);
+    b->parent = NULL;
+    b->refcnt = 1;
     if (data)
         memcpy(b->data, data, len);
     return b;
 }
 
-struct ccnl_buf_s *bufCleanUpList;
+struct ccnl_buf_s*
+ccnl_buf_slice(struct ccnl_buf_s *buf, unsigned char *data, int len)
+{
+    struct ccnl_buf_s *b;
+
+    if (buf->parent) // slices refer to the buffer owning the bytes
+        buf = buf->parent;
+    b = ccnl_pool_alloc(CCNL_POOL_SLICE);
+    if (!b)
+        return NULL;
+    b->datalen = len;
+    b->data = data;
+    b->parent = buf;
+    b->refcnt = 1;
+    buf->refcnt++;
+    return b;
+}
+
+struct ccnl_buf_s*
+ccnl_buf_share(struct ccnl_buf_s *buf)
+{
+    return buf ? ccnl_buf_slice(buf, buf->data, buf->datalen) : NULL;
+}
+
+void
+ccnl_buf_free(struct ccnl_buf_s *buf)
+{
+    if (!buf || --buf->refcnt > 0)
+        return;
+    if (buf->parent) {
+        ccnl_buf_free(buf->parent);
+        ccnl_pool_free(CCNL_POOL_SLICE, buf);
+    } else
+        ccnl_free(buf);
+}
+
+// the buffer the datagram in processing was received into
+static CCNL_THREAD_LOCAL struct ccnl_buf_s *rxbuf;
+
+struct ccnl_buf_s*
+ccnl_buf_set_rx(struct ccnl_buf_s *buf)
+{
+    struct ccnl_buf_s *prev = rxbuf;
+
+    rxbuf = buf;
+    return prev;
+}
+
+struct ccnl_buf_s*
+ccnl_buf_rx(unsigned char *data, int len)
+{
+    // a small packet would pin a whole receive buffer, copy it instead
+    if (rxbuf && rxbuf->datalen >= CCNL_BUF_SLICE_MIN &&
+        data >= rxbuf->data && data + len <= rxbuf->data + rxbuf->datalen)
+        return ccnl_buf_slice(rxbuf, data, len);
+    return ccnl_buf_new(data, len);
+}
+
+CCNL_THREAD_LOCAL struct ccnl_buf_s *bufCleanUpList;
 
 void
 ccnl_core_addToCleanup(struct ccnl_buf_s *buf)
@@ -74,21 +137,20 @@ ccnl_core_cleanup(struct ccnl_relay_s *ccnl)
 
     while (ccnl->pit)
         ccnl_interest_remove(ccnl, ccnl->pit);
+    ccnl_nametree_cleanup(&ccnl->pit_index);
     while (ccnl->faces)
         ccnl_face_remove(ccnl, ccnl->faces); // removes allmost all FWD entries
     while (ccnl->fib) {
-        struct ccnl_forward_s *fwd = ccnl->fib->next;
-        ccnl_prefix_free(ccnl->fib->prefix);
-        ccnl_free(ccnl->fib);
-        ccnl->fib = fwd;
+        struct ccnl_forward_s *fwd = ccnl->fib;
+        ccnl_fib_unlink(ccnl, fwd);
+        ccnl_prefix_free(fwd->prefix);
+        ccnl_free(fwd);
     }
+    ccnl_nametree_cleanup(&ccnl->fib_index);
     while (ccnl->contents)
         ccnl_content_remove(ccnl, ccnl->contents);
-    while (ccnl->nonces) {
-        struct ccnl_buf_s *tmp = ccnl->nonces->next;
-        ccnl_free(ccnl->nonces);
-        ccnl->nonces = tmp;
-    }
+    ccnl_nametree_cleanup(&ccnl->cs_index);
+    memset(ccnl->nonces, 0, sizeof(ccnl->nonces));
     for (k = 0; k < ccnl->ifcount; k++)
         ccnl_interface_cleanup(ccnl->ifs + k);
 
@@ -0,0 +1,361 @@
+/*
+ * @f ccnl-cache.c
+ * @b CCN lite (CCNL), replacement policies of the content store
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_LINUXKERNEL
+#include "ccnl-cache.h"
+#include "ccnl-relay.h"
+#include "ccnl-content.h"
+#include "ccnl-pkt.h"
+#include "ccnl-malloc.h"
+#include "ccnl-os-time.h"
+#include "ccnl-logging.h"
+#include <string.h>
+#else
+#include <ccnl-cache.h>
+#include <ccnl-relay.h>
+#include <ccnl-content.h>
+#include <ccnl-pkt.h>
+#include <ccnl-malloc.h>
+#include <ccnl-os-time.h>
+#include <ccnl-logging.h>
+#endif
+
+// ----------------------------------------------------------------------
+// LRU lists, c->segment is the list number + 1
+
+static void
+ccnl_cache_push(struct ccnl_cache_s *cs, int seg, struct ccnl_content_s *c)
+{
+    c->cache_prev = NULL;
+    c->cache_next = cs->head[seg];
+    if (cs->head[seg])
+        cs->head[seg]->cache_prev = c;
+    else
+        cs->tail[seg] = c;
+    cs->head[seg] = c;
+    cs->segbytes[seg] += c->bytes;
+    cs->segcnt[seg]++;
+    c->segment = seg + 1;
+}
+
+static void
+ccnl_cache_unlink(struct ccnl_cache_s *cs, struct ccnl_content_s *c)
+{
+    int seg = c->segment - 1;
+
+    if (c->cache_prev)
+        c->cache_prev->cache_next = c->cache_next;
+    else
+        cs->head[seg] = c->cache_next;
+    if (c->cache_next)
+        c->cache_next->cache_prev = c->cache_prev;
+    else
+        cs->tail[seg] = c->cache_prev;
+    c->cache_next = c->cache_prev = NULL;
+    cs->segbytes[seg] -= c->bytes;
+    cs->segcnt[seg]--;
+    c->segment = 0;
+}
+
+static void
+ccnl_lru_insert(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    ccnl_cache_push(&ccnl->cache, 0, c);
+}
+
+static void
+ccnl_lru_hit(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    ccnl_cache_unlink(&ccnl->cache, c);
+    ccnl_cache_push(&ccnl->cache, 0, c);
+}
+
+static void
+ccnl_lru_remove(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    ccnl_cache_unlink(&ccnl->cache, c);
+}
+
+static struct ccnl_content_s*
+ccnl_lru_victim(struct ccnl_relay_s *ccnl)
+{
+    return ccnl->cache.tail[0];
+}
+
+// ----------------------------------------------------------------------
+// SLRU: new content is on probation, a hit promotes it to the protected
+// list, whose least recently used entries fall back to probation
+
+static int
+ccnl_slru_protected_full(struct ccnl_relay_s *ccnl)
+{
+    struct ccnl_cache_s *cs = &ccnl->cache;
+
+    if (cs->segcnt[1] <= 1)
+        return 0;
+    if (cs->max_bytes > 0)
+        return cs->segbytes[1] > CCNL_CACHE_SLRU_PROTECTED(cs->max_bytes);
+    if (ccnl->max_cache_entries > 0)
+        return cs->segcnt[1] > CCNL_CACHE_SLRU_PROTECTED(ccnl->max_cache_entries);
+    return 0;
+}
+
+static void
+ccnl_slru_hit(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    struct ccnl_cache_s *cs = &ccnl->cache;
+    struct ccnl_content_s *d;
+
+    ccnl_cache_unlink(cs, c);
+    ccnl_cache_push(cs, 1, c);
+    while (ccnl_slru_protected_full(ccnl)) {
+        d = cs->tail[1];
+        ccnl_cache_unlink(cs, d);
+        ccnl_cache_push(cs, 0, d);
+    }
+}
+
+static struct ccnl_content_s*
+ccnl_slru_victim(struct ccnl_relay_s *ccnl)
+{
+    return ccnl->cache.tail[0] ? ccnl->cache.tail[0] : ccnl->cache.tail[1];
+}
+
+// ----------------------------------------------------------------------
+// LFU: buckets of entries with the same use count, a hit moves an entry
+// to the next bucket (O(1) LFU by Shah, Mitra and Matani)
+
+static struct ccnl_cache_freq_s*
+ccnl_lfu_bucket(struct ccnl_cache_s *cs, struct ccnl_cache_freq_s *prev,
+                uint32_t count)
+{
+    struct ccnl_cache_freq_s *b;
+
+    b = (struct ccnl_cache_freq_s*) ccnl_calloc(1, sizeof(*b));
+    if (!b)
+        return NULL;
+    b->count = count;
+    b->prev = prev;
+    b->next = prev ? prev->next : cs->freq;
+    if (b->next)
+        b->next->prev = b;
+    if (prev)
+        prev->next = b;
+    else
+        cs->freq = b;
+    return b;
+}
+
+static void
+ccnl_lfu_push(struct ccnl_cache_freq_s *b, struct ccnl_content_s *c)
+{
+    c->cache_prev = NULL;
+    c->cache_next = b->head;
+    if (b->head)
+        b->head->cache_prev = c;
+    else
+        b->tail = c;
+    b->head = c;
+    c->freq = b;
+    c->segment = 1;
+}
+
+static void
+ccnl_lfu_remove(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    struct ccnl_cache_s *cs = &ccnl->cache;
+    struct ccnl_cache_freq_s *b = c->freq;
+
+    if (c->cache_prev)
+        c->cache_prev->cache_next = c->cache_next;
+    else
+        b->head = c->cache_next;
+    if (c->cache_next)
+        c->cache_next->cache_prev = c->cache_prev;
+    else
+        b->tail = c->cache_prev;
+    c->cache_next = c->cache_prev = NULL;
+    c->freq = NULL;
+    c->segment = 0;
+    if (!b->head) {
+        if (b->prev)
+            b->prev->next = b->next;
+        else
+            cs->freq = b->next;
+        if (b->next)
+            b->next->prev = b->prev;
+        ccnl_free(b);
+    }
+}
+
+static void
+ccnl_lfu_insert(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    struct ccnl_cache_s *cs = &ccnl->cache;
+    struct ccnl_cache_freq_s *b = cs->freq;
+
+    if (!b || b->count != 1)
+        b = ccnl_lfu_bucket(cs, NULL, 1);
+    if (b)
+        ccnl_lfu_push(b, c);
+    else
+        DEBUGMSG_CORE(WARNING, "  no memory to track content %p\n", (void*)c);
+}
+
+static void
+ccnl_lfu_hit(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    struct ccnl_cache_s *cs = &ccnl->cache;
+    struct ccnl_cache_freq_s *b = c->freq, *next = b->next;
+
+    if (b->count < UINT32_MAX && (!next || next->count != b->count + 1))
+        next = ccnl_lfu_bucket(cs, b, b->count + 1);
+    if (b->count == UINT32_MAX || !next) { // stay, as most recently used
+        if (b->head == c)
+            return;
+        next = b; // not emptied by the removal
+    }
+    ccnl_lfu_remove(ccnl, c);
+    ccnl_lfu_push(next, c);
+}
+
+static struct ccnl_content_s*
+ccnl_lfu_victim(struct ccnl_relay_s *ccnl)
+{
+    return ccnl->cache.freq ? ccnl->cache.freq->tail : NULL;
+}
+
+// ----------------------------------------------------------------------
+
+static const struct {
+    const char *name;
+    void (*insert)(struct ccnl_relay_s*, struct ccnl_content_s*);
+    void (*hit)(struct ccnl_relay_s*, struct ccnl_content_s*);
+    void (*remove)(struct ccnl_relay_s*, struct ccnl_content_s*);
+    struct ccnl_content_s* (*victim)(struct ccnl_relay_s*);
+} policies[CCNL_CACHE_POLICIES] = {
+    { "lru",  ccnl_lru_insert, ccnl_lru_hit,  ccnl_lru_remove, ccnl_lru_victim },
+    { "slru", ccnl_lru_insert, ccnl_slru_hit, ccnl_lru_remove, ccnl_slru_victim },
+    { "lfu",  ccnl_lfu_insert, ccnl_lfu_hit,  ccnl_lfu_remove, ccnl_lfu_victim },
+};
+
+int
+ccnl_cache_str2policy(const char *name)
+{
+    int i;
+
+    for (i = 0; i < CCNL_CACHE_POLICIES; i++)
+        if (!strcmp(name, policies[i].name))
+            return i;
+    return -1;
+}
+
+const char*
+ccnl_cache_policy2str(int policy)
+{
+    if (policy < 0 || policy >= CCNL_CACHE_POLICIES)
+        return "?";
+    return policies[policy].name;
+}
+
+int
+ccnl_cache_set_policy(struct ccnl_relay_s *ccnl, int policy)
+{
+    struct ccnl_content_s *c;
+
+    if (policy < 0 || policy >= CCNL_CACHE_POLICIES)
+        return -1;
+    for (c = ccnl->contents; c; c = c->next)
+        if (c->segment)
+            policies[ccnl->cache.policy].remove(ccnl, c);
+    ccnl->cache.policy = policy;
+    for (c = ccnl->contents; c; c = c->next)
+        if (!(c->flags & CCNL_CONTENT_FLAGS_STATIC))
+            policies[policy].insert(ccnl, c);
+    return 0;
+}
+
+static int
+ccnl_cache_isfull(struct ccnl_relay_s *ccnl, size_t bytes)
+{
+    return (ccnl->max_cache_entries > 0 &&
+            ccnl->contentcnt >= ccnl->max_cache_entries) ||
+           (ccnl->cache.max_bytes > 0 &&
+            ccnl->cache.bytes + bytes > ccnl->cache.max_bytes);
+}
+
+int
+ccnl_cache_make_room(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    struct ccnl_cache_s *cs = &ccnl->cache;
+    struct ccnl_content_s *victim;
+    size_t bytes = c->pkt->buf ? c->pkt->buf->datalen : 0;
+    int cnt;
+
+    if (cs->max_bytes > 0 && bytes > cs->max_bytes)
+        return -1;
+    while (ccnl_cache_isfull(ccnl, bytes)) {
+        cnt = ccnl->contentcnt;
+        if (cs->remove_func && cs->remove_func(ccnl, c) &&
+                                        ccnl->contentcnt < cnt)
+            continue;
+        victim = policies[cs->policy].victim(ccnl);
+        if (!victim)
+            return -1;
+        if (victim->flags & CCNL_CONTENT_FLAGS_STATIC) { // made static after caching
+            policies[cs->policy].remove(ccnl, victim);
+            continue;
+        }
+        DEBUGMSG_CORE(DEBUG, " remove old entry from cache\n");
+        ccnl_content_remove(ccnl, victim);
+    }
+    return 0;
+}
+
+void
+ccnl_cache_insert(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    c->bytes = c->pkt->buf ? c->pkt->buf->datalen : 0;
+    ccnl->cache.bytes += c->bytes;
+    if (!(c->flags & CCNL_CONTENT_FLAGS_STATIC))
+        policies[ccnl->cache.policy].insert(ccnl, c);
+}
+
+void
+ccnl_cache_remove(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    ccnl->cache.bytes -= c->bytes;
+    if (c->segment)
+        policies[ccnl->cache.policy].remove(ccnl, c);
+}
+
+void
+ccnl_cache_hit(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    c->last_used = CCNL_NOW();
+    if (!c->segment)
+        return;
+    if (c->flags & CCNL_CONTENT_FLAGS_STATIC)
+        policies[ccnl->cache.policy].remove(ccnl, c);
+    else
+        policies[ccnl->cache.policy].hit(ccnl, c);
+}
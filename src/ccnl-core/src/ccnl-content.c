@@ -28,6 +28,7 @@
 #include "ccnl-os-time.h"
 #include "ccnl-logging.h"
 #include "ccnl-defs.h"
+#include "ccnl-pool.h"
 #else
 #include <ccnl-content.h>
 #include <ccnl-malloc.h>
@@ -35,6 +36,7 @@
 #include <ccnl-pkt.h>
 #include <ccnl-os-time.h>
 #include <ccnl-logging.h>
+#include <ccnl-pool.h>
 #endif
 
 // TODO: remove unused ccnl parameter
@@ -50,7 +52,7 @@ ccnl_content_new(struct ccnl_pkt_s **pkt)
              (void*) *pkt, ccnl_prefix_to_str((*pkt)->pfx, s, CCNL_MAX_PREFIX_SIZE),
              ((*pkt)->pfx->chunknum)? *((*pkt)->pfx->chunknum) : -1);
 
-    c = (struct ccnl_content_s *) ccnl_calloc(1, sizeof(struct ccnl_content_s));
+    c = ccnl_pool_alloc(CCNL_POOL_CONTENT);
     if (!c)
         return NULL;
     c->pkt = *pkt;
@@ -58,8 +60,12 @@ ccnl_content_new(struct ccnl_pkt_s **pkt)
     c->last_used = CCNL_NOW();
 #ifdef USE_SUITE_NDNTLV
     if (c->pkt->suite == CCNL_SUITE_NDNTLV) {
-        /* convert from milli seconds to seconds for now, as CCNL_NOW() has second granularity */
-        c->freshnessperiod = CCNL_NOW() + (c->pkt->s.ndntlv.freshnessperiod / 1000);
+        uint32_t msec = c->pkt->s.ndntlv.freshnessperiod, usec;
+
+        ccnl_get_timeval(&c->freshness);
+        usec = c->freshness.tv_usec + (msec % 1000) * 1000;
+        c->freshness.tv_sec += msec / 1000 + usec / 1000000;
+        c->freshness.tv_usec = usec % 1000000;
         c->stale = false;
     }
 #endif
@@ -71,5 +77,19 @@ void
 ccnl_content_free(struct ccnl_content_s *content) 
 {
     ccnl_pkt_free(content->pkt);
-    ccnl_free(content);
+    ccnl_pool_free(CCNL_POOL_CONTENT, content);
+}
+
+#ifdef USE_SUITE_NDNTLV
+bool
+ccnl_content_is_stale(struct ccnl_content_s *c)
+{
+    struct timeval now;
+
+    if (!c->stale && c->pkt->suite == CCNL_SUITE_NDNTLV) {
+        ccnl_get_timeval(&now);
+        c->stale = timevaldelta(&c->freshness, &now) <= 0;
+    }
+    return c->stale;
 }
+#endif
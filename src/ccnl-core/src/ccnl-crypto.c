@@ -480,7 +480,8 @@ ccnl_mgmt_crypto(struct ccnl_relay_s *ccnl, char *type, unsigned char *buf, int
           if (!c) goto Done;
 
           ccnl_content_serve_pending(ccnl, c);
-          ccnl_content_add2cache(ccnl, c);
+          if (ccnl_content_add2cache(ccnl, c) < 0)
+              ccnl_content_free(c);
       }
       Done:
       ccnl_free(out);
@@ -102,7 +102,7 @@ ccnl_frag_reset(struct ccnl_frag_s *e, struct ccnl_buf_s *buf,
         return;
     e->ifndx = ifndx;
     memcpy(&e->dest, dst, sizeof(*dst));
-    ccnl_free(e->bigpkt);
+    ccnl_buf_free(e->bigpkt);
     e->bigpkt = buf;
     if (buf)
         e->outsuite = ccnl_pkt2suite(buf->data, buf->datalen, 0);
@@ -231,13 +231,13 @@ ccnl_frag_getnextSEQD2012(struct ccnl_frag_s *e, int *ifndx, sockunion *su)
     if (datalen >= e->bigpkt->datalen) { // fits in a single fragment
         buf->data[flagoffs + e->flagwidth - 1] =
             CCNL_DTAG_FRAG_FLAG_FIRST | CCNL_DTAG_FRAG_FLAG_LAST;
-        ccnl_free(e->bigpkt);
+        ccnl_buf_free(e->bigpkt);
         e->bigpkt = NULL;
     } else if (e->sendoffs == 0) // this is the start fragment
         buf->data[flagoffs + e->flagwidth - 1] = CCNL_DTAG_FRAG_FLAG_FIRST;
     else if(datalen >= (e->bigpkt->datalen - e->sendoffs)) { // the end
         buf->data[flagoffs + e->flagwidth - 1] = CCNL_DTAG_FRAG_FLAG_LAST;
-        ccnl_free(e->bigpkt);
+        ccnl_buf_free(e->bigpkt);
         e->bigpkt = NULL;
     } else // in the middle
         buf->data[flagoffs + e->flagwidth - 1] = 0x00;
@@ -300,13 +300,13 @@ ccnl_frag_getnextCCNx2013(struct ccnl_frag_s *fr, int *ifndx, sockunion *su)
     // patch flag field:
     if (datalen >= fr->bigpkt->datalen) { // single
         buf->data[flagoffs] = CCNL_DTAG_FRAG_FLAG_SINGLE;
-        ccnl_free(fr->bigpkt);
+        ccnl_buf_free(fr->bigpkt);
         fr->bigpkt = NULL;
     } else if (fr->sendoffs == 0) // start
         buf->data[flagoffs] = CCNL_DTAG_FRAG_FLAG_FIRST;
     else if(datalen >= (fr->bigpkt->datalen - fr->sendoffs)) { // end
         buf->data[flagoffs] = CCNL_DTAG_FRAG_FLAG_LAST;
-        ccnl_free(fr->bigpkt);
+        ccnl_buf_free(fr->bigpkt);
         fr->bigpkt = NULL;
     } else
         buf->data[flagoffs] = CCNL_DTAG_FRAG_FLAG_MID;
@@ -356,7 +356,7 @@ ccnl_frag_getnextSEQD2015(struct ccnl_frag_s *fr, int *ifndx, sockunion *su)
 
         fr->sendoffs += datalen;
         if (fr->sendoffs >= fr->bigpkt->datalen) {
-            ccnl_free(fr->bigpkt);
+            ccnl_buf_free(fr->bigpkt);
             fr->bigpkt = NULL;
         }
 
@@ -409,7 +409,7 @@ ccnl_frag_getnextBE2015(struct ccnl_frag_s *fr, int *ifndx, sockunion *su)
 
         fr->sendoffs += datalen;
         if (fr->sendoffs >= (unsigned) fr->bigpkt->datalen) {
-            ccnl_free(fr->bigpkt);
+            ccnl_buf_free(fr->bigpkt);
             fr->bigpkt = NULL;
         }
 
@@ -466,7 +466,7 @@ void
 ccnl_frag_destroy(struct ccnl_frag_s *e)
 {
     if (e) {
-        ccnl_free(e->bigpkt);
+        ccnl_buf_free(e->bigpkt);
         ccnl_free(e->defrag);
         ccnl_free(e);
     }
@@ -27,6 +27,19 @@ void null_func(void);
 
 #include "ccnl-http-status.h"
 #include "ccnl-os-time.h"
+#ifdef USE_SHARDS
+#include "ccnl-shard.h"
+#endif
+#include <stdarg.h>
+#include <stddef.h>
+
+#ifdef USE_STATS
+// output of the metrics exports, grown as needed, see ccnl_http_metrics
+static struct {
+    char *buf;
+    int len, size;
+} metrics;
+#endif
 
 // ----------------------------------------------------------------------
 
@@ -76,6 +89,10 @@ ccnl_http_cleanup(struct ccnl_http_s *http)
         close(http->server);
     if (http->client)
         close(http->client);
+#ifdef USE_STATS
+    ccnl_free(metrics.buf);
+    memset(&metrics, 0, sizeof(metrics));
+#endif
     ccnl_free(http);
     return NULL;
 }
@@ -106,11 +123,22 @@ ccnl_http_anteselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
 int
 ccnl_http_postselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
                      fd_set *readfs, fd_set *writefs)
+{
+    if (!http)
+        return -1;
+    return ccnl_http_io(ccnl, http, FD_ISSET(http->server, readfs),
+                        http->client && FD_ISSET(http->client, readfs),
+                        http->client && FD_ISSET(http->client, writefs));
+}
+
+int
+ccnl_http_io(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
+             int server_readable, int client_readable, int client_writable)
 {
     if (!http)
         return -1;
     // accept only one client at the time:
-    if (!http->client && FD_ISSET(http->server, readfs)) {
+    if (!http->client && server_readable) {
         struct sockaddr_in peer;
         socklen_t len = sizeof(peer);
         http->client = accept(http->server, (struct sockaddr*) &peer, &len);
@@ -122,7 +150,7 @@ ccnl_http_postselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
             http->inlen = http->outlen = http->inoffs = http->outoffs = 0;
         }
     }
-    if (http->client && FD_ISSET(http->client, readfs)) {
+    if (http->client && client_readable) {
         int len = sizeof(http->in) - http->inlen - 1;
         len = recv(http->client, http->in + http->inlen, len, 0);
         if (len == 0) {
@@ -134,9 +162,9 @@ ccnl_http_postselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
             ccnl_http_status(ccnl, http);
         }
     }
-    if (http->client && FD_ISSET(http->client, writefs) && http->out) {
+    if (http->client && client_writable && http->out) {
         int len = send(http->client, http->out + http->outoffs,
-                       http->outlen, 0);
+                       http->outlen, MSG_DONTWAIT);
         if (len > 0) {
             http->outlen -= len;
             http->outoffs += len;
@@ -184,6 +212,357 @@ ccnl_cmpfib(const void *a, const void *b)
     return 0;
 }
 
+#ifdef USE_STATS
+
+/*
+ * GET /metrics returns the counters in the Prometheus text format, GET
+ * /metrics.json the same as one JSON object. Faces and routes are those of
+ * the relay serving the request (shard 0 of a sharded relay), the relay
+ * wide values are summed over all shards. Counters are read while the other
+ * shards may update them, which is fine for monitoring.
+ */
+
+static void
+ccnl_metrics_printf(const char *fmt, ...)
+{
+    va_list ap;
+    char *cp;
+    int n;
+
+    for (;;) {
+        va_start(ap, fmt);
+        n = metrics.buf ? vsnprintf(metrics.buf + metrics.len,
+                                    metrics.size - metrics.len, fmt, ap) : -1;
+        va_end(ap);
+        if (n >= 0 && metrics.len + n < metrics.size) {
+            metrics.len += n;
+            return;
+        }
+        n = metrics.size ? 2 * metrics.size : 16384;
+        cp = (char*) ccnl_realloc(metrics.buf, n);
+        if (!cp) // output is cut short
+            return;
+        metrics.buf = cp;
+        metrics.size = n;
+    }
+}
+
+// a string literal, escaped the same way in both formats
+static void
+ccnl_metrics_quote(const char *str)
+{
+    ccnl_metrics_printf("\"");
+    for (; *str; str++) {
+        if (*str == '"' || *str == '\\')
+            ccnl_metrics_printf("\\%c", *str);
+        else if ((unsigned char) *str >= ' ')
+            ccnl_metrics_printf("%c", *str);
+    }
+    ccnl_metrics_printf("\"");
+}
+
+struct ccnl_metrics_counter_s {
+    const char *name, *help;
+    size_t offs;
+};
+
+#define FACE_COUNTER(n, h) { #n, h, offsetof(struct ccnl_face_stats_s, n) }
+static const struct ccnl_metrics_counter_s face_counters[] = {
+    FACE_COUNTER(interests_in, "Interests received on the face"),
+    FACE_COUNTER(interests_out, "Interests sent on the face"),
+    FACE_COUNTER(data_in, "Data received on the face"),
+    FACE_COUNTER(data_out, "Data sent on the face"),
+    FACE_COUNTER(cs_hits, "Interests of the face answered by the CS"),
+    FACE_COUNTER(cs_misses, "Interests of the face not found in the CS"),
+    FACE_COUNTER(pit_aggregated, "Interests of the face added to a PIT entry"),
+};
+
+#define ROUTE_COUNTER(n, h) { #n, h, offsetof(struct ccnl_forward_stats_s, n) }
+static const struct ccnl_metrics_counter_s route_counters[] = {
+    ROUTE_COUNTER(interests_out, "Interests forwarded on the route"),
+    ROUTE_COUNTER(data_in, "Data satisfying an interest sent on the route"),
+    ROUTE_COUNTER(aggregated, "Interests aggregated with one sent on the route"),
+    ROUTE_COUNTER(expired, "Interests sent on the route which timed out"),
+};
+
+#define COUNTER(stats, c)   (*(uint32_t*) ((char*) (stats) + (c)->offs))
+
+// relay wide values, summed over the shards
+struct ccnl_metrics_relay_s {
+    struct ccnl_relay_stats_s stats;
+    int pitcnt, contentcnt, max_cache_entries;
+    unsigned long bytes, max_bytes;
+};
+
+static void
+ccnl_metrics_relay(struct ccnl_relay_s *ccnl, struct ccnl_metrics_relay_s *m)
+{
+    struct ccnl_relay_s *r;
+    int k, b, count = 1;
+
+#ifdef USE_SHARDS
+    if (ccnl->shards)
+        count = ccnl->shards->count;
+#endif
+    memset(m, 0, sizeof(*m));
+    for (k = 0; k < count; k++) {
+        r = ccnl;
+#ifdef USE_SHARDS
+        if (ccnl->shards)
+            r = ccnl->shards->shard[k].relay;
+#endif
+        m->stats.pit_satisfied += r->stats.pit_satisfied;
+        m->stats.pit_expired += r->stats.pit_expired;
+        for (b = 0; b < CCNL_STATS_BUCKETS; b++)
+            m->stats.residence[b] += r->stats.residence[b];
+        m->stats.residence_usec += r->stats.residence_usec;
+        m->pitcnt += r->pitcnt;
+        m->contentcnt += r->contentcnt;
+        m->max_cache_entries += r->max_cache_entries;
+        m->bytes += r->cache.bytes;
+        m->max_bytes += r->cache.max_bytes;
+    }
+}
+
+static void
+ccnl_metrics_prometheus(struct ccnl_relay_s *ccnl)
+{
+    struct ccnl_metrics_relay_s m;
+    struct ccnl_face_s *f;
+    struct ccnl_forward_s *fwd;
+    unsigned long cnt;
+    unsigned int c, r;
+    int i, b;
+    char s[CCNL_MAX_PREFIX_SIZE];
+
+    ccnl_metrics_relay(ccnl, &m);
+    ccnl_metrics_printf("# HELP ccnl_pit_entries Entries in the PIT\n"
+                        "# TYPE ccnl_pit_entries gauge\n"
+                        "ccnl_pit_entries %d\n", m.pitcnt);
+    ccnl_metrics_printf("# HELP ccnl_pit_satisfied_total PIT entries "
+                        "satisfied by data\n"
+                        "# TYPE ccnl_pit_satisfied_total counter\n"
+                        "ccnl_pit_satisfied_total %u\n",
+                        m.stats.pit_satisfied);
+    ccnl_metrics_printf("# HELP ccnl_pit_expired_total PIT entries "
+                        "removed at the end of their lifetime\n"
+                        "# TYPE ccnl_pit_expired_total counter\n"
+                        "ccnl_pit_expired_total %u\n", m.stats.pit_expired);
+    ccnl_metrics_printf("# HELP ccnl_pit_residence_seconds Time from "
+                        "creating a PIT entry until it was satisfied\n"
+                        "# TYPE ccnl_pit_residence_seconds histogram\n");
+    for (b = 0, cnt = 0; b < CCNL_STATS_BUCKETS; b++) {
+        cnt += m.stats.residence[b];
+        if (ccnl_stats_bucket_usec(b) < 0)
+            ccnl_metrics_printf("ccnl_pit_residence_seconds_bucket"
+                                "{le=\"+Inf\"} %lu\n", cnt);
+        else
+            ccnl_metrics_printf("ccnl_pit_residence_seconds_bucket"
+                                "{le=\"%.9g\"} %lu\n",
+                                ccnl_stats_bucket_usec(b) / 1e6, cnt);
+    }
+    ccnl_metrics_printf("ccnl_pit_residence_seconds_sum %.6f\n"
+                        "ccnl_pit_residence_seconds_count %lu\n",
+                        m.stats.residence_usec / 1e6, cnt);
+    ccnl_metrics_printf("# HELP ccnl_cs_entries Content objects in the CS\n"
+                        "# TYPE ccnl_cs_entries gauge\n"
+                        "ccnl_cs_entries %d\n"
+                        "# HELP ccnl_cs_max_entries Limit of content objects "
+                        "in the CS, negative if unlimited\n"
+                        "# TYPE ccnl_cs_max_entries gauge\n"
+                        "ccnl_cs_max_entries %d\n", m.contentcnt,
+                        m.max_cache_entries);
+    ccnl_metrics_printf("# HELP ccnl_cs_bytes Bytes of cached packets\n"
+                        "# TYPE ccnl_cs_bytes gauge\n"
+                        "ccnl_cs_bytes %lu\n"
+                        "# HELP ccnl_cs_max_bytes Byte budget of the CS, "
+                        "0 if unlimited\n"
+                        "# TYPE ccnl_cs_max_bytes gauge\n"
+                        "ccnl_cs_max_bytes %lu\n", m.bytes, m.max_bytes);
+
+    ccnl_metrics_printf("# HELP ccnl_interface_rx_total Packets received "
+                        "on the interface\n"
+                        "# TYPE ccnl_interface_rx_total counter\n");
+    for (i = 0; i < ccnl->ifcount; i++)
+        ccnl_metrics_printf("ccnl_interface_rx_total{interface=\"%d\"} %u\n",
+                            i, ccnl->ifs[i].rx_cnt);
+    ccnl_metrics_printf("# HELP ccnl_interface_tx_total Packets sent "
+                        "on the interface\n"
+                        "# TYPE ccnl_interface_tx_total counter\n");
+    for (i = 0; i < ccnl->ifcount; i++)
+        ccnl_metrics_printf("ccnl_interface_tx_total{interface=\"%d\"} %u\n",
+                            i, ccnl->ifs[i].tx_cnt);
+    ccnl_metrics_printf("# HELP ccnl_interface_queue_length Packets waiting "
+                        "in the queue of the interface\n"
+                        "# TYPE ccnl_interface_queue_length gauge\n");
+    for (i = 0; i < ccnl->ifcount; i++)
+        ccnl_metrics_printf("ccnl_interface_queue_length{interface=\"%d\"} "
+                            "%d\n", i, ccnl->ifs[i].txq.qlen);
+    ccnl_metrics_printf("# HELP ccnl_interface_drops_total Packets dropped "
+                        "by the queue of the interface\n"
+                        "# TYPE ccnl_interface_drops_total counter\n");
+    for (i = 0; i < ccnl->ifcount; i++)
+        ccnl_metrics_printf("ccnl_interface_drops_total{interface=\"%d\","
+                            "reason=\"overflow\"} %u\n"
+                            "ccnl_interface_drops_total{interface=\"%d\","
+                            "reason=\"codel\"} %u\n",
+                            i, ccnl->ifs[i].txq.drops,
+                            i, ccnl->ifs[i].txq.aqm_drops);
+
+    for (c = 0; c < sizeof(face_counters) / sizeof(*face_counters); c++) {
+        ccnl_metrics_printf("# HELP ccnl_face_%s_total %s\n"
+                            "# TYPE ccnl_face_%s_total counter\n",
+                            face_counters[c].name, face_counters[c].help,
+                            face_counters[c].name);
+        for (f = ccnl->faces; f; f = f->next)
+            ccnl_metrics_printf("ccnl_face_%s_total{face=\"%d\"} %u\n",
+                                face_counters[c].name, f->faceid,
+                                COUNTER(&f->stats, face_counters + c));
+    }
+    ccnl_metrics_printf("# HELP ccnl_face_drops_total Packets of the face "
+                        "dropped by the forwarder\n"
+                        "# TYPE ccnl_face_drops_total counter\n");
+    for (f = ccnl->faces; f; f = f->next)
+        for (r = 0; r < CCNL_DROP_REASONS; r++)
+            ccnl_metrics_printf("ccnl_face_drops_total{face=\"%d\","
+                                "reason=\"%s\"} %u\n", f->faceid,
+                                ccnl_stats_drop2str(r), f->stats.drops[r]);
+
+    for (c = 0; c < sizeof(route_counters) / sizeof(*route_counters); c++) {
+        ccnl_metrics_printf("# HELP ccnl_route_%s_total %s\n"
+                            "# TYPE ccnl_route_%s_total counter\n",
+                            route_counters[c].name, route_counters[c].help,
+                            route_counters[c].name);
+        for (fwd = ccnl->fib; fwd; fwd = fwd->next) {
+            ccnl_metrics_printf("ccnl_route_%s_total{prefix=",
+                                route_counters[c].name);
+            ccnl_metrics_quote(ccnl_prefix_to_str(fwd->prefix, s,
+                                                  CCNL_MAX_PREFIX_SIZE));
+            ccnl_metrics_printf(",face=\"%d\"} %u\n",
+                                fwd->face ? fwd->face->faceid : -1,
+                                COUNTER(&fwd->stats, route_counters + c));
+        }
+    }
+    ccnl_metrics_printf("# HELP ccnl_route_pit_entries PIT entries "
+                        "forwarded on the route\n"
+                        "# TYPE ccnl_route_pit_entries gauge\n");
+    for (fwd = ccnl->fib; fwd; fwd = fwd->next) {
+        ccnl_metrics_printf("ccnl_route_pit_entries{prefix=");
+        ccnl_metrics_quote(ccnl_prefix_to_str(fwd->prefix, s,
+                                              CCNL_MAX_PREFIX_SIZE));
+        ccnl_metrics_printf(",face=\"%d\"} %d\n",
+                            fwd->face ? fwd->face->faceid : -1, fwd->pit_refs);
+    }
+}
+
+static void
+ccnl_metrics_json(struct ccnl_relay_s *ccnl)
+{
+    struct ccnl_metrics_relay_s m;
+    struct ccnl_face_s *f;
+    struct ccnl_forward_s *fwd;
+    unsigned long cnt;
+    unsigned int c, r;
+    int i, b;
+    char s[CCNL_MAX_PREFIX_SIZE];
+
+    ccnl_metrics_relay(ccnl, &m);
+    for (b = 0, cnt = 0; b < CCNL_STATS_BUCKETS; b++)
+        cnt += m.stats.residence[b];
+    ccnl_metrics_printf("{\"pit\":{\"entries\":%d,\"satisfied\":%u,"
+                        "\"expired\":%u,\"residence_usec\":{\"count\":%lu,"
+                        "\"sum\":%llu,\"buckets\":[", m.pitcnt,
+                        m.stats.pit_satisfied, m.stats.pit_expired, cnt,
+                        (unsigned long long) m.stats.residence_usec);
+    for (b = 0; b < CCNL_STATS_BUCKETS; b++) {
+        if (ccnl_stats_bucket_usec(b) < 0)
+            ccnl_metrics_printf("%s{\"le\":null", b ? "," : "");
+        else
+            ccnl_metrics_printf("%s{\"le\":%ld", b ? "," : "",
+                                ccnl_stats_bucket_usec(b));
+        ccnl_metrics_printf(",\"count\":%u}", m.stats.residence[b]);
+    }
+    ccnl_metrics_printf("]}},\n\"cs\":{\"entries\":%d,\"max_entries\":%d,"
+                        "\"bytes\":%lu,\"max_bytes\":%lu},\n", m.contentcnt,
+                        m.max_cache_entries, m.bytes, m.max_bytes);
+
+    ccnl_metrics_printf("\"interfaces\":[");
+    for (i = 0; i < ccnl->ifcount; i++) {
+        ccnl_metrics_printf("%s\n{\"interface\":%d,\"addr\":",
+                            i ? "," : "", i);
+        ccnl_metrics_quote(ccnl_addr2ascii(&ccnl->ifs[i].addr));
+        ccnl_metrics_printf(",\"rx\":%u,\"tx\":%u,\"queue_length\":%d,"
+                            "\"drops\":{\"overflow\":%u,\"codel\":%u}}",
+                            ccnl->ifs[i].rx_cnt, ccnl->ifs[i].tx_cnt,
+                            ccnl->ifs[i].txq.qlen, ccnl->ifs[i].txq.drops,
+                            ccnl->ifs[i].txq.aqm_drops);
+    }
+
+    ccnl_metrics_printf("],\n\"faces\":[");
+    for (f = ccnl->faces; f; f = f->next) {
+        ccnl_metrics_printf("%s\n{\"face\":%d,\"interface\":%d,\"peer\":",
+                            f == ccnl->faces ? "" : ",", f->faceid, f->ifndx);
+        ccnl_metrics_quote(ccnl_addr2ascii(&f->peer));
+        for (c = 0; c < sizeof(face_counters) / sizeof(*face_counters); c++)
+            ccnl_metrics_printf(",\"%s\":%u", face_counters[c].name,
+                                COUNTER(&f->stats, face_counters + c));
+        ccnl_metrics_printf(",\"drops\":{");
+        for (r = 0; r < CCNL_DROP_REASONS; r++)
+            ccnl_metrics_printf("%s\"%s\":%u", r ? "," : "",
+                                ccnl_stats_drop2str(r), f->stats.drops[r]);
+        ccnl_metrics_printf("}}");
+    }
+
+    ccnl_metrics_printf("],\n\"routes\":[");
+    for (fwd = ccnl->fib; fwd; fwd = fwd->next) {
+        ccnl_metrics_printf("%s\n{\"prefix\":", fwd == ccnl->fib ? "" : ",");
+        ccnl_metrics_quote(ccnl_prefix_to_str(fwd->prefix, s,
+                                              CCNL_MAX_PREFIX_SIZE));
+        ccnl_metrics_printf(",\"face\":%d,\"pit_entries\":%d",
+                            fwd->face ? fwd->face->faceid : -1, fwd->pit_refs);
+        for (c = 0; c < sizeof(route_counters) / sizeof(*route_counters); c++)
+            ccnl_metrics_printf(",\"%s\":%u", route_counters[c].name,
+                                COUNTER(&fwd->stats, route_counters + c));
+        ccnl_metrics_printf("}");
+    }
+    ccnl_metrics_printf("]}\n");
+}
+
+// whether the request is a GET of @path
+static int
+ccnl_http_get(struct ccnl_http_s *http, const char *path)
+{
+    char *req = (char*) http->in;
+    int len = strlen(path);
+
+    return !strncmp(req, "GET ", 4) && !strncmp(req + 4, path, len) &&
+           (req[4 + len] == ' ' || req[4 + len] == '?');
+}
+
+static int
+ccnl_http_metrics(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
+                  int json)
+{
+    metrics.len = 0;
+    ccnl_metrics_printf("HTTP/1.1 200 OK\r\n"
+                        "Content-Type: %s\r\n"
+                        "Connection: close\r\n\r\n", json ?
+                        "application/json" :
+                        "text/plain; version=0.0.4; charset=utf-8");
+    if (json)
+        ccnl_metrics_json(ccnl);
+    else
+        ccnl_metrics_prometheus(ccnl);
+
+    http->out = (unsigned char*) metrics.buf;
+    http->outoffs = 0;
+    http->outlen = metrics.len;
+
+    return 0;
+}
+
+#endif // USE_STATS
+
 int
 ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http)
 {
@@ -201,6 +580,12 @@ ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http)
     struct ccnl_buf_s *bpt;
     char s[CCNL_MAX_PREFIX_SIZE];
 
+#ifdef USE_STATS
+    if (ccnl_http_get(http, "/metrics"))
+        return ccnl_http_metrics(ccnl, http, 0);
+    if (ccnl_http_get(http, "/metrics.json"))
+        return ccnl_http_metrics(ccnl, http, 1);
+#endif
     strcpy(txt, hdr);
     len += sprintf(txt+len,
                    "<html><head><title>ccn-lite-relay status</title>\n"
@@ -287,27 +672,51 @@ ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http)
                        "&nbsp;&nbsp;rx=%u&nbsp;&nbsp;tx=%u"
                        "\n",
                        i, ccnl_addr2ascii(&ccnl->ifs[i].addr),
-                       ccnl->ifs[i].qlen, CCNL_MAX_IF_QLEN,
+                       ccnl->ifs[i].txq.qlen, CCNL_MAX_IF_QLEN,
                        ccnl->ifs[i].rx_cnt, ccnl->ifs[i].tx_cnt);
+#ifdef USE_BATCH_IO
+        len += sprintf(txt+len, "&nbsp;&nbsp;rx_batches=%u (max %d)"
+                       "&nbsp;&nbsp;tx_batches=%u (max %d)\n",
+                       ccnl->ifs[i].rx_batches, ccnl->ifs[i].rx_batch_max,
+                       ccnl->ifs[i].tx_batches, ccnl->ifs[i].tx_batch_max);
+#endif
 #else
         len += sprintf(txt+len, "<li><strong>i%d</strong>&nbsp;&nbsp;"
                        "addr=<font face=courier>%s</font>&nbsp;&nbsp;"
                        "qlen=%d/%d"
                        "\n",
                        i, ccnl_addr2ascii(&ccnl->ifs[i].addr),
-                       ccnl->ifs[i].qlen, CCNL_MAX_IF_QLEN);
+                       ccnl->ifs[i].txq.qlen, CCNL_MAX_IF_QLEN);
 #endif
+        len += sprintf(txt+len, "&nbsp;&nbsp;bytes=%d&nbsp;&nbsp;"
+                       "delay=%uus (max %uus)&nbsp;&nbsp;"
+                       "drops=%u full, %u CoDel\n",
+                       ccnl->ifs[i].txq.qbytes, ccnl->ifs[i].txq.sojourn,
+                       ccnl->ifs[i].txq.sojourn_max, ccnl->ifs[i].txq.drops,
+                       ccnl->ifs[i].txq.aqm_drops);
     }
     len += sprintf(txt+len, "</ul>\n");
 
     len += sprintf(txt+len, "\n<p><table borders=0 width=100%% bgcolor=#e0e0ff>"
                    "<tr><td><em>Misc stats</em></table><ul>\n");
-    for (cnt = 0, bpt = ccnl->nonces; bpt; bpt = bpt->next, cnt++);
-    len += sprintf(txt+len, "<li>Nonces: %d\n", cnt);
+    for (cnt = 0, i = 0; i < CCNL_MAX_NONCES; i++)
+        cnt += ccnl->nonces[i].hash != 0;
+    len += sprintf(txt+len, "<li>Nonces: %d slots used\n", cnt);
     for (cnt = 0, ipt = ccnl->pit; ipt; ipt = ipt->next, cnt++);
     len += sprintf(txt+len, "<li>Pending interests: %d\n", cnt);
     len += sprintf(txt+len, "<li>Content chunks: %d (max=%d)\n",
                    ccnl->contentcnt, ccnl->max_cache_entries);
+    len += sprintf(txt+len, "<li>Cached bytes: %lu (max=%lu, policy=%s)\n",
+                   (unsigned long) ccnl->cache.bytes,
+                   (unsigned long) ccnl->cache.max_bytes,
+                   ccnl_cache_policy2str(ccnl->cache.policy));
+    for (i = 0; i < CCNL_POOL_TYPES; i++) {
+        const struct ccnl_pool_s *pool = ccnl_pool_stats(i);
+        len += sprintf(txt+len, "<li>Pool %s: %d in use, %d free, "
+                       "%lu hits, %lu misses\n", pool->name, pool->inuse,
+                       pool->freecnt, (unsigned long) pool->hits,
+                       (unsigned long) pool->misses);
+    }
     len += sprintf(txt+len, "</ul>\n");
 
     len += sprintf(txt+len, "\n<p><table borders=0 width=100%% bgcolor=#e0e0ff>"
@@ -322,6 +731,8 @@ ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http)
                    "<td align=right> %d<td>\n", CCNL_INTEREST_TIMEOUT);
     len += sprintf(txt+len, "<tr><td>nonces.max:"
                    "<td align=right> %d<td>\n", CCNL_MAX_NONCES);
+    len += sprintf(txt+len, "<tr><td>pool.maxfree:"
+                   "<td align=right> %d<td>\n", CCNL_OBJECT_POOL);
 
     //len += sprintf(txt+len, "<tr><td>compile.featureset:<td><td> %s\n",
     //               compile_string);
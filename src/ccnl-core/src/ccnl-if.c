@@ -25,6 +25,7 @@
 #include "ccnl-if.h"
 #include "ccnl-os-time.h"
 #include "ccnl-malloc.h"
+#include "ccnl-buf.h"
 #include "ccnl-logging.h"
 #include <sys/socket.h>
 #ifndef CCNL_RIOT
@@ -37,20 +38,17 @@
 #include <ccnl-if.h>
 #include <ccnl-os-time.h>
 #include <ccnl-malloc.h>
+#include <ccnl-buf.h>
 #include <ccnl-logging.h>
 #endif
 
 void
 ccnl_interface_cleanup(struct ccnl_if_s *i)
 {
-    int j;
     DEBUGMSG_CORE(TRACE, "ccnl_interface_cleanup\n");
 
     ccnl_sched_destroy(i->sched);
-    for (j = 0; j < i->qlen; j++) {
-        struct ccnl_txrequest_s *r = i->queue + (i->qfront+j)%CCNL_MAX_IF_QLEN;
-        ccnl_free(r->buf);
-    }
+    ccnl_txq_cleanup(&i->txq);
 #if !defined(CCNL_RIOT) && !defined(CCNL_ANDROID) && !defined(CCNL_LINUXKERNEL)
     ccnl_close_socket(i->sock);
 #endif
@@ -22,16 +22,24 @@
 
 #ifndef CCNL_LINUXKERNEL
 #include "ccnl-interest.h"
+#ifdef USE_STATS
+#include "ccnl-forward.h"
+#endif
 #include "ccnl-malloc.h"
 #include "ccnl-os-time.h"
 #include "ccnl-prefix.h"
 #include "ccnl-logging.h"
+#include "ccnl-pool.h"
 #else
 #include <ccnl-interest.h>
+#ifdef USE_STATS
+#include <ccnl-forward.h>
+#endif
 #include <ccnl-malloc.h>
 #include <ccnl-os-time.h>
 #include <ccnl-prefix.h>
 #include <ccnl-logging.h>
+#include <ccnl-pool.h>
 #endif
 
 //FIXME: RELEAY FUNCTION MUST BE RENAMED!
@@ -59,6 +67,79 @@ ccnl_interest_new(struct ccnl_face_s *from, struct ccnl_pkt_s **pkt)
 }
 */
 
+void
+ccnl_interest_refresh(struct ccnl_interest_s *i)
+{
+    uint32_t usec;
+
+    i->last_used = CCNL_NOW();
+    i->retries = 0;
+    ccnl_get_timeval(&i->expires);
+    usec = i->expires.tv_usec + (i->lifetime % 1000) * 1000;
+    i->expires.tv_sec += i->lifetime / 1000 + usec / 1000000;
+    i->expires.tv_usec = usec % 1000000;
+}
+
+void
+ccnl_interest_set_from(struct ccnl_interest_s *i, struct ccnl_face_s *from)
+{
+    if (i->from) {
+        if (i->from_prev)
+            i->from_prev->from_next = i->from_next;
+        else
+            i->from->interests = i->from_next;
+        if (i->from_next)
+            i->from_next->from_prev = i->from_prev;
+    }
+    i->from = from;
+    i->from_prev = NULL;
+    i->from_next = from ? from->interests : NULL;
+    if (!from)
+        return;
+    if (from->interests)
+        from->interests->from_prev = i;
+    from->interests = i;
+}
+
+#ifdef USE_STATS
+void
+ccnl_interest_set_fwd(struct ccnl_interest_s *i, struct ccnl_forward_s *fwd)
+{
+    if (i->fwd) {
+        if (i->fwd_prev)
+            i->fwd_prev->fwd_next = i->fwd_next;
+        else
+            i->fwd->interests = i->fwd_next;
+        if (i->fwd_next)
+            i->fwd_next->fwd_prev = i->fwd_prev;
+        i->fwd->pit_refs--;
+    }
+    i->fwd = fwd;
+    i->fwd_prev = NULL;
+    i->fwd_next = fwd ? fwd->interests : NULL;
+    if (!fwd)
+        return;
+    if (fwd->interests)
+        fwd->interests->fwd_prev = i;
+    fwd->interests = i;
+    fwd->pit_refs++;
+}
+#endif
+
+void
+ccnl_pendint_free(struct ccnl_pendint_s *pend)
+{
+    if (pend->face) {
+        if (pend->face_prev)
+            pend->face_prev->face_next = pend->face_next;
+        else
+            pend->face->pending = pend->face_next;
+        if (pend->face_next)
+            pend->face_next->face_prev = pend->face_prev;
+    }
+    ccnl_pool_free(CCNL_POOL_PENDINT, pend);
+}
+
 int
 ccnl_interest_isSame(struct ccnl_interest_s *i, struct ccnl_pkt_s *pkt)
 {
@@ -112,7 +193,7 @@ ccnl_interest_append_pending(struct ccnl_interest_s *i,  struct ccnl_face_s *fro
         }
         last = pi;
     }
-    pi = (struct ccnl_pendint_s *) ccnl_calloc(1,sizeof(struct ccnl_pendint_s));
+    pi = ccnl_pool_alloc(CCNL_POOL_PENDINT);
     if (!pi) {
         DEBUGMSG_CORE(DEBUG, "  no mem\n");
         return -1;
@@ -123,6 +204,13 @@ ccnl_interest_append_pending(struct ccnl_interest_s *i,  struct ccnl_face_s *fro
                   (void *) i->pkt->pfx);
     pi->face = from;
     pi->last_used = CCNL_NOW();
+    pi->interest = i;
+    if (from) {
+        pi->face_next = from->pending;
+        if (from->pending)
+            from->pending->face_prev = pi;
+        from->pending = pi;
+    }
     if (last)
         last->next = pi;
     else
@@ -146,11 +234,11 @@ ccnl_interest_remove_pending(struct ccnl_interest_s *i, struct ccnl_face_s *face
             found++;
             if (prev) {
                 prev->next = pend->next;
-                ccnl_free(pend);
+                ccnl_pendint_free(pend);
                 pend = prev->next;
             } else {
                 i->pending = pend->next;
-                ccnl_free(pend);
+                ccnl_pendint_free(pend);
                 pend = i->pending;
             }
         } else {
@@ -25,6 +25,18 @@
 
 #ifdef USE_DEBUG_MALLOC
 
+#ifdef USE_SHARDS
+#include <pthread.h>
+
+// the list of blocks is shared by all relay threads
+static pthread_mutex_t mem_lock = PTHREAD_MUTEX_INITIALIZER;
+# define MEM_LOCK()     pthread_mutex_lock(&mem_lock)
+# define MEM_UNLOCK()   pthread_mutex_unlock(&mem_lock)
+#else
+# define MEM_LOCK()     do {} while (0)
+# define MEM_UNLOCK()   do {} while (0)
+#endif
+
 #ifdef CCNL_ARDUINO
 void*
 debug_malloc(int s, const char *fn, int lno, double tstamp)
@@ -37,8 +49,10 @@ debug_malloc(int s, const char *fn, int lno, char *tstamp)
 
     if (!h)
         return NULL;
+    MEM_LOCK();
     h->next = mem;
     mem = h;
+    MEM_UNLOCK();
     h->fname = (char *) fn;
     h->lineno = lno;
     h->size = s;
@@ -90,9 +104,13 @@ void*
 debug_realloc(void *p, int s, const char *fn, int lno)
 {
     struct mhdr *h = (struct mhdr *) (((unsigned char *)p) - sizeof(struct mhdr));
+    int rc;
 
     if (p) {
-        if (debug_unlink(h)) {
+        MEM_LOCK();
+        rc = debug_unlink(h);
+        MEM_UNLOCK();
+        if (rc) {
             CONSOLE("%s @@@ memerror - realloc(%s:%d) at "
                     "%s:%d does not find memory block\n",
                     timestamp(), h->fname, h->lineno, fn, lno);
@@ -106,8 +124,10 @@ debug_realloc(void *p, int s, const char *fn, int lno)
     h->fname = (char *) fn;
     h->lineno = lno;
     h->size = s;
+    MEM_LOCK();
     h->next = mem;
     mem = h;
+    MEM_UNLOCK();
     return ((unsigned char *)h) + sizeof(struct mhdr);
 }
 
@@ -133,13 +153,17 @@ void
 debug_free(void *p, const char *fn, int lno)
 {
     struct mhdr *h = (struct mhdr *) (((unsigned char *)p) - sizeof(struct mhdr));
+    int rc;
 
     if (!p) {
 //      CONSOLE("%s: @@@ memerror - free() of NULL ptr at %s:%d\n",
 //         timestamp(), fn, lno);
         return;
     }
-    if (debug_unlink(h)) {
+    MEM_LOCK();
+    rc = debug_unlink(h);
+    MEM_UNLOCK();
+    if (rc) {
         CONSOLE(
            "%s @@@ memerror - free() at %s:%d does not find memory block %p\n",
                 timestamp(), fn, lno, p);
@@ -156,5 +180,348 @@ debug_free(void *p, const char *fn, int lno)
 }
 
 
-
 #endif // USE_DEBUG_MALLOC
+
+#ifdef USE_MALLOC_ACCT
+
+#include "ccnl-defs.h"
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#ifdef __GLIBC__
+#include <execinfo.h>
+#endif
+
+#ifndef CCNL_MALLOC_SITES
+# define CCNL_MALLOC_SITES      256
+#endif
+#ifndef CCNL_MALLOC_SAMPLES
+# define CCNL_MALLOC_SAMPLES    16
+#endif
+#define ACCT_MAGIC              0x6363a11c
+#define ACCT_FRAMES             8
+
+// precedes every block, keeps it aligned like malloc's
+union acct_hdr {
+    struct {
+        size_t size;
+        uint32_t site;
+        uint32_t magic;     // cleared when freed
+    } h;
+    long double align;
+};
+
+struct acct_site_s {
+    const char *file;       // NULL while unused
+    int line;
+    unsigned long allocs, frees;
+    unsigned long bytes;    // allocated in total
+    unsigned long live;     // bytes allocated and not freed
+};
+
+struct acct_sample_s {
+    uint32_t site;
+    size_t size;
+    int frames;
+    void *frame[ACCT_FRAMES];
+};
+
+int acct_sample;
+
+// site 0 takes the allocations of sites which do not fit into the table
+static struct acct_site_s acct_sites[CCNL_MALLOC_SITES];
+static struct acct_sample_s acct_samples[CCNL_MALLOC_SAMPLES];
+static unsigned long acct_sampled;
+static CCNL_THREAD_LOCAL int acct_countdown;
+
+#ifdef USE_SHARDS
+#include <pthread.h>
+
+// counters are updated by all relay threads, new sites are added under lock
+static pthread_mutex_t acct_lock = PTHREAD_MUTEX_INITIALIZER;
+# define ACCT_LOCK()            pthread_mutex_lock(&acct_lock)
+# define ACCT_UNLOCK()          pthread_mutex_unlock(&acct_lock)
+# define ACCT_ADD(v, n)         __atomic_fetch_add(&(v), (n), __ATOMIC_RELAXED)
+# define ACCT_SUB(v, n)         __atomic_fetch_sub(&(v), (n), __ATOMIC_RELAXED)
+# define ACCT_FILE(s)           __atomic_load_n(&(s)->file, __ATOMIC_ACQUIRE)
+# define ACCT_SET_FILE(s, f)    __atomic_store_n(&(s)->file, (f), __ATOMIC_RELEASE)
+#else
+# define ACCT_LOCK()            do {} while (0)
+# define ACCT_UNLOCK()          do {} while (0)
+# define ACCT_ADD(v, n)         ((v) += (n))
+# define ACCT_SUB(v, n)         ((v) -= (n))
+# define ACCT_FILE(s)           ((s)->file)
+# define ACCT_SET_FILE(s, f)    ((s)->file = (f))
+#endif
+
+// the table index of call site fn:lno, which is added if new; the file
+// names are compared by address, they are the literals of __FILE__
+static uint32_t
+acct_site(const char *fn, int lno)
+{
+    uint32_t h = (uint32_t) (((uintptr_t) fn >> 3) * 31 + lno), n, k;
+    struct acct_site_s *s;
+    const char *f;
+
+    for (n = 0; n < CCNL_MALLOC_SITES - 1; n++) {
+        k = 1 + (h + n) % (CCNL_MALLOC_SITES - 1);
+        s = acct_sites + k;
+        f = ACCT_FILE(s);
+        if (!f) {
+            ACCT_LOCK();
+            if (!s->file) {
+                s->line = lno;
+                ACCT_SET_FILE(s, fn);
+            }
+            f = s->file;
+            ACCT_UNLOCK();
+        }
+        if (f == fn && s->line == lno)
+            return k;
+    }
+    return 0;
+}
+
+static void
+acct_take_sample(uint32_t site, size_t size)
+{
+    struct acct_sample_s *smp;
+
+    smp = acct_samples + ACCT_ADD(acct_sampled, 1) % CCNL_MALLOC_SAMPLES;
+    smp->frames = 0;
+    smp->site = site;
+    smp->size = size;
+#ifdef __GLIBC__
+    smp->frames = backtrace(smp->frame, ACCT_FRAMES);
+#endif
+}
+
+static void*
+acct_account(union acct_hdr *h, size_t s, const char *fn, int lno)
+{
+    uint32_t site;
+
+    if (!h)
+        return NULL;
+    site = acct_site(fn, lno);
+    h->h.size = s;
+    h->h.site = site;
+    h->h.magic = ACCT_MAGIC;
+    ACCT_ADD(acct_sites[site].allocs, 1);
+    ACCT_ADD(acct_sites[site].bytes, s);
+    ACCT_ADD(acct_sites[site].live, s);
+    if (acct_sample > 0 && --acct_countdown <= 0) {
+        acct_countdown = acct_sample;
+        acct_take_sample(site, s);
+    }
+    return h + 1;
+}
+
+// the header of p, NULL (and a complaint) if it was not allocated here
+static union acct_hdr*
+acct_hdr(void *p, const char *what)
+{
+    union acct_hdr *h = (union acct_hdr*) p - 1;
+
+    if (h->h.magic == ACCT_MAGIC)
+        return h;
+    CONSOLE("%s @@@ memerror - %s() of block %p which is not allocated\n",
+            timestamp(), what, p);
+    return NULL;
+}
+
+static void
+acct_release(union acct_hdr *h)
+{
+    struct acct_site_s *s = acct_sites + h->h.site;
+
+    h->h.magic = 0;
+    ACCT_ADD(s->frees, 1);
+    ACCT_SUB(s->live, h->h.size);
+}
+
+void*
+acct_malloc(size_t s, const char *fn, int lno)
+{
+    return acct_account((union acct_hdr*) malloc(sizeof(union acct_hdr) + s),
+                        s, fn, lno);
+}
+
+void*
+acct_calloc(size_t n, size_t s, const char *fn, int lno)
+{
+    union acct_hdr *h;
+
+    if (s && n > ((size_t) -1 - sizeof(*h)) / s)
+        return NULL;
+    h = (union acct_hdr*) calloc(1, sizeof(*h) + n * s);
+    return acct_account(h, n * s, fn, lno);
+}
+
+void*
+acct_realloc(void *p, size_t s, const char *fn, int lno)
+{
+    union acct_hdr *h, old;
+
+    if (!p)
+        return acct_malloc(s, fn, lno);
+    h = acct_hdr(p, "realloc");
+    if (!h)
+        return NULL;
+    old = *h;
+    acct_release(h);
+    h = (union acct_hdr*) realloc(h, sizeof(*h) + s);
+    if (!h) { // p is still valid
+        *((union acct_hdr*) p - 1) = old;
+        ACCT_SUB(acct_sites[old.h.site].frees, 1);
+        ACCT_ADD(acct_sites[old.h.site].live, old.h.size);
+        return NULL;
+    }
+    return acct_account(h, s, fn, lno);
+}
+
+char*
+acct_strdup(const char *s, const char *fn, int lno)
+{
+    char *cp;
+
+    if (!s)
+        return NULL;
+    cp = (char*) acct_malloc(strlen(s) + 1, fn, lno);
+    if (cp)
+        strcpy(cp, s);
+    return cp;
+}
+
+void
+acct_free(void *p)
+{
+    union acct_hdr *h;
+
+    if (!p)
+        return;
+    h = acct_hdr(p, "free");
+    if (!h)
+        return;
+    acct_release(h);
+    free(h);
+}
+
+static int
+acct_printf(char *buf, int size, int len, const char *fmt, ...)
+{
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = vsnprintf(len < size ? buf + len : NULL, len < size ? size - len : 0,
+                  fmt, ap);
+    va_end(ap);
+    return n < 0 ? len : len + n;
+}
+
+static const char*
+acct_basename(const char *fn)
+{
+    const char *cp = strrchr(fn, '/');
+
+    return cp ? cp + 1 : fn;
+}
+
+struct acct_order_s {
+    int site;
+    unsigned long live;     // when the dump started, sites keep changing
+};
+
+static int
+acct_cmplive(const void *a, const void *b)
+{
+    const struct acct_order_s *oa = a, *ob = b;
+
+    if (oa->live != ob->live)
+        return oa->live < ob->live ? 1 : -1;
+    return oa->site - ob->site;
+}
+
+int
+acct_memdump(char *buf, int size)
+{
+    static struct acct_order_s order[CCNL_MALLOC_SITES];
+    unsigned long allocs = 0, frees = 0, bytes = 0, live = 0, n;
+    struct acct_site_s *s;
+    char site[64];
+    int i, cnt = 0, len = 0;
+
+    ACCT_LOCK(); // for order[]
+    for (i = 0; i < CCNL_MALLOC_SITES; i++)
+        if (acct_sites[i].allocs) {
+            order[cnt].site = i;
+            order[cnt++].live = acct_sites[i].live;
+        }
+    qsort(order, cnt, sizeof(*order), acct_cmplive);
+
+    len = acct_printf(buf, size, len, "%-32s %10s %10s %10s %12s %14s\n",
+                      "site", "allocs", "frees", "blocks", "live_bytes",
+                      "bytes");
+    for (i = 0; i < cnt; i++) {
+        s = acct_sites + order[i].site;
+        if (s->file)
+            snprintf(site, sizeof(site), "%s:%d", acct_basename(s->file),
+                     s->line);
+        else
+            strcpy(site, "(other)");
+        len = acct_printf(buf, size, len, "%-32s %10lu %10lu %10lu %12lu "
+                          "%14lu\n", site, s->allocs, s->frees,
+                          s->allocs - s->frees, s->live, s->bytes);
+        allocs += s->allocs;
+        frees += s->frees;
+        bytes += s->bytes;
+        live += s->live;
+    }
+    len = acct_printf(buf, size, len, "%-32s %10lu %10lu %10lu %12lu %14lu\n",
+                      "total", allocs, frees, allocs - frees, live, bytes);
+
+    n = acct_sampled < CCNL_MALLOC_SAMPLES ? acct_sampled : CCNL_MALLOC_SAMPLES;
+    if (n)
+        len = acct_printf(buf, size, len, "last %lu of %lu sampled "
+                          "allocations (1 in %d):\n", n, acct_sampled,
+                          acct_sample);
+    for (i = 0; i < (int) n; i++) {
+        struct acct_sample_s *smp = acct_samples + i;
+        char **sym = NULL;
+        int f;
+
+        s = acct_sites + smp->site;
+        len = acct_printf(buf, size, len, "%s:%d %lu bytes\n",
+                          s->file ? acct_basename(s->file) : "(other)",
+                          s->line, (unsigned long) smp->size);
+#ifdef __GLIBC__
+        sym = backtrace_symbols(smp->frame, smp->frames);
+#endif
+        for (f = 0; f < smp->frames; f++) {
+            if (sym)
+                len = acct_printf(buf, size, len, "    %s\n", sym[f]);
+            else
+                len = acct_printf(buf, size, len, "    %p\n", smp->frame[f]);
+        }
+        free(sym);
+    }
+    ACCT_UNLOCK();
+
+    return len;
+}
+
+void
+acct_memprint(void)
+{
+    int len = acct_memdump(NULL, 0);
+    char *buf = (char*) malloc(len + 1);
+
+    if (!buf)
+        return;
+    acct_memdump(buf, len + 1);
+    CONSOLE("[M] %s: @@@ allocations by call site\n%s", timestamp(), buf);
+    free(buf);
+}
+
+#endif // USE_MALLOC_ACCT
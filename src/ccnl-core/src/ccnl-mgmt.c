@@ -194,7 +194,8 @@ ccnl_mgmt_send_return_split(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
                 pkt->contlen = len5;
                 c = ccnl_content_new(&pkt);
                 ccnl_content_serve_pending(ccnl, c);
-                ccnl_content_add2cache(ccnl, c);
+                if (ccnl_content_add2cache(ccnl, c) < 0)
+                    ccnl_content_free(c);
 /*
                 //put to cache
                 struct ccnl_prefix_s *prefix_a = 0;
@@ -561,6 +562,10 @@ ccnl_mgmt_debug(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
     int num_faces, num_fwds, num_interfaces, num_interests, num_contents;
     int buflen, num, typ;
     char *cp = "debug cmd failed";
+#ifdef USE_MALLOC_ACCT
+    char *memtxt = NULL;
+    int memlen = 0;
+#endif
     int rc = -1;
 
     //variables for answer
@@ -708,7 +713,19 @@ ccnl_mgmt_debug(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
                     contentlast_use, contentserved_cnt, cprefixlen, cprefix);
 
             ccnl->halt_flag = 1;
-        } else
+        }
+#ifdef USE_MALLOC_ACCT
+        else if (!strcmp((char*) debugaction, "memdump")) {
+            // some room for what the allocation itself adds
+            memlen = acct_memdump(NULL, 0) + 256;
+            memtxt = (char*) ccnl_malloc(memlen);
+            if (memtxt)
+                acct_memdump(memtxt, memlen);
+            else
+                memlen = 0;
+        }
+#endif
+        else
             cp = "unknown debug action, ignored";
     } else
         cp = "no debug action given, ignored";
@@ -720,6 +737,9 @@ Bail:
     if(!debugaction) debugaction = (unsigned char *)"Error for debug cmd";
     stmt_length = 200 * num_faces + 200 * num_interfaces + 200 * num_fwds //alloc stroage for answer dynamically.
             + 200 * num_interests + 200 * num_contents;
+#ifdef USE_MALLOC_ACCT
+    stmt_length += memlen;
+#endif
     contentobject_length = stmt_length + 1000;
     object_length = contentobject_length + 1000;
 
@@ -760,6 +780,12 @@ Bail:
         len3 = ccnl_mgmt_create_content_stmt(num_contents, content, contentnext, contentprev,
                 contentlast_use, contentserved_cnt, ccontents, cprefix, stmt, len3);
     }
+#ifdef USE_MALLOC_ACCT
+    if (memtxt) {
+        len3 += ccnl_ccnb_mkHeader(stmt+len3, CCNL_DTAG_DEBUGREPLY, CCN_TT_DTAG);
+        len3 += ccnl_ccnb_mkStrBlob(stmt+len3, CCN_DTAG_CONTENT, CCN_TT_DTAG, memtxt);
+    }
+#endif
 
     stmt[len3++] = 0; //end of debug reply
 
@@ -807,6 +833,9 @@ Bail:
     ccnl_free(suite);
     ccnl_free(action);
     ccnl_free(debugaction);
+#ifdef USE_MALLOC_ACCT
+    ccnl_free(memtxt);
+#endif
 
     for(it = 0; it < num_faces; ++it) {
         ccnl_free(facepeer[it]);
@@ -1741,7 +1770,7 @@ ccnl_mgmt_prefixreg(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
     // should (re)verify that action=="prefixreg"
     if (faceid && p->compcnt > 0) {
         struct ccnl_face_s *f;
-        struct ccnl_forward_s *fwd, **fwd2;
+        struct ccnl_forward_s *fwd;
         int fi = strtol((const char*)faceid, NULL, 0);
 
         p->suite = suite[0];
@@ -1760,10 +1789,12 @@ ccnl_mgmt_prefixreg(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
         if (suite)
             fwd->suite = suite[0];
 
-        fwd2 = &ccnl->fib;
-        while (*fwd2)
-            fwd2 = &((*fwd2)->next);
-        *fwd2 = fwd;
+        if (!fwd->prefix || ccnl_fib_link(ccnl, fwd)) {
+            if (fwd->prefix)
+                ccnl_prefix_free(fwd->prefix);
+            ccnl_free(fwd);
+            goto Bail;
+        }
         cp = "prefixreg cmd worked";
     } else {
         DEBUGMSG(TRACE, "mgmt: ignored prefixreg faceid=%s\n", faceid);
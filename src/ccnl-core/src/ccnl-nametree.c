@@ -0,0 +1,269 @@
+/*
+ * @f ccnl-nametree.c
+ * @b CCN lite (CCNL), hashed name tree for the CS, PIT and FIB indices
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_LINUXKERNEL
+#include "ccnl-nametree.h"
+#include "ccnl-defs.h"
+#include "ccnl-malloc.h"
+#include "ccnl-prefix.h"
+#include "ccnl-logging.h"
+#include <string.h>
+#else
+#include <ccnl-nametree.h>
+#include <ccnl-defs.h>
+#include <ccnl-malloc.h>
+#include <ccnl-prefix.h>
+#include <ccnl-logging.h>
+#endif
+
+// FNV-1a, the component length is hashed as well to keep the
+// component boundaries apart
+#define FNV_OFFSET      2166136261u
+#define FNV_PRIME       16777619u
+
+uint32_t
+ccnl_nametree_seed(int suite)
+{
+    return (FNV_OFFSET ^ (uint32_t) suite) * FNV_PRIME;
+}
+
+uint32_t
+ccnl_nametree_hash(uint32_t h, unsigned char *comp, int complen)
+{
+    int i;
+
+    h = (h ^ (uint32_t) complen) * FNV_PRIME;
+    for (i = 0; i < complen; i++)
+        h = (h ^ comp[i]) * FNV_PRIME;
+    return h;
+}
+
+static int
+ccnl_nametree_grow(struct ccnl_nametree_s *t)
+{
+    struct ccnl_nametree_node_s **b, *n;
+    int i, size = t->size ? 2 * t->size : CCNL_NAMETREE_BUCKETS;
+
+    b = (struct ccnl_nametree_node_s**) ccnl_calloc(size, sizeof(*b));
+    if (!b)
+        return -1;
+    for (i = 0; i < t->size; i++) {
+        while ((n = t->buckets[i])) {
+            t->buckets[i] = n->hnext;
+            n->hnext = b[n->hash & (size - 1)];
+            b[n->hash & (size - 1)] = n;
+        }
+    }
+    ccnl_free(t->buckets);
+    t->buckets = b;
+    t->size = size;
+    return 0;
+}
+
+// checks whether n represents the first depth components of pfx,
+// comparing from the last component upwards
+static int
+ccnl_nametree_isName(struct ccnl_nametree_node_s *n,
+                     struct ccnl_prefix_s *pfx, int depth)
+{
+    if (n->depth != depth || n->suite != pfx->suite)
+        return 0;
+    while (depth > 0) {
+        depth--;
+        if (n->complen != pfx->complen[depth] ||
+                        memcmp(n->comp, pfx->comp[depth], n->complen))
+            return 0;
+        n = n->parent;
+    }
+    return 1;
+}
+
+struct ccnl_nametree_node_s*
+ccnl_nametree_find(struct ccnl_nametree_s *t, struct ccnl_prefix_s *pfx,
+                   int depth)
+{
+    struct ccnl_nametree_node_s *n;
+    uint32_t h;
+    int i;
+
+    if (!t->size || depth > pfx->compcnt)
+        return NULL;
+    h = ccnl_nametree_seed(pfx->suite);
+    for (i = 0; i < depth; i++)
+        h = ccnl_nametree_hash(h, pfx->comp[i], pfx->complen[i]);
+
+    for (n = t->buckets[h & (t->size - 1)]; n; n = n->hnext)
+        if (n->hash == h && ccnl_nametree_isName(n, pfx, depth))
+            return n;
+    return NULL;
+}
+
+struct ccnl_nametree_node_s*
+ccnl_nametree_child(struct ccnl_nametree_s *t,
+                    struct ccnl_nametree_node_s *parent,
+                    unsigned char *comp, int complen)
+{
+    struct ccnl_nametree_node_s *n;
+    uint32_t h;
+
+    if (!t->size)
+        return NULL;
+    h = ccnl_nametree_hash(parent->hash, comp, complen);
+    for (n = t->buckets[h & (t->size - 1)]; n; n = n->hnext)
+        if (n->hash == h && n->parent == parent && n->complen == complen &&
+                                            !memcmp(n->comp, comp, complen))
+            return n;
+    return NULL;
+}
+
+static struct ccnl_nametree_node_s*
+ccnl_nametree_newNode(struct ccnl_nametree_s *t,
+                      struct ccnl_nametree_node_s *parent, int suite,
+                      uint32_t h, unsigned char *comp, int complen)
+{
+    struct ccnl_nametree_node_s *n;
+
+    if (t->count >= t->size && ccnl_nametree_grow(t))
+        return NULL;
+    n = (struct ccnl_nametree_node_s*) ccnl_calloc(1, sizeof(*n) + complen);
+    if (!n)
+        return NULL;
+    n->hash = h;
+    n->suite = suite;
+    n->complen = complen;
+    if (complen)
+        memcpy(n->comp, comp, complen);
+    n->parent = parent;
+    if (parent) {
+        n->depth = parent->depth + 1;
+        n->sibling = parent->child;
+        if (parent->child)
+            parent->child->sibprev = n;
+        parent->child = n;
+        parent->refs++;
+    }
+    n->hnext = t->buckets[h & (t->size - 1)];
+    t->buckets[h & (t->size - 1)] = n;
+    t->count++;
+
+    return n;
+}
+
+struct ccnl_nametree_node_s*
+ccnl_nametree_get(struct ccnl_nametree_s *t, struct ccnl_prefix_s *pfx,
+                  int depth)
+{
+    struct ccnl_nametree_node_s *n, *c;
+    int i;
+
+    n = ccnl_nametree_find(t, pfx, depth);
+    if (n) {
+        n->refs++;
+        return n;
+    }
+
+    // walk down from the root of the suite, creating what is missing
+    n = ccnl_nametree_find(t, pfx, 0);
+    if (!n) {
+        n = ccnl_nametree_newNode(t, NULL, pfx->suite,
+                                  ccnl_nametree_seed(pfx->suite), NULL, 0);
+        if (!n)
+            return NULL;
+    }
+    for (i = 0; i < depth; i++) {
+        c = ccnl_nametree_child(t, n, pfx->comp[i], pfx->complen[i]);
+        if (!c) {
+            c = ccnl_nametree_newNode(t, n, pfx->suite,
+                        ccnl_nametree_hash(n->hash, pfx->comp[i],
+                                           pfx->complen[i]),
+                        pfx->comp[i], pfx->complen[i]);
+            if (!c) {
+                // drop the partial path again
+                if (!n->refs)
+                    ccnl_nametree_release(t, n);
+                return NULL;
+            }
+        }
+        n = c;
+    }
+    n->refs++;
+
+    return n;
+}
+
+void
+ccnl_nametree_release(struct ccnl_nametree_s *t, struct ccnl_nametree_node_s *n)
+{
+    struct ccnl_nametree_node_s **pp, *parent;
+
+    while (n) {
+        if (n->refs > 0)
+            n->refs--;
+        if (n->refs > 0 || n->entries)
+            return;
+
+        for (pp = &t->buckets[n->hash & (t->size - 1)]; *pp; pp = &(*pp)->hnext)
+            if (*pp == n) {
+                *pp = n->hnext;
+                break;
+            }
+        parent = n->parent;
+        if (parent) {
+            if (n->sibprev)
+                n->sibprev->sibling = n->sibling;
+            else
+                parent->child = n->sibling;
+            if (n->sibling)
+                n->sibling->sibprev = n->sibprev;
+        }
+        t->count--;
+        ccnl_free(n);
+        n = parent;
+    }
+}
+
+struct ccnl_nametree_node_s*
+ccnl_nametree_next(struct ccnl_nametree_node_s *n,
+                   struct ccnl_nametree_node_s *top, int maxdepth)
+{
+    if (n->child && n->depth < maxdepth)
+        return n->child;
+    while (n != top) {
+        if (n->sibling)
+            return n->sibling;
+        n = n->parent;
+    }
+    return NULL;
+}
+
+void
+ccnl_nametree_cleanup(struct ccnl_nametree_s *t)
+{
+    if (t->count)
+        DEBUGMSG_CORE(WARNING, "nametree cleanup: %d nodes still in use\n",
+                      t->count);
+    ccnl_free(t->buckets);
+    t->buckets = NULL;
+    t->size = t->count = 0;
+}
+
+// eof
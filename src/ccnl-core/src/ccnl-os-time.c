@@ -22,21 +22,19 @@
 
 #ifndef CCNL_LINUXKERNEL
 #include "ccnl-os-time.h"
+#include "ccnl-defs.h"
 #include "ccnl-malloc.h"
+#include <limits.h>
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
 #else
 #include <ccnl-os-time.h>
+#include <ccnl-defs.h>
 #include <ccnl-malloc.h>
 #endif
 
 
-
-
-struct ccnl_timer_s *eventqueue;
-
-
 #if defined(CCNL_RIOT) && !(defined(__FreeBSD__) || defined(__APPLE__) || defined(__linux__))
 #include <xtimer.h>
 
@@ -98,7 +96,7 @@ current_time(void)
 char*
 timestamp(void)
 {
-    static char ts[16], *cp;
+    static CCNL_THREAD_LOCAL char ts[16], *cp;
 
     sprintf(ts, "%.4g", CCNL_NOW());
     cp = strchr(ts, '.');
@@ -129,50 +127,199 @@ ccnl_get_timeval(struct timeval *tv)
     gettimeofday(tv, NULL);
 }
 
-void*
-ccnl_set_timer(uint64_t usec, void (*fct)(void *aux1, void *aux2),
-                 void *aux1, void *aux2)
+// ----------------------------------------------------------------------
+// hierarchical timing wheel: level l has CCNL_TIMER_SLOTS slots of
+// 2^(l*CCNL_TIMER_WHEEL_BITS) ticks (1 tick = 1 msec). A timer is kept in
+// the level which covers its distance and moved to the lower levels
+// ("cascaded") when the wheel reaches its slot. Slots are FIFO lists, those
+// of level 0 (one tick each) are kept sorted on the exact timeout so that
+// the timers of a tick fire from the head in that order.
+
+#define CCNL_TIMER_SLOTS        (1 << CCNL_TIMER_WHEEL_BITS)
+#define CCNL_TIMER_MASK         (CCNL_TIMER_SLOTS - 1)
+#define CCNL_TIMER_SPAN         ((uint64_t)1 << (CCNL_TIMER_WHEEL_BITS * \
+                                                 CCNL_TIMER_WHEEL_LEVELS))
+
+struct ccnl_timerwheel_s {
+    uint64_t tick;              // current tick, slots before it are served
+    int count;                  // pending timers
+    int poolcnt;
+    struct ccnl_timer_s *pool;  // free timer nodes
+    uint64_t occupied[CCNL_TIMER_WHEEL_LEVELS];  // bitmap of non-empty slots
+    struct ccnl_timer_s *slot[CCNL_TIMER_WHEEL_LEVELS][CCNL_TIMER_SLOTS];
+    struct ccnl_timer_s *tail[CCNL_TIMER_WHEEL_LEVELS][CCNL_TIMER_SLOTS];
+};
+
+static CCNL_THREAD_LOCAL struct ccnl_timerwheel_s wheel;
+
+static uint64_t
+ccnl_timer_tick(struct timeval *tv)
+{
+    return (uint64_t)tv->tv_sec * 1000 + tv->tv_usec / 1000;
+}
+
+// smallest j >= 0 such that slot (start + j) & CCNL_TIMER_MASK is occupied
+static int
+ccnl_timer_scan(uint64_t occupied, unsigned int start)
+{
+    uint64_t rot = occupied;
+
+    if (start)
+        rot = (occupied >> start) | (occupied << (CCNL_TIMER_SLOTS - start));
+    rot &= (uint64_t)-1 >> (64 - CCNL_TIMER_SLOTS);
+#ifdef __GNUC__
+    return __builtin_ctzll(rot);
+#else
+    {
+        int j = 0;
+        for (; !(rot & 1); rot >>= 1)
+            j++;
+        return j;
+    }
+#endif
+}
+
+static void
+ccnl_timer_link(struct ccnl_timer_s *t)
+{
+    uint64_t expires = ccnl_timer_tick(&t->timeout), delta;
+    struct ccnl_timer_s *p;
+    int level;
+
+    if (expires < wheel.tick)
+        expires = wheel.tick;
+    delta = expires - wheel.tick;
+    if (delta >= CCNL_TIMER_SPAN) // re-cascaded until in reach
+        expires = wheel.tick + CCNL_TIMER_SPAN - 1, delta = CCNL_TIMER_SPAN - 1;
+    for (level = 0; level < CCNL_TIMER_WHEEL_LEVELS - 1; level++)
+        if (delta < ((uint64_t)1 << ((level + 1) * CCNL_TIMER_WHEEL_BITS)))
+            break;
+
+    t->level = level;
+    t->slot = (expires >> (level * CCNL_TIMER_WHEEL_BITS)) & CCNL_TIMER_MASK;
+    // appended, in level 0 behind the last one which is not later; timers
+    // set in a burst have ascending timeouts, so this rarely walks
+    p = wheel.tail[level][t->slot];
+    if (!level)
+        while (p && timevaldelta(&p->timeout, &t->timeout) > 0)
+            p = p->prev;
+    t->prev = p;
+    t->next = p ? p->next : wheel.slot[level][t->slot];
+    if (p)
+        p->next = t;
+    else
+        wheel.slot[level][t->slot] = t;
+    if (t->next)
+        t->next->prev = t;
+    else
+        wheel.tail[level][t->slot] = t;
+    t->pending = 1;
+    wheel.occupied[level] |= (uint64_t)1 << t->slot;
+}
+
+static void
+ccnl_timer_unlink(struct ccnl_timer_s *t)
+{
+    if (t->prev)
+        t->prev->next = t->next;
+    else
+        wheel.slot[t->level][t->slot] = t->next;
+    if (t->next)
+        t->next->prev = t->prev;
+    else
+        wheel.tail[t->level][t->slot] = t->prev;
+    if (!wheel.slot[t->level][t->slot])
+        wheel.occupied[t->level] &= ~((uint64_t)1 << t->slot);
+    t->next = t->prev = NULL;
+    t->pending = 0;
+}
+
+static void
+ccnl_timer_recycle(struct ccnl_timer_s *t)
 {
-    struct ccnl_timer_s *t, **pp;
-    //    static int handlercnt;
+    if (wheel.poolcnt >= CCNL_TIMER_POOL) {
+        ccnl_free(t);
+        return;
+    }
+    t->next = wheel.pool;
+    wheel.pool = t;
+    wheel.poolcnt++;
+}
 
-    t = (struct ccnl_timer_s *) ccnl_calloc(1, sizeof(*t));
-    if (!t)
-        return 0;
+static void*
+ccnl_timer_add(struct timeval *timeout, void (*fct)(void *aux1, void *aux2),
+               void *aux1, void *aux2)
+{
+    struct ccnl_timer_s *t = wheel.pool;
+
+    if (t) {
+        wheel.pool = t->next;
+        wheel.poolcnt--;
+        memset(t, 0, sizeof(*t));
+    } else {
+        t = (struct ccnl_timer_s *) ccnl_calloc(1, sizeof(*t));
+        if (!t)
+            return NULL;
+    }
     t->fct2 = fct;
-    gettimeofday(&t->timeout, NULL);
-    usec += t->timeout.tv_usec;
-    t->timeout.tv_sec += usec / 1000000;
-    t->timeout.tv_usec = usec % 1000000;
+    t->timeout = *timeout;
     t->aux1 = aux1;
     t->aux2 = aux2;
 
-    for (pp = &eventqueue; ; pp = &((*pp)->next)) {
-    if (!*pp || (*pp)->timeout.tv_sec > t->timeout.tv_sec ||
-        ((*pp)->timeout.tv_sec == t->timeout.tv_sec &&
-         (*pp)->timeout.tv_usec > t->timeout.tv_usec)) {
-        t->next = *pp;
-        //        t->handler = handlercnt++;
-        *pp = t;
-        return t;
+    if (!wheel.count) { // nothing pending, the wheel may have stood still
+        struct timeval now;
+        gettimeofday(&now, NULL);
+        wheel.tick = ccnl_timer_tick(&now);
     }
-    }
-    return NULL; // ?
+    ccnl_timer_link(t);
+    wheel.count++;
+    return t;
+}
+
+void*
+ccnl_set_timer(uint64_t usec, void (*fct)(void *aux1, void *aux2),
+                 void *aux1, void *aux2)
+{
+    struct timeval timeout;
+
+    gettimeofday(&timeout, NULL);
+    usec += timeout.tv_usec;
+    timeout.tv_sec += usec / 1000000;
+    timeout.tv_usec = usec % 1000000;
+
+    return ccnl_timer_add(&timeout, fct, aux1, aux2);
 }
 
 void
 ccnl_rem_timer(void *h)
 {
-    struct ccnl_timer_s **pp;
+    struct ccnl_timer_s *t = (struct ccnl_timer_s *) h;
 
-    for (pp = &eventqueue; *pp; pp = &((*pp)->next)) {
-        if ((void*)*pp == h) {
-            struct ccnl_timer_s *e = *pp;
-            *pp = e->next;
-            ccnl_free(e);
-            break;
-        }
+    if (!t || !t->pending) // already fired or removed
+        return;
+    ccnl_timer_unlink(t);
+    wheel.count--;
+    ccnl_timer_recycle(t);
+}
+
+void
+ccnl_timer_cleanup(void)
+{
+    int level, i;
+
+    for (level = 0; level < CCNL_TIMER_WHEEL_LEVELS; level++)
+        for (i = 0; i < CCNL_TIMER_SLOTS; i++)
+            while (wheel.slot[level][i]) {
+                struct ccnl_timer_s *t = wheel.slot[level][i];
+                ccnl_timer_unlink(t);
+                ccnl_free(t);
+            }
+    while (wheel.pool) {
+        struct ccnl_timer_s *t = wheel.pool;
+        wheel.pool = t->next;
+        ccnl_free(t);
     }
+    wheel.count = wheel.poolcnt = 0;
 }
 
 #endif
@@ -248,31 +395,112 @@ ccnl_rem_timer(void *p)
 
 #else// we have to work through the pending timer requests ourself
 
+// the first tick after the current one at which a slot is due: the tick of
+// a timer in level 0 or the tick at which a higher level slot is cascaded
+static uint64_t
+ccnl_timer_next(void)
+{
+    uint64_t next = (uint64_t)-1, base, cand;
+    int level, shift;
+
+    for (level = 0; level < CCNL_TIMER_WHEEL_LEVELS; level++) {
+        if (!wheel.occupied[level])
+            continue;
+        shift = level * CCNL_TIMER_WHEEL_BITS;
+        base = wheel.tick >> shift;
+        cand = (base + 1 + ccnl_timer_scan(wheel.occupied[level],
+                           (base + 1) & CCNL_TIMER_MASK)) << shift;
+        if (cand < next)
+            next = cand;
+    }
+    return next;
+}
+
+static void
+ccnl_timer_cascade(void)
+{
+    int level, shift;
+
+    for (level = CCNL_TIMER_WHEEL_LEVELS - 1; level > 0; level--) {
+        struct ccnl_timer_s *t, **head;
+
+        shift = level * CCNL_TIMER_WHEEL_BITS;
+        if (wheel.tick & (((uint64_t)1 << shift) - 1))
+            continue;
+        head = &wheel.slot[level][(wheel.tick >> shift) & CCNL_TIMER_MASK];
+        while ((t = *head) != NULL) {
+            ccnl_timer_unlink(t);
+            ccnl_timer_link(t);
+        }
+    }
+}
+
+// fires the timers of the current tick which are due at @now
+static void
+ccnl_timer_fire(struct timeval *now)
+{
+    struct ccnl_timer_s **head = &wheel.slot[0][wheel.tick & CCNL_TIMER_MASK];
+
+    for (;;) {
+        struct ccnl_timer_s *t = *head; // the earliest, the slot is sorted
+        void (*fct)(char,int), (*fct2)(void*,void*);
+        char node;
+        int intarg;
+        void *aux1, *aux2;
+
+        if (!t || timevaldelta(&t->timeout, now) >= 0)
+            return;
+
+        // unlink before the callback which may set or remove timers
+        fct = t->fct;
+        fct2 = t->fct2;
+        node = t->node;
+        intarg = t->intarg;
+        aux1 = t->aux1;
+        aux2 = t->aux2;
+        ccnl_timer_unlink(t);
+        wheel.count--;
+        ccnl_timer_recycle(t);
+
+        if (fct)
+            (fct)(node, intarg);
+        else if (fct2)
+            (fct2)(aux1, aux2);
+    }
+}
+
 // "looper": serves all pending events and returns the number of microseconds
 // when the next event should be triggered.
 int
 ccnl_run_events(void)
 {
-    static struct timeval now;
-    long usec;
+    struct timeval now;
+    struct ccnl_timer_s *t;
+    uint64_t tick, next;
 
     gettimeofday(&now, 0);
-    while (eventqueue) {
-        struct ccnl_timer_s *t = eventqueue;
-
-        usec = timevaldelta(&(t->timeout), &now);
-        if (usec >= 0)
-            return usec;
-
-        if (t->fct)
-            (t->fct)(t->node, t->intarg);
-        else if (t->fct2)
-            (t->fct2)(t->aux1, t->aux2);
-        eventqueue = t->next;
-        ccnl_free(t);
+    tick = ccnl_timer_tick(&now);
+    for (;;) {
+        ccnl_timer_fire(&now);
+        if (!wheel.count)
+            return -1;
+        if (wheel.tick >= tick)
+            break;
+        // skip the ticks in which nothing is due
+        next = ccnl_timer_next();
+        wheel.tick = next < tick ? next : tick;
+        ccnl_timer_cascade();
     }
 
-    return -1;
+    // timers still pending in the current tick ...
+    t = wheel.slot[0][wheel.tick & CCNL_TIMER_MASK];
+    if (t)
+        return timevaldelta(&t->timeout, &now);
+    // ... or wake up at the begin of the next tick in which a slot is due
+    next = ccnl_timer_next();
+    if (next - tick >= INT_MAX / 1000)
+        next = tick + INT_MAX / 1000 - 1;
+    return (next - tick) * 1000 - now.tv_usec % 1000;
 }
 
 #endif // CCNL_LINUXKERNEL
@@ -285,28 +513,7 @@ void*
 ccnl_set_absolute_timer(struct timeval abstime, void (*fct)(void *aux1, void *aux2),
          void *aux1, void *aux2)
 {
-    struct ccnl_timer_s *t, **pp;
-    //    static int handlercnt;
-
-    t = (struct ccnl_timer_s *) ccnl_calloc(1, sizeof(*t));
-    if (!t)
-    return 0;
-    t->fct2 = fct;
-    t->timeout = abstime;
-    t->aux1 = aux1;
-    t->aux2 = aux2;
-
-    for (pp = &eventqueue; ; pp = &((*pp)->next)) {
-    if (!*pp || (*pp)->timeout.tv_sec > t->timeout.tv_sec ||
-        ((*pp)->timeout.tv_sec == t->timeout.tv_sec &&
-         (*pp)->timeout.tv_usec > t->timeout.tv_usec)) {
-        t->next = *pp;
-        //        t->handler = handlercnt++;
-        *pp = t;
-        return t;
-    }
-    }
-    return NULL; // ?
+    return ccnl_timer_add(&abstime, fct, aux1, aux2);
 }
 
 #endif
@@ -29,6 +29,7 @@
 
 #include "ccnl-prefix.h"
 #include "ccnl-malloc.h"
+#include "ccnl-pool.h"
 
 #include "ccnl-logging.h"
 
@@ -70,19 +71,20 @@ ccnl_pkt_free(struct ccnl_pkt_s *pkt)
             ccnl_prefix_free(pkt->pfx);
         }
         if(pkt->buf){
-            ccnl_free(pkt->buf);
+            ccnl_buf_free(pkt->buf);
         }
-        ccnl_free(pkt);
+        ccnl_pool_free(CCNL_POOL_PKT, pkt);
     }
 }
 
 
 struct ccnl_pkt_s *
 ccnl_pkt_dup(struct ccnl_pkt_s *pkt){
-    struct ccnl_pkt_s * ret = ccnl_malloc(sizeof(struct ccnl_pkt_s));
+    struct ccnl_pkt_s * ret;
     if(!pkt){
         return NULL;
     }
+    ret = ccnl_pool_alloc(CCNL_POOL_PKT);
     if(!ret){
         return NULL;
     }
@@ -0,0 +1,117 @@
+/*
+ * @f ccnl-pool.c
+ * @b CCN lite (CCNL), per-type pools of fixed-size objects
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_LINUXKERNEL
+#include "ccnl-pool.h"
+#include "ccnl-defs.h"
+#include "ccnl-malloc.h"
+#include "ccnl-pkt.h"
+#include "ccnl-prefix.h"
+#include "ccnl-interest.h"
+#include "ccnl-content.h"
+#include "ccnl-buf.h"
+#include "ccnl-txq.h"
+#include <string.h>
+#else
+#include <ccnl-pool.h>
+#include <ccnl-defs.h>
+#include <ccnl-malloc.h>
+#include <ccnl-pkt.h>
+#include <ccnl-prefix.h>
+#include <ccnl-interest.h>
+#include <ccnl-content.h>
+#include <ccnl-buf.h>
+#include <ccnl-txq.h>
+#endif
+
+// see ccnl_prefix_new() for the layout
+#define PREFIX_BLOCK    (sizeof(struct ccnl_prefix_s) + CCNL_MAX_NAME_COMP * \
+                         (sizeof(unsigned char*) + sizeof(int)))
+
+static CCNL_THREAD_LOCAL struct ccnl_pool_s pools[CCNL_POOL_TYPES] = {
+    { "pkt",      sizeof(struct ccnl_pkt_s),      NULL, 0, 0, 0, 0 },
+    { "prefix",   PREFIX_BLOCK,                   NULL, 0, 0, 0, 0 },
+    { "interest", sizeof(struct ccnl_interest_s), NULL, 0, 0, 0, 0 },
+    { "pendint",  sizeof(struct ccnl_pendint_s),  NULL, 0, 0, 0, 0 },
+    { "content",  sizeof(struct ccnl_content_s),  NULL, 0, 0, 0, 0 },
+    { "slice",    sizeof(struct ccnl_buf_s),      NULL, 0, 0, 0, 0 },
+    { "txreq",    sizeof(struct ccnl_txrequest_s), NULL, 0, 0, 0, 0 },
+};
+
+void*
+ccnl_pool_alloc(int type)
+{
+    struct ccnl_pool_s *pool = pools + type;
+    void *p = pool->free;
+
+    if (p) {
+        pool->free = *(void**) p;
+        pool->freecnt--;
+        pool->hits++;
+        memset(p, 0, pool->size);
+    } else {
+        p = ccnl_calloc(1, pool->size);
+        if (!p)
+            return NULL;
+        pool->misses++;
+    }
+    pool->inuse++;
+    return p;
+}
+
+void
+ccnl_pool_free(int type, void *p)
+{
+    struct ccnl_pool_s *pool = pools + type;
+
+    if (!p)
+        return;
+    pool->inuse--;
+    if (pool->freecnt >= CCNL_OBJECT_POOL) {
+        ccnl_free(p);
+        return;
+    }
+    *(void**) p = pool->free;
+    pool->free = p;
+    pool->freecnt++;
+}
+
+const struct ccnl_pool_s*
+ccnl_pool_stats(int type)
+{
+    return pools + type;
+}
+
+void
+ccnl_pool_cleanup(void)
+{
+    int i;
+    void *p;
+
+    for (i = 0; i < CCNL_POOL_TYPES; i++) {
+        while ((p = pools[i].free)) {
+            pools[i].free = *(void**) p;
+            ccnl_free(p);
+        }
+        pools[i].freecnt = 0;
+    }
+}
@@ -23,6 +23,7 @@
 
 #ifndef CCNL_LINUXKERNEL
 #include "ccnl-prefix.h"
+#include "ccnl-pool.h"
 #include "ccnl-pkt-ndntlv.h"
 #include "ccnl-pkt-cistlv.h"
 #include "ccnl-pkt-ccntlv.h"
@@ -38,26 +39,40 @@
 #endif // !defined(CCNL_RIOT) && !defined(CCNL_ANDROID)
 #else //CCNL_LINUXKERNEL
 #include <ccnl-prefix.h>
+#include <ccnl-pool.h>
 #include <ccnl-pkt-ndntlv.h>
 #include <ccnl-pkt-cistlv.h>
 #include <ccnl-pkt-ccntlv.h>
 #endif //CCNL_LINUXKERNEL
 
 
+// prefixes of up to CCNL_MAX_NAME_COMP components come from the prefix
+// pool, with the comp and complen arrays placed right behind the struct
+#define INLINE_COMP(p)          ((unsigned char**) ((p) + 1))
+#define INLINE_COMPLEN(p)       ((int*) (INLINE_COMP(p) + CCNL_MAX_NAME_COMP))
+
 struct ccnl_prefix_s*
 ccnl_prefix_new(int suite, int cnt)
 {
     struct ccnl_prefix_s *p;
 
-    p = (struct ccnl_prefix_s *) ccnl_calloc(1, sizeof(struct ccnl_prefix_s));
-    if (!p){
-        return NULL;
-    }
-    p->comp = (unsigned char**) ccnl_malloc(cnt * sizeof(unsigned char*));
-    p->complen = (int*) ccnl_malloc(cnt * sizeof(int));
-    if (!p->comp || !p->complen) {
-        ccnl_prefix_free(p);
-        return NULL;
+    if (cnt <= CCNL_MAX_NAME_COMP) {
+        p = ccnl_pool_alloc(CCNL_POOL_PREFIX);
+        if (!p)
+            return NULL;
+        p->comp = INLINE_COMP(p);
+        p->complen = INLINE_COMPLEN(p);
+    } else {
+        p = (struct ccnl_prefix_s *) ccnl_calloc(1, sizeof(struct ccnl_prefix_s));
+        if (!p){
+            return NULL;
+        }
+        p->comp = (unsigned char**) ccnl_malloc(cnt * sizeof(unsigned char*));
+        p->complen = (int*) ccnl_malloc(cnt * sizeof(int));
+        if (!p->comp || !p->complen) {
+            ccnl_prefix_free(p);
+            return NULL;
+        }
     }
     p->compcnt = cnt;
     p->suite = suite;
@@ -70,9 +85,13 @@ void
 ccnl_prefix_free(struct ccnl_prefix_s *p)
 {
     ccnl_free(p->bytes);
+    ccnl_free(p->chunknum);
+    if (p->comp == INLINE_COMP(p)) {
+        ccnl_pool_free(CCNL_POOL_PREFIX, p);
+        return;
+    }
     ccnl_free(p->comp);
     ccnl_free(p->complen);
-    ccnl_free(p->chunknum);
     ccnl_free(p);
 }
 
@@ -137,8 +156,10 @@ ccnl_prefix_appendCmp(struct ccnl_prefix_s *prefix, unsigned char *cmp,
     }
 
     prefix->compcnt++;
-    prefix->comp = (unsigned char**) ccnl_malloc(prefix->compcnt * sizeof(unsigned char*));
-    prefix->complen = (int*) ccnl_malloc(prefix->compcnt * sizeof(int));
+    if (oldcomp != INLINE_COMP(prefix)) {
+        prefix->comp = (unsigned char**) ccnl_malloc(prefix->compcnt * sizeof(unsigned char*));
+        prefix->complen = (int*) ccnl_malloc(prefix->compcnt * sizeof(int));
+    }
     prefix->bytes = (unsigned char*) ccnl_malloc(prefixlen + cmplen);
 
     memcpy(prefix->bytes, oldbytes, prefixlen);
@@ -153,8 +174,10 @@ ccnl_prefix_appendCmp(struct ccnl_prefix_s *prefix, unsigned char *cmp,
     prefix->comp[lastcmp] = &prefix->bytes[prefixlen];
     prefix->complen[lastcmp] = cmplen;
 
-    ccnl_free(oldcomp);
-    ccnl_free(oldcomplen);
+    if (oldcomp != prefix->comp) {
+        ccnl_free(oldcomp);
+        ccnl_free(oldcomplen);
+    }
     ccnl_free(oldbytes);
 
     return 0;
@@ -644,7 +667,9 @@ ccnl_prefix_to_str_detailed(struct ccnl_prefix_s *pr, int ccntlv_skip, int escap
 
     for (i = 0; i < (size_t)pr->compcnt; i++) {
 #ifdef USE_NFN
-        if((strncmp("call", (char*)pr->comp[i]+skip, 4) && strncmp("(call", (char*)pr->comp[i]+skip, 5)) || call_slash)
+        int complen = pr->complen[i] - skip; // comp[i] is not terminated
+        if((!(complen >= 4 && !memcmp("call", pr->comp[i]+skip, 4)) &&
+            !(complen >= 5 && !memcmp("(call", pr->comp[i]+skip, 5))) || call_slash)
         {
 #endif
             result = snprintf(buf + len, buflen - len, "/");
@@ -716,7 +741,7 @@ ccnl_prefix_to_str_detailed(struct ccnl_prefix_s *pr, int ccntlv_skip, int escap
 char*
 ccnl_prefix_to_path(struct ccnl_prefix_s *pr)
 {
-    static char prefix_buf[4096];
+    static CCNL_THREAD_LOCAL char prefix_buf[4096];
     int len= 0, i;
     int result;
 
@@ -35,6 +35,14 @@
 
 
 
+static struct ccnl_face_s**
+ccnl_face_bucket(struct ccnl_relay_s *ccnl, sockunion *peer)
+{
+    if (!peer)
+        return ccnl->face_hash;
+    return ccnl->face_hash + (ccnl_addr_hash(peer) & (CCNL_FACE_BUCKETS - 1));
+}
+
 struct ccnl_face_s*
 ccnl_get_face_or_create(struct ccnl_relay_s *ccnl, int ifndx,
                        struct sockaddr *sa, int addrlen)
@@ -42,14 +50,14 @@ ccnl_get_face_or_create(struct ccnl_relay_s *ccnl, int ifndx,
 // sa!=NULL && ifndx==-1: search suitable interface for given sa_family
 // sa!=NULL && ifndx!=-1: use this (incoming) interface for outgoing
 {
-    static int seqno;
+    static CCNL_THREAD_LOCAL int seqno;
     int i;
-    struct ccnl_face_s *f;
+    struct ccnl_face_s *f, **bucket = ccnl_face_bucket(ccnl, (sockunion*)sa);
 
     DEBUGMSG_CORE(TRACE, "ccnl_get_face_or_create src=%s\n",
              ccnl_addr2ascii((sockunion*)sa));
 
-    for (f = ccnl->faces; f; f = f->next) {
+    for (f = *bucket; f; f = f->hash_next) {
         if (!sa) {
             if (f->ifndx == -1)
                 return f;
@@ -96,6 +104,8 @@ ccnl_get_face_or_create(struct ccnl_relay_s *ccnl, int ifndx,
         f->ifndx = -1;
     f->last_used = CCNL_NOW();
     DBL_LINKED_LIST_ADD(ccnl->faces, f);
+    f->hash_next = *bucket;
+    *bucket = f;
 
     TRACEOUT();
     return f;
@@ -104,9 +114,10 @@ ccnl_get_face_or_create(struct ccnl_relay_s *ccnl, int ifndx,
 struct ccnl_face_s*
 ccnl_face_remove(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f)
 {
-    struct ccnl_face_s *f2;
-    struct ccnl_interest_s *pit;
-    struct ccnl_forward_s **ppfwd;
+    struct ccnl_face_s *f2, **pf;
+    struct ccnl_pendint_s *pend;
+    struct ccnl_forward_s *fwd;
+    int k;
 
     DEBUGMSG_CORE(DEBUG, "face_remove relay=%p face=%p\n",
              (void*)ccnl, (void*)f);
@@ -116,51 +127,49 @@ ccnl_face_remove(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f)
     ccnl_frag_destroy(f->frag);
 #endif
     DEBUGMSG_CORE(TRACE, "face_remove: cleaning PIT\n");
-    for (pit = ccnl->pit; pit; ) {
-        struct ccnl_pendint_s **ppend, *pend;
-        if (pit->from == f)
-            pit->from = NULL;
-        for (ppend = &pit->pending; *ppend;) {
-            if ((*ppend)->face == f) {
-                pend = *ppend;
-                *ppend = pend->next;
-                ccnl_free(pend);
-            } else
-                ppend = &(*ppend)->next;
-        }
-        if (pit->pending)
-            pit = pit->next;
-        else {
+    while (f->interests)
+        ccnl_interest_set_from(f->interests, NULL);
+    while ((pend = f->pending)) {
+        struct ccnl_interest_s *pit = pend->interest;
+        struct ccnl_pendint_s **ppend = &pit->pending;
+
+        while (*ppend != pend)
+            ppend = &(*ppend)->next;
+        *ppend = pend->next;
+        ccnl_pendint_free(pend);
+        if (!pit->pending) {
             DEBUGMSG_CORE(TRACE, "before NFN interest_remove 0x%p\n",
                           (void*)pit);
 #ifdef USE_NFN
-            pit = ccnl_nfn_interest_remove(ccnl, pit);
+            ccnl_nfn_interest_remove(ccnl, pit);
 #else
-            pit = ccnl_interest_remove(ccnl, pit);
+            ccnl_interest_remove(ccnl, pit);
 #endif
         }
     }
     DEBUGMSG_CORE(TRACE, "face_remove: cleaning fwd table\n");
-    for (ppfwd = &ccnl->fib; *ppfwd;) {
-        if ((*ppfwd)->face == f) {
-            struct ccnl_forward_s *pfwd = *ppfwd;
-            ccnl_prefix_free(pfwd->prefix);
-            *ppfwd = pfwd->next;
-            ccnl_free(pfwd);
-        } else
-            ppfwd = &(*ppfwd)->next;
+    while ((fwd = f->fwds)) {
+        ccnl_fib_unlink(ccnl, fwd);
+        ccnl_prefix_free(fwd->prefix);
+        ccnl_free(fwd);
     }
     DEBUGMSG_CORE(TRACE, "face_remove: cleaning pkt queue\n");
     while (f->outq) {
         struct ccnl_buf_s *tmp = f->outq->next;
-        ccnl_free(f->outq);
+        ccnl_buf_free(f->outq);
         f->outq = tmp;
     }
+    for (k = 0; k < ccnl->ifcount; k++)
+        ccnl_txq_orphan(&ccnl->ifs[k].txq, f);
     DEBUGMSG_CORE(TRACE, "face_remove: unlinking1 %p %p\n",
              (void*)f->next, (void*)f->prev);
     f2 = f->next;
     DEBUGMSG_CORE(TRACE, "face_remove: unlinking2\n");
     DBL_LINKED_LIST_REMOVE(ccnl->faces, f);
+    for (pf = ccnl_face_bucket(ccnl, f->ifndx == -1 ? NULL : &f->peer);
+                                                    *pf != f; )
+        pf = &(*pf)->hash_next;
+    *pf = f->hash_next;
     DEBUGMSG_CORE(TRACE, "face_remove: unlinking3\n");
     ccnl_free(f);
 
@@ -173,27 +182,24 @@ ccnl_interface_enqueue(void (tx_done)(void*, int, int), struct ccnl_face_s *f,
                        struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
                        struct ccnl_buf_s *buf, sockunion *dest)
 {
-    struct ccnl_txrequest_s *r;
-
     DEBUGMSG_CORE(TRACE, "enqueue interface=%p buf=%p len=%zd (qlen=%d)\n",
                   (void*)ifc, (void*)buf,
-                  buf ? buf->datalen : -1, ifc ? ifc->qlen : -1);
+                  buf ? buf->datalen : -1, ifc ? ifc->txq.qlen : -1);
 
-    if (ifc->qlen >= CCNL_MAX_IF_QLEN) {
-        DEBUGMSG_CORE(WARNING, "  DROPPING buf=%p\n", (void*)buf);
-        ccnl_free(buf);
+    if (ccnl_txq_enqueue(&ifc->txq, f, buf, dest, tx_done))
         return;
-    }
-    r = ifc->queue + ((ifc->qfront + ifc->qlen) % CCNL_MAX_IF_QLEN);
-    r->buf = buf;
-    memcpy(&r->dst, dest, sizeof(sockunion));
-    r->txdone = tx_done;
-    r->txdone_face = f;
-    ifc->qlen++;
 
 #ifdef USE_SCHEDULER
     ccnl_sched_RTS(ifc->sched, 1, buf->datalen, ccnl, ifc);
 #else
+#ifdef USE_BATCH_IO
+    // the IO loop sends the whole queue at once before it blocks again
+    if (ccnl->ccnl_ll_TX_batch_ptr) {
+        if (ifc->txq.qlen >= 4 * CCNL_IO_BATCH)
+            ccnl->ccnl_ll_TX_batch_ptr(ccnl, ifc);
+        return;
+    }
+#endif
     ccnl_interface_CTS(ccnl, ifc);
 #endif
 }
@@ -263,7 +269,7 @@ int
 ccnl_send_pkt(struct ccnl_relay_s *ccnl, struct ccnl_face_s *to,
                 struct ccnl_pkt_s *pkt)
 {
-    return ccnl_face_enqueue(ccnl, to, buf_dup(pkt->buf));
+    return ccnl_face_enqueue(ccnl, to, ccnl_buf_share(pkt->buf));
 }
 
 int
@@ -278,12 +284,22 @@ ccnl_face_enqueue(struct ccnl_relay_s *ccnl, struct ccnl_face_s *to,
     DEBUGMSG_CORE(TRACE, "enqueue face=%p (id=%d.%d) buf=%p len=%zd\n",
              (void*) to, ccnl->id, to->faceid, (void*) buf, buf ? buf->datalen : -1);
 
-    for (msg = to->outq; msg; msg = msg->next) // already in the queue?
-        if (buf_equal(msg, buf)) {
-            DEBUGMSG_CORE(VERBOSE, "    not enqueued because already there\n");
-            ccnl_free(buf);
-            return -1;
-        }
+    // already in the queue? Packets which the face passes on at once wait
+    // in the interface queue, which finds them by their hash
+    if (to->outq) {
+        for (msg = to->outq; msg; msg = msg->next)
+            if (buf_equal(msg, buf))
+                break;
+    } else if (to->ifndx >= 0 && ccnl_txq_find(&ccnl->ifs[to->ifndx].txq,
+                                                to, buf))
+        msg = buf;
+    else
+        msg = NULL;
+    if (msg) {
+        DEBUGMSG_CORE(VERBOSE, "    not enqueued because already there\n");
+        ccnl_buf_free(buf);
+        return -1;
+    }
     buf->next = NULL;
     if (to->outqend)
         to->outqend->next = buf;
@@ -307,6 +323,139 @@ ccnl_face_enqueue(struct ccnl_relay_s *ccnl, struct ccnl_face_s *to,
     return 0;
 }
 
+#define DEBUGMSG_AGEING(trace, debug, buf, buf_len)    \
+DEBUGMSG_CORE(TRACE, "%s %p\n", (trace), (void*) i);   \
+DEBUGMSG_CORE(DEBUG, " %s 0x%p <%s>\n", (debug),       \
+    (void*)i,                                          \
+    ccnl_prefix_to_str(i->pkt->pfx,buf,buf_len));
+
+static void
+ccnl_interest_timeout(void *ptr, void *interest);
+
+#ifdef USE_STATS
+static void
+ccnl_interest_expired(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
+{
+    ccnl->stats.pit_expired++;
+    if (i->fwd)
+        i->fwd->stats.expired++;
+}
+
+static void
+ccnl_interest_satisfied(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
+{
+    struct timeval now;
+    long usec;
+
+    ccnl_get_timeval(&now);
+    usec = timevaldelta(&now, &i->created);
+    if (usec < 0)
+        usec = 0;
+    ccnl->stats.pit_satisfied++;
+    ccnl->stats.residence[ccnl_stats_bucket(usec)]++;
+    ccnl->stats.residence_usec += usec;
+    if (i->fwd)
+        i->fwd->stats.data_in++;
+}
+#endif
+
+static void
+ccnl_interest_schedule(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
+{
+    struct timeval now;
+    long usec;
+
+    ccnl_get_timeval(&now);
+    usec = timevaldelta(&i->expires, &now);
+    if (usec <= 0 || usec > CCNL_INTEREST_RETRANSMIT * 1000L)
+        usec = CCNL_INTEREST_RETRANSMIT * 1000L;
+    i->timer = ccnl_set_timer(usec, ccnl_interest_timeout, ccnl, i);
+}
+
+// retransmits @interest or removes it when its lifetime is over
+static void
+ccnl_interest_timeout(void *ptr, void *interest)
+{
+    struct ccnl_relay_s *relay = (struct ccnl_relay_s*) ptr;
+    struct ccnl_interest_s *i = (struct ccnl_interest_s*) interest;
+    struct timeval now;
+    char s[CCNL_MAX_PREFIX_SIZE];
+    (void) s;
+
+    i->timer = NULL;
+    ccnl_get_timeval(&now);
+    // CONFORM: "Entries in the PIT MUST timeout rather
+    // than being held indefinitely."
+    if (timevaldelta(&i->expires, &now) <= 0 ||
+                            i->retries >= CCNL_MAX_INTEREST_RETRANSMIT) {
+#ifdef USE_NFN_REQUESTS
+        if (!ccnl_nfnprefix_isNFN(i->pkt->pfx)) {
+            DEBUGMSG_AGEING("AGING: REMOVE CCN INTEREST", "timeout: remove interest", s, CCNL_MAX_PREFIX_SIZE);
+#ifdef USE_STATS
+            ccnl_interest_expired(relay, i);
+#endif
+            ccnl_nfn_interest_remove(relay, i);
+            return;
+        } else if (ccnl_nfnprefix_isIntermediate(i->pkt->pfx)) {
+            DEBUGMSG_AGEING("AGING: REMOVE INTERMEDIATE INTEREST", "timeout: remove interest", s, CCNL_MAX_PREFIX_SIZE);
+#ifdef USE_STATS
+            ccnl_interest_expired(relay, i);
+#endif
+            ccnl_nfn_interest_remove(relay, i);
+            return;
+        } else if (!(ccnl_nfnprefix_isKeepalive(i->pkt->pfx))) {
+            if (i->keepalive == NULL) {
+                if (ccnl_nfn_already_computing(relay, i->pkt->pfx)) {
+                    DEBUGMSG_AGEING("AGING: KEEP ALIVE INTEREST", "timeout: already computing", s, CCNL_MAX_PREFIX_SIZE);
+                    ccnl_interest_refresh(i);
+                } else {
+                    DEBUGMSG_AGEING("AGING: KEEP ALIVE INTEREST", "timeout: request status info", s, CCNL_MAX_PREFIX_SIZE);
+                    ccnl_nfn_interest_keepalive(relay, i);
+                }
+            } else {
+                DEBUGMSG_AGEING("AGING: KEEP ALIVE INTEREST", "timeout: wait for status info", s, CCNL_MAX_PREFIX_SIZE);
+            }
+        } else {
+            DEBUGMSG_AGEING("AGING: REMOVE KEEP ALIVE INTEREST", "timeout: remove keep alive interest", s, CCNL_MAX_PREFIX_SIZE);
+            struct ccnl_interest_s *origin = i->keepalive_origin;
+#ifdef USE_STATS
+            ccnl_interest_expired(relay, origin);
+#endif
+            ccnl_nfn_interest_remove(relay, origin);
+            ccnl_nfn_interest_remove(relay, i);
+            return;
+        }
+#else // USE_NFN_REQUESTS
+        DEBUGMSG_AGEING("AGING: REMOVE INTEREST", "timeout: remove interest", s, CCNL_MAX_PREFIX_SIZE);
+#ifdef USE_STATS
+        ccnl_interest_expired(relay, i);
+#endif
+#ifdef USE_NFN
+        ccnl_nfn_interest_remove(relay, i);
+#else
+        ccnl_interest_remove(relay, i);
+#endif
+        return;
+#endif
+    } else {
+        // CONFORM: "A node MUST retransmit Interest Messages
+        // periodically for pending PIT entries."
+        DEBUGMSG_CORE(DEBUG, " retransmit %d <%s>\n", i->retries,
+                 ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE));
+#ifdef USE_NFN
+        if (i->flags & CCNL_PIT_COREPROPAGATES){
+#endif
+            DEBUGMSG_CORE(TRACE, "AGING: PROPAGATING INTEREST %p\n", (void*) i);
+            ccnl_interest_propagate(relay, i);
+#ifdef USE_NFN
+        }
+#endif
+
+        i->retries++;
+    }
+    ccnl_interest_schedule(relay, i);
+}
+
 struct ccnl_interest_s*
 ccnl_interest_new(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
                   struct ccnl_pkt_s **pkt)
@@ -314,8 +463,7 @@ ccnl_interest_new(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
 
-    struct ccnl_interest_s *i = (struct ccnl_interest_s *) ccnl_calloc(1,
-                                            sizeof(struct ccnl_interest_s));
+    struct ccnl_interest_s *i = ccnl_pool_alloc(CCNL_POOL_INTEREST);
     DEBUGMSG_CORE(TRACE,
                   "ccnl_new_interest(prefix=%s, suite=%s)\n",
                   ccnl_prefix_to_str((*pkt)->pfx, s, CCNL_MAX_PREFIX_SIZE),
@@ -323,14 +471,32 @@ ccnl_interest_new(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
 
     if (!i)
         return NULL;
+    i->node = ccnl_nametree_get(&ccnl->pit_index, (*pkt)->pfx,
+                                (*pkt)->pfx->compcnt);
+    if (!i->node) {
+        ccnl_pool_free(CCNL_POOL_INTEREST, i);
+        return NULL;
+    }
+    i->samename_next = (struct ccnl_interest_s*) i->node->entries;
+    if (i->samename_next)
+        i->samename_next->samename_prev = i;
+    i->node->entries = i;
     i->pkt = *pkt;
-    /* currently, the aging function relies on seconds rather than on milli seconds */
-    i->lifetime = (*pkt)->s.ndntlv.interestlifetime / 1000;
+    i->lifetime = CCNL_INTEREST_TIMEOUT * 1000;
+#ifdef USE_SUITE_NDNTLV
+    if (i->pkt->suite == CCNL_SUITE_NDNTLV)
+        i->lifetime = i->pkt->s.ndntlv.interestlifetime;
+#endif
     *pkt = NULL;
     i->flags |= CCNL_PIT_COREPROPAGATES;
-    i->from = from;
-    i->last_used = CCNL_NOW();
+    ccnl_interest_set_from(i, from);
+    ccnl_interest_refresh(i);
+#ifdef USE_STATS
+    ccnl_get_timeval(&i->created);
+#endif
     DBL_LINKED_LIST_ADD(ccnl->pit, i);
+    ccnl->pitcnt++;
+    ccnl_interest_schedule(ccnl, i);
 
     return i;
 }
@@ -352,28 +518,54 @@ ccnl_interest_remove(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
         return i->next;
 #endif
 */
+    ccnl_interest_set_from(i, NULL);
     while (i->pending) {
-        struct ccnl_pendint_s *tmp = i->pending->next;          \
-        ccnl_free(i->pending);
+        struct ccnl_pendint_s *tmp = i->pending->next;
+        ccnl_pendint_free(i->pending);
         i->pending = tmp;
     }
+    ccnl_rem_timer(i->timer);
+    i->timer = NULL;
     i2 = i->next;
     DBL_LINKED_LIST_REMOVE(ccnl->pit, i);
+    ccnl->pitcnt--;
+#ifdef USE_STATS
+    ccnl_interest_set_fwd(i, NULL);
+#endif
+    if (i->samename_prev)
+        i->samename_prev->samename_next = i->samename_next;
+    else
+        i->node->entries = i->samename_next;
+    if (i->samename_next)
+        i->samename_next->samename_prev = i->samename_prev;
+    ccnl_nametree_release(&ccnl->pit_index, i->node);
 
     if(i->pkt){
         ccnl_pkt_free(i->pkt);
     }
-    if(i){
-        ccnl_free(i);
-    }
+    ccnl_pool_free(CCNL_POOL_INTEREST, i);
     return i2;
 }
 
+struct ccnl_interest_s*
+ccnl_interest_lookup(struct ccnl_relay_s *ccnl, struct ccnl_pkt_s *pkt)
+{
+    struct ccnl_nametree_node_s *n;
+    struct ccnl_interest_s *i;
+
+    n = ccnl_nametree_find(&ccnl->pit_index, pkt->pfx, pkt->pfx->compcnt);
+    if (!n)
+        return NULL;
+    for (i = (struct ccnl_interest_s*) n->entries; i; i = i->samename_next)
+        if (ccnl_interest_isSame(i, pkt))
+            return i;
+    return NULL;
+}
+
 void
 ccnl_interest_propagate(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
 {
     struct ccnl_forward_s *fwd;
-    int rc = 0;
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
 
@@ -387,25 +579,18 @@ ccnl_interest_propagate(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
 
     // CONFORM: "A node MUST implement some strategy rule, even if it is only to
     // transmit an Interest Message on all listed dest faces in sequence."
-    // CCNL strategy: we forward on all FWD entries with a prefix match
+    // CCNL strategy: we forward on all FWD entries with the longest prefix match
 
-    for (fwd = ccnl->fib; fwd; fwd = fwd->next) {
-        if (!fwd->prefix)
-            continue;
-
-        //Only for matching suite
-        if (!i->pkt->pfx || fwd->suite != i->pkt->pfx->suite) {
-            DEBUGMSG_CORE(VERBOSE, "  not same suite (%d/%d)\n",
-                     fwd->suite, i->pkt->pfx ? i->pkt->pfx->suite : -1);
-            continue;
-        }
-
-        rc = ccnl_prefix_cmp(fwd->prefix, NULL, i->pkt->pfx, CMP_LONGEST);
-
-        DEBUGMSG_CORE(DEBUG, "  ccnl_interest_propagate, rc=%d/%d\n",
-                 rc, fwd->prefix->compcnt);
-        if (rc < fwd->prefix->compcnt)
-            continue;
+    if (!i->pkt->pfx)
+        return;
+#ifdef USE_SHARDS
+    // interests of local origin may carry a name of another shard
+    if (ccnl->shard_handoff && ccnl->shard_handoff(ccnl, i))
+        return;
+#endif
+    for (fwd = ccnl_fib_lookup(ccnl, i->pkt->pfx); fwd; fwd = fwd->samename_next) {
+        DEBUGMSG_CORE(DEBUG, "  ccnl_interest_propagate, match=%d/%d\n",
+                 fwd->prefix->compcnt, i->pkt->pfx->compcnt);
 
         DEBUGMSG_CORE(DEBUG, "  ccnl_interest_propagate, fwd==%p\n", (void*)fwd);
         // suppress forwarding to origin of interest, except wireless
@@ -431,6 +616,13 @@ ccnl_interest_propagate(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
                 (fwd->tap)(ccnl, i->from, i->pkt->pfx, i->pkt->buf);
             if (fwd->face)
                 ccnl_send_pkt(ccnl, fwd->face, i->pkt);
+#ifdef USE_STATS
+            if (fwd->face)
+                fwd->face->stats.interests_out++;
+            fwd->stats.interests_out++;
+            if (!i->fwd)
+                ccnl_interest_set_fwd(i, fwd);
+#endif
 #if defined(USE_NACK) || defined(USE_RONR)
             matching_face = 1;
 #endif
@@ -517,232 +709,404 @@ ccnl_interest_broadcast(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *inter
     }
 }
 
+// links c into the CS name index, returns -1 if out of memory
+static int
+ccnl_content_index(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    struct ccnl_nametree_node_s *n;
+
+    n = ccnl_nametree_get(&ccnl->cs_index, c->pkt->pfx, c->pkt->pfx->compcnt);
+    if (!n) {
+        DEBUGMSG_CORE(WARNING, "  could not index content, out of memory\n");
+        return -1;
+    }
+    c->node = n;
+    c->samename_prev = NULL;
+    c->samename_next = (struct ccnl_content_s*) n->entries;
+    if (c->samename_next)
+        c->samename_next->samename_prev = c;
+    n->entries = c;
+    return 0;
+}
+
+// the node is used instead of the name, the NFN code may temporarily
+// replace c->pkt
+static void
+ccnl_content_unindex(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    if (!c->node)
+        return;
+    if (c->samename_prev)
+        c->samename_prev->samename_next = c->samename_next;
+    else
+        c->node->entries = c->samename_next;
+    if (c->samename_next)
+        c->samename_next->samename_prev = c->samename_prev;
+    ccnl_nametree_release(&ccnl->cs_index, c->node);
+    c->node = NULL;
+    c->samename_next = c->samename_prev = NULL;
+}
+
 struct ccnl_content_s*
 ccnl_content_remove(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
 {
     struct ccnl_content_s *c2;
     DEBUGMSG_CORE(TRACE, "ccnl_content_remove\n");
 
+    ccnl_rem_timer(c->timer);
+    c->timer = NULL;
+    ccnl_cache_remove(ccnl, c);
     c2 = c->next;
     DBL_LINKED_LIST_REMOVE(ccnl->contents, c);
+    ccnl_content_unindex(ccnl, c);
 
 //    free_content(c);
-    if (c->pkt) {
-        ccnl_prefix_free(c->pkt->pfx);
-        ccnl_free(c->pkt->buf);
-        ccnl_free(c->pkt);
-    }
-    //    ccnl_prefix_free(c->name);
-    ccnl_free(c);
+    ccnl_content_free(c);
 
     ccnl->contentcnt--;
     return c2;
 }
 
-struct ccnl_content_s*
+static void
+ccnl_content_timeout(void *ptr, void *content)
+{
+    struct ccnl_relay_s *relay = (struct ccnl_relay_s*) ptr;
+    struct ccnl_content_s *c = (struct ccnl_content_s*) content;
+
+    c->timer = NULL;
+    if (c->flags & CCNL_CONTENT_FLAGS_STATIC) // made static after caching
+        return;
+    DEBUGMSG_CORE(TRACE, "AGING: CONTENT REMOVE %p\n", (void*) c);
+    ccnl_content_remove(relay, c);
+}
+
+int
 ccnl_content_add2cache(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
 {
-    struct ccnl_content_s *cit;
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
 
     DEBUGMSG_CORE(DEBUG, "ccnl_content_add2cache (%d/%d) --> %p = %s [%d]\n",
                   ccnl->contentcnt, ccnl->max_cache_entries,
                   (void*)c, ccnl_prefix_to_str(c->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE), (c->pkt->pfx->chunknum)? *(c->pkt->pfx->chunknum) : -1);
-    for (cit = ccnl->contents; cit; cit = cit->next) {
-        if (c == cit) {
-            DEBUGMSG_CORE(DEBUG, "--- Already in cache ---\n");
-            return NULL;
-        }
+    if (c->node) {
+        DEBUGMSG_CORE(DEBUG, "--- Already in cache ---\n");
+        return 0;
     }
 #ifdef USE_NACK
     if (ccnl_nfnprefix_contentIsNACK(c))
-        return NULL;
+        return -1;
+#endif
+    if (ccnl_cache_make_room(ccnl, c) < 0) {
+        DEBUGMSG_CORE(DEBUG, "  no room in the cache\n");
+        return -1;
+    }
+    // indexed first, so that there is nothing to undo if it fails
+    if (ccnl_content_index(ccnl, c) < 0)
+        return -1;
+    DBL_LINKED_LIST_ADD(ccnl->contents, c);
+    ccnl->contentcnt++;
+    ccnl_cache_insert(ccnl, c);
+    if (!(c->flags & CCNL_CONTENT_FLAGS_STATIC))
+        c->timer = ccnl_set_timer(CCNL_CONTENT_TIMEOUT * 1000000L,
+                                  ccnl_content_timeout, ccnl, c);
+
+    return 0;
+}
+
+static struct ccnl_content_s*
+ccnl_content_match(struct ccnl_relay_s *ccnl, struct ccnl_pkt_s *pkt,
+                   int (*cMatch)(struct ccnl_pkt_s*, struct ccnl_content_s*))
+{
+    struct ccnl_prefix_s *pfx = pkt->pfx;
+    struct ccnl_nametree_node_s *top, *n;
+    struct ccnl_content_s *c;
+    int maxsuffix;
+
+    top = ccnl_nametree_find(&ccnl->cs_index, pfx, pfx->compcnt);
+    if (top)
+        for (c = (struct ccnl_content_s*) top->entries; c; c = c->samename_next)
+            if (!cMatch(pkt, c))
+                return c;
+
+    switch (pfx->suite) {
+#ifdef USE_SUITE_CCNB
+    case CCNL_SUITE_CCNB:
+        maxsuffix = pkt->s.ccnb.maxsuffix;
+        break;
+#endif
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV:
+        maxsuffix = pkt->s.ndntlv.maxsuffix;
+        break;
 #endif
-    if (ccnl->max_cache_entries > 0 &&
-        ccnl->contentcnt >= ccnl->max_cache_entries) { // remove oldest content
-        struct ccnl_content_s *c2, *oldest = NULL;
-        uint32_t age = 0;
-        for (c2 = ccnl->contents; c2; c2 = c2->next) {
-             if (!(c2->flags & CCNL_CONTENT_FLAGS_STATIC)) {
-                 if ((age == 0) || c2->last_used < age) {
-                     age = c2->last_used;
-                     oldest = c2;
-                 }
-             }
-         }
-         if (oldest) {
-             DEBUGMSG_CORE(DEBUG, " remove old entry from cache\n");
-             ccnl_content_remove(ccnl, oldest);
-         }
+    default: // exact match only
+        return NULL;
     }
-    if ((ccnl->max_cache_entries <= 0) ||
-         (ccnl->contentcnt <= ccnl->max_cache_entries)) {
-            DBL_LINKED_LIST_ADD(ccnl->contents, c);
-            ccnl->contentcnt++;
+
+    // longer names, bounded by maxsuffix (which counts the digest)
+    if (top)
+        for (n = ccnl_nametree_next(top, top, pfx->compcnt + maxsuffix - 1);
+             n; n = ccnl_nametree_next(n, top, pfx->compcnt + maxsuffix - 1))
+            for (c = (struct ccnl_content_s*) n->entries; c;
+                                                        c = c->samename_next)
+                if (!cMatch(pkt, c))
+                    return c;
+
+    // the last component of the interest can be the content's digest
+    if (pfx->compcnt > 0) {
+        n = ccnl_nametree_find(&ccnl->cs_index, pfx, pfx->compcnt - 1);
+        if (n)
+            for (c = (struct ccnl_content_s*) n->entries; c;
+                                                        c = c->samename_next)
+                if (!cMatch(pkt, c))
+                    return c;
     }
 
+    return NULL;
+}
+
+struct ccnl_content_s*
+ccnl_content_lookup(struct ccnl_relay_s *ccnl, struct ccnl_pkt_s *pkt,
+                    int (*cMatch)(struct ccnl_pkt_s*, struct ccnl_content_s*))
+{
+    struct ccnl_content_s *c = ccnl_content_match(ccnl, pkt, cMatch);
+
+    if (c)
+        ccnl_cache_hit(ccnl, c);
+    else if (ccnl->ccnl_store_lookup_ptr)
+        c = ccnl->ccnl_store_lookup_ptr(ccnl, pkt, cMatch);
     return c;
 }
 
-int
-ccnl_content_serve_pending(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+struct ccnl_content_s*
+ccnl_content_find_dup(struct ccnl_relay_s *ccnl, struct ccnl_pkt_s *pkt)
 {
-    struct ccnl_interest_s *i;
-    struct ccnl_face_s *f;
+    struct ccnl_nametree_node_s *n;
+    struct ccnl_content_s *c;
+
+    n = ccnl_nametree_find(&ccnl->cs_index, pkt->pfx, pkt->pfx->compcnt);
+    if (!n)
+        return NULL;
+    for (c = (struct ccnl_content_s*) n->entries; c; c = c->samename_next)
+        if (buf_equal(c->pkt->buf, pkt->buf))
+            return c;
+    return NULL;
+}
+
+// serves c to the faces pending on PIT entry i and removes i,
+// returns the number of deliveries (0 if i does not match)
+static int
+ccnl_interest_serve(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i,
+                    struct ccnl_content_s *c)
+{
+    struct ccnl_pendint_s *pi;
     int cnt = 0;
-    DEBUGMSG_CORE(TRACE, "ccnl_content_serve_pending\n");
     char s[CCNL_MAX_PREFIX_SIZE];
+    (void) s;
 
- #ifdef USE_TIMEOUT_KEEPALIVE // TODO: shouldn't this be USE_NFN_REQUESTS?
-     if (ccnl_nfnprefix_isIntermediate(c->pkt->pfx)) {
-         return 1;   // don't forward incoming intermediate content, just cache
-     }
- #endif
-
-    for (f = ccnl->faces; f; f = f->next){
-                f->flags &= ~CCNL_FACE_FLAGS_SERVED; // reply on a face only once
-    }
-    for (i = ccnl->pit; i;) {
-        struct ccnl_pendint_s *pi;
-        if (!i->pkt->pfx)
-            continue;
+    if (!i->pkt->pfx)
+        return 0;
 
 #ifdef USE_NFN_REQUESTS
-        if (ccnl_nfnprefix_isKeepalive(i->pkt->pfx) != ccnl_nfnprefix_isKeepalive(c->pkt->pfx)) {
-            i = i->next;
-            continue;
-        }
-        if (ccnl_nfnprefix_isIntermediate(i->pkt->pfx) != ccnl_nfnprefix_isIntermediate(c->pkt->pfx)) {
-            i = i->next;
-            continue;
-        }
+    if (ccnl_nfnprefix_isKeepalive(i->pkt->pfx) != ccnl_nfnprefix_isKeepalive(c->pkt->pfx))
+        return 0;
+    if (ccnl_nfnprefix_isIntermediate(i->pkt->pfx) != ccnl_nfnprefix_isIntermediate(c->pkt->pfx))
+        return 0;
 #endif
 
-        switch (i->pkt->pfx->suite) {
+    switch (i->pkt->pfx->suite) {
 #ifdef USE_SUITE_CCNB
-        case CCNL_SUITE_CCNB:
-            if (!ccnl_i_prefixof_c(i->pkt->pfx, i->pkt->s.ccnb.minsuffix,
-                       i->pkt->s.ccnb.maxsuffix, c)) {
-                // XX must also check i->ppkd
-                i = i->next;
-                continue;
-            }
-            break;
+    case CCNL_SUITE_CCNB:
+        if (!ccnl_i_prefixof_c(i->pkt->pfx, i->pkt->s.ccnb.minsuffix,
+                   i->pkt->s.ccnb.maxsuffix, c)) {
+            // XX must also check i->ppkd
+            return 0;
+        }
+        break;
 #endif
 #ifdef USE_SUITE_CCNTLV
-        case CCNL_SUITE_CCNTLV:
-            if (ccnl_prefix_cmp(c->pkt->pfx, NULL, i->pkt->pfx, CMP_EXACT)) {
-                // XX must also check keyid
-                i = i->next;
-                continue;
-            }
-            break;
+    case CCNL_SUITE_CCNTLV:
+        if (ccnl_prefix_cmp(c->pkt->pfx, NULL, i->pkt->pfx, CMP_EXACT)) {
+            // XX must also check keyid
+            return 0;
+        }
+        break;
 #endif
 #ifdef USE_SUITE_CISTLV
-        case CCNL_SUITE_CISTLV:
-            if (ccnl_prefix_cmp(c->pkt->pfx, NULL, i->pkt->pfx, CMP_EXACT)) {
-                // XX must also check keyid
-                i = i->next;
-                continue;
-            }
-            break;
+    case CCNL_SUITE_CISTLV:
+        if (ccnl_prefix_cmp(c->pkt->pfx, NULL, i->pkt->pfx, CMP_EXACT)) {
+            // XX must also check keyid
+            return 0;
+        }
+        break;
 #endif
 #ifdef USE_SUITE_IOTTLV
-        case CCNL_SUITE_IOTTLV:
-          if (ccnl_prefix_cmp(c->pkt->pfx, NULL, i->pkt->pfx, CMP_EXACT)) {
-                // XX must also check keyid
-                i = i->next;
-                continue;
-            }
-            break;
+    case CCNL_SUITE_IOTTLV:
+      if (ccnl_prefix_cmp(c->pkt->pfx, NULL, i->pkt->pfx, CMP_EXACT)) {
+            // XX must also check keyid
+            return 0;
+        }
+        break;
 #endif
 #ifdef USE_SUITE_NDNTLV
-        case CCNL_SUITE_NDNTLV:
-            if (!ccnl_i_prefixof_c(i->pkt->pfx, i->pkt->s.ndntlv.minsuffix,
-                       i->pkt->s.ndntlv.maxsuffix, c)) {
-                // XX must also check i->ppkl,
-                i = i->next;
-                continue;
-            }
-            break;
-#endif
-        default:
-            i = i->next;
-            continue;
+    case CCNL_SUITE_NDNTLV:
+        if (!ccnl_i_prefixof_c(i->pkt->pfx, i->pkt->s.ndntlv.minsuffix,
+                   i->pkt->s.ndntlv.maxsuffix, c)) {
+            // XX must also check i->ppkl,
+            return 0;
         }
+        break;
+#endif
+    default:
+        return 0;
+    }
 
-        //Hook for add content to cache by callback:
-        if(i && ! i->pending){
-            DEBUGMSG_CORE(WARNING, "releasing interest 0x%p OK?\n", (void*)i);
-            c->flags |= CCNL_CONTENT_FLAGS_STATIC;
-            i = ccnl_interest_remove(ccnl, i);
-
-            c->served_cnt++;
-            cnt++;
-            continue;
-            //return 1;
+    //Hook for add content to cache by callback:
+    if(! i->pending){
+        DEBUGMSG_CORE(WARNING, "releasing interest 0x%p OK?\n", (void*)i);
+        c->flags |= CCNL_CONTENT_FLAGS_STATIC;
+#ifdef USE_STATS
+        ccnl_interest_satisfied(ccnl, i);
+#endif
+        ccnl_interest_remove(ccnl, i);
 
-        }
+        c->served_cnt++;
+        return 1;
+    }
 
-        // CONFORM: "Data MUST only be transmitted in response to
-        // an Interest that matches the Data."
-        for (pi = i->pending; pi; pi = pi->next) {
-            if (pi->face->flags & CCNL_FACE_FLAGS_SERVED)
-                continue;
-            pi->face->flags |= CCNL_FACE_FLAGS_SERVED;
-            if (pi->face->ifndx >= 0) {
-                int32_t nonce = 0;
-                if (i->pkt != NULL && i->pkt->s.ndntlv.nonce != NULL) {
-                    if (i->pkt->s.ndntlv.nonce->datalen == 4) {
-                        memcpy(&nonce, i->pkt->s.ndntlv.nonce->data, 4);
-                    }
+    // CONFORM: "Data MUST only be transmitted in response to
+    // an Interest that matches the Data."
+    for (pi = i->pending; pi; pi = pi->next) {
+        if (pi->face->flags & CCNL_FACE_FLAGS_SERVED)
+            continue;
+        pi->face->flags |= CCNL_FACE_FLAGS_SERVED;
+        if (pi->face->ifndx >= 0) {
+            int32_t nonce = 0;
+            if (i->pkt != NULL && i->pkt->s.ndntlv.nonce != NULL) {
+                if (i->pkt->s.ndntlv.nonce->datalen == 4) {
+                    memcpy(&nonce, i->pkt->s.ndntlv.nonce->data, 4);
                 }
+            }
 
 #ifdef USE_NFN_REQUESTS
-                struct ccnl_pkt_s *pkt = c->pkt;
-                int matches_start_request = ccnl_nfnprefix_isRequest(i->pkt->pfx)
-                                            && i->pkt->pfx->request->type == NFN_REQUEST_TYPE_START;
-                if (matches_start_request) {
-                    nfn_request_content_set_prefix(c, i->pkt->pfx);
-                }
+            struct ccnl_pkt_s *pkt = c->pkt;
+            int matches_start_request = ccnl_nfnprefix_isRequest(i->pkt->pfx)
+                                        && i->pkt->pfx->request->type == NFN_REQUEST_TYPE_START;
+            if (matches_start_request) {
+                nfn_request_content_set_prefix(c, i->pkt->pfx);
+            }
 #endif
 #ifndef CCNL_LINUXKERNEL
-                DEBUGMSG_CFWD(INFO, "  outgoing data=<%s>%s nonce=%"PRIi32" to=%s\n",
-                          ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE),
-                          ccnl_suite2str(i->pkt->pfx->suite), nonce,
-                          ccnl_addr2ascii(&pi->face->peer));
+            DEBUGMSG_CFWD(INFO, "  outgoing data=<%s>%s nonce=%"PRIi32" to=%s\n",
+                      ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE),
+                      ccnl_suite2str(i->pkt->pfx->suite), nonce,
+                      ccnl_addr2ascii(&pi->face->peer));
 #else
-                DEBUGMSG_CFWD(INFO, "  outgoing data=<%s>%s nonce=%d to=%s\n",
-                          ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE),
-                          ccnl_suite2str(i->pkt->pfx->suite), nonce,
-                          ccnl_addr2ascii(&pi->face->peer));
+            DEBUGMSG_CFWD(INFO, "  outgoing data=<%s>%s nonce=%d to=%s\n",
+                      ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE),
+                      ccnl_suite2str(i->pkt->pfx->suite), nonce,
+                      ccnl_addr2ascii(&pi->face->peer));
 #endif
-                DEBUGMSG_CORE(VERBOSE, "    Serve to face: %d (pkt=%p)\n",
-                         pi->face->faceid, (void*) c->pkt);
+            DEBUGMSG_CORE(VERBOSE, "    Serve to face: %d (pkt=%p)\n",
+                     pi->face->faceid, (void*) c->pkt);
 #ifdef USE_NFN_MONITOR
-                ccnl_nfn_monitor(ccnl, pi->face, c->pkt->pfx,
-                                 c->pkt->content, c->pkt->contlen);
+            ccnl_nfn_monitor(ccnl, pi->face, c->pkt->pfx,
+                             c->pkt->content, c->pkt->contlen);
 #endif
 
-                ccnl_send_pkt(ccnl, pi->face, c->pkt);
+            ccnl_send_pkt(ccnl, pi->face, c->pkt);
+#ifdef USE_STATS
+            pi->face->stats.data_out++;
+#endif
 
 #ifdef USE_NFN_REQUESTS
-                if (matches_start_request) {
-                    ccnl_pkt_free(c->pkt);
-                    c->pkt = pkt;
-                }
+            if (matches_start_request) {
+                ccnl_pkt_free(c->pkt);
+                c->pkt = pkt;
+            }
 #endif
 
-            } else {// upcall to deliver content to local client
+        } else {// upcall to deliver content to local client
 #ifdef CCNL_APP_RX
-                ccnl_app_RX(ccnl, c);
+            ccnl_app_RX(ccnl, c);
 #endif
+        }
+        c->served_cnt++;
+        cnt++;
+    }
+#ifdef USE_STATS
+    ccnl_interest_satisfied(ccnl, i);
+#endif
+    ccnl_interest_remove(ccnl, i);
+
+    return cnt;
+}
+
+// serves c to all PIT entries with the name of PIT index node n
+static int
+ccnl_interest_serve_node(struct ccnl_relay_s *ccnl,
+                         struct ccnl_nametree_node_s *n,
+                         struct ccnl_content_s *c)
+{
+    struct ccnl_interest_s *i, *i2;
+    int cnt = 0;
+
+    for (i = (struct ccnl_interest_s*) n->entries; i; i = i2) {
+        i2 = i->samename_next;
+        cnt += ccnl_interest_serve(ccnl, i, c);
+    }
+    return cnt;
+}
+
+int
+ccnl_content_serve_pending(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    struct ccnl_prefix_s *pfx = c->pkt->pfx;
+    struct ccnl_nametree_node_s *n, *last = NULL, *n2;
+    struct ccnl_face_s *f;
+    int cnt = 0;
+    DEBUGMSG_CORE(TRACE, "ccnl_content_serve_pending\n");
+
+ #ifdef USE_TIMEOUT_KEEPALIVE // TODO: shouldn't this be USE_NFN_REQUESTS?
+     if (ccnl_nfnprefix_isIntermediate(c->pkt->pfx)) {
+         return 1;   // don't forward incoming intermediate content, just cache
+     }
+ #endif
+
+    for (f = ccnl->faces; f; f = f->next){
+                f->flags &= ~CCNL_FACE_FLAGS_SERVED; // reply on a face only once
+    }
+
+    // only PIT entries whose name is a prefix of the content name, or the
+    // content name plus one component (the digest), can match
+    for (n = ccnl_nametree_find(&ccnl->pit_index, pfx, 0); n;
+         n = ccnl_nametree_child(&ccnl->pit_index, n, pfx->comp[n->depth],
+                                 pfx->complen[n->depth])) {
+        last = n;
+        if (n->depth == pfx->compcnt)
+            break;
+    }
+    if (last) {
+        // the reference keeps last and its ancestors alive while
+        // satisfied entries are removed
+        last->refs++;
+        if (last->depth == pfx->compcnt) {
+            n = last->child;
+            if (n)
+                n->refs++;
+            while (n) {
+                cnt += ccnl_interest_serve_node(ccnl, n, c);
+                n2 = n->sibling;
+                if (n2)
+                    n2->refs++;
+                ccnl_nametree_release(&ccnl->pit_index, n);
+                n = n2;
             }
-            c->served_cnt++;
-            cnt++;
         }
-        i = ccnl_interest_remove(ccnl, i);
+        for (n = last; n; n = n->parent)
+            cnt += ccnl_interest_serve_node(ccnl, n, c);
+        ccnl_nametree_release(&ccnl->pit_index, last);
     }
 
 #ifdef USE_NFN_REQUESTS
@@ -753,100 +1117,17 @@ ccnl_content_serve_pending(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
     return cnt;
 }
 
-#define DEBUGMSG_AGEING(trace, debug, buf, buf_len)    \
-DEBUGMSG_CORE(TRACE, "%s %p\n", (trace), (void*) i);   \
-DEBUGMSG_CORE(DEBUG, " %s 0x%p <%s>\n", (debug),       \
-    (void*)i,                                          \
-    ccnl_prefix_to_str(i->pkt->pfx,buf,buf_len));
-
 void
 ccnl_do_ageing(void *ptr, void *dummy)
 {
 
     struct ccnl_relay_s *relay = (struct ccnl_relay_s*) ptr;
-    struct ccnl_content_s *c = relay->contents;
-    struct ccnl_interest_s *i = relay->pit;
     struct ccnl_face_s *f = relay->faces;
     time_t t = CCNL_NOW();
     DEBUGMSG_CORE(VERBOSE, "ageing t=%d\n", (int)t);
     (void) dummy;
-    char s[CCNL_MAX_PREFIX_SIZE];
-    (void) s;
-
-    while (c) {
-        if ((c->last_used + CCNL_CONTENT_TIMEOUT) <= (uint32_t) t &&
-                                !(c->flags & CCNL_CONTENT_FLAGS_STATIC)){
-            DEBUGMSG_CORE(TRACE, "AGING: CONTENT REMOVE %p\n", (void*) c);
-            c = ccnl_content_remove(relay, c);
-        }
-        else {
-#ifdef USE_SUITE_NDNTLV
-            if (c->pkt->suite == CCNL_SUITE_NDNTLV) {
-                if ((c->last_used + (c->pkt->s.ndntlv.freshnessperiod / 1000)) <= (uint32_t) t) {
-                    c->stale = true;
-                }
-            }
-#endif
-            c = c->next;
-        }
-    }
-    while (i) { // CONFORM: "Entries in the PIT MUST timeout rather
-                // than being held indefinitely."
-        if ((i->last_used + i->lifetime) <= (uint32_t) t ||
-                                i->retries >= CCNL_MAX_INTEREST_RETRANSMIT) {
-#ifdef USE_NFN_REQUESTS
-                if (!ccnl_nfnprefix_isNFN(i->pkt->pfx)) {
-                    DEBUGMSG_AGEING("AGING: REMOVE CCN INTEREST", "timeout: remove interest", s, CCNL_MAX_PREFIX_SIZE);
-                    i = ccnl_nfn_interest_remove(relay, i);
-                } else if (ccnl_nfnprefix_isIntermediate(i->pkt->pfx)) {
-                    DEBUGMSG_AGEING("AGING: REMOVE INTERMEDIATE INTEREST", "timeout: remove interest", s, CCNL_MAX_PREFIX_SIZE);
-                    i = ccnl_nfn_interest_remove(relay, i);
-                } else if (!(ccnl_nfnprefix_isKeepalive(i->pkt->pfx))) {
-                    if (i->keepalive == NULL) {
-                        if (ccnl_nfn_already_computing(relay, i->pkt->pfx)) {
-                            DEBUGMSG_AGEING("AGING: KEEP ALIVE INTEREST", "timeout: already computing", s, CCNL_MAX_PREFIX_SIZE);
-                            i->last_used = CCNL_NOW();
-                            i->retries = 0;
-                        } else {
-                            DEBUGMSG_AGEING("AGING: KEEP ALIVE INTEREST", "timeout: request status info", s, CCNL_MAX_PREFIX_SIZE);
-                            ccnl_nfn_interest_keepalive(relay, i);
-                        }
-                    } else {
-                        DEBUGMSG_AGEING("AGING: KEEP ALIVE INTEREST", "timeout: wait for status info", s, CCNL_MAX_PREFIX_SIZE);
-                    }
-                    i = i->next;
-                } else {
-                    DEBUGMSG_AGEING("AGING: REMOVE KEEP ALIVE INTEREST", "timeout: remove keep alive interest", s, CCNL_MAX_PREFIX_SIZE);
-                    struct ccnl_interest_s *origin = i->keepalive_origin;
-                    ccnl_nfn_interest_remove(relay, origin);
-                    i = ccnl_nfn_interest_remove(relay, i);
-                }
-#else // USE_NFN_REQUESTS
-                DEBUGMSG_AGEING("AGING: REMOVE INTEREST", "timeout: remove interest", s, CCNL_MAX_PREFIX_SIZE);
-#ifdef USE_NFN
-                i = ccnl_nfn_interest_remove(relay, i);
-#else
-                i = ccnl_interest_remove(relay, i);
-#endif
-#endif
-        } else {
-            // CONFORM: "A node MUST retransmit Interest Messages
-            // periodically for pending PIT entries."
-            DEBUGMSG_CORE(DEBUG, " retransmit %d <%s>\n", i->retries,
-                     ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE));
-#ifdef USE_NFN
-            if (i->flags & CCNL_PIT_COREPROPAGATES){
-#endif
-                DEBUGMSG_CORE(TRACE, "AGING: PROPAGATING INTEREST %p\n", (void*) i);
-                ccnl_interest_propagate(relay, i);
-#ifdef USE_NFN
-            }
-#endif
 
-            i->retries++;
-            i = i->next;
-        }
-    }
+    // PIT entries and cached content expire by their own timers
     while (f) {
         if (!(f->flags & CCNL_FACE_FLAGS_STATIC) &&
                 (f->last_used + CCNL_FACE_TIMEOUT) <= t){
@@ -858,53 +1139,81 @@ ccnl_do_ageing(void *ptr, void *dummy)
     }
 }
 
+// FNV-1a, 0 is reserved for empty slots
+static uint64_t
+ccnl_nonce_hash(struct ccnl_buf_s *nonce)
+{
+    uint64_t h = 14695981039346656037ULL;
+    ssize_t i;
+
+    for (i = 0; i < nonce->datalen; i++) {
+        h ^= nonce->data[i];
+        h *= 1099511628211ULL;
+    }
+    return h ? h : 1;
+}
+
+// wrapping msec clock of the nonce table
+static uint32_t
+ccnl_nonce_now(void)
+{
+    struct timeval tv;
+
+    ccnl_get_timeval(&tv);
+    return (uint32_t) tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
 int
-ccnl_nonce_find_or_append(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *nonce)
+ccnl_nonce_find_or_append(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *nonce,
+                          uint32_t lifetime)
 {
-    struct ccnl_buf_s *n, *n2 = 0;
-    int i;
+    uint64_t h = ccnl_nonce_hash(nonce);
+    uint32_t now = ccnl_nonce_now();
+    struct ccnl_nonce_s *n, *slot = NULL;
+    int i, k = (int) ((h ^ (h >> 32)) & (CCNL_MAX_NONCES - 1));
     DEBUGMSG_CORE(TRACE, "ccnl_nonce_find_or_append\n");
 
-    for (n = ccnl->nonces, i = 0; n; n = n->next, i++) {
-        if (buf_equal(n, nonce))
-            return -1;
-        if (n->next)
-            n2 = n;
-    }
-    n = ccnl_buf_new(nonce->data, nonce->datalen);
-    if (n) {
-        n->next = ccnl->nonces;
-        ccnl->nonces = n;
-        if (i >= CCNL_MAX_NONCES && n2) {
-            ccnl_free(n2->next);
-            n2->next = 0;
+    // a nonce is always stored within CCNL_NONCE_PROBES slots of its home
+    // slot: in an unused or expired one, else in the one expiring first
+    for (i = 0; i < CCNL_NONCE_PROBES; i++) {
+        n = ccnl->nonces + ((k + i) & (CCNL_MAX_NONCES - 1));
+        if (!n->hash) { // its expires is 0, in the future half of the time
+            if (!slot || slot->hash)
+                slot = n;
+            break;
+        }
+        if ((int32_t) (n->expires - now) <= 0) {
+            if (!slot || (int32_t) (slot->expires - now) > 0)
+                slot = n;
+            continue;
         }
+        if (n->hash == h)
+            return -1;
+        if (!slot || (int32_t) (n->expires - slot->expires) < 0)
+            slot = n;
     }
+    if (lifetime > INT32_MAX)
+        lifetime = INT32_MAX;
+    slot->hash = h;
+    slot->expires = now + lifetime;
     return 0;
 }
 
 int
 ccnl_nonce_isDup(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt)
 {
-    if(CCNL_MAX_NONCES < 0){
-        struct ccnl_interest_s *i = NULL;
-        for (i = relay->pit; i; i = i->next) {
-            if(buf_equal(i->pkt->s.ndntlv.nonce, pkt->s.ndntlv.nonce)){
-                return 1;
-            }
-        }
-        return 0;
-    }
     switch (pkt->suite) {
 #ifdef USE_SUITE_CCNB
     case CCNL_SUITE_CCNB:
         return pkt->s.ccnb.nonce &&
-            ccnl_nonce_find_or_append(relay, pkt->s.ccnb.nonce);
+            ccnl_nonce_find_or_append(relay, pkt->s.ccnb.nonce,
+                                      CCNL_INTEREST_TIMEOUT * 1000);
 #endif
 #ifdef USE_SUITE_NDNTLV
     case CCNL_SUITE_NDNTLV:
         return pkt->s.ndntlv.nonce &&
-            ccnl_nonce_find_or_append(relay, pkt->s.ndntlv.nonce);
+            ccnl_nonce_find_or_append(relay, pkt->s.ndntlv.nonce,
+                                      pkt->s.ndntlv.interestlifetime);
 #endif
     default:
         break;
@@ -912,6 +1221,129 @@ ccnl_nonce_isDup(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt)
     return 0;
 }
 
+// keeps the FIB entries of a face listed at the face
+static void
+ccnl_fib_face_link(struct ccnl_forward_s *fwd)
+{
+    fwd->face_prev = NULL;
+    fwd->face_next = NULL;
+    if (!fwd->face)
+        return;
+    fwd->face_next = fwd->face->fwds;
+    if (fwd->face_next)
+        fwd->face_next->face_prev = fwd;
+    fwd->face->fwds = fwd;
+}
+
+static void
+ccnl_fib_face_unlink(struct ccnl_forward_s *fwd)
+{
+    if (!fwd->face)
+        return;
+    if (fwd->face_prev)
+        fwd->face_prev->face_next = fwd->face_next;
+    else
+        fwd->face->fwds = fwd->face_next;
+    if (fwd->face_next)
+        fwd->face_next->face_prev = fwd->face_prev;
+    fwd->face_next = fwd->face_prev = NULL;
+}
+
+int
+ccnl_fib_link(struct ccnl_relay_s *relay, struct ccnl_forward_s *fwd)
+{
+    struct ccnl_forward_s *first;
+
+    fwd->node = ccnl_nametree_get(&relay->fib_index, fwd->prefix,
+                                  fwd->prefix->compcnt);
+    if (!fwd->node)
+        return -1;
+    // append, entries with the same name are used in the order of adding
+    fwd->samename_next = NULL;
+    first = (struct ccnl_forward_s*) fwd->node->entries;
+    if (first) {
+        fwd->samename_prev = first->samename_prev;
+        fwd->samename_prev->samename_next = fwd;
+        first->samename_prev = fwd;
+    } else {
+        fwd->node->entries = fwd;
+        fwd->samename_prev = fwd;
+    }
+    fwd->prev = NULL;
+    DBL_LINKED_LIST_ADD(relay->fib, fwd);
+    ccnl_fib_face_link(fwd);
+#ifdef USE_SHARDS
+    relay->fib_gen++;
+#endif
+
+    return 0;
+}
+
+struct ccnl_forward_s*
+ccnl_fib_unlink(struct ccnl_relay_s *relay, struct ccnl_forward_s *fwd)
+{
+    struct ccnl_forward_s *fwd2 = fwd->next;
+
+#ifdef USE_STATS
+    // PIT entries sent on it no longer count for it
+    while (fwd->interests)
+        ccnl_interest_set_fwd(fwd->interests, NULL);
+#endif
+
+    DBL_LINKED_LIST_REMOVE(relay->fib, fwd);
+    fwd->next = fwd->prev = NULL;
+    ccnl_fib_face_unlink(fwd);
+#ifdef USE_SHARDS
+    relay->fib_gen++;
+#endif
+    if (fwd->node) {
+        struct ccnl_forward_s *first = fwd->node->entries;
+
+        if (fwd == first)
+            fwd->node->entries = fwd->samename_next;
+        else
+            fwd->samename_prev->samename_next = fwd->samename_next;
+        if (fwd->samename_next)
+            fwd->samename_next->samename_prev = fwd->samename_prev;
+        else if (fwd != first) // the last one
+            first->samename_prev = fwd->samename_prev;
+        ccnl_nametree_release(&relay->fib_index, fwd->node);
+        fwd->node = NULL;
+        fwd->samename_next = fwd->samename_prev = NULL;
+    }
+
+    return fwd2;
+}
+
+struct ccnl_forward_s*
+ccnl_fib_lookup(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx)
+{
+    struct ccnl_nametree_node_s *n;
+    struct ccnl_forward_s *fwd = NULL;
+
+    // descend along the name, remembering the deepest registered prefix
+    n = ccnl_nametree_find(&relay->fib_index, pfx, 0);
+    while (n) {
+        if (n->entries)
+            fwd = (struct ccnl_forward_s*) n->entries;
+        if (n->depth >= pfx->compcnt)
+            break;
+        n = ccnl_nametree_child(&relay->fib_index, n, pfx->comp[n->depth],
+                                pfx->complen[n->depth]);
+    }
+
+    return fwd;
+}
+
+struct ccnl_forward_s*
+ccnl_fib_find(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx)
+{
+    struct ccnl_nametree_node_s *n;
+
+    n = ccnl_nametree_find(&relay->fib_index, pfx, pfx->compcnt);
+    return n ? (struct ccnl_forward_s*) n->entries : NULL;
+}
+
 #ifdef NEEDS_PREFIX_MATCHING
 
 /* add a new entry to the FIB */
@@ -919,33 +1351,36 @@ int
 ccnl_fib_add_entry(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
                    struct ccnl_face_s *face)
 {
-    struct ccnl_forward_s *fwd, **fwd2;
+    struct ccnl_forward_s *fwd;
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
 
     DEBUGMSG_CUTL(INFO, "adding FIB for <%s>, suite %s\n",
              ccnl_prefix_to_str(pfx,s,CCNL_MAX_PREFIX_SIZE), ccnl_suite2str(pfx->suite));
 
-    for (fwd = relay->fib; fwd; fwd = fwd->next) {
-        if (fwd->suite == pfx->suite &&
-                        !ccnl_prefix_cmp(fwd->prefix, NULL, pfx, CMP_EXACT)) {
-            ccnl_prefix_free(fwd->prefix);
-            fwd->prefix = NULL;
-            break;
-        }
-    }
-    if (!fwd) {
+    fwd = ccnl_fib_find(relay, pfx);
+    if (fwd) {
+        // same name, the prefix is swapped without touching the index
+        ccnl_prefix_free(fwd->prefix);
+        fwd->prefix = pfx;
+        ccnl_fib_face_unlink(fwd);
+        fwd->face = face;
+        ccnl_fib_face_link(fwd);
+#ifdef USE_SHARDS
+        relay->fib_gen++;
+#endif
+    } else {
         fwd = (struct ccnl_forward_s *) ccnl_calloc(1, sizeof(*fwd));
         if (!fwd)
             return -1;
-        fwd2 = &relay->fib;
-        while (*fwd2)
-            fwd2 = &((*fwd2)->next);
-        *fwd2 = fwd;
         fwd->suite = pfx->suite;
+        fwd->prefix = pfx;
+        fwd->face = face;
+        if (ccnl_fib_link(relay, fwd)) {
+            ccnl_free(fwd);
+            return -1;
+        }
     }
-    fwd->prefix = pfx;
-    fwd->face = face;
     DEBUGMSG_CUTL(DEBUG, "added FIB via %s\n", ccnl_addr2ascii(&fwd->face->peer));
 
     return 0;
@@ -957,36 +1392,30 @@ ccnl_fib_rem_entry(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
                    struct ccnl_face_s *face)
 {
     struct ccnl_forward_s *fwd;
-    int res = -1;
-    struct ccnl_forward_s *last = NULL;
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
 
     if (pfx != NULL) {
-        char *s = NULL;
         DEBUGMSG_CUTL(INFO, "removing FIB for <%s>, suite %s\n",
                       ccnl_prefix_to_str(pfx,s,CCNL_MAX_PREFIX_SIZE), ccnl_suite2str(pfx->suite));
+        fwd = ccnl_fib_find(relay, pfx);
+        while (fwd && face && fwd->face != face)
+            fwd = fwd->samename_next;
+    } else {
+        for (fwd = relay->fib; fwd; fwd = fwd->next)
+            if ((face == NULL) || (fwd->face == face))
+                break;
     }
+    if (!fwd)
+        return -1;
 
-    for (fwd = relay->fib; fwd; last = fwd, fwd = fwd->next) {
-        if (((pfx == NULL) || (fwd->suite == pfx->suite)) &&
-            ((pfx == NULL) || !ccnl_prefix_cmp(fwd->prefix, NULL, pfx, CMP_EXACT)) &&
-            ((face == NULL) || (fwd->face == face))) {
-            res = 0;
-            if (!last) {
-                relay->fib = fwd->next;
-            }
-            else {
-                last->next = fwd->next;
-            }
-            ccnl_prefix_free(fwd->prefix);
-            ccnl_free(fwd);
-            break;
-        }
-    }
-    DEBUGMSG_CUTL(DEBUG, "added FIB via %s\n", ccnl_addr2ascii(&fwd->face->peer));
+    DEBUGMSG_CUTL(DEBUG, "removed FIB via %s\n",
+                  fwd->face ? ccnl_addr2ascii(&fwd->face->peer) : "<tap>");
+    ccnl_fib_unlink(relay, fwd);
+    ccnl_prefix_free(fwd->prefix);
+    ccnl_free(fwd);
 
-    return res;
+    return 0;
 }
 #endif
 
@@ -1046,30 +1475,27 @@ ccnl_interface_CTS(void *aux1, void *aux2)
 {
     struct ccnl_relay_s *ccnl = (struct ccnl_relay_s *)aux1;
     struct ccnl_if_s *ifc = (struct ccnl_if_s *)aux2;
-    struct ccnl_txrequest_s *r, req;
+    struct ccnl_txrequest_s *r;
 
     DEBUGMSG_CORE(TRACE, "interface_CTS interface=%p, qlen=%d, sched=%p\n",
-             (void*)ifc, ifc->qlen, (void*)ifc->sched);
+             (void*)ifc, ifc->txq.qlen, (void*)ifc->sched);
 
-    if (ifc->qlen <= 0)
+    r = ccnl_txq_dequeue(&ifc->txq);
+    if (!r)
         return;
 
 #ifdef USE_STATS
     ifc->tx_cnt++;
 #endif
 
-    r = ifc->queue + ifc->qfront;
-    memcpy(&req, r, sizeof(req));
-    ifc->qfront = (ifc->qfront + 1) % CCNL_MAX_IF_QLEN;
-    ifc->qlen--;
 #ifndef CCNL_LINUXKERNEL
     assert(ccnl->ccnl_ll_TX_ptr != 0);
 #endif
-    ccnl->ccnl_ll_TX_ptr(ccnl, ifc, &req.dst, req.buf);
+    ccnl->ccnl_ll_TX_ptr(ccnl, ifc, &r->dst, r->buf);
 #ifdef USE_SCHEDULER
-    ccnl_sched_CTS_done(ifc->sched, 1, req.buf->datalen);
-    if (req.txdone)
-        req.txdone(req.txdone_face, 1, req.buf->datalen);
+    ccnl_sched_CTS_done(ifc->sched, 1, r->buf->datalen);
+    if (r->txdone)
+        r->txdone(r->txdone_face, 1, r->buf->datalen);
 #endif
-    ccnl_free(req.buf);
+    ccnl_txq_release(r);
 }
@@ -62,10 +62,10 @@ char*
 ccnl_addr2ascii(sockunion *su)
 {
 #ifdef USE_UNIXSOCKET
-    static char result[256];
+    static CCNL_THREAD_LOCAL char result[256];
 #else
     /* each byte requires 2 chars + 1 for the colon/slash + 6 for the protocol + 1 for \0 */
-    static char result[(CCNL_MAX_ADDRESS_LEN * 3) + 7];
+    static CCNL_THREAD_LOCAL char result[(CCNL_MAX_ADDRESS_LEN * 3) + 7];
 #endif
 
     if (!su)
@@ -192,11 +192,68 @@ ccnl_addr_cmp(sockunion *s1, sockunion *s2)
     return -1;
 }
 
+// FNV-1a
+static uint32_t
+ccnl_addr_hash_bytes(uint32_t h, const void *data, size_t len)
+{
+    const unsigned char *cp = data;
+
+    while (len--) {
+        h ^= *cp++;
+        h *= 16777619;
+    }
+    return h;
+}
+
+uint32_t
+ccnl_addr_hash(sockunion *su)
+{
+    uint32_t h = ccnl_addr_hash_bytes(2166136261u, &su->sa.sa_family,
+                                      sizeof(su->sa.sa_family));
+
+    switch (su->sa.sa_family) {
+#if defined(USE_LINKLAYER) && \
+    ((!defined(__FreeBSD__) && !defined(__APPLE__)) || \
+    (defined(CCNL_RIOT) && defined(__FreeBSD__)) ||  \
+    (defined(CCNL_RIOT) && defined(__APPLE__)) )
+        case AF_PACKET:
+            return ccnl_addr_hash_bytes(h, su->linklayer.sll_addr,
+                                        su->linklayer.sll_halen);
+#endif
+#ifdef USE_WPAN
+        case AF_IEEE802154:
+            return ccnl_addr_hash_bytes(h, &su->wpan.addr.pan_id,
+                                        sizeof(su->wpan.addr.pan_id));
+#endif
+#ifdef USE_IPV4
+        case AF_INET:
+            h = ccnl_addr_hash_bytes(h, &su->ip4.sin_addr.s_addr,
+                                     sizeof(su->ip4.sin_addr.s_addr));
+            return ccnl_addr_hash_bytes(h, &su->ip4.sin_port,
+                                        sizeof(su->ip4.sin_port));
+#endif
+#ifdef USE_IPV6
+        case AF_INET6:
+            h = ccnl_addr_hash_bytes(h, su->ip6.sin6_addr.s6_addr, 16);
+            return ccnl_addr_hash_bytes(h, &su->ip6.sin6_port,
+                                        sizeof(su->ip6.sin6_port));
+#endif
+#ifdef USE_UNIXSOCKET
+        case AF_UNIX:
+            return ccnl_addr_hash_bytes(h, su->ux.sun_path,
+                                        strlen(su->ux.sun_path));
+#endif
+        default:
+            break;
+    }
+    return h;
+}
+
 char*
 ll2ascii(unsigned char *addr, size_t len)
 {
     size_t i;
-    static char out[CCNL_LLADDR_STR_MAX_LEN + 1];
+    static CCNL_THREAD_LOCAL char out[CCNL_LLADDR_STR_MAX_LEN + 1];
 
     out[0] = '\0';
 
@@ -0,0 +1,70 @@
+/*
+ * @f ccnl-stats.c
+ * @b CCN lite (CCNL), forwarding counters per face, per route and per relay
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_LINUXKERNEL
+#include "ccnl-stats.h"
+#else
+#include <ccnl-stats.h>
+#endif
+
+int
+ccnl_stats_bucket(long usec)
+{
+    unsigned long v;
+    int b = 0;
+
+    if (usec <= CCNL_STATS_BUCKET_USEC)
+        return 0;
+    // one more than the bits of (usec - 1) / 64
+    v = (unsigned long) (usec - 1) / CCNL_STATS_BUCKET_USEC;
+    while (v && b < CCNL_STATS_BUCKETS - 1) {
+        v >>= 1;
+        b++;
+    }
+    return b;
+}
+
+long
+ccnl_stats_bucket_usec(int b)
+{
+    if (b < 0 || b >= CCNL_STATS_BUCKETS - 1)
+        return -1;
+    return (long) CCNL_STATS_BUCKET_USEC << b;
+}
+
+const char*
+ccnl_stats_drop2str(int reason)
+{
+    switch (reason) {
+    case CCNL_DROP_HOPLIMIT:
+        return "hoplimit";
+    case CCNL_DROP_DUPNONCE:
+        return "dupnonce";
+    case CCNL_DROP_UNSOLICITED:
+        return "unsolicited";
+    default:
+        break;
+    }
+    return "?";
+}
+
+// eof
@@ -0,0 +1,370 @@
+/*
+ * @f ccnl-txq.c
+ * @b CCN lite (CCNL), transmit queues of the interfaces
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_LINUXKERNEL
+#include "ccnl-txq.h"
+#include "ccnl-face.h"
+#include "ccnl-buf.h"
+#include "ccnl-pool.h"
+#include "ccnl-os-time.h"
+#include "ccnl-logging.h"
+#include <string.h>
+#else
+#include <ccnl-txq.h>
+#include <ccnl-face.h>
+#include <ccnl-buf.h>
+#include <ccnl-pool.h>
+#include <ccnl-os-time.h>
+#include <ccnl-logging.h>
+#endif
+
+// bytes at the end of a packet which are hashed for the duplicate table,
+// that is where nonces and signatures are
+#define CCNL_TXQ_HASHLEN        64
+
+static uint64_t
+ccnl_txq_now(void)
+{
+    struct timeval tv;
+
+    ccnl_get_timeval(&tv);
+    return (uint64_t) tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static uint32_t
+ccnl_txq_hash(struct ccnl_face_s *f, struct ccnl_buf_s *buf)
+{
+    uint32_t h = 2166136261u ^ (uint32_t) buf->datalen; // FNV-1a
+    ssize_t i = buf->datalen > CCNL_TXQ_HASHLEN ?
+                        buf->datalen - CCNL_TXQ_HASHLEN : 0;
+
+    for (; i < buf->datalen; i++) {
+        h ^= buf->data[i];
+        h *= 16777619u;
+    }
+    h ^= (uint32_t) (uintptr_t) f;
+    return h * 16777619u;
+}
+
+static struct ccnl_txrequest_s**
+ccnl_txq_bucket(struct ccnl_txq_s *q, uint32_t hash)
+{
+    return q->dups + ((hash ^ (hash >> 16)) & (CCNL_TXQ_BUCKETS - 1));
+}
+
+int
+ccnl_txq_find(struct ccnl_txq_s *q, struct ccnl_face_s *f,
+              struct ccnl_buf_s *buf)
+{
+    uint32_t hash = ccnl_txq_hash(f, buf);
+    struct ccnl_txrequest_s *r;
+
+    for (r = *ccnl_txq_bucket(q, hash); r; r = r->dup_next)
+        if (r->hash == hash && r->txdone_face == f && buf_equal(r->buf, buf))
+            return 1;
+    return 0;
+}
+
+static void
+ccnl_txq_unhash(struct ccnl_txq_s *q, struct ccnl_txrequest_s *r)
+{
+    struct ccnl_txrequest_s **pr = ccnl_txq_bucket(q, r->hash);
+
+    while (*pr != r)
+        pr = &(*pr)->dup_next;
+    *pr = r->dup_next;
+    r->dup_next = NULL;
+}
+
+static void
+ccnl_txq_activate(struct ccnl_txq_s *q, struct ccnl_txflow_s *fl)
+{
+    fl->txq = q;
+    fl->deficit = q->quantum > 0 ? q->quantum : CCNL_MAX_PACKET_SIZE;
+    fl->next = NULL;
+    if (q->active_tail)
+        q->active_tail->next = fl;
+    else
+        q->active = fl;
+    q->active_tail = fl;
+}
+
+static void
+ccnl_txq_deactivate(struct ccnl_txq_s *q, struct ccnl_txflow_s *fl)
+{
+    struct ccnl_txflow_s **pf = &q->active, *prev = NULL;
+
+    while (*pf != fl) {
+        prev = *pf;
+        pf = &prev->next;
+    }
+    *pf = fl->next;
+    if (q->active_tail == fl)
+        q->active_tail = prev;
+    fl->next = NULL;
+}
+
+static struct ccnl_txrequest_s*
+ccnl_txq_pop(struct ccnl_txq_s *q, struct ccnl_txflow_s *fl)
+{
+    struct ccnl_txrequest_s *r = fl->head;
+
+    if (!r)
+        return NULL;
+    fl->head = r->next;
+    if (!fl->head)
+        fl->tail = NULL;
+    fl->qlen--;
+    q->qlen--;
+    q->qbytes -= r->buf->datalen;
+    if (r->txdone_face)
+        ccnl_txq_unhash(q, r);
+    r->next = NULL;
+    return r;
+}
+
+void
+ccnl_txq_release(struct ccnl_txrequest_s *r)
+{
+    ccnl_buf_free(r->buf);
+    ccnl_pool_free(CCNL_POOL_TXREQ, r);
+}
+
+int
+ccnl_txq_enqueue(struct ccnl_txq_s *q, struct ccnl_face_s *f,
+                 struct ccnl_buf_s *buf, sockunion *dst,
+                 void (*txdone)(void*, int, int))
+{
+    struct ccnl_txflow_s *fl, *fat;
+    struct ccnl_txrequest_s *r;
+
+    if (q->qlen >= CCNL_MAX_IF_QLEN) { // drop the oldest of the longest flow
+        for (fat = fl = q->active; fl; fl = fl->next)
+            if (fl->qlen > fat->qlen)
+                fat = fl;
+        DEBUGMSG_CORE(WARNING, "  DROPPING buf=%p\n", (void*)fat->head->buf);
+        ccnl_txq_release(ccnl_txq_pop(q, fat));
+        if (!fat->head)
+            ccnl_txq_deactivate(q, fat);
+        q->drops++;
+    }
+    r = ccnl_pool_alloc(CCNL_POOL_TXREQ);
+    if (!r) {
+        ccnl_buf_free(buf);
+        q->drops++;
+        return -1;
+    }
+    fl = f ? &f->txflow : &q->flow;
+    if (fl->head && fl->txq != q) // the face has packets at another interface
+        fl = &q->flow;
+    r->buf = buf;
+    memcpy(&r->dst, dst, sizeof(sockunion));
+    r->txdone = txdone;
+    r->txdone_face = f;
+    r->enqueued = ccnl_txq_now();
+    if (f) {
+        struct ccnl_txrequest_s **bucket;
+        r->hash = ccnl_txq_hash(f, buf);
+        bucket = ccnl_txq_bucket(q, r->hash);
+        r->dup_next = *bucket;
+        *bucket = r;
+    }
+
+    if (fl->tail)
+        fl->tail->next = r;
+    else {
+        fl->head = r;
+        ccnl_txq_activate(q, fl);
+    }
+    fl->tail = r;
+    fl->qlen++;
+    q->qlen++;
+    q->qbytes += buf->datalen;
+    return 0;
+}
+
+// ----------------------------------------------------------------------
+// CoDel, see RFC 8289
+
+static uint32_t
+ccnl_txq_sqrt(uint32_t n)
+{
+    uint32_t r = 0, b = 1u << 30;
+
+    while (b > n)
+        b >>= 2;
+    for (; b; b >>= 2) {
+        if (n >= r + b) {
+            n -= r + b;
+            r = (r >> 1) + b;
+        } else
+            r >>= 1;
+    }
+    return r;
+}
+
+// the drops of a dropping state follow each other with interval/sqrt(count)
+static uint64_t
+ccnl_txq_control_law(uint64_t t, uint32_t count)
+{
+    return t + (uint32_t) CCNL_TXQ_INTERVAL / ccnl_txq_sqrt(count);
+}
+
+static int
+ccnl_txq_ok_to_drop(struct ccnl_txflow_s *fl, struct ccnl_txrequest_s *r,
+                    uint64_t now)
+{
+    // the last packet of a flow is always sent
+    if (now - r->enqueued < CCNL_TXQ_TARGET || !fl->head) {
+        fl->first_above = 0;
+        return 0;
+    }
+    if (!fl->first_above) {
+        fl->first_above = now + CCNL_TXQ_INTERVAL;
+        return 0;
+    }
+    return now >= fl->first_above;
+}
+
+static void
+ccnl_txq_drop(struct ccnl_txq_s *q, struct ccnl_txrequest_s *r)
+{
+    DEBUGMSG_CORE(DEBUG, "  CoDel drops buf=%p\n", (void*)r->buf);
+    ccnl_txq_release(r);
+    q->aqm_drops++;
+}
+
+static struct ccnl_txrequest_s*
+ccnl_txq_codel(struct ccnl_txq_s *q, struct ccnl_txflow_s *fl, uint64_t now)
+{
+    struct ccnl_txrequest_s *r = ccnl_txq_pop(q, fl);
+
+    if (!r)
+        return NULL;
+    if (fl->dropping) {
+        if (!ccnl_txq_ok_to_drop(fl, r, now))
+            fl->dropping = 0;
+        while (fl->dropping && now >= fl->drop_next) {
+            ccnl_txq_drop(q, r);
+            fl->dropcnt++;
+            r = ccnl_txq_pop(q, fl);
+            if (!ccnl_txq_ok_to_drop(fl, r, now))
+                fl->dropping = 0;
+            else
+                fl->drop_next = ccnl_txq_control_law(fl->drop_next,
+                                                     fl->dropcnt);
+        }
+    } else if (ccnl_txq_ok_to_drop(fl, r, now)) {
+        ccnl_txq_drop(q, r);
+        r = ccnl_txq_pop(q, fl);
+        fl->dropping = 1;
+        // start near the previous rate if the last dropping state was recent
+        if (fl->dropcnt > 2 &&
+                now < fl->drop_next + 16 * (uint64_t) CCNL_TXQ_INTERVAL)
+            fl->dropcnt -= 2;
+        else
+            fl->dropcnt = 1;
+        fl->drop_next = ccnl_txq_control_law(now, fl->dropcnt);
+    }
+    return r;
+}
+
+// ----------------------------------------------------------------------
+
+struct ccnl_txrequest_s*
+ccnl_txq_dequeue(struct ccnl_txq_s *q)
+{
+    struct ccnl_txflow_s *fl;
+    struct ccnl_txrequest_s *r;
+    uint64_t now = 0;
+
+    while ((fl = q->active) != NULL) {
+        if (fl->deficit < fl->head->buf->datalen) { // its turn is over
+            fl->deficit += q->quantum > 0 ? q->quantum : CCNL_MAX_PACKET_SIZE;
+            if (fl->next) {
+                q->active = fl->next;
+                fl->next = NULL;
+                q->active_tail->next = fl;
+                q->active_tail = fl;
+            }
+            continue;
+        }
+        if (!now)
+            now = ccnl_txq_now();
+        r = ccnl_txq_codel(q, fl, now);
+        if (!fl->head)
+            ccnl_txq_deactivate(q, fl);
+        if (r) {
+            fl->deficit -= r->buf->datalen;
+            q->sojourn = now - r->enqueued;
+            if (q->sojourn > q->sojourn_max)
+                q->sojourn_max = q->sojourn;
+            return r;
+        }
+    }
+    return NULL;
+}
+
+void
+ccnl_txq_orphan(struct ccnl_txq_s *q, struct ccnl_face_s *f)
+{
+    struct ccnl_txflow_s *fl = &f->txflow;
+    struct ccnl_txrequest_s *r;
+
+    // packets which went to the flow without a face, see ccnl_txq_enqueue
+    for (r = q->flow.head; r; r = r->next)
+        if (r->txdone_face == f) {
+            ccnl_txq_unhash(q, r);
+            r->txdone = NULL;
+            r->txdone_face = NULL;
+        }
+    if (!fl->head || fl->txq != q)
+        return;
+    ccnl_txq_deactivate(q, fl);
+    for (r = fl->head; r; r = r->next) {
+        ccnl_txq_unhash(q, r);
+        r->txdone = NULL;
+        r->txdone_face = NULL;
+    }
+    if (q->flow.tail)
+        q->flow.tail->next = fl->head;
+    else {
+        q->flow.head = fl->head;
+        ccnl_txq_activate(q, &q->flow);
+    }
+    q->flow.tail = fl->tail;
+    q->flow.qlen += fl->qlen;
+    memset(fl, 0, sizeof(*fl));
+}
+
+void
+ccnl_txq_cleanup(struct ccnl_txq_s *q)
+{
+    struct ccnl_txflow_s *fl;
+    struct ccnl_txrequest_s *r;
+
+    while ((fl = q->active) != NULL) {
+        while ((r = ccnl_txq_pop(q, fl)) != NULL)
+            ccnl_txq_release(r);
+        ccnl_txq_deactivate(q, fl);
+    }
+}
@@ -0,0 +1,71 @@
+#include "ccnl-unit.h"
+
+#include "ccnl-core.h"
+
+//objects are aligned and zeroed, large ones do not waste the current chunk
+//-------------------------------------------------------------------------------------------
+int ccnl_test_prepare_arena(void **arena, void **unused){
+
+    (void) unused;
+    *arena = ccnl_calloc(1, sizeof(struct ccnl_arena_s));
+
+    return *arena != NULL;
+}
+
+int ccnl_test_run_arena(void *arena, void *unused){
+
+    struct ccnl_arena_s *a = arena;
+    char *p1, *p2, *big;
+    int chunks;
+    (void) unused;
+
+    p1 = ccnl_arena_alloc(a, 3);
+    p2 = ccnl_arena_alloc(a, sizeof(double));
+    if (!C_ASSERT_EQUAL_INT(p1 && p2, 1))
+        return 0;
+    if (!C_ASSERT_EQUAL_INT(p2 - p1, 8) ||
+        !C_ASSERT_EQUAL_INT(((size_t) p2) % sizeof(double), 0) ||
+        !C_ASSERT_EQUAL_INT(p2[0] | p2[7], 0))
+        return 0;
+    chunks = a->chunkcnt;
+
+    big = ccnl_arena_alloc(a, CCNL_ARENA_CHUNK);
+    if (!C_ASSERT_EQUAL_INT(big != NULL, 1) ||
+        !C_ASSERT_EQUAL_INT(a->chunkcnt, chunks + 1))
+        return 0;
+    memset(big, 0xff, CCNL_ARENA_CHUNK);
+    p1 = ccnl_arena_alloc(a, 8);
+    return C_ASSERT_EQUAL_INT(p1 - p2, 8) &&
+           C_ASSERT_EQUAL_INT(a->chunkcnt, chunks + 1) &&
+           C_ASSERT_EQUAL_INT((int) a->used, 16 + CCNL_ARENA_CHUNK + 8);
+}
+
+int ccnl_test_cleanup_arena(void *arena, void *unused){
+
+    struct ccnl_arena_s *a = arena;
+    int ok;
+    (void) unused;
+
+    ccnl_arena_release(a);
+    ok = C_ASSERT_EQUAL_INT(a->chunkcnt, 0) &&
+         C_ASSERT_EQUAL_INT(a->chunks == NULL, 1);
+    ccnl_free(a);
+    return ok;
+}
+
+//Run Tests
+int main(){
+    int testnum = 0;
+    int res = 0;
+    void *arena = NULL, *unused = NULL;
+
+    //Test: ARENA ALLOCATION
+    ++testnum;
+    res = RUN_TEST(testnum, "testing arena allocation",
+                   ccnl_test_prepare_arena, ccnl_test_run_arena,
+                   ccnl_test_cleanup_arena, arena, unused);
+    if(!res){
+        return -1;
+    }
+    return 0;
+}
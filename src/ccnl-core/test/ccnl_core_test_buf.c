@@ -0,0 +1,73 @@
+#include "ccnl-unit.h"
+
+#include "ccnl-core.h"
+
+//slices keep their parent alive, small packets are copied out of the receive buffer
+//-------------------------------------------------------------------------------------------
+int ccnl_test_prepare_buf(void **rx, void **unused){
+
+    struct ccnl_buf_s *b = ccnl_buf_new(NULL, CCNL_MAX_PACKET_SIZE);
+
+    (void) unused;
+    if (!b)
+        return 0;
+    memset(b->data, 'x', b->datalen);
+    *rx = b;
+    return 1;
+}
+
+int ccnl_test_run_buf(void *rx, void *unused){
+
+    struct ccnl_buf_s *b = rx, *big, *small, *shared;
+
+    (void) unused;
+    ccnl_buf_set_rx(b);
+    big = ccnl_buf_rx(b->data + 10, CCNL_BUF_SLICE_MIN);
+    b->datalen = CCNL_BUF_SLICE_MIN - 1; // a small datagram
+    small = ccnl_buf_rx(b->data, 20);
+    ccnl_buf_set_rx(NULL);
+    if (!big || !small)
+        return 0;
+    if (!C_ASSERT_EQUAL_INT(big->parent == b && big->data == b->data + 10, 1) ||
+        !C_ASSERT_EQUAL_INT(small->parent == NULL && small->data != b->data, 1) ||
+        !C_ASSERT_EQUAL_INT(b->refcnt, 2))
+        return 0;
+
+    shared = ccnl_buf_share(big);
+    if (!C_ASSERT_EQUAL_INT(shared->parent == b && buf_equal(shared, big), 1) ||
+        !C_ASSERT_EQUAL_INT(b->refcnt, 3))
+        return 0;
+    ccnl_buf_free(big);
+    ccnl_buf_free(small);
+    ccnl_buf_free(b); // the IO loop lets go of the receive buffer
+    if (!C_ASSERT_EQUAL_INT(shared->parent->refcnt, 1) ||
+        !C_ASSERT_EQUAL_INT(shared->data[0], 'x'))
+        return 0;
+    ccnl_buf_free(shared);
+    return C_ASSERT_EQUAL_INT(ccnl_pool_stats(CCNL_POOL_SLICE)->inuse, 0);
+}
+
+int ccnl_test_cleanup_buf(void *rx, void *unused){
+
+    (void) rx;
+    (void) unused;
+    ccnl_pool_cleanup();
+    return 1;
+}
+
+//Run Tests
+int main(){
+    int testnum = 0;
+    int res = 0;
+    void *rx = NULL, *unused = NULL;
+
+    //Test: BUFFER SLICES
+    ++testnum;
+    res = RUN_TEST(testnum, "testing buffer slices and references",
+                   ccnl_test_prepare_buf, ccnl_test_run_buf,
+                   ccnl_test_cleanup_buf, rx, unused);
+    if(!res){
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,182 @@
+#include "ccnl-unit.h"
+
+#include "ccnl-core.h"
+
+struct ccnl_content_s*
+ccnl_test_content(struct ccnl_relay_s *relay, const char *name, int len){
+
+    struct ccnl_pkt_s *pkt = ccnl_pool_alloc(CCNL_POOL_PKT);
+    struct ccnl_content_s *c;
+    char uri[32];
+
+    if (!pkt)
+        return NULL;
+    strcpy(uri, name);
+    pkt->suite = CCNL_SUITE_NDNTLV;
+    pkt->pfx = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL, NULL);
+    pkt->buf = ccnl_buf_new(NULL, len);
+    c = ccnl_content_new(&pkt);
+    if (c && ccnl_content_add2cache(relay, c) < 0) {
+        ccnl_content_free(c); // no room
+        return NULL;
+    }
+    return c;
+}
+
+// names of the cached content, most recently added first
+char*
+ccnl_test_cached(struct ccnl_relay_s *relay){
+
+    static char names[64];
+    struct ccnl_content_s *c;
+    char s[CCNL_MAX_PREFIX_SIZE];
+
+    names[0] = '\0';
+    for (c = relay->contents; c; c = c->next)
+        strcat(names, ccnl_prefix_to_str(c->pkt->pfx, s, CCNL_MAX_PREFIX_SIZE));
+    return names;
+}
+
+int ccnl_test_prepare_cache(void **relay, void **unused){
+
+    struct ccnl_relay_s *r = ccnl_calloc(1, sizeof(struct ccnl_relay_s));
+
+    (void) unused;
+    if (!r)
+        return 0;
+    r->max_cache_entries = 3;
+    *relay = r;
+    return ccnl_test_content(r, "/a", 10) && ccnl_test_content(r, "/b", 10) &&
+           ccnl_test_content(r, "/c", 10);
+}
+
+int ccnl_test_cleanup_cache(void *relay, void *unused){
+
+    struct ccnl_relay_s *r = relay;
+
+    (void) unused;
+    while (r->contents)
+        ccnl_content_remove(r, r->contents);
+    ccnl_timer_cleanup();
+    ccnl_free(r);
+    return 1;
+}
+
+//the least recently used content is replaced, a hit counts as use
+//-------------------------------------------------------------------------------------------
+int ccnl_test_run_cache_lru(void *relay, void *unused){
+
+    struct ccnl_relay_s *r = relay;
+
+    (void) unused;
+    ccnl_cache_hit(r, r->contents->next->next); // a
+    ccnl_test_content(r, "/d", 10);
+    return C_ASSERT_EQUAL_STRING(ccnl_test_cached(r), "/d/c/a");
+}
+
+//content hit once is protected from a scan of new content
+//-------------------------------------------------------------------------------------------
+int ccnl_test_run_cache_slru(void *relay, void *unused){
+
+    struct ccnl_relay_s *r = relay;
+
+    (void) unused;
+    r->max_cache_entries = 5; // 4 protected
+    if (!C_ASSERT_EQUAL_INT(ccnl_cache_set_policy(r, CCNL_CACHE_SLRU), 0))
+        return 0;
+    ccnl_cache_hit(r, r->contents->next->next); // a
+    ccnl_test_content(r, "/d", 10);
+    ccnl_test_content(r, "/e", 10);
+    ccnl_test_content(r, "/f", 10);
+    ccnl_test_content(r, "/g", 10);
+    ccnl_test_content(r, "/h", 10); // LRU would replace a
+    return C_ASSERT_EQUAL_STRING(ccnl_test_cached(r), "/h/g/f/e/a");
+}
+
+//the least frequently used content is replaced, the older one among equals
+//-------------------------------------------------------------------------------------------
+int ccnl_test_run_cache_lfu(void *relay, void *unused){
+
+    struct ccnl_relay_s *r = relay;
+    struct ccnl_content_s *a = r->contents->next->next, *b = r->contents->next;
+
+    (void) unused;
+    if (!C_ASSERT_EQUAL_INT(ccnl_cache_set_policy(r, CCNL_CACHE_LFU), 0))
+        return 0;
+    ccnl_cache_hit(r, a);
+    ccnl_cache_hit(r, a);
+    ccnl_cache_hit(r, b);
+    ccnl_test_content(r, "/d", 10);
+    if (!C_ASSERT_EQUAL_STRING(ccnl_test_cached(r), "/d/b/a"))
+        return 0;
+    ccnl_test_content(r, "/e", 10);
+    ccnl_cache_hit(r, r->contents); // e
+    ccnl_test_content(r, "/f", 10);
+    return C_ASSERT_EQUAL_STRING(ccnl_test_cached(r), "/f/e/a");
+}
+
+//the byte budget is kept, static content is never replaced
+//-------------------------------------------------------------------------------------------
+int ccnl_test_run_cache_bytes(void *relay, void *unused){
+
+    struct ccnl_relay_s *r = relay;
+
+    (void) unused;
+    r->max_cache_entries = -1;
+    r->cache.max_bytes = 100;
+    r->contents->next->next->flags |= CCNL_CONTENT_FLAGS_STATIC; // a
+    if (!C_ASSERT_EQUAL_INT(ccnl_test_content(r, "/d", 60) != NULL, 1) ||
+        !C_ASSERT_EQUAL_STRING(ccnl_test_cached(r), "/d/c/b/a") ||
+        !C_ASSERT_EQUAL_INT(r->cache.bytes, 90))
+        return 0;
+    if (!C_ASSERT_EQUAL_INT(ccnl_test_content(r, "/e", 101) == NULL, 1) ||
+        !C_ASSERT_EQUAL_INT(ccnl_test_content(r, "/f", 90) != NULL, 1))
+        return 0;
+    // a is kept, the others made room for f
+    return C_ASSERT_EQUAL_STRING(ccnl_test_cached(r), "/f/a") &&
+           C_ASSERT_EQUAL_INT(r->cache.bytes, 100);
+}
+
+//Run Tests
+int main(){
+    int testnum = 0;
+    int res = 0;
+    void *relay = NULL, *unused = NULL;
+
+    //Test: LRU
+    ++testnum;
+    res = RUN_TEST(testnum, "testing LRU replacement",
+                   ccnl_test_prepare_cache, ccnl_test_run_cache_lru,
+                   ccnl_test_cleanup_cache, relay, unused);
+    if(!res){
+        return -1;
+    }
+
+    //Test: SLRU
+    ++testnum;
+    res = RUN_TEST(testnum, "testing SLRU replacement",
+                   ccnl_test_prepare_cache, ccnl_test_run_cache_slru,
+                   ccnl_test_cleanup_cache, relay, unused);
+    if(!res){
+        return -1;
+    }
+
+    //Test: LFU
+    ++testnum;
+    res = RUN_TEST(testnum, "testing LFU replacement",
+                   ccnl_test_prepare_cache, ccnl_test_run_cache_lfu,
+                   ccnl_test_cleanup_cache, relay, unused);
+    if(!res){
+        return -1;
+    }
+
+    //Test: BYTE BUDGET
+    ++testnum;
+    res = RUN_TEST(testnum, "testing cache byte budget",
+                   ccnl_test_prepare_cache, ccnl_test_run_cache_bytes,
+                   ccnl_test_cleanup_cache, relay, unused);
+    if(!res){
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,226 @@
+#include "ccnl-unit.h"
+
+#include "ccnl-core.h"
+
+struct ccnl_face_s*
+ccnl_test_face(struct ccnl_relay_s *relay, int port){
+
+    sockunion su;
+
+    memset(&su, 0, sizeof(su));
+    su.ip4.sin_family = AF_INET;
+    su.ip4.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    su.ip4.sin_port = htons(port);
+    return ccnl_get_face_or_create(relay, 0, &su.sa, sizeof(su.ip4));
+}
+
+//faces are found by their peer address, removing a face removes what refers to it
+//-------------------------------------------------------------------------------------------
+int ccnl_test_prepare_face(void **relay, void **pkt){
+
+    struct ccnl_relay_s *r = ccnl_calloc(1, sizeof(struct ccnl_relay_s));
+    struct ccnl_pkt_s *p = ccnl_pool_alloc(CCNL_POOL_PKT);
+    char uri[] = "/test/face";
+
+    if (!r || !p)
+        return 0;
+    r->ifcount = 1;
+    r->ifs[0].addr.sa.sa_family = AF_INET;
+    p->suite = CCNL_SUITE_NDNTLV;
+    p->pfx = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL, NULL);
+    p->buf = ccnl_buf_new(NULL, 10);
+    *relay = r;
+    *pkt = p;
+    return p->pfx && p->buf;
+}
+
+int ccnl_test_run_face(void *relay, void *pkt){
+
+    struct ccnl_relay_s *r = relay;
+    struct ccnl_pkt_s *p = pkt;
+    struct ccnl_face_s *a, *b, *c;
+    struct ccnl_interest_s *i;
+    char uri[] = "/test";
+    int k, faceid;
+
+    for (k = 0; k < 2 * CCNL_FACE_BUCKETS; k++)
+        if (!ccnl_test_face(r, 10000 + k))
+            return 0;
+    a = ccnl_test_face(r, 9001);
+    b = ccnl_test_face(r, 9002);
+    c = ccnl_test_face(r, 9003);
+    if (!C_ASSERT_EQUAL_INT(a && b && c && a != b, 1) ||
+        !C_ASSERT_EQUAL_INT(ccnl_test_face(r, 9001) == a, 1) ||
+        !C_ASSERT_EQUAL_INT(ccnl_test_face(r, 9002) == b, 1))
+        return 0;
+
+    if (!C_ASSERT_EQUAL_INT(ccnl_fib_add_entry(r,
+                    ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL, NULL), c), 0))
+        return 0;
+    i = ccnl_interest_new(r, a, &p);
+    if (!i || ccnl_interest_append_pending(i, a) ||
+              ccnl_interest_append_pending(i, b))
+        return 0;
+
+    faceid = a->faceid;
+    ccnl_face_remove(r, a); // the interest is still pending for b
+    if (!C_ASSERT_EQUAL_INT(r->pit == i && i->from == NULL, 1) ||
+        !C_ASSERT_EQUAL_INT(i->pending->face == b && !i->pending->next, 1))
+        return 0;
+    ccnl_face_remove(r, b);
+    if (!C_ASSERT_EQUAL_INT(r->pit == NULL, 1))
+        return 0;
+    ccnl_face_remove(r, c);
+    if (!C_ASSERT_EQUAL_INT(r->fib == NULL, 1))
+        return 0;
+    a = ccnl_test_face(r, 9001); // a new face
+    return C_ASSERT_EQUAL_INT(a && a->faceid != faceid, 1);
+}
+
+int ccnl_test_cleanup_face(void *relay, void *pkt){
+
+    struct ccnl_relay_s *r = relay;
+
+    (void) pkt; // owned by the removed interest
+    while (r->faces)
+        ccnl_face_remove(r, r->faces);
+    ccnl_nametree_cleanup(&r->pit_index);
+    ccnl_nametree_cleanup(&r->fib_index);
+    ccnl_timer_cleanup();
+    ccnl_free(r);
+    return 1;
+}
+
+//entries with the same name stay in the order of adding, also after removals
+//-------------------------------------------------------------------------------------------
+static struct ccnl_forward_s*
+ccnl_test_fib_link(struct ccnl_relay_s *relay, struct ccnl_face_s *face){
+
+    struct ccnl_forward_s *fwd = ccnl_calloc(1, sizeof(*fwd));
+    char uri[] = "/test/fib";
+
+    if (!fwd)
+        return NULL;
+    fwd->prefix = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL, NULL);
+    fwd->suite = CCNL_SUITE_NDNTLV;
+    fwd->face = face;
+    if (!fwd->prefix || ccnl_fib_link(relay, fwd)) {
+        ccnl_prefix_free(fwd->prefix);
+        ccnl_free(fwd);
+        return NULL;
+    }
+    return fwd;
+}
+
+static int
+ccnl_test_fib_order(struct ccnl_relay_s *relay, struct ccnl_face_s **faces,
+                    int cnt){
+
+    struct ccnl_forward_s *fwd = NULL;
+    char uri[] = "/test/fib";
+    struct ccnl_prefix_s *pfx = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV,
+                                                 NULL, NULL);
+    int k;
+
+    if (pfx)
+        fwd = ccnl_fib_find(relay, pfx);
+    ccnl_prefix_free(pfx);
+    for (k = 0; k < cnt && fwd; k++, fwd = fwd->samename_next)
+        if (fwd->face != faces[k])
+            return 0;
+    return k == cnt && !fwd;
+}
+
+static void
+ccnl_test_fib_unlink(struct ccnl_relay_s *relay, struct ccnl_forward_s *fwd){
+
+    ccnl_fib_unlink(relay, fwd);
+    ccnl_prefix_free(fwd->prefix);
+    ccnl_free(fwd);
+}
+
+int ccnl_test_prepare_fib_order(void **relay, void **unused){
+
+    struct ccnl_relay_s *r = ccnl_calloc(1, sizeof(struct ccnl_relay_s));
+
+    (void) unused;
+    if (!r)
+        return 0;
+    r->ifcount = 1;
+    r->ifs[0].addr.sa.sa_family = AF_INET;
+    *relay = r;
+    return 1;
+}
+
+int ccnl_test_run_fib_order(void *relay, void *unused){
+
+    struct ccnl_relay_s *r = relay;
+    struct ccnl_face_s *f[4], *order[3];
+    struct ccnl_forward_s *fwd[4];
+    int k;
+
+    (void) unused;
+    for (k = 0; k < 4; k++) {
+        f[k] = ccnl_test_face(r, 9101 + k);
+        fwd[k] = f[k] ? ccnl_test_fib_link(r, f[k]) : NULL;
+        if (!fwd[k])
+            return 0;
+    }
+    if (!ccnl_test_fib_order(r, f, 4))
+        return 0;
+
+    // the last one, appended again
+    ccnl_test_fib_unlink(r, fwd[3]);
+    if (!ccnl_test_fib_order(r, f, 3))
+        return 0;
+    fwd[3] = ccnl_test_fib_link(r, f[3]);
+    if (!fwd[3] || !ccnl_test_fib_order(r, f, 4))
+        return 0;
+
+    // the first and a middle one, then one appended behind the rest
+    ccnl_test_fib_unlink(r, fwd[0]);
+    ccnl_test_fib_unlink(r, fwd[2]);
+    fwd[0] = ccnl_test_fib_link(r, f[0]);
+    order[0] = f[1];
+    order[1] = f[3];
+    order[2] = f[0];
+    return fwd[0] && ccnl_test_fib_order(r, order, 3);
+}
+
+int ccnl_test_cleanup_fib_order(void *relay, void *unused){
+
+    struct ccnl_relay_s *r = relay;
+
+    (void) unused;
+    while (r->faces) // removes the FIB entries
+        ccnl_face_remove(r, r->faces);
+    ccnl_nametree_cleanup(&r->fib_index);
+    ccnl_free(r);
+    return 1;
+}
+
+//Run Tests
+int main(){
+    int testnum = 0;
+    int res = 0;
+    void *relay = NULL, *pkt = NULL;
+
+    //Test: FACE TABLE
+    ++testnum;
+    res = RUN_TEST(testnum, "testing face lookup and removal",
+                   ccnl_test_prepare_face, ccnl_test_run_face,
+                   ccnl_test_cleanup_face, relay, pkt);
+    if(!res){
+        return -1;
+    }
+
+    //Test: FIB ENTRIES WITH THE SAME NAME
+    ++testnum;
+    res = RUN_TEST(testnum, "testing the order of FIB entries with one name",
+                   ccnl_test_prepare_fib_order, ccnl_test_run_fib_order,
+                   ccnl_test_cleanup_fib_order, relay, pkt);
+    if(!res){
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "ccnl-unit.h"
+
+#include "ccnl-core.h"
+#include "ccnl-nfn-memo.h"
+
+#define MEMO_NAMELEN    250
+
+//the key of a name applied many times is sized from the reduced term
+//-------------------------------------------------------------------------------------------
+int ccnl_test_prepare_memo_long(void **name, void **expr){
+
+    *name = ccnl_malloc(MEMO_NAMELEN + 2);
+    *expr = ccnl_malloc(2 * 60 + 8);
+    if (!*name || !*expr)
+        return 0;
+    ((char*) *name)[0] = '/';
+    memset((char*) *name + 1, 'a', MEMO_NAMELEN);
+    ((char*) *name)[MEMO_NAMELEN + 1] = '\0';
+    return 1;
+}
+
+static char*
+memo_test_key(char *uri, char *expr){
+
+    char buf[MEMO_NAMELEN + 2];
+    struct ccnl_prefix_s *p;
+    char *key;
+
+    strcpy(buf, uri);
+    p = ccnl_URItoPrefix(buf, CCNL_SUITE_NDNTLV, expr, NULL);
+    if (!p)
+        return NULL;
+    key = ccnl_nfn_memo_key(p);
+    ccnl_prefix_free(p);
+    return key;
+}
+
+int ccnl_test_run_memo_long(void *name, void *expr){
+
+    char *n = name, *e = expr, *key, *cp;
+    int i, ok;
+
+    //five occurrences fit, the key is the name five times
+    strcpy(e, "(@x");
+    for (i = 0; i < 5; i++)
+        strcat(e, " x");
+    strcat(e, ")");
+    key = memo_test_key(n, e);
+    if (!key)
+        return 0;
+    ok = C_ASSERT_EQUAL_INT(strlen(key), 5 * (MEMO_NAMELEN + 1) + 4);
+    for (cp = key, i = 0; ok && i < 5; i++, cp += MEMO_NAMELEN + 2)
+        ok = C_ASSERT_EQUAL_STRING_N(cp, n, MEMO_NAMELEN + 1);
+    ccnl_free(key);
+    if (!ok)
+        return 0;
+
+    //sixty do not fit into a packet, there is no key
+    strcpy(e, "(@x");
+    for (i = 0; i < 60; i++)
+        strcat(e, " x");
+    strcat(e, ")");
+    key = memo_test_key(n, e);
+    ccnl_free(key);
+    return key == NULL;
+}
+
+int ccnl_test_cleanup_memo_long(void *name, void *expr){
+
+    ccnl_free(name);
+    ccnl_free(expr);
+    return 1;
+}
+
+//a lambda binding the argument keeps the application, it would capture it
+//-------------------------------------------------------------------------------------------
+int ccnl_test_prepare_memo_capture(void **key1, void **key2){
+
+    *key1 = memo_test_key("/COMPUTE", "(@x @y x) y");
+    *key2 = memo_test_key("/COMPUTE", "@y y");
+    return *key1 && *key2;
+}
+
+int ccnl_test_run_memo_capture(void *key1, void *key2){
+
+    char *key;
+    int ok;
+
+    if (!C_ASSERT_EQUAL_STRING(key1, "(@x(@y x)) y") ||
+        !C_ASSERT_EQUAL_STRING(key2, "(@y y)"))
+        return 0;
+    //without a clash the application is reduced
+    key = memo_test_key("/COMPUTE", "(@x @y x) z");
+    if (!key)
+        return 0;
+    ok = C_ASSERT_EQUAL_STRING(key, "(@y z)");
+    ccnl_free(key);
+    return ok;
+}
+
+int ccnl_test_cleanup_memo_capture(void *key1, void *key2){
+
+    ccnl_free(key1);
+    ccnl_free(key2);
+    return 1;
+}
+
+//Run Tests
+int main(){
+    int testnum = 0;
+    int res = 0;
+    void *d1 = NULL, *d2 = NULL;
+
+    //Test: MEMO KEY LONGER THAN THE NAME
+    ++testnum;
+    res = RUN_TEST(testnum, "testing memo keys longer than the name",
+                   ccnl_test_prepare_memo_long, ccnl_test_run_memo_long,
+                   ccnl_test_cleanup_memo_long, d1, d2);
+    if(!res){
+        return -1;
+    }
+
+    //Test: MEMO KEY WITHOUT VARIABLE CAPTURE
+    ++testnum;
+    res = RUN_TEST(testnum, "testing memo keys of a captured argument",
+                   ccnl_test_prepare_memo_capture, ccnl_test_run_memo_capture,
+                   ccnl_test_cleanup_memo_capture, d1, d2);
+    if(!res){
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include "ccnl-unit.h"
+
+#include "ccnl-core.h"
+
+int nametree_suite;
+
+struct ccnl_nametree_s nametree_tree;
+
+//exact and prefix lookups
+//-------------------------------------------------------------------------------------------
+int ccnl_test_prepare_nametree(void **prefix1, void **prefix2){
+
+    char *c1 = ccnl_malloc(100);
+    strcpy(c1, "/path/to/data");
+    *prefix1 = ccnl_URItoPrefix(c1, nametree_suite, NULL, NULL);
+
+    char *c2 = ccnl_malloc(100);
+    strcpy(c2, "/path/to/other");
+    *prefix2 = ccnl_URItoPrefix(c2, nametree_suite, NULL, NULL);
+
+    return *prefix1 && *prefix2;
+}
+
+int ccnl_test_run_nametree(void *prefix1, void *prefix2){
+
+    struct ccnl_prefix_s *p1 = prefix1;
+    struct ccnl_prefix_s *p2 = prefix2;
+    struct ccnl_nametree_node_s *n1, *n2, *n;
+    int cnt = 0;
+
+    n1 = ccnl_nametree_get(&nametree_tree, p1, p1->compcnt);
+    n2 = ccnl_nametree_get(&nametree_tree, p2, p2->compcnt);
+    if (!n1 || !n2 || n1 == n2)
+        return 0;
+    if (ccnl_nametree_find(&nametree_tree, p1, p1->compcnt) != n1)
+        return 0;
+    // common prefix /path/to
+    if (n1->parent != n2->parent ||
+        ccnl_nametree_find(&nametree_tree, p2, 2) != n1->parent)
+        return 0;
+    for (n = n1->parent; n; n = ccnl_nametree_next(n, n1->parent, 3))
+        cnt++;
+    if (!C_ASSERT_EQUAL_INT(cnt, 3))
+        return 0;
+
+    ccnl_nametree_release(&nametree_tree, n1);
+    if (ccnl_nametree_find(&nametree_tree, p1, p1->compcnt))
+        return 0;
+    ccnl_nametree_release(&nametree_tree, n2);
+    return C_ASSERT_EQUAL_INT(nametree_tree.count, 0);
+}
+
+int ccnl_test_cleanup_nametree(void *prefix1, void *prefix2){
+
+    struct ccnl_prefix_s *p1 = prefix1;
+    struct ccnl_prefix_s *p2 = prefix2;
+
+    ccnl_nametree_cleanup(&nametree_tree);
+    ccnl_prefix_free(p1);
+    ccnl_prefix_free(p2);
+    return 1;
+}
+
+//Run Tests
+int main(){
+    int testnum = 0;
+    int res = 0;
+    //Name tree tests for all suites
+    char *testdescription = ccnl_malloc(512);
+    struct ccnl_prefix_s *p1 = NULL, *p2 = NULL;
+    for(nametree_suite = 0; nametree_suite < 3; ++nametree_suite) {
+
+        //Test: NAMETREE EXACT AND PREFIX LOOKUP
+        ++testnum;
+        sprintf(testdescription, "testing name tree lookups with suite %s",
+                ccnl_suite2str(nametree_suite));
+        res = RUN_TEST(testnum, testdescription, ccnl_test_prepare_nametree,
+                 ccnl_test_run_nametree, ccnl_test_cleanup_nametree, p1, p2);
+
+        if(!res){
+            return -1;
+        }
+    }
+    return 0;
+}
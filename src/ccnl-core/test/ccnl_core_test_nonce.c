@@ -0,0 +1,100 @@
+#include "ccnl-unit.h"
+
+#include "ccnl-core.h"
+
+//a nonce is a duplicate until its lifetime ends, the table never overflows
+//-------------------------------------------------------------------------------------------
+int ccnl_test_prepare_nonce(void **relay, void **nonce){
+
+    *relay = ccnl_calloc(1, sizeof(struct ccnl_relay_s));
+    *nonce = ccnl_buf_new(NULL, 4);
+    return *relay && *nonce;
+}
+
+int ccnl_test_run_nonce(void *relay, void *nonce){
+
+    struct ccnl_relay_s *r = relay;
+    struct ccnl_buf_s *n = nonce;
+    uint32_t k;
+
+    memcpy(n->data, "\x01\x02\x03\x04", 4);
+    if (!C_ASSERT_EQUAL_INT(ccnl_nonce_find_or_append(r, n, 10000), 0) ||
+        !C_ASSERT_EQUAL_INT(ccnl_nonce_find_or_append(r, n, 10000), -1))
+        return 0;
+    n->data[3] = 5;
+    if (!C_ASSERT_EQUAL_INT(ccnl_nonce_find_or_append(r, n, 0), 0) ||
+        !C_ASSERT_EQUAL_INT(ccnl_nonce_find_or_append(r, n, 0), 0)) // expired
+        return 0;
+
+    // many more nonces than slots: the newest ones are always found
+    for (k = 0; k < 4 * CCNL_MAX_NONCES; k++) {
+        memcpy(n->data, &k, 4);
+        if (!C_ASSERT_EQUAL_INT(ccnl_nonce_find_or_append(r, n, 10000), 0) ||
+            !C_ASSERT_EQUAL_INT(ccnl_nonce_find_or_append(r, n, 10000), -1))
+            return 0;
+    }
+    return 1;
+}
+
+//an empty slot is free whatever the msec clock: at a clock past 2^31 its
+//expires of 0 lies in the future, the table then looks as if it was full
+//-------------------------------------------------------------------------------------------
+int ccnl_test_run_nonce_clock(void *relay, void *nonce){
+
+    struct ccnl_relay_s *r = relay;
+    struct ccnl_buf_s *n = nonce;
+    struct timeval tv;
+    uint32_t k, now;
+    int i;
+
+    // the slots as seen at a clock of 2^31 + 1000 msec
+    ccnl_get_timeval(&tv);
+    now = (uint32_t) tv.tv_sec * 1000 + tv.tv_usec / 1000;
+    for (i = 0; i < CCNL_MAX_NONCES; i++)
+        r->nonces[i].expires = now - 0x80000000u - 1000;
+
+    for (k = 0; k < CCNL_MAX_NONCES / 16; k++) {
+        memcpy(n->data, &k, 4);
+        if (!C_ASSERT_EQUAL_INT(ccnl_nonce_find_or_append(r, n, 10000), 0))
+            return 0;
+    }
+    for (k = 0; k < CCNL_MAX_NONCES / 16; k++) {
+        memcpy(n->data, &k, 4);
+        if (!C_ASSERT_EQUAL_INT(ccnl_nonce_find_or_append(r, n, 10000), -1))
+            return 0;
+    }
+    return 1;
+}
+
+int ccnl_test_cleanup_nonce(void *relay, void *nonce){
+
+    ccnl_free(relay);
+    ccnl_buf_free(nonce);
+    return 1;
+}
+
+//Run Tests
+int main(){
+    int testnum = 0;
+    int res = 0;
+    void *relay = NULL, *nonce = NULL;
+
+    //Test: NONCE TABLE
+    ++testnum;
+    res = RUN_TEST(testnum, "testing duplicate nonce detection",
+                   ccnl_test_prepare_nonce, ccnl_test_run_nonce,
+                   ccnl_test_cleanup_nonce, relay, nonce);
+    if(!res){
+        return -1;
+    }
+
+    //Test: NONCE TABLE, MSEC CLOCK PAST 2^31
+    ++testnum;
+    res = RUN_TEST(testnum, "testing empty nonce slots at a late clock",
+                   ccnl_test_prepare_nonce, ccnl_test_run_nonce_clock,
+                   ccnl_test_cleanup_nonce, relay, nonce);
+    if(!res){
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include "ccnl-unit.h"
+
+#include "ccnl-core.h"
+
+//released objects are handed out again, prefixes keep their components inline
+//-------------------------------------------------------------------------------------------
+int ccnl_test_prepare_pool(void **prefix, void **pkt){
+
+    char *c = ccnl_malloc(100);
+    strcpy(c, "/path/to/data");
+    *prefix = ccnl_URItoPrefix(c, CCNL_SUITE_NDNTLV, NULL, NULL);
+    ccnl_free(c);
+    *pkt = ccnl_pool_alloc(CCNL_POOL_PKT);
+
+    return *prefix && *pkt;
+}
+
+int ccnl_test_run_pool(void *prefix, void *pkt){
+
+    struct ccnl_prefix_s *p = prefix;
+    const struct ccnl_pool_s *stats = ccnl_pool_stats(CCNL_POOL_PREFIX);
+    uint32_t hits = stats->hits;
+    void *again;
+    char s[CCNL_MAX_PREFIX_SIZE];
+
+    if (!C_ASSERT_EQUAL_INT(ccnl_prefix_appendCmp(p, (unsigned char*) "x", 1), 0))
+        return 0;
+    if (!C_ASSERT_EQUAL_STRING(ccnl_prefix_to_str(p, s, CCNL_MAX_PREFIX_SIZE),
+                               "/path/to/data/x"))
+        return 0;
+    ccnl_prefix_free(p);
+    p = ccnl_prefix_new(CCNL_SUITE_NDNTLV, 2);
+    if (!C_ASSERT_EQUAL_INT(p == prefix && stats->hits == hits + 1, 1))
+        return 0;
+    ccnl_prefix_free(p);
+
+    ccnl_pool_free(CCNL_POOL_PKT, pkt);
+    again = ccnl_pool_alloc(CCNL_POOL_PKT);
+    if (!C_ASSERT_EQUAL_INT(again == pkt, 1))
+        return 0;
+    ccnl_pool_free(CCNL_POOL_PKT, again);
+    stats = ccnl_pool_stats(CCNL_POOL_PKT);
+    return C_ASSERT_EQUAL_INT(stats->inuse, 0) &&
+           C_ASSERT_EQUAL_INT(stats->freecnt, 1);
+}
+
+int ccnl_test_cleanup_pool(void *prefix, void *pkt){
+
+    (void) prefix;
+    (void) pkt;
+    ccnl_pool_cleanup();
+    return C_ASSERT_EQUAL_INT(ccnl_pool_stats(CCNL_POOL_PKT)->freecnt, 0);
+}
+
+//Run Tests
+int main(){
+    int testnum = 0;
+    int res = 0;
+    void *prefix = NULL, *pkt = NULL;
+
+    //Test: POOL REUSE
+    ++testnum;
+    res = RUN_TEST(testnum, "testing object pool reuse",
+                   ccnl_test_prepare_pool, ccnl_test_run_pool,
+                   ccnl_test_cleanup_pool, prefix, pkt);
+    if(!res){
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include "ccnl-unit.h"
+
+#include "ccnl-core.h"
+
+int ccnl_test_prepare_stats(void **unused1, void **unused2){
+
+    (void) unused1;
+    (void) unused2;
+    return 1;
+}
+
+//residence times fall into the bucket with the next bound at or above them
+//-------------------------------------------------------------------------------------------
+int ccnl_test_run_stats_bucket(void *unused1, void *unused2){
+
+    int b;
+
+    (void) unused1;
+    (void) unused2;
+    if (!C_ASSERT_EQUAL_INT(ccnl_stats_bucket(0), 0) ||
+        !C_ASSERT_EQUAL_INT(ccnl_stats_bucket(64), 0) ||
+        !C_ASSERT_EQUAL_INT(ccnl_stats_bucket(65), 1) ||
+        !C_ASSERT_EQUAL_INT(ccnl_stats_bucket(128), 1) ||
+        !C_ASSERT_EQUAL_INT(ccnl_stats_bucket(129), 2) ||
+        !C_ASSERT_EQUAL_INT(ccnl_stats_bucket(100000000L),
+                            CCNL_STATS_BUCKETS - 1))
+        return 0;
+    for (b = 0; b < CCNL_STATS_BUCKETS - 1; b++) {
+        long usec = ccnl_stats_bucket_usec(b);
+        if (!C_ASSERT_EQUAL_INT(ccnl_stats_bucket(usec), b) ||
+            !C_ASSERT_EQUAL_INT(ccnl_stats_bucket(usec + 1), b + 1))
+            return 0;
+    }
+    return C_ASSERT_EQUAL_INT(ccnl_stats_bucket_usec(CCNL_STATS_BUCKETS - 1),
+                              -1);
+}
+
+int ccnl_test_cleanup_stats(void *unused1, void *unused2){
+
+    (void) unused1;
+    (void) unused2;
+    return 1;
+}
+
+//Run Tests
+int main(){
+    int testnum = 0;
+    int res = 0;
+
+    //Test: HISTOGRAM BUCKETS
+    ++testnum;
+    res = RUN_TEST(testnum, "testing the residence histogram buckets",
+                   ccnl_test_prepare_stats, ccnl_test_run_stats_bucket,
+                   ccnl_test_cleanup_stats, NULL, NULL);
+    if(!res){
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include "ccnl-unit.h"
+
+#include "ccnl-core.h"
+
+char timer_fired[8];
+int timer_cnt;
+
+void ccnl_test_timer_cb(void *aux1, void *aux2){
+    (void) aux2;
+    timer_fired[timer_cnt++] = *(char*) aux1;
+}
+
+//timers fire in order of their timeout, removed ones never
+//-------------------------------------------------------------------------------------------
+int ccnl_test_prepare_timer(void **removed, void **far){
+
+    static char tags[] = "abcdef";
+
+    timer_cnt = 0;
+    memset(timer_fired, 0, sizeof(timer_fired));
+    ccnl_set_timer(80000, ccnl_test_timer_cb, tags + 3, NULL); // level 1
+    ccnl_set_timer(2000, ccnl_test_timer_cb, tags + 1, NULL);
+    ccnl_set_timer(0, ccnl_test_timer_cb, tags + 0, NULL);
+    ccnl_set_timer(2000, ccnl_test_timer_cb, tags + 2, NULL);
+    *removed = ccnl_set_timer(5000, ccnl_test_timer_cb, tags + 4, NULL);
+    *far = ccnl_set_timer(3600000000ULL * 10, ccnl_test_timer_cb, tags + 5, NULL);
+
+    return *removed && *far;
+}
+
+int ccnl_test_run_timer(void *removed, void *far){
+
+    long usec;
+
+    ccnl_rem_timer(removed);
+    ccnl_rem_timer(removed); // no-op
+    while ((usec = ccnl_run_events()) >= 0 && timer_cnt < 4) {
+        if (!C_ASSERT_EQUAL_INT(usec <= 80000, 1))
+            return 0;
+    }
+    if (!C_ASSERT_EQUAL_STRING(timer_fired, "abcd"))
+        return 0;
+    // only the far timer is left
+    if (usec < 0 || (unsigned long) usec < 1000000)
+        return 0;
+    ccnl_rem_timer(far);
+    return C_ASSERT_EQUAL_INT(ccnl_run_events(), -1);
+}
+
+int ccnl_test_cleanup_timer(void *removed, void *far){
+
+    (void) removed;
+    (void) far;
+    ccnl_timer_cleanup();
+    return 1;
+}
+
+//a burst of timers in few ticks, set in descending order, fires in order
+//-------------------------------------------------------------------------------------------
+#define TIMER_BURST 1000
+
+struct timeval timer_burst_timeout[TIMER_BURST];
+int timer_burst_fired[TIMER_BURST];
+
+void ccnl_test_timer_burst_cb(void *aux1, void *aux2){
+    (void) aux2;
+    timer_burst_fired[timer_cnt++] = (int)(long) aux1;
+}
+
+int ccnl_test_prepare_timer_burst(void **unused1, void **unused2){
+
+    struct ccnl_timer_s *t;
+    long i;
+
+    (void) unused1;
+    (void) unused2;
+    timer_cnt = 0;
+    for (i = 0; i < TIMER_BURST; i++) {
+        t = ccnl_set_timer(3000 - 2 * i, ccnl_test_timer_burst_cb,
+                           (void*) i, NULL);
+        if (!t)
+            return 0;
+        timer_burst_timeout[i] = t->timeout;
+    }
+    return 1;
+}
+
+int ccnl_test_run_timer_burst(void *unused1, void *unused2){
+
+    int i;
+
+    (void) unused1;
+    (void) unused2;
+    while (ccnl_run_events() >= 0);
+    if (!C_ASSERT_EQUAL_INT(timer_cnt, TIMER_BURST))
+        return 0;
+    for (i = 1; i < TIMER_BURST; i++)
+        if (timevaldelta(&timer_burst_timeout[timer_burst_fired[i]],
+                         &timer_burst_timeout[timer_burst_fired[i-1]]) < 0)
+            return 0;
+    return 1;
+}
+
+//Run Tests
+int main(){
+    int testnum = 0;
+    int res = 0;
+    void *removed = NULL, *far = NULL;
+
+    //Test: TIMER ORDER AND REMOVAL
+    ++testnum;
+    res = RUN_TEST(testnum, "testing timer order and removal",
+                   ccnl_test_prepare_timer, ccnl_test_run_timer,
+                   ccnl_test_cleanup_timer, removed, far);
+    if(!res){
+        return -1;
+    }
+
+    //Test: TIMER BURST ORDER
+    ++testnum;
+    res = RUN_TEST(testnum, "testing the order of a burst of timers",
+                   ccnl_test_prepare_timer_burst, ccnl_test_run_timer_burst,
+                   ccnl_test_cleanup_timer, removed, far);
+    if(!res){
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,207 @@
+#include "ccnl-unit.h"
+
+#include "ccnl-core.h"
+
+struct ccnl_txq_test_s {
+    struct ccnl_txq_s q;
+    struct ccnl_face_s a, b;
+    sockunion dst;
+};
+
+int
+ccnl_test_txq_add(struct ccnl_txq_test_s *t, struct ccnl_face_s *f, char id){
+
+    unsigned char data[10];
+
+    memset(data, id, sizeof(data));
+    return ccnl_txq_enqueue(&t->q, f, ccnl_buf_new(data, sizeof(data)),
+                            &t->dst, NULL);
+}
+
+// ids of the next n packets sent
+char*
+ccnl_test_txq_sent(struct ccnl_txq_test_s *t, int n){
+
+    static char ids[32];
+    struct ccnl_txrequest_s *r;
+    int k = 0;
+
+    while (k < n && (r = ccnl_txq_dequeue(&t->q))) {
+        ids[k++] = r->buf->data[0];
+        ccnl_txq_release(r);
+    }
+    ids[k] = '\0';
+    return ids;
+}
+
+int ccnl_test_prepare_txq(void **txq, void **unused){
+
+    struct ccnl_txq_test_s *t = ccnl_calloc(1, sizeof(struct ccnl_txq_test_s));
+
+    (void) unused;
+    if (!t)
+        return 0;
+    t->q.quantum = 10;
+    t->dst.sa.sa_family = AF_INET;
+    *txq = t;
+    return 1;
+}
+
+int ccnl_test_cleanup_txq(void *txq, void *unused){
+
+    struct ccnl_txq_test_s *t = txq;
+
+    (void) unused;
+    ccnl_txq_cleanup(&t->q);
+    ccnl_free(t);
+    return 1;
+}
+
+//faces take turns, an equal packet of a face is found while it waits
+//-------------------------------------------------------------------------------------------
+int ccnl_test_run_txq_drr(void *txq, void *unused){
+
+    struct ccnl_txq_test_s *t = txq;
+    unsigned char data[10];
+    struct ccnl_buf_s *buf;
+    int found;
+
+    (void) unused;
+    ccnl_test_txq_add(t, &t->a, '1');
+    ccnl_test_txq_add(t, &t->a, '2');
+    ccnl_test_txq_add(t, &t->a, '3');
+    ccnl_test_txq_add(t, &t->b, 'b');
+    ccnl_test_txq_add(t, NULL, 'x');
+    memset(data, '2', sizeof(data));
+    buf = ccnl_buf_new(data, sizeof(data));
+    found = ccnl_txq_find(&t->q, &t->a, buf) && !ccnl_txq_find(&t->q, &t->b, buf);
+    if (!C_ASSERT_EQUAL_INT(found, 1) ||
+        !C_ASSERT_EQUAL_INT(t->q.qlen, 5) ||
+        !C_ASSERT_EQUAL_INT(t->q.qbytes, 50) ||
+        !C_ASSERT_EQUAL_STRING(ccnl_test_txq_sent(t, 10), "1bx23")) {
+        ccnl_buf_free(buf);
+        return 0;
+    }
+    found = ccnl_txq_find(&t->q, &t->a, buf);
+    ccnl_buf_free(buf);
+    return C_ASSERT_EQUAL_INT(found, 0) && C_ASSERT_EQUAL_INT(t->q.qlen, 0);
+}
+
+//packets waiting too long are dropped, those of a removed face are still sent
+//-------------------------------------------------------------------------------------------
+int ccnl_test_run_txq_codel(void *txq, void *unused){
+
+    struct ccnl_txq_test_s *t = txq;
+    struct ccnl_txrequest_s *r;
+    char id;
+
+    (void) unused;
+    for (id = '0'; id <= '9'; id++)
+        ccnl_test_txq_add(t, &t->a, id);
+    for (r = t->a.txflow.head; r; r = r->next)
+        r->enqueued -= 2 * CCNL_TXQ_INTERVAL;
+    if (!C_ASSERT_EQUAL_STRING(ccnl_test_txq_sent(t, 1), "0"))
+        return 0;
+    t->a.txflow.first_above -= 2 * CCNL_TXQ_INTERVAL; // above for too long
+    if (!C_ASSERT_EQUAL_STRING(ccnl_test_txq_sent(t, 2), "23") ||
+        !C_ASSERT_EQUAL_INT(t->q.aqm_drops, 1) ||
+        !C_ASSERT_EQUAL_INT(t->q.sojourn >= 2 * CCNL_TXQ_INTERVAL, 1))
+        return 0;
+    ccnl_txq_orphan(&t->q, &t->a);
+    return C_ASSERT_EQUAL_INT(t->a.txflow.qlen, 0) &&
+           C_ASSERT_EQUAL_INT(t->q.qlen, 6) &&
+           C_ASSERT_EQUAL_STRING(ccnl_test_txq_sent(t, 10), "456789");
+}
+
+//a face with packets at another interface does not stay in the queue
+//once it is removed
+//-------------------------------------------------------------------------------------------
+int ccnl_test_run_txq_spill(void *txq, void *unused){
+
+    struct ccnl_txq_test_s *t = txq;
+    struct ccnl_txq_s other;
+    unsigned char data[10];
+    struct ccnl_buf_s *buf;
+    int found;
+
+    (void) unused;
+    memset(&other, 0, sizeof(other));
+    memset(data, 'o', sizeof(data));
+    ccnl_txq_enqueue(&other, &t->a, ccnl_buf_new(data, sizeof(data)),
+                     &t->dst, NULL);
+    ccnl_test_txq_add(t, &t->a, '1');
+    memset(data, '1', sizeof(data));
+    buf = ccnl_buf_new(data, sizeof(data));
+    found = ccnl_txq_find(&t->q, &t->a, buf);
+    ccnl_txq_orphan(&t->q, &t->a);
+    ccnl_txq_orphan(&other, &t->a);
+    found += 2 * ccnl_txq_find(&t->q, &t->a, buf);
+    ccnl_buf_free(buf);
+    ccnl_txq_cleanup(&other);
+    return C_ASSERT_EQUAL_INT(found, 1) &&
+           C_ASSERT_EQUAL_INT(t->q.flow.head->txdone_face == NULL, 1) &&
+           C_ASSERT_EQUAL_STRING(ccnl_test_txq_sent(t, 10), "1");
+}
+
+//a full queue drops from the longest flow
+//-------------------------------------------------------------------------------------------
+int ccnl_test_run_txq_full(void *txq, void *unused){
+
+    struct ccnl_txq_test_s *t = txq;
+    int k;
+
+    (void) unused;
+    ccnl_test_txq_add(t, &t->a, 'a');
+    for (k = 1; k < CCNL_MAX_IF_QLEN; k++)
+        ccnl_test_txq_add(t, &t->b, 'b');
+    if (!C_ASSERT_EQUAL_INT(ccnl_test_txq_add(t, &t->a, 'A'), 0) ||
+        !C_ASSERT_EQUAL_INT(t->q.qlen, CCNL_MAX_IF_QLEN) ||
+        !C_ASSERT_EQUAL_INT(t->q.drops, 1) ||
+        !C_ASSERT_EQUAL_INT(t->b.txflow.qlen, CCNL_MAX_IF_QLEN - 2))
+        return 0;
+    return C_ASSERT_EQUAL_STRING(ccnl_test_txq_sent(t, 3), "abA");
+}
+
+//Run Tests
+int main(){
+    int testnum = 0;
+    int res = 0;
+    void *txq = NULL, *unused = NULL;
+
+    //Test: DRR
+    ++testnum;
+    res = RUN_TEST(testnum, "testing round robin and duplicates of the interface queue",
+                   ccnl_test_prepare_txq, ccnl_test_run_txq_drr,
+                   ccnl_test_cleanup_txq, txq, unused);
+    if(!res){
+        return -1;
+    }
+
+    //Test: CODEL
+    ++testnum;
+    res = RUN_TEST(testnum, "testing CoDel drops of the interface queue",
+                   ccnl_test_prepare_txq, ccnl_test_run_txq_codel,
+                   ccnl_test_cleanup_txq, txq, unused);
+    if(!res){
+        return -1;
+    }
+
+    //Test: FACE AT TWO INTERFACES
+    ++testnum;
+    res = RUN_TEST(testnum, "testing the removal of a face at two interfaces",
+                   ccnl_test_prepare_txq, ccnl_test_run_txq_spill,
+                   ccnl_test_cleanup_txq, txq, unused);
+    if(!res){
+        return -1;
+    }
+
+    //Test: FULL QUEUE
+    ++testnum;
+    res = RUN_TEST(testnum, "testing a full interface queue",
+                   ccnl_test_prepare_txq, ccnl_test_run_txq_full,
+                   ccnl_test_cleanup_txq, txq, unused);
+    if(!res){
+        return -1;
+    }
+    return 0;
+}
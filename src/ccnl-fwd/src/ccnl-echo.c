@@ -94,6 +94,9 @@ ccnl_echo_cleanup(struct ccnl_relay_s *relay)
     for (fwd = relay->fib; fwd; fwd = fwd->next) {
         if (fwd->tap == ccnl_echo_request) {
             fwd->tap = NULL;
+#ifdef USE_SHARDS
+            relay->fib_gen++;
+#endif
 /*
             if (fwd->face == NULL) { // remove this entry
                 free_prefix(fwd->prefix);
@@ -62,7 +62,7 @@ int
 ccnl_fwd_handleContent(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                        struct ccnl_pkt_s **pkt)
 {
-    struct ccnl_content_s *c;
+    struct ccnl_content_s *c, *uncached = NULL;
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
 
@@ -86,6 +86,10 @@ ccnl_fwd_handleContent(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                   ccnl_suite2str((*pkt)->suite),
                   ccnl_addr2ascii(from ? &from->peer : NULL));
 #endif
+#ifdef USE_STATS
+    if (from)
+        from->stats.data_in++;
+#endif
 
 #if defined(USE_SUITE_CCNB) && defined(USE_SIGNATURES)
 //  FIXME: mgmt messages for NDN and other suites?
@@ -97,11 +101,9 @@ ccnl_fwd_handleContent(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
 #endif /* USE_SUITE_CCNB && USE_SIGNATURES*/
 
     // CONFORM: Step 1:
-    for (c = relay->contents; c; c = c->next) {
-        if (buf_equal(c->pkt->buf, (*pkt)->buf)) {
-            DEBUGMSG_CFWD(TRACE, "  content is duplicate, ignoring\n");
-            return 0; // content is dup, do nothing
-        }
+    if (ccnl_content_find_dup(relay, *pkt)) {
+        DEBUGMSG_CFWD(TRACE, "  content is duplicate, ignoring\n");
+        return 0; // content is dup, do nothing
     }
 
 #ifdef USE_NFN_REQUESTS
@@ -143,6 +145,10 @@ ccnl_fwd_handleContent(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
     if (!ccnl_content_serve_pending(relay, c)) { // unsolicited content
         // CONFORM: "A node MUST NOT forward unsolicited data [...]"
         DEBUGMSG_CFWD(DEBUG, "  removed because no matching interest\n");
+#ifdef USE_STATS
+        if (from)
+            from->stats.drops[CCNL_DROP_UNSOLICITED]++;
+#endif
         ccnl_content_free(c);
         return 0;
     }
@@ -152,7 +158,8 @@ ccnl_fwd_handleContent(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
 #endif
         if (relay->max_cache_entries != 0) { // it's set to -1 or a limit
             DEBUGMSG_CFWD(DEBUG, "  adding content to cache\n");
-            ccnl_content_add2cache(relay, c);
+            if (ccnl_content_add2cache(relay, c) < 0)
+                uncached = c; // no room, e.g. larger than the byte budget
             DEBUGMSG_CFWD(INFO, "data after creating packet %.*s\n", c->pkt->contlen, c->pkt->content);
         } else {
             DEBUGMSG_CFWD(DEBUG, "  content not added to cache\n");
@@ -175,6 +182,8 @@ ccnl_fwd_handleContent(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
         ccnl_fib_add_entry(relay, pfx_wo_chunk, from);
     }
 #endif
+    if (uncached)
+        ccnl_content_free(uncached);
     return 0;
 }
 
@@ -251,6 +260,9 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                   ccnl_suite2str((*pkt)->suite), nonce,
                   ccnl_addr2ascii(from ? &from->peer : NULL));
 #endif
+#ifdef USE_STATS
+    from->stats.interests_in++;
+#endif
 
 #ifdef USE_DUP_CHECK
 
@@ -260,6 +272,9 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
     #else
         DEBUGMSG_CFWD(DEBUG, "  dropped because of duplicate nonce %d\n", nonce);
     #endif
+#ifdef USE_STATS
+        from->stats.drops[CCNL_DROP_DUPNONCE]++;
+#endif
         return 0;
     }
 #endif
@@ -320,13 +335,12 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
             // Step 1: search in content store
     DEBUGMSG_CFWD(DEBUG, "  searching in CS\n");
 
-    for (c = relay->contents; c; c = c->next) {
-        if (c->pkt->pfx->suite != (*pkt)->pfx->suite)
-            continue;
-        if (cMatch(*pkt, c))
-            continue;
-
+    c = ccnl_content_lookup(relay, *pkt, cMatch);
+    if (c) {
         DEBUGMSG_CFWD(DEBUG, "  found matching content %p\n", (void *) c);
+#ifdef USE_STATS
+        from->stats.cs_hits++;
+#endif
         if (from->ifndx >= 0) {
 #ifdef USE_NFN_REQUESTS
             struct ccnl_pkt_s *cpkt = c->pkt;
@@ -341,6 +355,9 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                                  c->pkt->contlen);
 #endif
             ccnl_send_pkt(relay, from, c->pkt);
+#ifdef USE_STATS
+            from->stats.data_out++;
+#endif
 #ifdef USE_NFN_REQUESTS
             c->pkt = cpkt;
 #endif
@@ -350,13 +367,16 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
             ccnl_app_RX(relay, c);
 #endif
         }
+        if (c->flags & CCNL_CONTENT_FLAGS_UNCACHED)
+            ccnl_content_free(c);
         return 0; // we are done
     }
+#ifdef USE_STATS
+    from->stats.cs_misses++;
+#endif
 
     // CONFORM: Step 2: check whether interest is already known
-    for (i = relay->pit; i; i = i->next)
-        if (ccnl_interest_isSame(i, *pkt))
-            break;
+    i = ccnl_interest_lookup(relay, *pkt);
 
     if (!i) { // this is a new/unknown I request: create and propagate
 #ifdef USE_NFN
@@ -365,8 +385,12 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
 #endif
         propagate = 1;
     }
-    if (!ccnl_pkt_fwdOK(*pkt))
+    if (!ccnl_pkt_fwdOK(*pkt)) {
+#ifdef USE_STATS
+        from->stats.drops[CCNL_DROP_HOPLIMIT]++;
+#endif
         return -1;
+    }
     if (!i) {
         i = ccnl_interest_new(relay, from, pkt);
 
@@ -384,6 +408,13 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
     }
     if (i) { // store the I request, for the incoming face (Step 3)
         DEBUGMSG_CFWD(DEBUG, "  appending interest entry %p\n", (void *) i);
+#ifdef USE_STATS
+        if (!propagate) {
+            from->stats.pit_aggregated++;
+            if (i->fwd)
+                i->fwd->stats.aggregated++;
+        }
+#endif
         ccnl_interest_append_pending(i, from);
         if(propagate) {
             ccnl_interest_propagate(relay, i);
@@ -518,6 +549,9 @@ ccnl_ccntlv_forwarder(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
         hp->hoplimit--;
         if (hp->hoplimit <= 0) { // drop it
             DEBUGMSG_CFWD(DEBUG, "  pkt dropped because of hop limit\n");
+#ifdef USE_STATS
+            from->stats.drops[CCNL_DROP_HOPLIMIT]++;
+#endif
             *data += payloadlen;
             *datalen -= payloadlen;
             return 0;
@@ -642,6 +676,9 @@ ccnl_cistlv_forwarder(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
 
     hoplimit = hp->hoplim - 1;
     if (hp->pkttype == CISCO_PT_Interest && hoplimit <= 0) { // drop it
+#ifdef USE_STATS
+        from->stats.drops[CCNL_DROP_HOPLIMIT]++;
+#endif
         *data += payloadlen;
         *datalen -= payloadlen;
         return 0;
@@ -813,7 +850,7 @@ int
 ccnl_set_tap(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
              tapCallback callback)
 {
-    struct ccnl_forward_s *fwd, **fwd2;
+    struct ccnl_forward_s *fwd;
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
 
@@ -821,25 +858,24 @@ ccnl_set_tap(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
              ccnl_prefix_to_str(pfx,s,CCNL_MAX_PREFIX_SIZE),
              ccnl_suite2str(pfx->suite));
 
-    for (fwd = relay->fib; fwd; fwd = fwd->next) {
-        if (fwd->suite == pfx->suite &&
-                        !ccnl_prefix_cmp(fwd->prefix, NULL, pfx, CMP_EXACT)) {
-            ccnl_prefix_free(fwd->prefix);
-            fwd->prefix = NULL;
-            break;
-        }
-    }
-    if (!fwd) {
+    fwd = ccnl_fib_find(relay, pfx);
+    if (fwd) {
+        ccnl_prefix_free(fwd->prefix);
+        fwd->prefix = pfx;
+#ifdef USE_SHARDS
+        relay->fib_gen++;
+#endif
+    } else {
         fwd = (struct ccnl_forward_s *) ccnl_calloc(1, sizeof(*fwd));
         if (!fwd)
             return -1;
-        fwd2 = &relay->fib;
-        while (*fwd2)
-            fwd2 = &((*fwd2)->next);
-        *fwd2 = fwd;
         fwd->suite = pfx->suite;
+        fwd->prefix = pfx;
+        if (ccnl_fib_link(relay, fwd)) {
+            ccnl_free(fwd);
+            return -1;
+        }
     }
-    fwd->prefix = pfx;
     fwd->tap = callback;
     return 0;
 }
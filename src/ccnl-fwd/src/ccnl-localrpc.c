@@ -64,6 +64,9 @@ static const char *compile_string = ""
 #ifdef USE_LINKLAYER
         "ETHERNET, "
 #endif
+#ifdef USE_MALLOC_ACCT
+        "MALLOC_ACCT, "
+#endif
 #ifdef USE_WPAN
         "WPAN, "
 #endif
@@ -113,6 +113,10 @@
 #include "../../ccnl-core/src/ccnl-logging.c"
 #include "../../ccnl-core/src/ccnl-os-time.c"
 #include "../../ccnl-core/src/ccnl-prefix.c"
+#include "../../ccnl-core/src/ccnl-nametree.c"
+#include "../../ccnl-core/src/ccnl-pool.c"
+#include "../../ccnl-core/src/ccnl-cache.c"
+#include "../../ccnl-core/src/ccnl-txq.c"
 #include "../../ccnl-core/src/ccnl-relay.c"
 #include "../../ccnl-core/src/ccnl-sched.c"
 #include "../../ccnl-core/src/ccnl-interest.c"
@@ -131,7 +135,6 @@
 
 #define ccnl_app_RX(x,y)                do{}while(0)
 
-#define cache_strategy_remove(...)      0
 
 
 
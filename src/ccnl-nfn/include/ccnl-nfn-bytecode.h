@@ -0,0 +1,71 @@
+/*
+ * @f ccnl-nfn-bytecode.h
+ * @b CCN-lite, compiler of ZAM programs and lambda expressions
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_NFN_BYTECODE_H
+#define CCNL_NFN_BYTECODE_H
+
+#include "ccnl-nfn.h"
+
+/**
+ * @brief An empty program, blocks are added with ZAM_compileCode(); its
+ * names are interned in @p tab
+ */
+struct zam_prog_s*
+ZAM_newProg(struct zam_symtab_s *tab);
+
+/**
+ * @brief Compiles the ZAM program @p zam, e.g. "CLOSURE(HALT);RESOLVENAME(add 1 2)",
+ * into a new block of @p prog
+ *
+ * @param[in] suite     suite of the prefixes in the program
+ *
+ * @return the block, NULL if @p zam does not compile
+ */
+struct zam_code_s*
+ZAM_compileCode(struct zam_prog_s *prog, char *zam, int suite);
+
+/**
+ * @brief A new program with the compiled @p zam as its entry, NULL on errors
+ */
+struct zam_prog_s*
+ZAM_compile(struct zam_symtab_s *tab, char *zam, int suite);
+
+/**
+ * @brief The code CALL runs for @p num_params parameters, compiled into
+ * @p prog on first use
+ */
+struct zam_code_s*
+ZAM_callCode(struct zam_prog_s *prog, int num_params, int suite);
+
+void
+ZAM_freeProg(struct zam_prog_s *prog);
+
+/**
+ * @brief Writes the instructions of @p code from @p pc on to @p buf,
+ * for debug output
+ *
+ * @return the length written, at most @p size - 1
+ */
+int
+ZAM_code2str(char *buf, int size, struct zam_code_s *code, int pc);
+
+#endif // CCNL_NFN_BYTECODE_H
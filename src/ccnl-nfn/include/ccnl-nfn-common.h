@@ -61,9 +61,13 @@ struct ccnl_prefix_s *
 ccnl_nfnprefix_mkCallPrefix(struct ccnl_prefix_s *name,
                             struct configuration_s *config, int parameter_num);
 
+// frees the prefixes of the elements, the rest is in the arena
 void
 ccnl_nfn_freeStack(struct stack_s* s);
 
+int
+ccnl_nfnprefix_toExpr(struct ccnl_prefix_s *prefix, char *str);
+
 struct ccnl_interest_s *
 ccnl_nfn_query2interest(struct ccnl_relay_s *ccnl,
                         struct ccnl_prefix_s **prefix,
@@ -76,13 +80,13 @@ create_prefix_for_content_on_result_stack(struct ccnl_relay_s *ccnl,
 struct const_s *
 ccnl_nfn_krivine_str2const(char *str);
 
-void ccnl_nfn_freeClosure(struct closure_s *c);
-
 void ccnl_nfn_releaseEnvironment(struct environment_s **env);
 
+// see ccnl-nfn-env.c
+void ccnl_nfn_freeEnvironment(struct environment_s *env);
+
 struct configuration_s *
-new_config(struct ccnl_relay_s *ccnl, char *prog,
-           struct environment_s *global_dict,
+new_config(struct ccnl_relay_s *ccnl, struct zam_prog_s *prog,
            int start_locally,
            struct ccnl_prefix_s *prefix, int configid, int suite);
 
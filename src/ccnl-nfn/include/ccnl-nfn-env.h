@@ -0,0 +1,108 @@
+/*
+ * @f ccnl-nfn-env.h
+ * @b CCN-lite, interned names and persistent environments of the ZAM
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_NFN_ENV_H
+#define CCNL_NFN_ENV_H
+
+#include "ccnl-nfn.h"
+
+/**
+ * Each relay has a table of the names its programs use. A name is
+ * interned when a program is compiled, the program holds a reference to
+ * it until it is freed; the names of builtins stay. The table also holds
+ * the global environment (add, ifelse, ...), compiled and bound once per
+ * relay and shared by all its configurations.
+ */
+
+#define ZAM_SYM_BUCKETS         256         // power of two
+
+struct zam_symtab_s {
+    struct zam_sym_s *buckets[ZAM_SYM_BUCKETS];
+    unsigned int nextid;
+    int count;
+    struct zam_prog_s *lib;         // the code of the global environment
+    struct environment_s *globals;
+};
+
+/**
+ * @brief The table of @p ccnl, created with the global environment on
+ * first use
+ */
+struct zam_symtab_s*
+ZAM_symtab(struct ccnl_relay_s *ccnl);
+
+void
+ZAM_freeSymtab(struct zam_symtab_s *tab);
+
+/**
+ * @brief The symbol of the @p len characters at @p name, with a new
+ * reference to it
+ */
+struct zam_sym_s*
+ZAM_intern(struct zam_symtab_s *tab, const char *name, int len);
+
+/**
+ * @brief The symbol of @p name if it is known, no reference is taken
+ */
+struct zam_sym_s*
+ZAM_findSym(struct zam_symtab_s *tab, const char *name, int len);
+
+void
+ZAM_releaseSym(struct zam_symtab_s *tab, struct zam_sym_s *sym);
+
+/**
+ * @brief The code bound to @p name in the global environment
+ */
+struct zam_code_s*
+ZAM_global(struct zam_symtab_s *tab, const char *name);
+
+/**
+ * @brief A new environment: @p env with @p sym bound to the closure of
+ * @p code and @p cenv. @p env is not changed.
+ *
+ * With an @p arena, the new nodes are taken from it and nothing is
+ * counted. Without, they are counted: the result has a reference for the
+ * caller, @p env keeps its reference and the one to @p cenv is taken over
+ * (and released if out of memory).
+ *
+ * @return the environment, NULL if out of memory
+ */
+struct environment_s*
+ZAM_envBind(struct ccnl_arena_s *arena, struct environment_s *env,
+            struct zam_sym_s *sym, struct zam_code_s *code,
+            struct environment_s *cenv);
+
+/**
+ * @brief The closure bound to @p sym in @p env, NULL if there is none
+ */
+struct closure_s*
+ZAM_envFind(struct environment_s *env, struct zam_sym_s *sym);
+
+/**
+ * @brief Calls @p fct for each binding of @p env, for debug output
+ */
+void
+ZAM_envWalk(struct environment_s *env,
+            void (*fct)(struct zam_sym_s *sym, struct closure_s *c, void *arg),
+            void *arg);
+
+#endif // CCNL_NFN_ENV_H
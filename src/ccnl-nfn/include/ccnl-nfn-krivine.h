@@ -16,8 +16,13 @@ Krivine_reduction(struct ccnl_relay_s *ccnl, char *expression,
                   struct configuration_s **config,
                   struct ccnl_prefix_s *prefix, int suite);
 
+// an object of the computation, freed with the configuration
+void*
+ZAM_alloc(struct configuration_s *config, size_t size);
+
 void
-push_to_stack(struct stack_s **top, void *content, int type);
+push_to_stack(struct configuration_s *config, struct stack_s **top,
+              void *content, int type);
 
 struct stack_s *
 pop_from_stack(struct stack_s **top);
@@ -26,4 +31,13 @@ struct stack_s *
 pop_or_resolve_from_result_stack(struct ccnl_relay_s *ccnl,
                                  struct configuration_s *config);
 
+// for builtins: continue with code, then after the builtin; returns
+// ZAM_BIF_JUMP, or ZAM_BIF_END if code is NULL
+int
+ZAM_enter(struct configuration_s *config, struct zam_code_s *code);
+
+// for builtins: TAILAPPLY, enters the closure on top of the argument stack
+int
+ZAM_tailapply(struct configuration_s *config);
+
 #endif //CCNL_NFN_KRIVINE_H
@@ -0,0 +1,118 @@
+/*
+ * @f ccnl-nfn-memo.h
+ * @b CCN-lite, memo table of NFN results
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_NFN_MEMO_H
+#define CCNL_NFN_MEMO_H
+
+#ifndef CCNL_LINUXKERNEL
+#include <stdint.h>
+#endif
+
+#include "ccnl-nfn.h"
+
+/**
+ * Results of NFN computations, keyed on the normalized expression and the
+ * suite. The relay's own results and those of sub-computations it
+ * receives are kept, independent of the content store, so that the same
+ * expression, asked by another client or as part of another computation,
+ * is neither evaluated nor fetched again. The least recently used entries
+ * are dropped to stay within the bounds, entries expire after
+ * NFN_MEMO_LIFETIME seconds.
+ */
+
+#define NFN_MEMO_BUCKETS        128         // power of two
+#define NFN_MEMO_MAX_ENTRIES    512
+#define NFN_MEMO_MAX_BYTES      (256 * 1024)
+#define NFN_MEMO_LIFETIME       300         // seconds
+
+struct nfn_memo_entry_s {
+    struct nfn_memo_entry_s *chain;         // same bucket
+    struct nfn_memo_entry_s *next, *prev;   // most recently used first
+    uint32_t hash;
+    int suite;
+    double created;
+    char *expr;
+    struct ccnl_buf_s *result;
+};
+
+// the normalized expression of a name, computed once per computation
+struct nfn_memo_key_s {
+    struct nfn_memo_key_s *next;
+    struct ccnl_prefix_s *prefix;
+    char *key;                              // NULL if the name has none
+};
+
+struct nfn_memo_s {
+    struct nfn_memo_entry_s *buckets[NFN_MEMO_BUCKETS];
+    struct nfn_memo_entry_s *lru, *oldest;
+    int entries;
+    long bytes;
+    uint32_t hits, misses;
+};
+
+/**
+ * @brief The normalized expression of the NFN name @p prefix: the lambda
+ * expression with the routable name applied to it, reduced where a
+ * lambda is applied to a name or a number (unless the lambda body binds
+ * that name), and printed canonically. "/a/n/(@x call 1 x)" and
+ * "call 1 /a/n" have the same key.
+ *
+ * @return a string to be freed by the caller, NULL if there is none or it
+ *         would not fit into a packet
+ */
+char*
+ccnl_nfn_memo_key(struct ccnl_prefix_s *prefix);
+
+/**
+ * @brief The result computed for the expression of @p prefix, NULL if none
+ *
+ * The key of @p prefix is kept at @p config (may be NULL), which looks up
+ * the same names each time it is resumed.
+ */
+struct ccnl_buf_s*
+ccnl_nfn_memo_lookup(struct ccnl_relay_s *ccnl, struct configuration_s *config,
+                     struct ccnl_prefix_s *prefix);
+
+/**
+ * @brief Remembers @p data as the result of the expression of @p prefix
+ */
+void
+ccnl_nfn_memo_add(struct ccnl_relay_s *ccnl, struct ccnl_prefix_s *prefix,
+                  unsigned char *data, int len);
+
+/**
+ * @brief Puts the result remembered for @p prefix into the content store,
+ * see @ref ccnl_nfn_memo_lookup
+ *
+ * @return the content object, NULL if there is no result
+ */
+struct ccnl_content_s*
+ccnl_nfn_memo_content(struct ccnl_relay_s *ccnl, struct configuration_s *config,
+                      struct ccnl_prefix_s *prefix);
+
+void
+ccnl_nfn_memo_free(struct nfn_memo_s *memo);
+
+void
+ccnl_nfn_memo_freeKeys(struct nfn_memo_key_s *keys);
+
+#endif // CCNL_NFN_MEMO_H
@@ -7,7 +7,8 @@
 
 #include "ccnl-nfn.h"
 
-struct builtin_s *op_extensions;
+// ZAM_registerOp(), read when a relay builds its symbol table
+extern struct builtin_s *op_extensions;
 extern struct builtin_s bifs[];
 
 #endif //CCNL_NFN_OPS_H
@@ -29,4 +29,10 @@ ccnl_lambdaFreeTerm(struct ccnl_lambdaTerm_s *t);
 int
 ccnl_lambdaTermToStr(char *cfg, struct ccnl_lambdaTerm_s *t, char last);
 
+// as ccnl_lambdaTermToStr, but writes at most size bytes (none if cfg is
+// NULL) and returns the length of the complete string, like snprintf
+int
+ccnl_lambdaTermToStrn(char *cfg, int size, struct ccnl_lambdaTerm_s *t,
+                      char last);
+
 #endif //CCNL_NFN_PARSE_H
@@ -22,6 +22,7 @@
 #ifndef CCNL_NFN_H
 #define CCNL_NFN_H
 
+#include "ccnl-arena.h"
 #include "ccnl-relay.h"
 #include "ccnl-prefix.h"
 #include "ccnl-interest.h"
@@ -41,6 +42,37 @@
 #define STACK_TYPE_PREFIXRAW            4
 #define STACK_TYPE_CLOSURE              5
 
+#define NFN_MAX_CALL_PARAMS             64
+
+// FOX asks for the call at up to NFN_FOX_MAX_PARALLEL of its routable
+// parameters at once, and continues when NFN_FOX_QUORUM of them have
+// answered (0: all of them)
+#ifndef NFN_FOX_MAX_PARALLEL
+# define NFN_FOX_MAX_PARALLEL           8
+#endif
+#ifndef NFN_FOX_QUORUM
+# define NFN_FOX_QUORUM                 1
+#endif
+
+enum { // abstract machine instruction set
+    ZAM_UNKNOWN,
+    ZAM_ACCESS,
+    ZAM_APPLY,
+    ZAM_CALL,
+    ZAM_CLOSURE,
+    ZAM_FOX,
+    ZAM_GRAB,
+    ZAM_HALT,
+    ZAM_RESOLVENAME,
+    ZAM_TAILAPPLY,
+    // only in compiled code
+    ZAM_BUILTIN,        // a builtin_s, OP_ADD etc.
+    ZAM_DEFINE,         // bind a closure of the code to the name, for let
+    ZAM_PUSHINT,        // push an integer on the result stack
+    ZAM_PUSHCONST,      // push a copy of the const_s
+    ZAM_PUSHPREFIX      // push a copy of the prefix
+};
+
 
 void
 ZAM_init(void);
@@ -59,18 +91,73 @@ struct stack_s{
     struct stack_s *next;
 };
 
-struct environment_s{
+// a name, interned once per relay (ccnl-nfn-env.c): names are equal iff
+// their symbols are
+struct zam_sym_s{
+    struct zam_sym_s *next;     // same bucket
+    unsigned int id;            // key in environments, never reused
     int refcount;
-    char *name;
-    struct closure_s *closure;
-    struct environment_s *next;
+    struct builtin_s *bif;      // the builtin of this name, if any
+    char name[1];
 };
 
 struct closure_s{
-    char *term;
+    struct zam_code_s *code;
     struct environment_s *env;
 };
 
+// Environments are persistent hash array mapped tries over symbol ids,
+// 5 bits per level: binding a name copies the path to its slot and shares
+// everything else, so that a lookup is at most 7 steps, and closures keep
+// their environment without copying it. A node is never changed once built.
+// Those of a computation are in its arena and not counted (refcount 0).
+struct env_slot_s{
+    struct zam_sym_s *sym;      // NULL: a sub-trie
+    union {
+        struct closure_s closure;
+        struct environment_s *child;
+    } u;
+};
+
+struct environment_s{
+    int refcount;
+    unsigned int bitmap;        // slots used at this level
+    struct env_slot_s slot[1];  // one per bit set, in order
+};
+
+// Programs are compiled once (ccnl-nfn-bytecode.c) into blocks of
+// instructions; RESOLVENAME is expanded by the compiler, a CLOSURE refers
+// to the block of its body.
+struct zam_instr_s{
+    int op;
+    int num;            // PUSHINT
+    struct zam_sym_s *sym;      // ACCESS, GRAB, DEFINE
+    void *ptr;          // CLOSURE, DEFINE: code; BUILTIN: builtin_s;
+                        // PUSHCONST, PUSHPREFIX: the value
+};
+
+struct zam_code_s{
+    struct zam_code_s *next;    // blocks of the same program
+    int len;
+    struct zam_instr_s instr[1];
+};
+
+struct zam_prog_s{
+    struct zam_symtab_s *symtab;
+    struct zam_code_s *entry;
+    struct zam_code_s *blocks;
+    struct zam_sym_s **names;   // the symbols used, one reference each
+    int namecnt;
+    struct zam_code_s **calls;  // the code of CALL, by number of parameters
+    int callcnt;
+};
+
+// where to go on when the end of a block is reached
+struct zam_cont_s{
+    struct zam_code_s *code;
+    int pc;
+};
+
 struct prefix_mapping_s{
      struct prefix_mapping_s *next, *prev;
      struct ccnl_prefix_s *key;
@@ -82,6 +169,8 @@ struct fox_machine_state_s{
     struct stack_s **params;
     int it_routable_param;
     struct prefix_mapping_s *prefix_mapping;
+    struct ccnl_prefix_s *asked[NFN_FOX_MAX_PARALLEL]; // names waited for
+    int askedcnt;
 };
 
 struct configuration_s{
@@ -89,13 +178,20 @@ struct configuration_s{
     int local_done;
     int suite;
     int start_locally;
-    char *prog;
+    struct zam_prog_s *prog;
+    struct zam_code_s *code;    // block being run, NULL at the end
+    int pc;                     // its next instruction
+    struct zam_cont_s *cont;    // continuation stack
+    int contlen, contsize;
     struct stack_s *result_stack;
     struct stack_s *argument_stack;
     struct environment_s *env;
-    struct environment_s *global_dict;
     struct fox_machine_state_s *fox_state;
+    struct ccnl_arena_s arena;  // stack elements, closures, environments,
+                                // integers and constants of the computation
     struct ccnl_prefix_s *prefix;
+    struct nfn_memo_key_s *memo_keys; // of the names it looked up, see
+                                      // ccnl-nfn-memo.h
 
     struct configuration_s *next;
     struct configuration_s *prev;
@@ -110,6 +206,8 @@ struct ccnl_krivine_s {
     struct configuration_s *configuration_list;
     int configid; // = -1;
     int numOfRunningComputations; // = 0;
+    struct nfn_memo_s *memo;    // results, see ccnl-nfn-memo.h
+    struct zam_symtab_s *symtab; // names and globals, see ccnl-nfn-env.h
 };
 
 // ----------------------------------------------------------------------
@@ -147,14 +245,18 @@ struct ccnl_interest_s*
 ccnl_nfn_RX_request(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
                     struct ccnl_pkt_s **pkt);
 
-// built in function
-typedef char* (*BIF)(struct ccnl_relay_s *ccnl, struct configuration_s *config,
-               int *restart, int *halt, char *prog, char *pending,
-                      struct stack_s **stack);
+// built in function, returns one of
+#define ZAM_BIF_NEXT    0   // continue with the next instruction
+#define ZAM_BIF_AGAIN   1   // run it again, when resumed if *halt < 0
+#define ZAM_BIF_JUMP    2   // continue where ZAM_enter() went
+#define ZAM_BIF_END     3   // end of the computation
+
+typedef int (*BIF)(struct ccnl_relay_s *ccnl, struct configuration_s *config,
+                   int *restart, int *halt, struct stack_s **stack);
 
-#define A_BIF(FCT) char* FCT(struct ccnl_relay_s *ccnl,\
+#define A_BIF(FCT) int FCT(struct ccnl_relay_s *ccnl,\
         struct configuration_s *config, int *restart, int *halt,\
-        char *prog, char *pending, struct stack_s **stack);
+        struct stack_s **stack);
 
 A_BIF(op_builtin_add)
 A_BIF(op_builtin_find)
@@ -165,7 +267,7 @@ A_BIF(op_builtin_sub)
 struct builtin_s {
     char *name;
     BIF fct;
-    struct builtin_s *next;
+    struct builtin_s *next;     // ZAM_registerOp()
 };
 
 
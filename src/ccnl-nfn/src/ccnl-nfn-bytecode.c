@@ -0,0 +1,510 @@
+/*
+ * @f ccnl-nfn-bytecode.c
+ * @b CCN-lite, compiler of ZAM programs and lambda expressions
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+/*
+ * The machine used to run the program text itself, tokenizing and
+ * rewriting it on every step. Here the text is translated once: each
+ * RESOLVENAME(term) is expanded into the instructions the machine would
+ * have produced for the term, and every CLOSURE body becomes a block of
+ * its own. Names are interned per program, integers, constants and
+ * prefixes are kept in the instructions. A block which ends continues
+ * with what follows the instruction that entered it.
+ */
+
+#ifdef USE_NFN
+
+#include "ccnl-nfn-bytecode.h"
+
+#include "ccnl-nfn-common.h"
+#include "ccnl-nfn-env.h"
+#include "ccnl-nfn-parse.h"
+
+#include "ccnl-malloc.h"
+#include "ccnl-logging.h"
+
+#ifndef CCNL_LINUXKERNEL
+
+#include "ccnl-os-includes.h"
+
+// a block while it is compiled
+struct zam_buf_s {
+    struct zam_instr_s *instr;
+    int len, size;
+};
+
+static int
+zam_emit(struct zam_buf_s *b, int op, int num, struct zam_sym_s *sym,
+         void *ptr)
+{
+    struct zam_instr_s *in;
+
+    if (b->len == b->size) {
+        int size = b->size ? 2 * b->size : 8;
+        in = ccnl_realloc(b->instr, size * sizeof(*in));
+        if (!in)
+            return -1;
+        b->instr = in;
+        b->size = size;
+    }
+    in = b->instr + b->len++;
+    in->op = op;
+    in->num = num;
+    in->sym = sym;
+    in->ptr = ptr;
+    return 0;
+}
+
+// moves the instructions into a block of the program
+static struct zam_code_s*
+zam_seal(struct zam_prog_s *prog, struct zam_buf_s *b)
+{
+    struct zam_code_s *code;
+
+    code = ccnl_malloc(sizeof(*code) +
+                       (b->len ? b->len - 1 : 0) * sizeof(struct zam_instr_s));
+    if (code) {
+        code->len = b->len;
+        if (b->len)
+            memcpy(code->instr, b->instr, b->len * sizeof(struct zam_instr_s));
+        code->next = prog->blocks;
+        prog->blocks = code;
+    }
+    ccnl_free(b->instr);
+    b->instr = NULL;
+    b->len = b->size = 0;
+    return code;
+}
+
+// frees what the instructions own, the program does not know them yet
+static void
+zam_discard(struct zam_buf_s *b)
+{
+    int i;
+
+    for (i = 0; i < b->len; i++) {
+        if (b->instr[i].op == ZAM_PUSHCONST)
+            ccnl_free(b->instr[i].ptr);
+        else if (b->instr[i].op == ZAM_PUSHPREFIX)
+            ccnl_prefix_free(b->instr[i].ptr);
+    }
+    ccnl_free(b->instr);
+    b->instr = NULL;
+    b->len = b->size = 0;
+}
+
+// the program keeps one reference to each symbol it uses
+static struct zam_sym_s*
+zam_intern(struct zam_prog_s *prog, char *name, int len)
+{
+    struct zam_sym_s *s;
+    int i;
+
+    s = ZAM_findSym(prog->symtab, name, len);
+    for (i = 0; s && i < prog->namecnt; i++)
+        if (prog->names[i] == s)
+            return s;
+    if (!(prog->namecnt & (prog->namecnt - 1))) { // 0, 1, 2, 4, ...
+        struct zam_sym_s **names = ccnl_realloc(prog->names,
+            (prog->namecnt ? 2 * prog->namecnt : 1) * sizeof(*names));
+        if (!names)
+            return NULL;
+        prog->names = names;
+    }
+    s = ZAM_intern(prog->symtab, name, len);
+    if (s)
+        prog->names[prog->namecnt++] = s;
+    return s;
+}
+
+static int
+zam_compile_seq(struct zam_prog_s *prog, struct zam_buf_s *b,
+                char *zam, int len, int suite);
+
+static int
+zam_compile_term(struct zam_prog_s *prog, struct zam_buf_s *b,
+                 char *term, int suite);
+
+// what RESOLVENAME did with the term at run time
+static int
+zam_compile_lambda(struct zam_prog_s *prog, struct zam_buf_s *b,
+                   struct ccnl_lambdaTerm_s *t, int suite)
+{
+    if (!t)
+        return -1;
+    if (term_is_var(t)) {
+        char *cp = t->v, *end;
+        struct zam_sym_s *sym;
+
+        if (isdigit(*cp)) {
+            long n = strtol(cp, &end, 0);
+            if (!*end)
+                return zam_emit(b, ZAM_PUSHINT, (int) n, NULL, NULL) ||
+                       zam_emit(b, ZAM_TAILAPPLY, 0, NULL, NULL) ? -1 : 0;
+        } else if (*cp == '\'') { // quoted name (constant)
+            struct const_s *con = ccnl_nfn_krivine_str2const(cp);
+            if (!con)
+                return -1;
+            if (zam_emit(b, ZAM_PUSHCONST, 0, NULL, con)) {
+                ccnl_free(con);
+                return -1;
+            }
+            return zam_emit(b, ZAM_TAILAPPLY, 0, NULL, NULL);
+        } else if (*cp == '/') { // content name
+            struct ccnl_prefix_s *p = ccnl_URItoPrefix(cp, suite, NULL, NULL);
+            if (!p)
+                return -1;
+            if (zam_emit(b, ZAM_PUSHPREFIX, 0, NULL, p)) {
+                ccnl_prefix_free(p);
+                return -1;
+            }
+            return zam_emit(b, ZAM_TAILAPPLY, 0, NULL, NULL);
+        }
+        sym = zam_intern(prog, t->v, strlen(t->v));
+        return !sym || zam_emit(b, ZAM_ACCESS, 0, sym, NULL) ||
+               zam_emit(b, ZAM_TAILAPPLY, 0, NULL, NULL) ? -1 : 0;
+    }
+    if (term_is_lambda(t)) {
+        struct zam_sym_s *var = zam_intern(prog, t->v, strlen(t->v));
+        if (!var || zam_emit(b, ZAM_GRAB, 0, var, NULL))
+            return -1;
+        return zam_compile_lambda(prog, b, t->m, suite);
+    }
+    {   // application: the argument becomes a closure
+        struct zam_buf_s arg = {NULL, 0, 0};
+        struct zam_code_s *code;
+
+        if (zam_compile_lambda(prog, &arg, t->n, suite)) {
+            zam_discard(&arg);
+            return -1;
+        }
+        code = zam_seal(prog, &arg);
+        if (!code || zam_emit(b, ZAM_CLOSURE, 0, NULL, code))
+            return -1;
+        return zam_compile_lambda(prog, b, t->m, suite);
+    }
+}
+
+// "let NAME = EXPR endlet REST" binds the name, then goes on with REST
+static int
+zam_compile_let(struct zam_prog_s *prog, struct zam_buf_s *b,
+                char *term, int suite)
+{
+    struct zam_buf_s def = {NULL, 0, 0};
+    struct zam_code_s *code;
+    struct zam_sym_s *name;
+    char *eq, *endlet, *end, c;
+    int namelen, rc;
+
+    eq = strchr(term, '=');
+    endlet = eq ? strstr(eq, "endlet") : NULL;
+    if (!endlet)
+        return -1;
+    for (term += 3; isspace(*term); term++);
+    for (namelen = eq - term; namelen > 0 && isspace(term[namelen-1]);
+                                                                namelen--);
+    name = zam_intern(prog, term, namelen);
+    if (!name)
+        return -1;
+
+    for (end = endlet; end > eq + 1 && isspace(end[-1]); end--);
+    c = *end;
+    *end = '\0';
+    rc = zam_compile_term(prog, &def, eq + 1, suite);
+    *end = c;
+    if (rc) {
+        zam_discard(&def);
+        return -1;
+    }
+    code = zam_seal(prog, &def);
+    if (!code || zam_emit(b, ZAM_DEFINE, 0, name, code))
+        return -1;
+    for (endlet += 6; isspace(*endlet); endlet++);
+    return *endlet ? zam_compile_term(prog, b, endlet, suite) : 0;
+}
+
+static int
+zam_compile_term(struct zam_prog_s *prog, struct zam_buf_s *b,
+                 char *term, int suite)
+{
+    struct ccnl_lambdaTerm_s *t;
+    char *cp = term;
+    int rc;
+
+    while (isspace(*cp))
+        cp++;
+    if (!strncmp(cp, "let", 3) && isspace(cp[3]))
+        return zam_compile_let(prog, b, cp, suite);
+    t = ccnl_lambdaStrToTerm(0, &cp, NULL);
+    rc = zam_compile_lambda(prog, b, t, suite);
+    ccnl_lambdaFreeTerm(t);
+    if (rc)
+        DEBUGMSG(WARNING, "could not compile term <%s>\n", term);
+    return rc;
+}
+
+static int
+zam_compile_seq(struct zam_prog_s *prog, struct zam_buf_s *b,
+                char *zam, int len, int suite)
+{
+    char *end = zam + len;
+
+    while (zam < end) {
+        char *cp = zam, *arg = NULL;
+        int namelen, arglen = 0, rc = 0;
+
+        // TODO: count opening/closing parentheses when hunting for ';' ?
+        while (cp < end && *cp != '(' && *cp != ';')
+            cp++;
+        namelen = cp - zam;
+        if (cp < end && *cp == '(') {
+            int nesting = 0;
+            arg = ++cp;
+            while (cp < end && (*cp != ')' || nesting > 0)) {
+                if (*cp == '(')
+                    nesting++;
+                else if (*cp == ')')
+                    nesting--;
+                cp++;
+            }
+            arglen = cp - arg;
+            if (cp < end)
+                cp++;
+        }
+
+#define ZAM_IS(NAME) (namelen == sizeof(NAME) - 1 && \
+                      !strncmp(zam, NAME, sizeof(NAME) - 1))
+        if (ZAM_IS("ACCESS") || ZAM_IS("GRAB")) {
+            struct zam_sym_s *name = arg ? zam_intern(prog, arg, arglen)
+                                         : NULL;
+            rc = !name || zam_emit(b, ZAM_IS("GRAB") ? ZAM_GRAB : ZAM_ACCESS,
+                                   0, name, NULL);
+        } else if (ZAM_IS("APPLY"))
+            rc = zam_emit(b, ZAM_APPLY, 0, NULL, NULL);
+        else if (ZAM_IS("CALL"))
+            rc = zam_emit(b, ZAM_CALL, 0, NULL, NULL);
+        else if (ZAM_IS("CLOSURE")) {
+            struct zam_buf_s body = {NULL, 0, 0};
+            struct zam_code_s *code;
+            if (!arg || zam_compile_seq(prog, &body, arg, arglen, suite)) {
+                zam_discard(&body);
+                return -1;
+            }
+            code = zam_seal(prog, &body);
+            rc = !code || zam_emit(b, ZAM_CLOSURE, 0, NULL, code);
+        } else if (ZAM_IS("FOX"))
+            rc = zam_emit(b, ZAM_FOX, 0, NULL, NULL);
+        else if (ZAM_IS("HALT"))
+            rc = zam_emit(b, ZAM_HALT, 0, NULL, NULL);
+        else if (ZAM_IS("RESOLVENAME")) {
+            char *term = arg ? ccnl_malloc(arglen + 1) : NULL;
+            if (!term)
+                return -1;
+            memcpy(term, arg, arglen);
+            term[arglen] = '\0';
+            rc = zam_compile_term(prog, b, term, suite);
+            ccnl_free(term);
+        } else if (ZAM_IS("TAILAPPLY"))
+            rc = zam_emit(b, ZAM_TAILAPPLY, 0, NULL, NULL);
+        else {
+            struct zam_sym_s *sym = ZAM_findSym(prog->symtab, zam, namelen);
+            struct builtin_s *bp = sym ? sym->bif : NULL;
+            if (!bp) {
+                DEBUGMSG(INFO, "  ** DID NOT find %.*s\n", namelen, zam);
+                return -1;
+            }
+            rc = zam_emit(b, ZAM_BUILTIN, 0, NULL, bp);
+        }
+#undef ZAM_IS
+        if (rc)
+            return -1;
+        if (cp < end && *cp == ';')
+            cp++;
+        zam = cp;
+    }
+    return 0;
+}
+
+// ----------------------------------------------------------------------
+
+struct zam_prog_s*
+ZAM_newProg(struct zam_symtab_s *tab)
+{
+    struct zam_prog_s *prog;
+
+    if (!tab)
+        return NULL;
+    prog = ccnl_calloc(1, sizeof(struct zam_prog_s));
+    if (prog)
+        prog->symtab = tab;
+    return prog;
+}
+
+struct zam_code_s*
+ZAM_compileCode(struct zam_prog_s *prog, char *zam, int suite)
+{
+    struct zam_buf_s b = {NULL, 0, 0};
+
+    if (zam_compile_seq(prog, &b, zam, strlen(zam), suite)) {
+        zam_discard(&b);
+        return NULL;
+    }
+    return zam_seal(prog, &b);
+}
+
+struct zam_prog_s*
+ZAM_compile(struct zam_symtab_s *tab, char *zam, int suite)
+{
+    struct zam_prog_s *prog = ZAM_newProg(tab);
+
+    if (!prog)
+        return NULL;
+    prog->entry = ZAM_compileCode(prog, zam, suite);
+    if (!prog->entry) {
+        ZAM_freeProg(prog);
+        return NULL;
+    }
+    return prog;
+}
+
+struct zam_code_s*
+ZAM_callCode(struct zam_prog_s *prog, int num_params, int suite)
+{
+    char zam[100 + 10 * NFN_MAX_CALL_PARAMS];
+    int i, len;
+
+    if (num_params < 0 || num_params > NFN_MAX_CALL_PARAMS)
+        return NULL;
+    if (num_params < prog->callcnt && prog->calls[num_params])
+        return prog->calls[num_params];
+    if (num_params >= prog->callcnt) {
+        struct zam_code_s **calls = ccnl_realloc(prog->calls,
+                                        (num_params + 1) * sizeof(*calls));
+        if (!calls)
+            return NULL;
+        memset(calls + prog->callcnt, 0,
+               (num_params + 1 - prog->callcnt) * sizeof(*calls));
+        prog->calls = calls;
+        prog->callcnt = num_params + 1;
+    }
+
+    // ... @x(@y y x 2 op)));TAILAPPLY"
+    len = sprintf(zam, "CLOSURE(FOX);RESOLVENAME(@op(");
+    for (i = 0; i < num_params; ++i)
+        len += sprintf(zam + len, "@x%d(", i);
+    for (i = num_params - 1; i >= 0; --i)
+        len += sprintf(zam + len, " x%d", i);
+    len += sprintf(zam + len, " %d op", num_params);
+    for (i = 0; i < num_params + 2; ++i)
+        len += sprintf(zam + len, ")");
+    prog->calls[num_params] = ZAM_compileCode(prog, zam, suite);
+    return prog->calls[num_params];
+}
+
+void
+ZAM_freeProg(struct zam_prog_s *prog)
+{
+    int i;
+
+    if (!prog)
+        return;
+    while (prog->blocks) {
+        struct zam_code_s *code = prog->blocks;
+        prog->blocks = code->next;
+        for (i = 0; i < code->len; i++) {
+            if (code->instr[i].op == ZAM_PUSHCONST)
+                ccnl_free(code->instr[i].ptr);
+            else if (code->instr[i].op == ZAM_PUSHPREFIX)
+                ccnl_prefix_free(code->instr[i].ptr);
+        }
+        ccnl_free(code);
+    }
+    for (i = 0; i < prog->namecnt; i++)
+        ZAM_releaseSym(prog->symtab, prog->names[i]);
+    ccnl_free(prog->names);
+    ccnl_free(prog->calls);
+    ccnl_free(prog);
+}
+
+int
+ZAM_code2str(char *buf, int size, struct zam_code_s *code, int pc)
+{
+    int len = 0;
+
+    if (size <= 0)
+        return 0;
+    *buf = '\0';
+    for (; code && pc < code->len && len < size - 1; pc++) {
+        struct zam_instr_s *in = code->instr + pc;
+        char *sep = pc + 1 < code->len ? ";" : "";
+
+        switch (in->op) {
+        case ZAM_ACCESS:
+        case ZAM_GRAB:
+        case ZAM_DEFINE:
+            len += snprintf(buf + len, size - len, "%s(%s)%s",
+                            in->op == ZAM_ACCESS ? "ACCESS" :
+                            in->op == ZAM_GRAB ? "GRAB" : "DEFINE",
+                            in->sym->name, sep);
+            break;
+        case ZAM_CLOSURE:
+            len += snprintf(buf + len, size - len, "CLOSURE(");
+            if (len < size - 1)
+                len += ZAM_code2str(buf + len, size - len, in->ptr, 0);
+            if (len < size - 1)
+                len += snprintf(buf + len, size - len, ")%s", sep);
+            break;
+        case ZAM_PUSHINT:
+            len += snprintf(buf + len, size - len, "PUSHINT(%d)%s",
+                            in->num, sep);
+            break;
+        case ZAM_PUSHCONST:
+            len += snprintf(buf + len, size - len, "PUSHCONST('%.*s')%s",
+                            ((struct const_s*) in->ptr)->len,
+                            ((struct const_s*) in->ptr)->str, sep);
+            break;
+        case ZAM_PUSHPREFIX:
+            len += snprintf(buf + len, size - len, "PUSHPREFIX(%s)%s",
+                            ccnl_prefix_to_path(in->ptr), sep);
+            break;
+        case ZAM_BUILTIN:
+            len += snprintf(buf + len, size - len, "%s%s",
+                            ((struct builtin_s*) in->ptr)->name, sep);
+            break;
+        default:
+            len += snprintf(buf + len, size - len, "%s%s",
+                            in->op == ZAM_APPLY ? "APPLY" :
+                            in->op == ZAM_CALL ? "CALL" :
+                            in->op == ZAM_FOX ? "FOX" :
+                            in->op == ZAM_HALT ? "HALT" :
+                            in->op == ZAM_TAILAPPLY ? "TAILAPPLY" : "?", sep);
+            break;
+        }
+        if (len > size - 1) // truncated
+            len = size - 1;
+    }
+    return len;
+}
+
+#endif // !CCNL_LINUXKERNEL
+
+#endif // USE_NFN
+// eof
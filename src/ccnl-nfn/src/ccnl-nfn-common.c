@@ -25,6 +25,9 @@
 #ifdef USE_NFN
 
 #include "ccnl-nfn-common.h"
+#include "ccnl-nfn-bytecode.h"
+#include "ccnl-nfn-env.h"
+#include "ccnl-nfn-memo.h"
 
 #include <stdio.h>
 
@@ -87,8 +90,8 @@ ccnl_nfn_query2interest(struct ccnl_relay_s *ccnl,
 
     DEBUGMSG(TRACE, "nfn_query2interest(configID=%d)\n", config->configid);
 
-    from = ccnl_malloc(sizeof(struct ccnl_face_s));
-    pkt = ccnl_calloc(1, sizeof(*pkt));
+    from = ccnl_calloc(1, sizeof(struct ccnl_face_s));
+    pkt = ccnl_pool_alloc(CCNL_POOL_PKT);
     if (!from || !pkt) {
         ccnl_free(from);
         ccnl_pkt_free(pkt);
@@ -140,13 +143,13 @@ ccnl_nfn_result2content(struct ccnl_relay_s *ccnl,
              ccnl_prefix_to_path(*prefix), ccnl_suite2str((*prefix)->suite),
              resultlen);
 
-    pkt = ccnl_calloc(1, sizeof(*pkt));
+    pkt = ccnl_pool_alloc(CCNL_POOL_PKT);
     if (!pkt)
         return NULL;
 
     pkt->buf = ccnl_mkSimpleContent(*prefix, resultstr, resultlen, &resultpos, NULL);
     if (!pkt->buf) {
-        ccnl_free(pkt);
+        ccnl_pool_free(CCNL_POOL_PKT, pkt);
         return NULL;
     }
     pkt->pfx = *prefix;
@@ -170,8 +173,7 @@ new_machine_state(void)
 }
 
 struct configuration_s *
-new_config(struct ccnl_relay_s *ccnl, char *prog,
-           struct environment_s *global_dict,
+new_config(struct ccnl_relay_s *ccnl, struct zam_prog_s *prog,
            int start_locally,
            struct ccnl_prefix_s *prefix, int configid, int suite)
 {
@@ -180,7 +182,7 @@ new_config(struct ccnl_relay_s *ccnl, char *prog,
 
     ret = ccnl_calloc(1, sizeof(struct configuration_s));
     ret->prog = prog;
-    ret->global_dict = global_dict;
+    ret->code = prog ? prog->entry : NULL;
     ret->fox_state = new_machine_state();
     ret->configid = ccnl->km->configid;
     ret->start_locally = start_locally;
@@ -190,18 +192,6 @@ new_config(struct ccnl_relay_s *ccnl, char *prog,
     return ret;
 }
 
-void
-ccnl_nfn_freeEnvironment(struct environment_s *env)
-{
-    while (env && env->refcount <= 1) {
-        struct environment_s *next = env->next;
-        ccnl_free(env->name);
-        ccnl_nfn_freeClosure(env->closure);
-        ccnl_free(env);
-        env = next;
-    }
-}
-
 void
 ccnl_nfn_releaseEnvironment(struct environment_s **env)
 {
@@ -214,16 +204,6 @@ ccnl_nfn_releaseEnvironment(struct environment_s **env)
     }
 }
 
-void
-ccnl_nfn_freeClosure(struct closure_s *c)
-{
-    if (!c)
-        return;
-    ccnl_free(c->term);
-    ccnl_nfn_releaseEnvironment(&c->env);
-    ccnl_free(c);
-}
-
 void ccnl_nfn_reserveEnvironment(struct environment_s *env) {
     if (!env)
         return;
@@ -233,24 +213,9 @@ void ccnl_nfn_reserveEnvironment(struct environment_s *env) {
 void
 ccnl_nfn_freeStack(struct stack_s* s)
 {
-    while (s) {
-        struct stack_s *next = s->next;
-
-        switch (s->type) {
-        case STACK_TYPE_CLOSURE:
-            ccnl_nfn_freeClosure((struct closure_s *)s->content);
-            break;
-        case STACK_TYPE_PREFIX:
+    for (; s; s = s->next)
+        if (s->type == STACK_TYPE_PREFIX || s->type == STACK_TYPE_PREFIXRAW)
             ccnl_prefix_free(((struct ccnl_prefix_s *)s->content));
-            break;
-        case STACK_TYPE_INT:
-        default:
-            ccnl_free(s->content);
-            break;
-        }
-        ccnl_free(s);
-        s = next;
-    }
 }
 
 void
@@ -265,8 +230,9 @@ ccnl_nfn_freeMachineState(struct fox_machine_state_s* f)
         int i = f->num_of_params;
         for (s = f->params; i > 0; s++, i--)
             ccnl_nfn_freeStack(*s);
-        ccnl_free(f->params);
     }
+    while (f->askedcnt > 0)
+        ccnl_prefix_free(f->asked[--f->askedcnt]);
     /*while (f->prefix_mapping) {
         struct prefix_mapping_s *m = f->prefix_mapping;
         //FIXME: WHY SEGFAULT HERE???
@@ -290,13 +256,17 @@ ccnl_nfn_freeConfiguration(struct configuration_s* c)
 
     if (!c)
         return;
-    ccnl_free(c->prog);
     ccnl_nfn_freeStack(c->result_stack);
     ccnl_nfn_freeStack(c->argument_stack);
-    ccnl_nfn_releaseEnvironment(&c->env);
-    ccnl_nfn_releaseEnvironment(&c->global_dict);
     ccnl_nfn_freeMachineState(c->fox_state);
+    ccnl_nfn_memo_freeKeys(c->memo_keys);
+    DEBUGMSG(DEBUG, "  arena of %d: %d bytes in %d chunks\n", c->configid,
+             (int) c->arena.used, c->arena.chunkcnt);
+    ccnl_arena_release(&c->arena);
     ccnl_prefix_free(c->prefix);
+    // the arena referred to the code and names
+    ZAM_freeProg(c->prog);
+    ccnl_free(c->cont);
     ccnl_free(c);
 }
 
@@ -315,6 +285,8 @@ ccnl_nfn_freeKrivine(struct ccnl_relay_s *ccnl)
         DBL_LINKED_LIST_REMOVE(ccnl->km->configuration_list, c);
         ccnl_nfn_freeConfiguration(c);
     }
+    ccnl_nfn_memo_free(ccnl->km->memo);
+    ZAM_freeSymtab(ccnl->km->symtab);
     ccnl_free(ccnl->km);
 }
 
@@ -453,6 +425,11 @@ ccnl_nfn_local_content_search(struct ccnl_relay_s *ccnl,
     if (prefixchunkzero) ccnl_prefix_free(prefixchunkzero);
     prefixchunkzero = 0;
 
+    // a result computed or received before, by this or another computation
+    content = ccnl_nfn_memo_content(ccnl, config, prefix);
+    if (content)
+        return content;
+
     if (!config || !config->fox_state || !config->fox_state->prefix_mapping)
         return NULL;
 
@@ -514,7 +491,7 @@ ccnl_nfn_interest_remove(struct ccnl_relay_s *relay, struct ccnl_interest_s *i)
     else
         ccnl_nack_reply(relay, i->pkt->pfx, face, i->pkt->suite);
 #endif
-    i->from = NULL;
+    ccnl_interest_set_from(i, NULL);
     i = ccnl_interest_remove(relay, i);
 
     if (faceid < 0)
@@ -577,7 +554,7 @@ ccnl_nfn_mkKeepaliveInterest(struct ccnl_relay_s *ccnl,
 
     // If no existing keepalive interest was found, create a new one.
     if (!i) {
-        pkt = (struct ccnl_pkt_s *) ccnl_calloc(1, sizeof(*pkt));
+        pkt = ccnl_pool_alloc(CCNL_POOL_PKT);
         if (!pkt)
             return NULL;
 
@@ -700,6 +677,33 @@ ccnl_nfnprefix_clear(struct ccnl_prefix_s *p, unsigned int flags)
     p->nfnflags &= ~flags;
 }
 
+// the expression of an NFN name: its last component, followed by the
+// routable name in front of it if there is one
+int
+ccnl_nfnprefix_toExpr(struct ccnl_prefix_s *prefix, char *str)
+{
+    int i, len, offset = 0;
+
+#if defined(USE_SUITE_CCNTLV) || defined(USE_SUITE_CISTLV)
+    if (prefix->suite == CCNL_SUITE_CCNTLV ||
+                                        prefix->suite == CCNL_SUITE_CISTLV)
+        offset = 4;
+#endif
+    if (prefix->compcnt < 1) {
+        *str = '\0';
+        return 0;
+    }
+    len = prefix->complen[prefix->compcnt-1] - offset;
+    memcpy(str, prefix->comp[prefix->compcnt-1] + offset, len);
+    str[len] = '\0';
+    if (prefix->compcnt > 1)
+        len += sprintf(str + len, " ");
+    for (i = 0; i < prefix->compcnt-1; i++)
+        len += sprintf(str+len,"/%.*s", prefix->complen[i] - offset,
+                       prefix->comp[i] + offset);
+    return len;
+}
+
 int
 ccnl_nfnprefix_fillCallExpr(char *buf, struct fox_machine_state_s *s,
                             int exclude_param)
@@ -757,9 +761,11 @@ ccnl_nfnprefix_mkCallPrefix(struct ccnl_prefix_s *name,
     struct ccnl_prefix_s *p;
     char *bytes = ccnl_malloc(CCNL_MAX_PACKET_SIZE);
 
-    p = ccnl_prefix_new(name->suite, name->compcnt + 1);
-    if (!p)
+    p = bytes ? ccnl_prefix_new(name->suite, name->compcnt + 1) : NULL;
+    if (!p) {
+        ccnl_free(bytes);
         return NULL;
+    }
 
     p->compcnt = name->compcnt + 1;
     p->nfnflags = CCNL_PREFIX_NFN;
@@ -805,9 +811,17 @@ ccnl_nfnprefix_mkCallPrefix(struct ccnl_prefix_s *name,
     }
     len += p->complen[i];
 
-    p->bytes = ccnl_realloc(bytes, len);
+    // moved rather than realloc'ed, the components are rebased on bytes
+    p->bytes = ccnl_malloc(len);
+    if (!p->bytes) {
+        ccnl_free(bytes);
+        ccnl_prefix_free(p);
+        return NULL;
+    }
+    memcpy(p->bytes, bytes, len);
     for (i = 0; i < p->compcnt; i++)
         p->comp[i] = (unsigned char*)(p->bytes + ((char*)p->comp[i] - bytes));
+    ccnl_free(bytes);
 
     return p;
 }
@@ -819,10 +833,12 @@ ccnl_nfnprefix_mkComputePrefix(struct configuration_s *config, int suite)
     struct ccnl_prefix_s *p;
     char *bytes = ccnl_malloc(CCNL_MAX_PACKET_SIZE);
 
-    p = ccnl_prefix_new(suite, 2);
-    p->compcnt = 2;
-    if (!p)
+    p = bytes ? ccnl_prefix_new(suite, 2) : NULL;
+    if (!p) {
+        ccnl_free(bytes);
         return NULL;
+    }
+    p->compcnt = 2;
     p->nfnflags = CCNL_PREFIX_NFN;
 
 #ifdef USE_NFN_REQUESTS
@@ -868,9 +884,17 @@ ccnl_nfnprefix_mkComputePrefix(struct configuration_s *config, int suite)
     }
     len += p->complen[1];
 
-    p->bytes = ccnl_realloc(bytes, len);
+    // moved rather than realloc'ed, the components are rebased on bytes
+    p->bytes = ccnl_malloc(len);
+    if (!p->bytes) {
+        ccnl_free(bytes);
+        ccnl_prefix_free(p);
+        return NULL;
+    }
+    memcpy(p->bytes, bytes, len);
     for (i = 0; i < p->compcnt; i++)
         p->comp[i] = (unsigned char*)(p->bytes + ((char*)p->comp[i] - bytes));
+    ccnl_free(bytes);
 
     return p;
 }
@@ -0,0 +1,411 @@
+/*
+ * @f ccnl-nfn-env.c
+ * @b CCN-lite, interned names and persistent environments of the ZAM
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifdef USE_NFN
+
+#include "ccnl-nfn-env.h"
+
+#include "ccnl-nfn-bytecode.h"
+#include "ccnl-nfn-common.h"
+#include "ccnl-nfn-ops.h"
+
+#include "ccnl-malloc.h"
+#include "ccnl-logging.h"
+
+#ifndef CCNL_LINUXKERNEL
+
+#include "ccnl-os-includes.h"
+
+// ----------------------------------------------------------------------
+// symbols
+
+static unsigned int
+sym_hash(const char *name, int len)
+{
+    unsigned int h = 2166136261u; // FNV-1a
+
+    while (len-- > 0) {
+        h ^= (unsigned char) *name++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+struct zam_sym_s*
+ZAM_findSym(struct zam_symtab_s *tab, const char *name, int len)
+{
+    struct zam_sym_s *s;
+
+    s = tab->buckets[sym_hash(name, len) & (ZAM_SYM_BUCKETS - 1)];
+    for (; s; s = s->next)
+        if (!strncmp(s->name, name, len) && !s->name[len])
+            return s;
+    return NULL;
+}
+
+struct zam_sym_s*
+ZAM_intern(struct zam_symtab_s *tab, const char *name, int len)
+{
+    struct zam_sym_s *s = ZAM_findSym(tab, name, len), **bucket;
+
+    if (s) {
+        s->refcount++;
+        return s;
+    }
+    s = ccnl_calloc(1, sizeof(*s) + len);
+    if (!s)
+        return NULL;
+    memcpy(s->name, name, len);
+    s->name[len] = '\0';
+    s->id = tab->nextid++;
+    s->refcount = 1;
+    bucket = tab->buckets + (sym_hash(name, len) & (ZAM_SYM_BUCKETS - 1));
+    s->next = *bucket;
+    *bucket = s;
+    tab->count++;
+    return s;
+}
+
+void
+ZAM_releaseSym(struct zam_symtab_s *tab, struct zam_sym_s *sym)
+{
+    struct zam_sym_s **pp;
+
+    if (!sym || --sym->refcount > 0)
+        return;
+    pp = tab->buckets + (sym_hash(sym->name, strlen(sym->name)) &
+                         (ZAM_SYM_BUCKETS - 1));
+    for (; *pp; pp = &(*pp)->next)
+        if (*pp == sym) {
+            *pp = sym->next;
+            break;
+        }
+    tab->count--;
+    ccnl_free(sym);
+}
+
+// ----------------------------------------------------------------------
+// environments
+
+#define ENV_BITS    5
+#define ENV_MASK    ((1u << ENV_BITS) - 1)
+
+static int
+env_popcount(unsigned int x)
+{
+    int n = 0;
+
+    for (; x; x &= x - 1)
+        n++;
+    return n;
+}
+
+static struct environment_s*
+env_new(struct ccnl_arena_s *arena, int cnt)
+{
+    size_t size = sizeof(struct environment_s) +
+                  (cnt - 1) * sizeof(struct env_slot_s);
+    struct environment_s *e;
+
+    if (arena)
+        return ccnl_arena_alloc(arena, size);
+    e = ccnl_malloc(size);
+    if (e)
+        e->refcount = 1;
+    return e;
+}
+
+static void
+env_reserveSlot(struct env_slot_s *s)
+{
+    ccnl_nfn_reserveEnvironment(s->sym ? s->u.closure.env : s->u.child);
+}
+
+static void
+env_releaseSlot(struct env_slot_s *s)
+{
+    ccnl_nfn_releaseEnvironment(s->sym ? &s->u.closure.env : &s->u.child);
+}
+
+// a copy of e with slot pos replaced by (or, if add, inserted before) *s
+static struct environment_s*
+env_copy(struct ccnl_arena_s *arena, struct environment_s *e, int pos,
+         int add, unsigned int bit, struct env_slot_s *s)
+{
+    int cnt = e ? env_popcount(e->bitmap) : 0, i, j;
+    struct environment_s *n = env_new(arena, cnt + add);
+
+    if (!n)
+        return NULL;
+    n->bitmap = (e ? e->bitmap : 0) | bit;
+    for (i = j = 0; i < cnt + add; i++) {
+        if (i == pos) {
+            n->slot[i] = *s;
+            if (!add)
+                j++;
+            continue;
+        }
+        n->slot[i] = e->slot[j++];
+        if (!arena)
+            env_reserveSlot(n->slot + i);
+    }
+    return n;
+}
+
+static struct environment_s*
+env_bind(struct ccnl_arena_s *arena, struct environment_s *e, int shift,
+         struct env_slot_s *s)
+{
+    unsigned int bit = 1u << ((s->sym->id >> shift) & ENV_MASK);
+    int pos = e ? env_popcount(e->bitmap & (bit - 1)) : 0;
+    struct env_slot_s *old, sub;
+    struct environment_s *child;
+
+    if (!e || !(e->bitmap & bit))
+        return env_copy(arena, e, pos, 1, bit, s);
+    old = e->slot + pos;
+    if (old->sym == s->sym)
+        return env_copy(arena, e, pos, 0, bit, s);
+
+    // two names share the slot at this level: push them one level down,
+    // ids differ in some bit, the recursion ends with the last one
+    if (old->sym) {
+        sub = *old;
+        if (!arena)
+            env_reserveSlot(&sub);
+        child = env_bind(arena, NULL, shift + ENV_BITS, &sub);
+        if (!child) {
+            if (!arena)
+                env_releaseSlot(&sub);
+            return NULL;
+        }
+        sub.u.child = env_bind(arena, child, shift + ENV_BITS, s);
+        if (!arena)
+            ccnl_nfn_releaseEnvironment(&child);
+    } else
+        sub.u.child = env_bind(arena, old->u.child, shift + ENV_BITS, s);
+    if (!sub.u.child)
+        return NULL;
+    sub.sym = NULL;
+    child = env_copy(arena, e, pos, 0, bit, &sub);
+    if (!child && !arena)
+        ccnl_nfn_releaseEnvironment(&sub.u.child);
+    return child;
+}
+
+struct environment_s*
+ZAM_envBind(struct ccnl_arena_s *arena, struct environment_s *env,
+            struct zam_sym_s *sym, struct zam_code_s *code,
+            struct environment_s *cenv)
+{
+    struct environment_s *e;
+    struct env_slot_s s;
+
+    s.sym = sym;
+    s.u.closure.code = code;
+    s.u.closure.env = cenv;
+    e = env_bind(arena, env, 0, &s);
+    if (!e && !arena)
+        ccnl_nfn_releaseEnvironment(&s.u.closure.env);
+    return e;
+}
+
+struct closure_s*
+ZAM_envFind(struct environment_s *env, struct zam_sym_s *sym)
+{
+    int shift;
+
+    for (shift = 0; env; shift += ENV_BITS) {
+        unsigned int bit = 1u << ((sym->id >> shift) & ENV_MASK);
+        struct env_slot_s *s;
+
+        if (!(env->bitmap & bit))
+            return NULL;
+        s = env->slot + env_popcount(env->bitmap & (bit - 1));
+        if (s->sym)
+            return s->sym == sym ? &s->u.closure : NULL;
+        env = s->u.child;
+    }
+    return NULL;
+}
+
+void
+ZAM_envWalk(struct environment_s *env,
+            void (*fct)(struct zam_sym_s *sym, struct closure_s *c, void *arg),
+            void *arg)
+{
+    int i, cnt;
+
+    if (!env)
+        return;
+    cnt = env_popcount(env->bitmap);
+    for (i = 0; i < cnt; i++)
+        if (env->slot[i].sym)
+            fct(env->slot[i].sym, &env->slot[i].u.closure, arg);
+        else
+            ZAM_envWalk(env->slot[i].u.child, fct, arg);
+}
+
+void
+ccnl_nfn_freeEnvironment(struct environment_s *env)
+{
+    int i, cnt;
+
+    if (!env)
+        return;
+    cnt = env_popcount(env->bitmap);
+    for (i = 0; i < cnt; i++)
+        env_releaseSlot(env->slot + i);
+    ccnl_free(env);
+}
+
+// ----------------------------------------------------------------------
+// the global environment
+
+static struct {
+    char *name;
+    char *zam;
+} ZAM_globals[] = {
+    //Operator on Church numbers
+    {"true_church",     "RESOLVENAME(@x@y x)"},
+    {"false_church",    "RESOLVENAME(@x@y y)"},
+    {"eq_church",
+        "CLOSURE(OP_CMPEQ_CHURCH);RESOLVENAME(@op(@x(@y x y op)))"},
+    {"leq_church",
+        "CLOSURE(OP_CMPLEQ_CHURCH);RESOLVENAME(@op(@x(@y x y op)))"},
+    {"ifelse_church",   "RESOLVENAME(@expr@yes@no(expr yes no))"},
+
+    //Operator on integer numbers
+    {"eq",      "CLOSURE(OP_CMPEQ);RESOLVENAME(@op(@x(@y x y op)))"},
+    {"leq",     "CLOSURE(OP_CMPLEQ);RESOLVENAME(@op(@x(@y x y op)))"},
+    {"ifelse",  "CLOSURE(OP_IFELSE);RESOLVENAME(@op(@x x op));TAILAPPLY"},
+    {"add",     "CLOSURE(OP_ADD);RESOLVENAME(@op(@x(@y x y op)));TAILAPPLY"},
+    {"sub",     "CLOSURE(OP_SUB);RESOLVENAME(@op(@x(@y x y op)));TAILAPPLY"},
+    {"mult",    "CLOSURE(OP_MULT);RESOLVENAME(@op(@x(@y x y op)));TAILAPPLY"},
+
+    {"call",    "CLOSURE(CALL);RESOLVENAME(@op(@x x op));TAILAPPLY"},
+
+    {"raw",     "TAILAPPLY;OP_RAW"},
+
+#ifdef USE_NFN_NSTRANS
+    {"translate", "CLOSURE(OP_NSTRANS);CLOSURE(OP_FIND);"
+                  "RESOLVENAME(@of(@o1(@x(@y x y o1 of))));TAILAPPLY"},
+#endif
+    {NULL, NULL}
+};
+
+static int
+symtab_addBuiltin(struct zam_symtab_s *tab, struct builtin_s *bp)
+{
+    struct zam_sym_s *s = ZAM_intern(tab, bp->name, strlen(bp->name));
+
+    if (!s)
+        return -1;
+    s->bif = bp; // the table keeps the reference
+    return 0;
+}
+
+static int
+symtab_addGlobal(struct zam_symtab_s *tab, int i)
+{
+    struct zam_code_s *code;
+    struct zam_sym_s *s;
+    struct environment_s *e;
+
+    code = ZAM_compileCode(tab->lib, ZAM_globals[i].zam, CCNL_SUITE_DEFAULT);
+    if (!code) {
+        DEBUGMSG(ERROR, "could not compile %s\n", ZAM_globals[i].name);
+        return -1;
+    }
+    s = ZAM_intern(tab, ZAM_globals[i].name, strlen(ZAM_globals[i].name));
+    if (!s)
+        return -1;
+    e = ZAM_envBind(NULL, tab->globals, s, code, NULL);
+    if (!e)
+        return -1;
+    ccnl_nfn_releaseEnvironment(&tab->globals);
+    tab->globals = e;
+    return 0;
+}
+
+struct zam_symtab_s*
+ZAM_symtab(struct ccnl_relay_s *ccnl)
+{
+    struct zam_symtab_s *tab;
+    struct builtin_s *bp;
+    int i, rc = 0;
+
+    if (ccnl->km->symtab)
+        return ccnl->km->symtab;
+    tab = ccnl_calloc(1, sizeof(*tab));
+    if (!tab)
+        return NULL;
+    tab->nextid = 1;
+    for (i = 0; bifs[i].name; i++)
+        rc |= symtab_addBuiltin(tab, bifs + i);
+    for (bp = op_extensions; bp; bp = bp->next)
+        rc |= symtab_addBuiltin(tab, bp);
+    tab->lib = ZAM_newProg(tab);
+    if (!tab->lib)
+        rc = -1;
+    for (i = 0; !rc && ZAM_globals[i].name; i++)
+        rc |= symtab_addGlobal(tab, i);
+    if (rc) {
+        ZAM_freeSymtab(tab);
+        return NULL;
+    }
+    DEBUGMSG(DEBUG, "global environment: %d names\n", tab->count);
+    ccnl->km->symtab = tab;
+    return tab;
+}
+
+struct zam_code_s*
+ZAM_global(struct zam_symtab_s *tab, const char *name)
+{
+    struct zam_sym_s *s = ZAM_findSym(tab, name, strlen(name));
+    struct closure_s *c = s ? ZAM_envFind(tab->globals, s) : NULL;
+
+    return c ? c->code : NULL;
+}
+
+void
+ZAM_freeSymtab(struct zam_symtab_s *tab)
+{
+    int i;
+
+    if (!tab)
+        return;
+    ccnl_nfn_releaseEnvironment(&tab->globals);
+    ZAM_freeProg(tab->lib);
+    for (i = 0; i < ZAM_SYM_BUCKETS; i++)
+        while (tab->buckets[i]) {
+            struct zam_sym_s *s = tab->buckets[i];
+            tab->buckets[i] = s->next;
+            ccnl_free(s);
+        }
+    ccnl_free(tab);
+}
+
+#endif // !CCNL_LINUXKERNEL
+
+#endif // USE_NFN
+// eof
@@ -25,8 +25,9 @@
 
 #include "ccnl-nfn-krivine.h"
 
+#include "ccnl-nfn-bytecode.h"
 #include "ccnl-nfn-common.h"
-#include "ccnl-nfn-parse.h"
+#include "ccnl-nfn-env.h"
 #include "ccnl-nfn-ops.h"
 
 #include "ccnl-os-time.h"
@@ -38,43 +39,38 @@
 
 #include "ccnl-os-includes.h"
 
-enum { // abstract machine instruction set
-    ZAM_UNKNOWN,
-    ZAM_ACCESS,
-    ZAM_APPLY,
-    ZAM_CALL,
-    ZAM_CLOSURE,
-    ZAM_FOX,
-    ZAM_GRAB,
-    ZAM_HALT,
-    ZAM_RESOLVENAME,
-    ZAM_TAILAPPLY
-};
-
 // ------------------------------------------------------------------
 // Machine state functions
 
-struct closure_s *
-new_closure(char *term, struct environment_s *env)
+void*
+ZAM_alloc(struct configuration_s *config, size_t size)
 {
-    struct closure_s *ret = ccnl_calloc(1, sizeof(struct closure_s));
+    return ccnl_arena_alloc(&config->arena, size);
+}
 
-    ret->term = term;
-    ret->env = env;
-    ccnl_nfn_reserveEnvironment(env);
+struct closure_s *
+new_closure(struct configuration_s *config, struct zam_code_s *code,
+            struct environment_s *env)
+{
+    struct closure_s *ret = ZAM_alloc(config, sizeof(struct closure_s));
 
+    if (ret) {
+        ret->code = code;
+        ret->env = env;
+    }
     return ret;
 }
 
 void
-push_to_stack(struct stack_s **top, void *content, int type)
+push_to_stack(struct configuration_s *config, struct stack_s **top,
+              void *content, int type)
 {
     struct stack_s *h;
 
     if (!top)
         return;
 
-    h = ccnl_calloc(1, sizeof(struct stack_s));
+    h = ZAM_alloc(config, sizeof(struct stack_s));
     if (h) {
         DEBUGMSG(TRACE, "push_to_stack: %p\n", (void*)h);
         h->next = *top;
@@ -122,6 +118,14 @@ stack_len(struct stack_s *s)
 }
 
 // #ifdef XXX
+static void
+print_binding(struct zam_sym_s *sym, struct closure_s *c, void *arg)
+{
+   int *num = arg;
+
+   printf("  #%d %s %p\n", (*num)++, sym->name, (void*) c->code);
+}
+
 void
 print_environment(struct environment_s *env)
 {
@@ -129,10 +133,7 @@ print_environment(struct environment_s *env)
 
    printf("  env addr %p (refcount=%d)\n",
           (void*) env, env ? env->refcount : -1);
-   while (env) {
-       printf("  #%d %s %p\n", num++, env->name, (void*) env->closure);
-       env = env->next;
-   }
+   ZAM_envWalk(env, print_binding, &num);
 }
 
 void
@@ -153,7 +154,10 @@ print_argument_stack(struct stack_s *stack)
 
    while (stack){
         struct closure_s *c = stack->content;
-        printf("Arg element #%d: %s\n", num++, c ? c->term : "<mark>");
+        char code[200];
+        if (c)
+            ZAM_code2str(code, sizeof(code), c->code, 0);
+        printf("Arg element #%d: %s\n", num++, c ? code : "<mark>");
         if (c)
             print_environment(c->env);
         stack = stack->next;
@@ -162,36 +166,23 @@ print_argument_stack(struct stack_s *stack)
 // #endif
 
 void
-add_to_environment(struct environment_s **env, char *name,
-                   struct closure_s *closure)
+add_to_environment(struct configuration_s *config, struct zam_sym_s *sym,
+                   struct zam_code_s *code, struct environment_s *env)
 {
     struct environment_s *e;
 
-    if (!env)
+    e = ZAM_envBind(&config->arena, config->env, sym, code, env);
+    if (!e) {
+        DEBUGMSG(ERROR, "could not bind %s\n", sym->name);
         return;
-
-    e = ccnl_calloc(1, sizeof(struct environment_s));
-    e->name = name;
-    e->closure = closure;
-    e->next = *env;
-    *env = e;
-    ccnl_nfn_reserveEnvironment(*env);
+    }
+    config->env = e;
 }
 
 struct closure_s*
-search_in_environment(struct environment_s *env, char *name)
-{
-    for (; env; env = env->next)
-        if (!strcmp(name, env->name))
-            return env->closure;
-
-    return NULL;
-}
-
-int
-iscontentname(char *cp)
+search_in_environment(struct environment_s *env, struct zam_sym_s *sym)
 {
-    return cp[0] == '/';
+    return ZAM_envFind(env, sym);
 }
 
 // ----------------------------------------------------------------------
@@ -233,90 +224,177 @@ create_namecomps(struct ccnl_relay_s *ccnl, struct configuration_s *config,
 
 // ----------------------------------------------------------------------
 
-// return a positive integer if ZAM instuction, or
-// return a negative integer if a builtin op, otherwise return 0
-int
-ZAM_nextToken(char *prog, char **argdup, char **cont)
+// an answer that does not count, the call failed there
+static int
+fox_isNACK(struct ccnl_content_s *c)
 {
-    char *cp = prog, *cp2;
-    int len;
-    int token = ZAM_UNKNOWN;
-
-    // TODO: count opening/closing parentheses when hunting for ';' ?
-    while (*cp && *cp != '(' && *cp != ';')
-        cp++;
-    len = cp - prog;
-
-    if (!strncmp(prog, "ACCESS", len))
-        token = ZAM_ACCESS;
-    else if (!strncmp(prog, "APPLY", len))
-        token = ZAM_APPLY;
-    else if (!strncmp(prog, "CALL", len))
-        token = ZAM_CALL;
-    else if (!strncmp(prog, "CLOSURE", len))
-        token = ZAM_CLOSURE;
-    else if (!strncmp(prog, "FOX", len))
-        token = ZAM_FOX;
-    else if (!strncmp(prog, "GRAB", len))
-        token = ZAM_GRAB;
-    else if (!strncmp(prog, "HALT", len))
-        token = ZAM_HALT;
-    else if (!strncmp(prog, "RESOLVENAME", len))
-        token = ZAM_RESOLVENAME;
-    else if (!strncmp(prog, "TAILAPPLY", len))
-        token = ZAM_TAILAPPLY;
-    else {
-        for (len = 0; bifs[len].name; len++)
-            if (!strncmp(prog, bifs[len].name, strlen(bifs[len].name))) {
-                token = -(len+1);
+#ifdef USE_NACK
+    return c->pkt->contlen >= 5 && !strncmp((char*)c->pkt->content, ":NACK", 5);
+#else
+    (void)c;
+    return 0;
+#endif
+}
+
+// whether the interest config sent for pref is still in the PIT
+static int
+fox_isPending(struct ccnl_relay_s *ccnl, struct configuration_s *config,
+              struct ccnl_prefix_s *pref)
+{
+    struct ccnl_interest_s *i;
+
+    for (i = ccnl->pit; i; i = i->next)
+        if (i->from && i->from->faceid == config->configid &&
+                    !ccnl_prefix_cmp(i->pkt->pfx, NULL, pref, CMP_EXACT))
+            return 1;
+    return 0;
+}
+
+// withdraws the interests FOX still waits for, they are no longer needed
+static void
+fox_cancel(struct ccnl_relay_s *ccnl, struct configuration_s *config)
+{
+    struct fox_machine_state_s *s = config->fox_state;
+    struct ccnl_interest_s *i = ccnl->pit;
+    int j;
+
+    while (i) {
+        for (j = 0; j < s->askedcnt; j++)
+            if (i->from && i->from->faceid == config->configid &&
+                !ccnl_prefix_cmp(i->pkt->pfx, NULL, s->asked[j], CMP_EXACT))
                 break;
-            }
-        if (token == ZAM_UNKNOWN)
-            DEBUGMSG(INFO, "  ** DID NOT find %s\n", prog);
+        if (j == s->askedcnt) {
+            i = i->next;
+            continue;
+        }
+        DEBUGMSG(DEBUG, "  withdrawing interest <%s>\n",
+                 ccnl_prefix_to_path(i->pkt->pfx));
+        ccnl_interest_set_from(i, NULL);
+        if (i->pending) // others wait for it, too
+            i = i->next;
+        else
+            i = ccnl_interest_remove(ccnl, i);
     }
+    while (s->askedcnt > 0)
+        ccnl_prefix_free(s->asked[--s->askedcnt]);
+}
 
-    if (*cp == '(') {
-        int nesting = 0;
-        cp2 = ++cp;
-        while (*cp2 && (*cp2 != ')' || nesting > 0)) {
-            if (*cp2 == '(')
-                nesting++;
-            else if (*cp2 == ')')
-                nesting--;
-            cp2++;
+// asks for the call at the next NFN_FOX_MAX_PARALLEL routable parameters
+// at once, returns the result if one of them is available locally
+static struct ccnl_content_s*
+fox_ask(struct ccnl_relay_s *ccnl, struct configuration_s *config)
+{
+    struct fox_machine_state_s *s = config->fox_state;
+    struct ccnl_prefix_s *pref[NFN_FOX_MAX_PARALLEL];
+    struct ccnl_content_s *c = NULL;
+    struct ccnl_interest_s *interest;
+    int cnt = 0, j, parameter_number;
+
+    while (cnt < NFN_FOX_MAX_PARALLEL) {
+        ++s->it_routable_param;
+        parameter_number = choose_parameter(config);
+        if (parameter_number < 0)
+            break;
+        // create new prefix with name components!!!!
+        pref[cnt] = create_namecomps(ccnl, config, parameter_number,
+                                     s->params[parameter_number]->content);
+        if (!pref[cnt])
+            continue;
+        for (j = 0; j < cnt; j++)
+            if (!ccnl_prefix_cmp(pref[j], NULL, pref[cnt], CMP_EXACT))
+                break;
+        if (j < cnt) { // e.g. two parameters available locally
+            ccnl_prefix_free(pref[cnt]);
+            continue;
+        }
+        c = ccnl_nfn_local_content_search(ccnl, config, pref[cnt++]);
+        if (c && !fox_isNACK(c))
+            break;
+        c = NULL;
+    }
+
+    for (j = 0; j < cnt; j++) {
+        if (c) { // result found locally, nothing to ask for
+            ccnl_prefix_free(pref[j]);
+            continue;
+        }
+        // result not in cache, search over the network
+        s->asked[s->askedcnt] = ccnl_prefix_dup(pref[j]);
+        if (!s->asked[s->askedcnt]) { // could not be collected
+            ccnl_prefix_free(pref[j]);
+            continue;
+        }
+        s->askedcnt++;
+        interest = ccnl_nfn_query2interest(ccnl, &pref[j], config);
+        if (pref[j])
+            ccnl_prefix_free(pref[j]);
+        if (interest) {
+            ccnl_interest_propagate(ccnl, interest);
+            DEBUGMSG(DEBUG, "  new interest's face is %d\n",
+                     interest->from->faceid);
         }
-        len = cp2 - cp;
-        *argdup = ccnl_malloc(len + 1);
-        memcpy(*argdup, cp, len);
-        (*argdup)[len] = '\0';
-        if (*cp2)
-            cp = cp2 + 1;
-    } else
-        *argdup = NULL;
-
-    if (*cp == ';')
-        *cont = cp + 1;
-    else
-        *cont = NULL;
-    return token;
+    }
+    return c;
+}
+
+// the result once NFN_FOX_QUORUM of the names asked for have been
+// answered, or when no more answers can come; names answered with a
+// NACK or whose interest timed out are given up
+static struct ccnl_content_s*
+fox_collect(struct ccnl_relay_s *ccnl, struct configuration_s *config)
+{
+    struct fox_machine_state_s *s = config->fox_state;
+    struct ccnl_content_s *c, *first = NULL;
+    int j, answers = 0, pending = 0;
+    int quorum = NFN_FOX_QUORUM > 0 ? NFN_FOX_QUORUM : s->askedcnt;
+
+    DEBUGMSG(DEBUG, "Checking if results were received\n");
+    for (j = 0; j < s->askedcnt; j++) {
+        c = ccnl_nfn_local_content_search(ccnl, config, s->asked[j]);
+        if (c && !fox_isNACK(c)) {
+            set_propagate_of_interests_to_1(ccnl, s->asked[j]);
+            if (!first)
+                first = c;
+            else if (c->pkt->contlen != first->pkt->contlen ||
+                     memcmp(c->pkt->content, first->pkt->content,
+                            c->pkt->contlen))
+                DEBUGMSG(WARNING, "FOX results differ, taking the first\n");
+            answers++;
+        } else if (fox_isPending(ccnl, config, s->asked[j]))
+            pending++;
+    }
+    DEBUGMSG(DEBUG, "  %d of %d answered, %d pending\n",
+             answers, s->askedcnt, pending);
+    if (pending && answers < quorum)
+        return NULL;
+    fox_cancel(ccnl, config);
+    return first;
 }
 
-char*
+// fetches or computes the result of the call on the result stack: the call
+// is asked for at all its routable parameters in parallel, the computation
+// pauses until enough of them have answered
+int
 ZAM_fox(struct ccnl_relay_s *ccnl, struct configuration_s *config,
-        int *restart, int *halt, char *prog, char *arg, char *contd)
+        int *restart, int *halt)
 {
-    int local_search = 0, i;
-    int parameter_number = 0;
+    int i;
     struct ccnl_content_s *c = NULL;
     struct ccnl_prefix_s *pref;
     struct ccnl_interest_s *interest;
 
-    DEBUGMSG(DEBUG, "---to do: FOX <%s>\n", arg);
-    ccnl_free(arg);
+    DEBUGMSG(DEBUG, "---to do: FOX\n");
     if (*restart) {
         *restart = 0;
-        local_search = 1;
-        goto recontinue;
+        c = fox_collect(ccnl, config);
+        if (c) {
+            DEBUGMSG(DEBUG, "Result was found\n");
+            DEBUGMSG_CFWD(INFO, "data after result was found %.*s\n", c->pkt->contlen, c->pkt->content);
+            goto handlecontent;
+        }
+        if (config->fox_state->askedcnt) // still waiting
+            goto pause;
+        goto next;
     }
 
     {
@@ -330,8 +408,8 @@ ZAM_fox(struct ccnl_relay_s *ccnl, struct configuration_s *config,
     }
     DEBUGMSG(DEBUG, "NUM OF PARAMS: %d\n", config->fox_state->num_of_params);
 
-    config->fox_state->params = ccnl_malloc(sizeof(struct ccnl_stack_s *) *
-                                            config->fox_state->num_of_params);
+    config->fox_state->params = ZAM_alloc(config, sizeof(struct stack_s *) *
+                                          config->fox_state->num_of_params);
 
     for (i = 0; i < config->fox_state->num_of_params; ++i) {
         //pop parameter from stack
@@ -357,56 +435,21 @@ ZAM_fox(struct ccnl_relay_s *ccnl, struct configuration_s *config,
     //as long as there is a routable parameter: try to find a result
     config->fox_state->it_routable_param = 0;
 
-    //check if last result is now available
-recontinue: //loop by reentering after timeout of the interest...
-    if (local_search) {
-        DEBUGMSG(DEBUG, "Checking if result was received\n");
-        parameter_number = choose_parameter(config);
-        pref = create_namecomps(ccnl, config, parameter_number,
-                        config->fox_state->params[parameter_number]->content);
-        // search for a result
-        c = ccnl_nfn_local_content_search(ccnl, config, pref);
-        set_propagate_of_interests_to_1(ccnl, pref);
-        ccnl_prefix_free(pref);
-        //TODO Check? //TODO remove interest here?
-        if (c) {
-	    DEBUGMSG(DEBUG, "Result was found\n");
-            DEBUGMSG_CFWD(INFO, "data after result was found %.*s\n", c->pkt->contlen, c->pkt->content);
-            goto handlecontent;
-	}
-    }
-
-    //result was not delivered --> choose next parameter
-    ++config->fox_state->it_routable_param;
-    parameter_number = choose_parameter(config);
-    if (parameter_number < 0)
+next: // all asked so far failed, ask at the next parameters
+    c = fox_ask(ccnl, config);
+    if (c)
+        goto handlecontent;
+    if (!config->fox_state->askedcnt)
         //no more parameter --> no result found, can try a local computation
         goto local_compute;
-    // create new prefix with name components!!!!
-    pref = create_namecomps(ccnl, config, parameter_number,
-                        config->fox_state->params[parameter_number]->content);
-    c = ccnl_nfn_local_content_search(ccnl, config, pref);
-    if (c) {
-        ccnl_prefix_free(pref);
-        goto handlecontent;
-    }
-
-    // Result not in cache, search over the network
-//    pref2 = ccnl_prefix_dup(pref);
-    interest = ccnl_nfn_query2interest(ccnl, &pref, config);
-    if (pref)
-        ccnl_prefix_free(pref);
-    if (interest) {
-        ccnl_interest_propagate(ccnl, interest);
-        DEBUGMSG(DEBUG, "  new interest's face is %d\n", interest->from->faceid);
-    }
-    // wait for content, return current program to continue later
+pause:
+    // wait for content, run FOX again to continue later
     *halt = -1; //set halt to -1 for async computations
-    return ccnl_strdup(prog);
+    return ZAM_BIF_AGAIN;
 
 local_compute:
     if (config->local_done)
-        return NULL;
+        return ZAM_BIF_END;
 
     config->local_done = 1;
     pref = ccnl_nfnprefix_mkComputePrefix(config, config->suite);
@@ -420,13 +463,6 @@ local_compute:
 
 handlecontent: //if result was found ---> handle it
     if (c) {
-#ifdef USE_NACK
-        if (!strncmp((char*)c->pkt->content, ":NACK", 5)) {
-            DEBUGMSG(DEBUG, "NACK RECEIVED, going to next parameter\n");
-            ++config->fox_state->it_routable_param;
-            return prog ? ccnl_strdup(prog) : NULL;
-        }
-#endif
         int isANumber = 1, i = 0;
 	    for(i = 0; i < c->pkt->contlen; ++i){
 	    	if(!isdigit(c->pkt->content[i])){
@@ -436,15 +472,17 @@ handlecontent: //if result was found ---> handle it
 	    }
 	    
         if (isANumber){
-            int *integer = ccnl_malloc(sizeof(int));
+            int *integer = ZAM_alloc(config, sizeof(int));
             *integer = strtol((char*)c->pkt->content, 0, 0);
-            push_to_stack(&config->result_stack, integer, STACK_TYPE_INT);
+            push_to_stack(config, &config->result_stack, integer,
+                          STACK_TYPE_INT);
         } else {
             struct prefix_mapping_s *mapping;
             struct ccnl_prefix_s *name =
                 create_prefix_for_content_on_result_stack(ccnl, config);
-            push_to_stack(&config->result_stack, name, STACK_TYPE_PREFIX);
-            mapping = ccnl_malloc(sizeof(struct prefix_mapping_s));
+            push_to_stack(config, &config->result_stack, name,
+                          STACK_TYPE_PREFIX);
+            mapping = ZAM_alloc(config, sizeof(struct prefix_mapping_s));
             mapping->key = ccnl_prefix_dup(name); //TODO COPY
             mapping->value = ccnl_prefix_dup(c->pkt->pfx);
             DBL_LINKED_LIST_ADD(config->fox_state->prefix_mapping, mapping);
@@ -453,392 +491,240 @@ handlecontent: //if result was found ---> handle it
                         ccnl_prefix_to_path(mapping->value));
         }
     }
-    
-    DEBUGMSG(DEBUG, " FOX continuation: %s\n", contd);
-    return ccnl_strdup(contd);
-}
 
-char*
-ZAM_resolvename(struct configuration_s *config, char *dummybuf,
-                char *arg, char *contd)
+    return ZAM_BIF_NEXT;
+}
+// continues with the first instruction of code, and with the rest of the
+// current block when code ends; nothing is kept for a call in tail position
+int
+ZAM_enter(struct configuration_s *config, struct zam_code_s *code)
 {
-    struct ccnl_lambdaTerm_s *t;
-    char res[1000], *cp = arg;
-    int len;
-
-    DEBUGMSG(DEBUG, "---to do: resolveNAME <%s>\n", arg);
-
-    //function definition
-    if (!strncmp(cp, "let", 3)) {
-        int i, end = 0, cp2len, namelength, lambdalen;
-        char *h, *cp2, *name, *lambda_expr, *resolveterm;
-
-        DEBUGMSG(DEBUG, " fct definition: %s\n", cp);
-        strcpy(res, cp+3);
-        for (i = 0; i < (int)strlen(res); ++i) {
-            if (!strncmp(res+i, "endlet", 6)) {
-                end = i;
-                break;
-            }
+    if (!code)
+        return ZAM_BIF_END;
+    if (config->code && config->pc + 1 < config->code->len) {
+        if (config->contlen == config->contsize) {
+            int size = config->contsize ? 2 * config->contsize : 16;
+            struct zam_cont_s *cont = ccnl_realloc(config->cont,
+                                                   size * sizeof(*cont));
+            if (!cont)
+                return ZAM_BIF_END;
+            config->cont = cont;
+            config->contsize = size;
         }
-        cp2len = strlen(res+end) + strlen("RESOLVENAME()");
-        h = strchr(cp, '=');
-        namelength = h - cp;
-
-        lambda_expr = ccnl_malloc(strlen(h));
-        name = ccnl_malloc(namelength);
-        cp2 = ccnl_malloc(cp2len);
-
-        memset(cp2, 0, cp2len);
-        memset(name, 0, namelength);
-        memset(lambda_expr, 0, strlen(h));
-
-        sprintf(cp2, "RESOLVENAME(%s)", res+end+7); //add 7 to overcome endlet
-        memcpy(name, cp+3, namelength-3); //copy name without let and endlet
-        trim(name);
-
-        lambdalen = strlen(h)-strlen(cp2)+11-6;
-        memcpy(lambda_expr, h+1, lambdalen); //copy lambda expression without =
-        trim(lambda_expr);
-        resolveterm = ccnl_malloc(strlen("RESOLVENAME()")+strlen(lambda_expr));
-        sprintf(resolveterm, "RESOLVENAME(%s)", lambda_expr);
-
-        add_to_environment(&config->env, name, new_closure(resolveterm, NULL));
-
-        ccnl_free(cp);
-        return ccnl_strdup(contd);
+        config->cont[config->contlen].code = config->code;
+        config->cont[config->contlen].pc = config->pc + 1;
+        config->contlen++;
     }
+    config->code = code;
+    config->pc = 0;
+    return ZAM_BIF_JUMP;
+}
 
-    //check if term can be made available, if yes enter it as a var
-    //try with searching in global env for an added term!
-
-    t = ccnl_lambdaStrToTerm(0, &cp, NULL);
-    ccnl_free(arg);
-
-    if (term_is_var(t)) {
-        char *end = 0;
-        cp = t->v;
-        if (isdigit(*cp)) {
-            // is disgit...
-            int *integer = ccnl_malloc(sizeof(int));
-            *integer = strtol(cp, &end, 0);
-            if (end && *end)
-                end = 0;
-            if (end)
-                push_to_stack(&config->result_stack, integer, STACK_TYPE_INT);
-            else
-                ccnl_free(integer);
-        } else if (*cp == '\'') { // quoted name (constant)
-            //determine size
-            struct const_s *con = ccnl_nfn_krivine_str2const(cp);
-            push_to_stack(&config->result_stack, con, STACK_TYPE_CONST);
-            end = (char*)1;
-        } else if (iscontentname(cp)) { // is content...
-            struct ccnl_prefix_s *prefix;
-            prefix = ccnl_URItoPrefix(cp, config->suite, NULL, NULL);
-            push_to_stack(&config->result_stack, prefix, STACK_TYPE_PREFIX);
-            end = (char*)1;
-        }
-        if (end) {
-            if (contd)
-                sprintf(res, "TAILAPPLY;%s", contd);
-            else
-                sprintf(res, "TAILAPPLY");
-        } else {
-            if (contd)
-                sprintf(res, "ACCESS(%s);TAILAPPLY;%s", t->v, contd);
-            else
-                sprintf(res, "ACCESS(%s);TAILAPPLY", t->v);
-        }
-        ccnl_lambdaFreeTerm(t);
-        return ccnl_strdup(res);
-    }
-    if (term_is_lambda(t)) {
-        char *var;
-        var = t->v;
-        ccnl_lambdaTermToStr(dummybuf, t->m, 0);
-        if (contd)
-            sprintf(res, "GRAB(%s);RESOLVENAME(%s);%s", var, dummybuf, contd);
-        else
-            sprintf(res, "GRAB(%s);RESOLVENAME(%s)", var, dummybuf);
-        ccnl_lambdaFreeTerm(t);
-        return ccnl_strdup(res);
-    }
-    if (term_is_app(t)) {
-        ccnl_lambdaTermToStr(dummybuf, t->n, 0);
-        len = sprintf(res, "CLOSURE(RESOLVENAME(%s));", dummybuf);
-        ccnl_lambdaTermToStr(dummybuf, t->m, 0);
-        len += sprintf(res+len, "RESOLVENAME(%s)", dummybuf);
-        if (contd)
-            len += sprintf(res+len, ";%s", contd);
-        ccnl_lambdaFreeTerm(t);
-        return ccnl_strdup(res);
-    }
-    return NULL;
+int
+ZAM_tailapply(struct configuration_s *config)
+{
+    struct stack_s *stack = pop_from_stack(&config->argument_stack);
+    struct closure_s *closure;
+    struct zam_code_s *code;
+
+    DEBUGMSG(DEBUG, "---to do: tailapply\n");
+    if (!stack)
+        return ZAM_BIF_END;
+    closure = (struct closure_s *) stack->content;
+    code = closure->code;
+    config->env = closure->env; //set environment from closure
+    return ZAM_enter(config, code);
 }
 
-// executes a ZAM instruction, returns the term to continue working on
-char*
-ZAM_term(struct ccnl_relay_s *ccnl, struct configuration_s *config,
-        int *halt, char *dummybuf, int *restart)
+// the name if code is that of RESOLVENAME(name), NULL otherwise
+struct zam_sym_s*
+ZAM_accessName(struct zam_code_s *code)
 {
-//    struct ccnl_lambdaTerm_s *t;
-//    char *pending, *p, *cp, *prog = config->prog;
-//    int len;
-
-    char *prog = config->prog;
-    struct builtin_s *bp;
-    char *arg, *contd;
-    int tok;
-
-    //pop closure
-    if (!prog || strlen(prog) == 0) {
-         if (config->result_stack) {
-             prog = ccnl_malloc(strlen((char*)config->result_stack->content)+1);
-             strcpy(prog, config->result_stack->content);
-             return prog;
-         }
-         DEBUGMSG(DEBUG, "no result returned\n");
-         return NULL;
-    }
+    if (code && code->len == 2 && code->instr[0].op == ZAM_ACCESS &&
+                                  code->instr[1].op == ZAM_TAILAPPLY)
+        return code->instr[0].sym;
+    return NULL;
+}
 
-    tok = ZAM_nextToken(prog, &arg, &contd);
+// executes one ZAM instruction, returns 0 when there is nothing left to run
+int
+ZAM_step(struct ccnl_relay_s *ccnl, struct configuration_s *config,
+         int *halt, int *restart)
+{
+    struct zam_instr_s *in;
+    int rc = ZAM_BIF_NEXT;
 
-    // TODO: count opening/closing parentheses when hunting for ';' ?
-/*
-    pending = strchr(prog, ';');
-    p = strchr(prog, '(');
-*/
+    while (config->code && config->pc >= config->code->len) {
+        if (!config->contlen) {
+            config->code = NULL;
+            break;
+        }
+        config->contlen--;
+        config->code = config->cont[config->contlen].code;
+        config->pc = config->cont[config->contlen].pc;
+    }
+    if (!config->code) {
+        DEBUGMSG(DEBUG, "no result returned\n");
+        return 0;
+    }
+    in = config->code->instr + config->pc;
 
-    switch (tok) {
+    switch (in->op) {
     case ZAM_ACCESS:
     {
-        struct closure_s *closure = search_in_environment(config->env, arg);
-        DEBUGMSG(DEBUG, "---to do: access <%s>\n", arg);
+        struct closure_s *closure = search_in_environment(config->env,
+                                                          in->sym);
+        DEBUGMSG(DEBUG, "---to do: access <%s>\n", in->sym->name);
         if (!closure) {
-            // TODO: is the following needed? Above search should have
-            // visited global_dict, already!
-            closure = search_in_environment(config->global_dict, arg);
+            closure = search_in_environment(config->prog->symtab->globals,
+                                            in->sym);
             if (!closure) {
-                DEBUGMSG(WARNING, "?? could not lookup var %s\n", arg);
-                ccnl_free(arg);
-                return NULL;
+                DEBUGMSG(WARNING, "?? could not lookup var %s\n",
+                         in->sym->name);
+                rc = ZAM_BIF_END;
+                break;
             }
         }
-        ccnl_free(arg);
-        closure = new_closure(ccnl_strdup(closure->term), closure->env);
-        push_to_stack(&config->argument_stack, closure, STACK_TYPE_CLOSURE);
-        return ccnl_strdup(contd);
+        closure = new_closure(config, closure->code, closure->env);
+        push_to_stack(config, &config->argument_stack, closure,
+                      STACK_TYPE_CLOSURE);
+        break;
     }
     case ZAM_APPLY:
     {
         struct stack_s *fct = pop_from_stack(&config->argument_stack);
         struct stack_s *par = pop_from_stack(&config->argument_stack);
         struct closure_s *fclosure, *aclosure;
-        char *code;
         DEBUGMSG(DEBUG, "---to do: apply\n");
 
-        if (!fct || !par)
-            return NULL;
+        if (!fct || !par) {
+            rc = ZAM_BIF_END;
+            break;
+        }
         fclosure = (struct closure_s *) fct->content;
         aclosure = (struct closure_s *) par->content;
-        if (!fclosure || !aclosure)
-            return NULL;
-        ccnl_free(fct);
-        ccnl_free(par);
-
-        code = aclosure->term;
-        if (config->env)
-            ccnl_nfn_releaseEnvironment(&config->env);
-        config->env = aclosure->env;
-        ccnl_free(aclosure);
-        push_to_stack(&config->argument_stack, fclosure, STACK_TYPE_CLOSURE);
+        if (!fclosure || !aclosure) {
+            rc = ZAM_BIF_END;
+            break;
+        }
 
-        if (contd)
-            sprintf(dummybuf, "%s;%s", code, contd);
-        else
-            strcat(dummybuf, code);
-        ccnl_free(code);
-        return ccnl_strdup(dummybuf);
+        config->env = aclosure->env;
+        fct->next = config->argument_stack;
+        config->argument_stack = fct;
+        rc = ZAM_enter(config, aclosure->code);
+        break;
     }
     case ZAM_CALL:
     {
         struct stack_s *h = pop_or_resolve_from_result_stack(ccnl, config);
-        int i, offset, num_params = *(int *)h->content;
-        char name[5];
-
-        DEBUGMSG(DEBUG, "---to do: CALL <%s>\n", arg);
-        ccnl_free(h->content);
-        ccnl_free(h);
-        sprintf(dummybuf, "CLOSURE(FOX);RESOLVENAME(@op(");
-	// ... @x(@y y x 2 op)));TAILAPPLY";
-        offset = strlen(dummybuf);
-        for (i = 0; i < num_params; ++i) {
-            sprintf(name, "x%d", i);
-            offset += sprintf(dummybuf+offset, "@%s(", name);
-        }
-        for (i = num_params - 1; i >= 0; --i) {
-            sprintf(name, "x%d", i);
-            offset += sprintf(dummybuf+offset, " %s", name);
+        int num_params;
+
+        DEBUGMSG(DEBUG, "---to do: CALL\n");
+        if (!h || h->type != STACK_TYPE_INT) {
+            ccnl_nfn_freeStack(h);
+            rc = ZAM_BIF_END;
+            break;
         }
-        offset += sprintf(dummybuf + offset, " %d", num_params);
-        offset += sprintf(dummybuf+offset, " op");
-        for (i = 0; i < num_params+2; ++i)
-            offset += sprintf(dummybuf + offset, ")");
-        if (contd)
-            sprintf(dummybuf + offset, ";%s", contd);
-        return ccnl_strdup(dummybuf);
+        num_params = *(int *)h->content;
+        ccnl_nfn_freeStack(h);
+        rc = ZAM_enter(config, ZAM_callCode(config->prog, num_params,
+                                            config->suite));
+        break;
     }
     case ZAM_CLOSURE:
     {
+        struct zam_code_s *code = in->ptr;
         struct closure_s *closure;
-        DEBUGMSG(DEBUG, "---to do: closure <%s> (contd=%s)\n", arg, contd);
-
-        if (!config->argument_stack && !strncmp(arg, "RESOLVENAME(", 12)) {
-            char v[500], *c;
-            int len;
-            c = strchr(arg+12, ')');
-            if (!c)
-                goto normal;
-            len = c - (arg+12);
-            memcpy(v, arg+12, len);
-            v[len] = '\0';
+        struct zam_sym_s *v = ZAM_accessName(code);
+
+        if (!config->argument_stack && v) {
             closure = search_in_environment(config->env, v);
-            if (!closure)
-                goto normal;
-            if (!strcmp(closure->term, arg)) {
-                DEBUGMSG(WARNING, "** detected tail recursion case %s/%s\n",
-                         closure->term, arg);
-            } else
-                goto normal;
-        } else {
-normal:
-            closure = new_closure(arg, config->env);
-            //configuration->env = NULL;//FIXME new environment?
-            push_to_stack(&config->argument_stack, closure, STACK_TYPE_CLOSURE);
-            arg = NULL;
-        }
-        if (contd) {
-            ccnl_free(arg);
-            return ccnl_strdup(contd);
+            if (closure && ZAM_accessName(closure->code) == v) {
+                DEBUGMSG(WARNING, "** detected tail recursion case %s\n",
+                         v->name);
+                break;
+            }
         }
-        DEBUGMSG(ERROR, "** not implemented, see line %d\n", __LINE__);
-        return arg;
+        closure = new_closure(config, code, config->env);
+        push_to_stack(config, &config->argument_stack, closure,
+                      STACK_TYPE_CLOSURE);
+        break;
     }
     case ZAM_FOX:
-        return ZAM_fox(ccnl, config, restart, halt, prog, arg, contd);
+        rc = ZAM_fox(ccnl, config, restart, halt);
+        break;
     case ZAM_GRAB:
     {
         struct stack_s *stack = pop_from_stack(&config->argument_stack);
-        DEBUGMSG(DEBUG, "---to do: grab <%s>\n", arg);
-        add_to_environment(&config->env, arg, stack->content);
-        ccnl_free(stack);
-        return ccnl_strdup(contd);
+        struct closure_s *closure;
+        DEBUGMSG(DEBUG, "---to do: grab <%s>\n", in->sym->name);
+        if (!stack) {
+            DEBUGMSG(WARNING, "?? nothing to grab for %s\n", in->sym->name);
+            rc = ZAM_BIF_END;
+            break;
+        }
+        closure = stack->content;
+        add_to_environment(config, in->sym, closure->code, closure->env);
+        break;
     }
     case ZAM_HALT:
         ccnl_nfn_freeStack(config->argument_stack);
-        //ccnl_nfn_freeStack(config->result_stack);
-        config->argument_stack = /*config->result_stack =*/ NULL;
+        config->argument_stack = NULL;
         *halt = 1;
-        if(contd == NULL) {
-            return NULL;
-        }
-        return ccnl_strdup(contd);
-    case ZAM_RESOLVENAME:
-        return ZAM_resolvename(config, dummybuf, arg, contd);
-    case ZAM_TAILAPPLY:
+        break;
+    case ZAM_DEFINE:
+        DEBUGMSG(DEBUG, " fct definition: %s\n", in->sym->name);
+        add_to_environment(config, in->sym, in->ptr, NULL);
+        break;
+    case ZAM_PUSHINT:
     {
-        struct stack_s *stack = pop_from_stack(&config->argument_stack);
-        struct closure_s *closure = (struct closure_s *) stack->content;
-        char *code = closure->term;
-        DEBUGMSG(DEBUG, "---to do: tailapply\n");
-
-        ccnl_free(stack);
-        if (contd) //build new term
-            sprintf(dummybuf, "%s;%s", code, contd);
-        else
-            strcpy(dummybuf, code);
-        if (config->env)
-            ccnl_nfn_releaseEnvironment(&config->env);
-        config->env = closure->env; //set environment from closure
-        ccnl_free(code);
-        ccnl_free(closure);
-        return ccnl_strdup(dummybuf);
+        int *integer = ZAM_alloc(config, sizeof(int));
+        *integer = in->num;
+        push_to_stack(config, &config->result_stack, integer, STACK_TYPE_INT);
+        break;
+    }
+    case ZAM_PUSHCONST:
+    {
+        struct const_s *con = in->ptr, *copy;
+        copy = ZAM_alloc(config, sizeof(struct const_s) + con->len);
+        memcpy(copy, con, sizeof(struct const_s) + con->len);
+        push_to_stack(config, &config->result_stack, copy, STACK_TYPE_CONST);
+        break;
     }
-    case ZAM_UNKNOWN:
+    case ZAM_PUSHPREFIX:
+        push_to_stack(config, &config->result_stack,
+                      ccnl_prefix_dup(in->ptr), STACK_TYPE_PREFIX);
+        break;
+    case ZAM_TAILAPPLY:
+        rc = ZAM_tailapply(config);
+        break;
+    case ZAM_BUILTIN:
+        DEBUGMSG(DEBUG, "builtin: %s\n", ((struct builtin_s*) in->ptr)->name);
+        rc = ((struct builtin_s*) in->ptr)->fct(ccnl, config, restart, halt,
+                                                 &config->result_stack);
         break;
     default:
-        DEBUGMSG(DEBUG, "builtin: %s (%s/%s)\n", bifs[-tok - 1].name, prog, contd);
-        return bifs[-tok - 1].fct(ccnl, config, restart, halt, prog,
-                                  contd, &config->result_stack);
+        DEBUGMSG(INFO, "unknown (built-in) command %d\n", in->op);
+        rc = ZAM_BIF_END;
+        break;
     }
 
-    ccnl_free(arg);
-
-    // iterate through all extension operations
-    for (bp = op_extensions; bp; bp = bp->next)
-        if (!strncmp(prog, bp->name, strlen(bp->name)))
-            return (bp->fct)(ccnl, config, restart, halt, prog,
-                             contd, &config->result_stack);
-
-    DEBUGMSG(INFO, "unknown (built-in) command <%s>\n", prog);
-
-    return NULL;
+    switch (rc) {
+    case ZAM_BIF_NEXT:
+        config->pc++;
+        break;
+    case ZAM_BIF_END:
+        config->code = NULL;
+        config->contlen = 0;
+        return 0;
+    default: // AGAIN, JUMP
+        break;
+    }
+    return 1;
 }
 
-
 //----------------------------------------------------------------
 
-void
-allocAndAdd(struct environment_s **env, char *name, char *cmd)
-{
-    struct closure_s *closure;
-
-    closure = new_closure(ccnl_strdup(cmd), NULL);
-    add_to_environment(env, ccnl_strdup(name), closure);
-}
-
-void
-setup_global_environment(struct environment_s **env)
-{
-    //Operator on Church numbers
-    allocAndAdd(env, "true_church",
-                "RESOLVENAME(@x@y x)");
-    allocAndAdd(env, "false_church",
-                "RESOLVENAME(@x@y y)");
-    allocAndAdd(env, "eq_church",
-                "CLOSURE(OP_CMPEQ_CHURCH);RESOLVENAME(@op(@x(@y x y op)))");
-    allocAndAdd(env, "leq_church",
-                "CLOSURE(OP_CMPLEQ_CHURCH);RESOLVENAME(@op(@x(@y x y op)))");
-    allocAndAdd(env, "ifelse_church",
-                "RESOLVENAME(@expr@yes@no(expr yes no))");
-
-    //Operator on integer numbers
-    allocAndAdd(env, "eq",
-                "CLOSURE(OP_CMPEQ);RESOLVENAME(@op(@x(@y x y op)))");
-    allocAndAdd(env, "leq",
-                "CLOSURE(OP_CMPLEQ);RESOLVENAME(@op(@x(@y x y op)))");
-    allocAndAdd(env, "ifelse",
-                "CLOSURE(OP_IFELSE);RESOLVENAME(@op(@x x op));TAILAPPLY");
-    allocAndAdd(env, "add",
-                "CLOSURE(OP_ADD);RESOLVENAME(@op(@x(@y x y op)));TAILAPPLY");
-    allocAndAdd(env, "sub",
-                "CLOSURE(OP_SUB);RESOLVENAME(@op(@x(@y x y op)));TAILAPPLY");
-    allocAndAdd(env, "mult",
-                "CLOSURE(OP_MULT);RESOLVENAME(@op(@x(@y x y op)));TAILAPPLY");
-
-    allocAndAdd(env, "call",
-                "CLOSURE(CALL);RESOLVENAME(@op(@x x op));TAILAPPLY");
-
-    allocAndAdd(env, "raw", "TAILAPPLY;OP_RAW");
-
-#ifdef USE_NFN_NSTRANS
-    allocAndAdd(env, "translate",
-                "CLOSURE(OP_NSTRANS);CLOSURE(OP_FIND);"
-                "RESOLVENAME(@of(@o1(@x(@y x y o1 of))));TAILAPPLY");
-#endif
-}
-
 // consumes the result stack, exports its content to a buffer
 struct ccnl_buf_s*
 Krivine_exportResultStack(struct ccnl_relay_s *ccnl,
@@ -873,13 +759,25 @@ Krivine_exportResultStack(struct ccnl_relay_s *ccnl,
             //h->datalen = strlen((char*)h->data);
             pos += sprintf(res + pos, "%d", *(int*)stack->content);
         }
-        ccnl_free(stack->content);
-        ccnl_free(stack);
+        ccnl_nfn_freeStack(stack);
     }
 
     return ccnl_buf_new(res, pos);
 }
 
+#ifdef USE_LOGGING
+static void
+ZAM_traceStep(int steps, struct configuration_s *config)
+{
+    char code[200];
+
+    ZAM_code2str(code, sizeof(code), config->code, config->pc);
+    DEBUGMSG(DEBUG, "Step %d (%d/%d): %s\n", steps,
+             stack_len(config->argument_stack),
+             stack_len(config->result_stack), code);
+}
+#endif
+
 // executes (loops over) a Lambda expression: tries to run to termination,
 // or returns after having emitted further remote lookup/reduction requests
 // the return val is a buffer with the result stack's (concatenated) content
@@ -890,41 +788,42 @@ Krivine_reduction(struct ccnl_relay_s *ccnl, char *expression,
                   struct ccnl_prefix_s *prefix, int suite)
 {
     int steps = 0, halt = 0, restart = 1;
-    int len = strlen("CLOSURE(HALT);RESOLVENAME()") + strlen(expression) + 1;
-    char *dummybuf;
 
     DEBUGMSG(TRACE, "Krivine_reduction()\n");
 
     if (!*config && strlen(expression) == 0)
         return 0;
-    dummybuf = ccnl_malloc(2000);
     if (!*config) {
-        char *prog;
-        struct environment_s *global_dict = NULL;
-
-        prog = ccnl_malloc(len*sizeof(char));
-        sprintf(prog, "CLOSURE(HALT);RESOLVENAME(%s)", expression);
-        setup_global_environment(&global_dict);
+        int len = strlen("CLOSURE(HALT);RESOLVENAME()") + strlen(expression) + 1;
+        char *zam = ccnl_malloc(len);
+        struct zam_symtab_s *tab = ZAM_symtab(ccnl);
+        struct zam_prog_s *prog = NULL;
+
+        if (zam && tab) {
+            sprintf(zam, "CLOSURE(HALT);RESOLVENAME(%s)", expression);
+            DEBUGMSG(INFO, "Prog: %s\n", zam);
+            prog = ZAM_compile(tab, zam, suite);
+        }
+        ccnl_free(zam);
+        if (!prog)
+            DEBUGMSG(WARNING, "could not compile <%s>\n", expression);
         DEBUGMSG(DEBUG, "PREFIX %s\n", ccnl_prefix_to_path(prefix));
-        *config = new_config(ccnl, prog, global_dict,
-                             start_locally,
+        *config = new_config(ccnl, prog, start_locally,
                              prefix, ccnl->km->configid, suite);
         DBL_LINKED_LIST_ADD(ccnl->km->configuration_list, (*config));
         restart = 0;
         --ccnl->km->configid;
     }
-    DEBUGMSG(INFO, "Prog: %s\n", (*config)->prog);
 
-    while ((*config)->prog && !halt) {
-        char *oldprog = (*config)->prog;
+    while (!halt) {
         steps++;
-        DEBUGMSG(DEBUG, "Step %d (%d/%d): %s\n", steps,
-                 stack_len((*config)->argument_stack),
-                 stack_len((*config)->result_stack), (*config)->prog);
-        (*config)->prog = ZAM_term(ccnl, *config, &halt, dummybuf, &restart);
-        ccnl_free(oldprog);
+#ifdef USE_LOGGING
+        DEBUGSTMT(DEBUG, ZAM_traceStep(steps, *config));
+#endif
+        if (!ZAM_step(ccnl, *config, &halt, &restart))
+            break;
+        restart = 0;
     }
-    ccnl_free(dummybuf);
 
     if (halt < 0) { //HALT < 0 means pause computation
         DEBUGMSG(INFO,"Pause computation: %d\n", -(*config)->configid);
@@ -0,0 +1,450 @@
+/*
+ * @f ccnl-nfn-memo.c
+ * @b CCN-lite, memo table of NFN results
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifdef USE_NFN
+
+#include "ccnl-nfn-memo.h"
+
+#include "ccnl-nfn-common.h"
+#include "ccnl-nfn-parse.h"
+
+#include "ccnl-os-time.h"
+#include "ccnl-malloc.h"
+#include "ccnl-logging.h"
+
+#ifndef CCNL_LINUXKERNEL
+
+#include "ccnl-os-includes.h"
+
+// ----------------------------------------------------------------------
+// normalization
+
+// replaces the free occurrences of variable x in t by name
+static int
+memo_subst(struct ccnl_lambdaTerm_s *t, char *x, char *name)
+{
+    while (t) {
+        if (t->v && !t->m) { // variable
+            if (!strcmp(t->v, x)) {
+                char *v = ccnl_strdup(name);
+                if (!v)
+                    return -1;
+                ccnl_free(t->v);
+                t->v = v;
+            }
+            return 0;
+        }
+        if (t->v) { // lambda
+            if (!strcmp(t->v, x))
+                return 0;
+            t = t->m;
+            continue;
+        }
+        if (memo_subst(t->m, x, name) < 0)
+            return -1;
+        t = t->n;
+    }
+    return 0;
+}
+
+// whether a lambda in t binds the variable x
+static int
+memo_binds(struct ccnl_lambdaTerm_s *t, char *x)
+{
+    for (; t; t = t->n) {
+        if (t->v && !t->m) // variable
+            return 0;
+        if (t->v) { // lambda
+            if (!strcmp(t->v, x))
+                return 1;
+            return memo_binds(t->m, x);
+        }
+        if (memo_binds(t->m, x))
+            return 1;
+    }
+    return 0;
+}
+
+// reduces (@x M) N to M[x:=N] along the application spine where N is a
+// name or a number, the form in which FOX asks for sub-computations; the
+// redex is kept where a lambda in M binds N, which would capture it
+static struct ccnl_lambdaTerm_s*
+memo_reduce(struct ccnl_lambdaTerm_s *t)
+{
+    struct ccnl_lambdaTerm_s *body;
+
+    if (!t || t->v) // variable or lambda
+        return t;
+    t->m = memo_reduce(t->m);
+    if (!t->m) {
+        ccnl_lambdaFreeTerm(t);
+        return NULL;
+    }
+    if (!t->m->v || !t->m->m || !t->n || !t->n->v || t->n->m)
+        return t;
+    body = t->m->m;
+    if (memo_binds(body, t->n->v))
+        return t;
+    if (memo_subst(body, t->m->v, t->n->v) < 0) {
+        ccnl_lambdaFreeTerm(t);
+        return NULL;
+    }
+    t->m->m = NULL;
+    ccnl_lambdaFreeTerm(t);
+    return memo_reduce(body);
+}
+
+// a "let" expression is not a lambda term, only its white space is folded
+static char*
+memo_squeeze(char *expr)
+{
+    char *key = ccnl_malloc(strlen(expr) + 1), *cp = key;
+
+    if (!key)
+        return NULL;
+    for (; *expr; expr++) {
+        if (isspace(*expr)) {
+            if (cp > key && cp[-1] != ' ')
+                *cp++ = ' ';
+        } else
+            *cp++ = *expr;
+    }
+    if (cp > key && cp[-1] == ' ')
+        cp--;
+    *cp = '\0';
+    return key;
+}
+
+// the expression of a /COMPUTE name does not apply to the name
+static int
+memo_isCompute(struct ccnl_prefix_s *p)
+{
+    int offset = 0;
+
+#if defined(USE_SUITE_CCNTLV) || defined(USE_SUITE_CISTLV)
+    if (p->suite == CCNL_SUITE_CCNTLV || p->suite == CCNL_SUITE_CISTLV)
+        offset = 4;
+#endif
+    return p->compcnt == 2 && p->complen[0] == 7 + offset &&
+           !memcmp(p->comp[0] + offset, "COMPUTE", 7);
+}
+
+char*
+ccnl_nfn_memo_key(struct ccnl_prefix_s *prefix)
+{
+    struct ccnl_lambdaTerm_s *t;
+    struct ccnl_prefix_s expr_only;
+    char *expr, *cp, *key = NULL;
+    int len;
+
+    if (!prefix || prefix->compcnt < 1)
+        return NULL;
+    expr = ccnl_malloc(CCNL_MAX_PACKET_SIZE);
+    if (!expr)
+        return NULL;
+    if (memo_isCompute(prefix)) {
+        expr_only = *prefix;
+        expr_only.comp++;
+        expr_only.complen++;
+        expr_only.compcnt--;
+        prefix = &expr_only;
+    }
+    ccnl_nfnprefix_toExpr(prefix, expr);
+
+    for (cp = expr; isspace(*cp); cp++);
+    if (!strncmp(cp, "let", 3) && isspace(cp[3])) {
+        key = memo_squeeze(cp);
+    } else {
+        t = memo_reduce(ccnl_lambdaStrToTerm(0, &cp, NULL));
+        if (t) {
+            // substituting may make the term longer than the name
+            len = ccnl_lambdaTermToStrn(NULL, 0, t, 0);
+            if (len < CCNL_MAX_PACKET_SIZE)
+                key = ccnl_malloc(len + 1);
+            if (key)
+                ccnl_lambdaTermToStrn(key, len + 1, t, 0);
+            ccnl_lambdaFreeTerm(t);
+        }
+    }
+    ccnl_free(expr);
+    return key;
+}
+
+// the key of prefix, kept at config (if any) since a computation looks up
+// the names it waits for each time it is resumed; *tmp is set to a key
+// which the caller frees
+static char*
+memo_key(struct configuration_s *config, struct ccnl_prefix_s *prefix,
+         char **tmp)
+{
+    struct nfn_memo_key_s *k;
+
+    *tmp = NULL;
+    if (config)
+        for (k = config->memo_keys; k; k = k->next)
+            if (k->prefix->suite == prefix->suite &&
+                        !ccnl_prefix_cmp(k->prefix, NULL, prefix, CMP_EXACT))
+                return k->key;
+    k = config ? ccnl_calloc(1, sizeof(*k)) : NULL;
+    if (k)
+        k->prefix = ccnl_prefix_dup(prefix);
+    if (!k || !k->prefix) {
+        ccnl_free(k);
+        return *tmp = ccnl_nfn_memo_key(prefix);
+    }
+    k->key = ccnl_nfn_memo_key(prefix);
+    k->next = config->memo_keys;
+    config->memo_keys = k;
+    return k->key;
+}
+
+void
+ccnl_nfn_memo_freeKeys(struct nfn_memo_key_s *keys)
+{
+    struct nfn_memo_key_s *k;
+
+    while ((k = keys) != NULL) {
+        keys = k->next;
+        ccnl_prefix_free(k->prefix);
+        ccnl_free(k->key);
+        ccnl_free(k);
+    }
+}
+
+// ----------------------------------------------------------------------
+// the table
+
+static uint32_t
+memo_hash(char *key, int suite)
+{
+    uint32_t h = 2166136261u ^ (uint32_t) suite; // FNV-1a
+
+    for (; *key; key++) {
+        h ^= (unsigned char) *key;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static long
+memo_size(struct nfn_memo_entry_s *e)
+{
+    return sizeof(*e) + strlen(e->expr) + 1 + e->result->datalen;
+}
+
+static void
+memo_unlink(struct nfn_memo_s *memo, struct nfn_memo_entry_s *e)
+{
+    if (e->prev)
+        e->prev->next = e->next;
+    else
+        memo->lru = e->next;
+    if (e->next)
+        e->next->prev = e->prev;
+    else
+        memo->oldest = e->prev;
+    e->next = e->prev = NULL;
+}
+
+static void
+memo_touch(struct nfn_memo_s *memo, struct nfn_memo_entry_s *e)
+{
+    if (memo->lru == e)
+        return;
+    if (e->prev || e->next || memo->oldest == e)
+        memo_unlink(memo, e);
+    e->next = memo->lru;
+    if (memo->lru)
+        memo->lru->prev = e;
+    memo->lru = e;
+    if (!memo->oldest)
+        memo->oldest = e;
+}
+
+static void
+memo_remove(struct nfn_memo_s *memo, struct nfn_memo_entry_s *e)
+{
+    struct nfn_memo_entry_s **pp;
+
+    for (pp = &memo->buckets[e->hash & (NFN_MEMO_BUCKETS - 1)]; *pp;
+                                                    pp = &(*pp)->chain)
+        if (*pp == e) {
+            *pp = e->chain;
+            break;
+        }
+    memo_unlink(memo, e);
+    memo->entries--;
+    memo->bytes -= memo_size(e);
+    ccnl_free(e->expr);
+    ccnl_free(e->result);
+    ccnl_free(e);
+}
+
+static struct nfn_memo_entry_s*
+memo_find(struct nfn_memo_s *memo, char *key, uint32_t hash, int suite)
+{
+    struct nfn_memo_entry_s *e;
+
+    for (e = memo->buckets[hash & (NFN_MEMO_BUCKETS - 1)]; e; e = e->chain)
+        if (e->hash == hash && e->suite == suite && !strcmp(e->expr, key))
+            return e;
+    return NULL;
+}
+
+struct ccnl_buf_s*
+ccnl_nfn_memo_lookup(struct ccnl_relay_s *ccnl, struct configuration_s *config,
+                     struct ccnl_prefix_s *prefix)
+{
+    struct nfn_memo_s *memo = ccnl->km ? ccnl->km->memo : NULL;
+    struct nfn_memo_entry_s *e;
+    uint32_t hash;
+    char *key, *tmp;
+
+    if (!memo || !memo->entries || !ccnl_nfnprefix_isNFN(prefix))
+        return NULL;
+    key = memo_key(config, prefix, &tmp);
+    if (!key)
+        return NULL;
+    hash = memo_hash(key, prefix->suite);
+    e = memo_find(memo, key, hash, prefix->suite);
+    if (e && CCNL_NOW() - e->created > NFN_MEMO_LIFETIME) {
+        memo_remove(memo, e);
+        e = NULL;
+    }
+    if (!e) {
+        memo->misses++;
+        ccnl_free(tmp);
+        return NULL;
+    }
+    memo->hits++;
+    memo_touch(memo, e);
+    DEBUGMSG(DEBUG, "memo hit <%s> (%u hits, %u misses)\n",
+             key, (unsigned) memo->hits, (unsigned) memo->misses);
+    ccnl_free(tmp);
+    return e->result;
+}
+
+void
+ccnl_nfn_memo_add(struct ccnl_relay_s *ccnl, struct ccnl_prefix_s *prefix,
+                  unsigned char *data, int len)
+{
+    struct nfn_memo_s *memo;
+    struct nfn_memo_entry_s *e;
+    struct ccnl_buf_s *result;
+    uint32_t hash;
+    char *key;
+
+    if (!ccnl->km || !data || len <= 0 || len > NFN_MEMO_MAX_BYTES / 16 ||
+                                            !ccnl_nfnprefix_isNFN(prefix))
+        return;
+    if (len >= 5 && !memcmp(data, ":NACK", 5))
+        return;
+#ifdef USE_NFN_REQUESTS
+    if (ccnl_nfnprefix_isRequest(prefix) ||
+                                    ccnl_nfnprefix_isIntermediate(prefix))
+        return;
+#endif
+    if (!ccnl->km->memo) {
+        ccnl->km->memo = ccnl_calloc(1, sizeof(struct nfn_memo_s));
+        if (!ccnl->km->memo)
+            return;
+    }
+    memo = ccnl->km->memo;
+    key = ccnl_nfn_memo_key(prefix);
+    if (!key)
+        return;
+    result = ccnl_buf_new(data, len);
+    if (!result) {
+        ccnl_free(key);
+        return;
+    }
+    hash = memo_hash(key, prefix->suite);
+    e = memo_find(memo, key, hash, prefix->suite);
+    if (e) {
+        memo->bytes -= e->result->datalen;
+        ccnl_free(e->result);
+        ccnl_free(key);
+    } else {
+        e = ccnl_calloc(1, sizeof(*e));
+        if (!e) {
+            ccnl_free(key);
+            ccnl_free(result);
+            return;
+        }
+        e->hash = hash;
+        e->suite = prefix->suite;
+        e->expr = key;
+        e->chain = memo->buckets[hash & (NFN_MEMO_BUCKETS - 1)];
+        memo->buckets[hash & (NFN_MEMO_BUCKETS - 1)] = e;
+        memo->entries++;
+        memo->bytes += sizeof(*e) + strlen(key) + 1;
+    }
+    e->result = result;
+    e->created = CCNL_NOW();
+    memo->bytes += len;
+    memo_touch(memo, e);
+    DEBUGMSG(DEBUG, "memo add <%s> = %.*s\n", e->expr, len, (char*) data);
+
+    while (memo->oldest != e && (memo->entries > NFN_MEMO_MAX_ENTRIES ||
+                                 memo->bytes > NFN_MEMO_MAX_BYTES))
+        memo_remove(memo, memo->oldest);
+}
+
+struct ccnl_content_s*
+ccnl_nfn_memo_content(struct ccnl_relay_s *ccnl, struct configuration_s *config,
+                      struct ccnl_prefix_s *prefix)
+{
+    struct ccnl_buf_s *result = ccnl_nfn_memo_lookup(ccnl, config, prefix);
+    struct ccnl_prefix_s *copy;
+    struct ccnl_content_s *c;
+
+    if (!result)
+        return NULL;
+    copy = ccnl_prefix_dup(prefix);
+    if (!copy)
+        return NULL;
+    c = ccnl_nfn_result2content(ccnl, &copy, result->data, result->datalen);
+    if (!c) {
+        ccnl_prefix_free(copy);
+        return NULL;
+    }
+    if (ccnl_content_add2cache(ccnl, c) < 0) { // no room
+        ccnl_content_free(c);
+        return NULL;
+    }
+    return c;
+}
+
+void
+ccnl_nfn_memo_free(struct nfn_memo_s *memo)
+{
+    if (!memo)
+        return;
+    while (memo->lru)
+        memo_remove(memo, memo->lru);
+    ccnl_free(memo);
+}
+
+#endif // !CCNL_LINUXKERNEL
+
+#endif // USE_NFN
+// eof
@@ -27,6 +27,7 @@
 #include <stdio.h>
 
 #include "ccnl-nfn-common.h"
+#include "ccnl-nfn-env.h"
 #include "ccnl-nfn-krivine.h"
 
 #include "ccnl-os-time.h"
@@ -34,6 +35,8 @@
 #include "ccnl-logging.h"
 
 
+struct builtin_s *op_extensions;
+
 // binds the name to the given fct in ZAM's list of known operations
 void
 ZAM_registerOp(char *name, BIF fct)
@@ -41,7 +44,7 @@ ZAM_registerOp(char *name, BIF fct)
     struct builtin_s *b;
     struct ccnl_buf_s *buf;
 
-    buf = ccnl_calloc(1, sizeof(*buf) + sizeof(*b));
+    buf = ccnl_buf_new(NULL, sizeof(*b));
     ccnl_core_addToCleanup(buf);
 
     b = (struct builtin_s*) buf->data;
@@ -63,15 +66,15 @@ ZAM_registerOp(char *name, BIF fct)
             h1 = pop_or_resolve_from_result_stack(ccnl, config); \
             if(h1 == NULL){ \
                 *halt = -1; \
-                return prog; \
+                return ZAM_BIF_AGAIN; \
             } \
             if(h1->type == STACK_TYPE_INT) i1 = *(int*)h1->content;\
             h2 = pop_or_resolve_from_result_stack(ccnl, config); \
             if(h2 == NULL){ \
                 *halt = -1; \
-                push_to_stack(&config->result_stack, h1->content, h1->type); \
-                ccnl_free(h1); \
-                return prog; \
+                h1->next = config->result_stack; \
+                config->result_stack = h1; \
+                return ZAM_BIF_AGAIN; \
             } \
             if(h1->type == STACK_TYPE_INT) i2 = *(int*)h2->content;\
             ccnl_nfn_freeStack(h1); ccnl_nfn_freeStack(h2); \
@@ -80,30 +83,27 @@ ZAM_registerOp(char *name, BIF fct)
 // ----------------------------------------------------------------------
 // builtin operations
 
-char*
+int
 op_builtin_add(struct ccnl_relay_s *ccnl, struct configuration_s *config,
-               int *restart, int *halt, char *prog, char *pending,
-               struct stack_s **stack)
+               int *restart, int *halt, struct stack_s **stack)
 {
     int i1=0, i2=0, *h;
     (void) restart;
-    DEBUGMSG(DEBUG, "---to do: OP_ADD <%s> pending: %s\n", prog+7, pending);
+    DEBUGMSG(DEBUG, "---to do: OP_ADD\n");
     pop2int();
-    h = ccnl_malloc(sizeof(int));
+    h = ZAM_alloc(config, sizeof(int));
     *h = i1 + i2;
-    push_to_stack(stack, h, STACK_TYPE_INT);
+    push_to_stack(config, stack, h, STACK_TYPE_INT);
 
-    return pending ? ccnl_strdup(pending) : NULL;
+    return ZAM_BIF_NEXT;
 }
 
-char*
+int
 op_builtin_find(struct ccnl_relay_s *ccnl, struct configuration_s *config,
-                int *restart, int *halt, char *prog, char *pending,
-                struct stack_s **stack)
+                int *restart, int *halt, struct stack_s **stack)
 {
     int local_search = 0;
     struct stack_s *h;
-    char *cp = NULL;
     struct ccnl_prefix_s *prefix;
     struct ccnl_content_s *c = NULL;
     (void)stack;
@@ -113,11 +113,11 @@ op_builtin_find(struct ccnl_relay_s *ccnl, struct configuration_s *config,
         *restart = 0;
         local_search = 1;
     } else {
-        DEBUGMSG(DEBUG, "---to do: OP_FIND <%s> <%s>\n", prog+7, pending);
+        DEBUGMSG(DEBUG, "---to do: OP_FIND\n");
         h = pop_from_stack(&config->result_stack);
         //    if (h->type != STACK_TYPE_PREFIX)  ...
         config->fox_state->num_of_params = 1;
-        config->fox_state->params = ccnl_malloc(sizeof(struct ccnl_stack_s *));
+        config->fox_state->params = ZAM_alloc(config, sizeof(struct stack_s *));
         config->fox_state->params[0] = h;
         config->fox_state->it_routable_param = 0;
     }
@@ -132,7 +132,7 @@ op_builtin_find(struct ccnl_relay_s *ccnl, struct configuration_s *config,
         struct ccnl_interest_s *interest;
         if (local_search) {
             DEBUGMSG(INFO, "FIND: no content\n");
-            return NULL;
+            return ZAM_BIF_END;
         }
         //Result not in cache, search over the network
         //        struct ccnl_interest_s *interest = mkInterestObject(ccnl, config, prefix);
@@ -142,12 +142,12 @@ op_builtin_find(struct ccnl_relay_s *ccnl, struct configuration_s *config,
                  interest->from->faceid);
         if (interest)
             ccnl_interest_propagate(ccnl, interest);
-        //wait for content, return current program to continue later
+        //wait for content, run OP_FIND again to continue later
         *halt = -1; //set halt to -1 for async computations
-        return ccnl_strdup(prog);
+        return ZAM_BIF_AGAIN;
     }
 
-    DEBUGMSG(INFO, "FIND: result was found ---> handle it (%s), prog=%s, pending=%s\n", ccnl_prefix_to_path(prefix), prog, pending);
+    DEBUGMSG(INFO, "FIND: result was found ---> handle it (%s)\n", ccnl_prefix_to_path(prefix));
 #ifdef USE_NACK
 /*
     if (!strncmp((char*)c->content, ":NACK", 5)) {
@@ -159,42 +159,34 @@ op_builtin_find(struct ccnl_relay_s *ccnl, struct configuration_s *config,
 */
 #endif
     prefix = ccnl_prefix_dup(prefix);
-    push_to_stack(&config->result_stack, prefix, STACK_TYPE_PREFIX);
-
-    if (pending) {
-        DEBUGMSG(DEBUG, "Pending: %s\n", pending);
+    push_to_stack(config, &config->result_stack, prefix, STACK_TYPE_PREFIX);
 
-        cp = ccnl_strdup(pending);
-    }
-    return cp;
+    return ZAM_BIF_NEXT;
 }
 
-char*
+int
 op_builtin_mult(struct ccnl_relay_s *ccnl, struct configuration_s *config,
-                int *restart, int *halt, char *prog, char *pending,
-                struct stack_s **stack)
+                int *restart, int *halt, struct stack_s **stack)
 {
     int i1=0, i2=0, *h;
     (void)restart;
 
-    DEBUGMSG(DEBUG, "---to do: OP_MULT <%s>\n", prog+8);
+    DEBUGMSG(DEBUG, "---to do: OP_MULT\n");
     pop2int();
-    h = ccnl_malloc(sizeof(int));
+    h = ZAM_alloc(config, sizeof(int));
     *h = i2 * i1;
-    push_to_stack(stack, h, STACK_TYPE_INT);
+    push_to_stack(config, stack, h, STACK_TYPE_INT);
 
-    return pending ? ccnl_strdup(pending) : NULL;
+    return ZAM_BIF_NEXT;
 }
 
-char*
+int
 op_builtin_raw(struct ccnl_relay_s *ccnl, struct configuration_s *config,
-               int *restart, int *halt, char *prog, char *pending,
-               struct stack_s **stack)
+               int *restart, int *halt, struct stack_s **stack)
 {
     (void)stack;
     int local_search = 0;
     struct stack_s *h;
-    char *cp = NULL;
     struct ccnl_prefix_s *prefix;
     struct ccnl_content_s *c = NULL;
 
@@ -205,7 +197,7 @@ op_builtin_raw(struct ccnl_relay_s *ccnl, struct configuration_s *config,
         *restart = 0;
         local_search = 1;
     } else {
-        DEBUGMSG(DEBUG, "---to do: OP_RAW <%s>\n", prog+7);
+        DEBUGMSG(DEBUG, "---to do: OP_RAW\n");
         h = pop_from_stack(&config->result_stack);
         if (!h || h->type != STACK_TYPE_PREFIX) {
             DEBUGMSG(DEBUG, "  stack empty or has no prefix %p\n", (void*) h);
@@ -213,7 +205,7 @@ op_builtin_raw(struct ccnl_relay_s *ccnl, struct configuration_s *config,
             DEBUGMSG(DEBUG, "  found a prefix!\n");
         }
         config->fox_state->num_of_params = 1;
-        config->fox_state->params = ccnl_malloc(sizeof(struct ccnl_stack_s *));
+        config->fox_state->params = ZAM_alloc(config, sizeof(struct stack_s *));
         config->fox_state->params[0] = h;
         config->fox_state->it_routable_param = 0;
     }
@@ -226,7 +218,7 @@ op_builtin_raw(struct ccnl_relay_s *ccnl, struct configuration_s *config,
     if (!c) {
         if (local_search) {
             DEBUGMSG(DEBUG, "RAW: no content\n");
-            return NULL;
+            return ZAM_BIF_END;
         }
         //Result not in cache, search over the network
         //        struct ccnl_interest_s *interest = mkInterestObject(ccnl, config, prefix);
@@ -235,12 +227,12 @@ op_builtin_raw(struct ccnl_relay_s *ccnl, struct configuration_s *config,
         DEBUGMSG(DEBUG, "RAW: sending new interest from Face ID: %d\n", interest->from->faceid);
         if (interest)
             ccnl_interest_propagate(ccnl, interest);
-        //wait for content, return current program to continue later
+        //wait for content, run OP_RAW again to continue later
         *halt = -1; //set halt to -1 for async computations
-        return prog ? ccnl_strdup(prog) : NULL;
+        return ZAM_BIF_AGAIN;
     }
 
-    DEBUGMSG(DEBUG, "RAW: result was found ---> handle it (%s), prog=%s, pending=%s\n", ccnl_prefix_to_path(prefix), prog, pending);
+    DEBUGMSG(DEBUG, "RAW: result was found ---> handle it (%s)\n", ccnl_prefix_to_path(prefix));
 #ifdef USE_NACK
 /*
     if (!strncmp((char*)c->content, ":NACK", 5)) {
@@ -252,146 +244,123 @@ op_builtin_raw(struct ccnl_relay_s *ccnl, struct configuration_s *config,
 */
 #endif
     prefix = ccnl_prefix_dup(prefix);
-    push_to_stack(&config->result_stack, prefix, STACK_TYPE_PREFIXRAW);
+    push_to_stack(config, &config->result_stack, prefix,
+                  STACK_TYPE_PREFIXRAW);
 
-    if (pending) {
-        DEBUGMSG(DEBUG, "Pending: %s\n", pending+1);
-
-        cp = ccnl_strdup(pending+1);
-    }
-    return cp;
+    return ZAM_BIF_NEXT;
 }
 
-char*
+int
 op_builtin_sub(struct ccnl_relay_s *ccnl, struct configuration_s *config,
-               int *restart, int *halt, char *prog, char *pending,
-               struct stack_s **stack)
+               int *restart, int *halt, struct stack_s **stack)
 {
     (void)restart;
     int i1=0, i2=0, *h;
 
-    DEBUGMSG(DEBUG, "---to do: OP_SUB <%s>\n", prog+7);
+    DEBUGMSG(DEBUG, "---to do: OP_SUB\n");
     pop2int();
-    h = ccnl_malloc(sizeof(int));
+    h = ZAM_alloc(config, sizeof(int));
     *h = i2 - i1;
-    push_to_stack(stack, h, STACK_TYPE_INT);
+    push_to_stack(config, stack, h, STACK_TYPE_INT);
 
-    return pending ? ccnl_strdup(pending) : NULL;
+    return ZAM_BIF_NEXT;
 }
 
 // ----------------------------------------------------------------------
 
-char*
+int
 op_builtin_cmpeqc(struct ccnl_relay_s *ccnl, struct configuration_s *config,
-                  int *restart, int *halt, char *prog, char *pending,
-                  struct stack_s **stack)
+                  int *restart, int *halt, struct stack_s **stack)
 {
     int i1=0, i2=0;
-    char res[1000], *cp;
+    char *cp;
     (void)restart;
     (void)stack;
     pop2int();
-    cp = (i1 == i2) ? "@x@y x" : "@x@y y";
-    DEBUGMSG(DEBUG, "---to do: OP_CMPEQ <%s>/<%s>\n", cp, pending);
-    if (pending)
-        sprintf(res, "RESOLVENAME(%s);%s", cp, pending);
-    else
-        sprintf(res, "RESOLVENAME(%s)", cp);
-    return ccnl_strdup(res);
+    cp = (i1 == i2) ? "true_church" : "false_church";
+    DEBUGMSG(DEBUG, "---to do: OP_CMPEQ <%s>\n", cp);
+    return ZAM_enter(config, ZAM_global(config->prog->symtab, cp));
 }
 
-char*
+int
 op_builtin_cmpleqc(struct ccnl_relay_s *ccnl, struct configuration_s *config,
-                  int *restart, int *halt, char *prog, char *pending,
-                  struct stack_s **stack)
+                  int *restart, int *halt, struct stack_s **stack)
 {
     int i1=0, i2=0;
-    char res[1000], *cp;
+    char *cp;
     (void)restart;
     (void)stack;
     pop2int();
-    cp = (i2 <= i1) ? "@x@y x" : "@x@y y";
-    DEBUGMSG(DEBUG, "---to do: OP_CMPLEQ <%s>/%s\n", cp, pending);
-    if (pending)
-        sprintf(res, "RESOLVENAME(%s);%s", cp, pending);
-    else
-        sprintf(res, "RESOLVENAME(%s)", cp);
-    return ccnl_strdup(res);
+    cp = (i2 <= i1) ? "true_church" : "false_church";
+    DEBUGMSG(DEBUG, "---to do: OP_CMPLEQ <%s>\n", cp);
+    return ZAM_enter(config, ZAM_global(config->prog->symtab, cp));
 }
 
-char*
+int
 op_builtin_cmpeq(struct ccnl_relay_s *ccnl, struct configuration_s *config,
-                 int *restart, int *halt, char *prog, char *pending,
-                 struct stack_s **stack)
+                 int *restart, int *halt, struct stack_s **stack)
 {
-    int i1=0, i2=0;
-    char res[1000], *cp;
+    int i1=0, i2=0, *h;
     (void)restart;
-    (void)stack;
 
-    DEBUGMSG(DEBUG, "---to do: OP_CMPEQ<%s>\n", pending);
+    DEBUGMSG(DEBUG, "---to do: OP_CMPEQ\n");
     pop2int();
-    cp = (i1 == i2) ? "1" : "0";
-    if (pending)
-        sprintf(res, "RESOLVENAME(%s);%s", cp, pending);
-    else
-        sprintf(res, "RESOLVENAME(%s)", cp);
-    return ccnl_strdup(res);
+    h = ZAM_alloc(config, sizeof(int));
+    *h = i1 == i2;
+    push_to_stack(config, stack, h, STACK_TYPE_INT);
+    return ZAM_tailapply(config);
 }
 
-char*
+int
 op_builtin_cmpleq(struct ccnl_relay_s *ccnl, struct configuration_s *config,
-                  int *restart, int *halt, char *prog, char *pending,
-                  struct stack_s **stack)
+                  int *restart, int *halt, struct stack_s **stack)
 {
-    int i1=0, i2=0;
-    char res[1000], *cp;
+    int i1=0, i2=0, *h;
     (void)restart;
-    (void)stack;
 
-    DEBUGMSG(DEBUG, "---to do: OP_CMPLEQ <%s>\n", pending);
+    DEBUGMSG(DEBUG, "---to do: OP_CMPLEQ\n");
     pop2int();
-    cp = (i2 <= i1) ? "1" : "0";
-    if (pending)
-        sprintf(res, "RESOLVENAME(%s);%s", cp, pending);
-    else
-        sprintf(res, "RESOLVENAME(%s)", cp);
-    return ccnl_strdup(res);
+    h = ZAM_alloc(config, sizeof(int));
+    *h = i2 <= i1;
+    push_to_stack(config, stack, h, STACK_TYPE_INT);
+    return ZAM_tailapply(config);
 }
 
-char*
+int
 op_builtin_ifelse(struct ccnl_relay_s *ccnl, struct configuration_s *config,
-                  int *restart, int *halt, char *prog, char *pending,
-                  struct stack_s **stack)
+                  int *restart, int *halt, struct stack_s **stack)
 {
     struct stack_s *h;
     int i1=0;
     (void)restart;
     (void)stack;
 
-    DEBUGMSG(DEBUG, "---to do: OP_IFELSE <%s>\n", prog+10);
+    DEBUGMSG(DEBUG, "---to do: OP_IFELSE\n");
     h = pop_or_resolve_from_result_stack(ccnl, config);
     if (!h) {
         *halt = -1;
-        return ccnl_strdup(prog);
+        return ZAM_BIF_AGAIN;
     }
     if (h->type != STACK_TYPE_INT) {
         DEBUGMSG(WARNING, "ifelse requires int as condition");
         ccnl_nfn_freeStack(h);
-        return NULL;
+        return ZAM_BIF_END;
     }
     i1 = *(int *)h->content;
+    ccnl_nfn_freeStack(h);
     if (i1) {
         struct stack_s *stack = pop_from_stack(&config->argument_stack);
         DEBUGMSG(DEBUG, "Execute if\n");
-        pop_from_stack(&config->argument_stack);
-        push_to_stack(&config->argument_stack, stack->content,
-                      STACK_TYPE_CLOSURE);
+        ccnl_nfn_freeStack(pop_from_stack(&config->argument_stack));
+        if (stack) {
+            stack->next = config->argument_stack;
+            config->argument_stack = stack;
+        }
     } else {
         DEBUGMSG(DEBUG, "Execute else\n");
-        pop_from_stack(&config->argument_stack);
+        ccnl_nfn_freeStack(pop_from_stack(&config->argument_stack));
     }
-    return ccnl_strdup(pending);
+    return ZAM_BIF_NEXT;
 }
 
 // ----------------------------------------------------------------------
@@ -401,12 +370,11 @@ op_builtin_ifelse(struct ccnl_relay_s *ccnl, struct configuration_s *config,
 // NFN namespace translation example: "translate NS /some/uri/to/fetch"
 // where NS is a constant: 'ccnb, 'ccnx2014, 'ndn2013
 
-char*
+int
 op_builtin_nstrans(struct ccnl_relay_s *ccnl, struct configuration_s *config,
-                   int *restart, int *halt, char *prog, char *pending,
-                   struct stack_s **stack)
+                   int *restart, int *halt, struct stack_s **stack)
 {
-    char *cp = NULL;
+    int rc = ZAM_BIF_NEXT;
     struct stack_s *s1, *s2;
 
     DEBUGMSG(DEBUG, "---to do: OP_NSTRANS\n");
@@ -414,13 +382,13 @@ op_builtin_nstrans(struct ccnl_relay_s *ccnl, struct configuration_s *config,
     s1 = pop_or_resolve_from_result_stack(ccnl, config);
     if (!s1) {
         *halt = -1;
-        return prog;
+        return ZAM_BIF_AGAIN;
     }
     s2 = pop_or_resolve_from_result_stack(ccnl, config);
     if (!s2) {
         ccnl_nfn_freeStack(s1);
         *halt = -1;
-        return prog;
+        return ZAM_BIF_AGAIN;
     }
 
     if (s2->type == STACK_TYPE_CONST && s1->type == STACK_TYPE_PREFIX) {
@@ -446,25 +414,18 @@ op_builtin_nstrans(struct ccnl_relay_s *ccnl, struct configuration_s *config,
 
         p->nfnflags = 0;
         p->suite = suite;
-        push_to_stack(stack, s1->content, STACK_TYPE_PREFIX);
-
-        ccnl_free(s1);
+        push_to_stack(config, stack, s1->content, STACK_TYPE_PREFIX);
         s1 = NULL;
-
-        if (pending) {
-            cp = ccnl_malloc(strlen(pending)+1);
-            strcpy(cp, pending);
-        }
     } else {
 out:
         *halt = -1;
-        cp = prog;
+        rc = ZAM_BIF_AGAIN;
     }
     if (s1)
         ccnl_nfn_freeStack(s1);
     ccnl_nfn_freeStack(s2);
 
-    return cp;
+    return rc;
 }
 
 #endif // USE_NFN_NSTRANS
@@ -161,6 +161,44 @@ ccnl_lambdaTermToStr(char *cfg, struct ccnl_lambdaTerm_s *t, char last)
     return len;
 }
 
+// where the output continues, NULL once it no longer fits
+#define TERMBUF(cfg, size, len)  ((len) < (size) ? (cfg) + (len) : NULL)
+#define TERMROOM(size, len)      ((len) < (size) ? (size) - (len) : 0)
+
+int
+ccnl_lambdaTermToStrn(char *cfg, int size, struct ccnl_lambdaTerm_s *t,
+                      char last)
+{
+    int len = 0;
+
+    if (t->v && t->m) { // Lambda (sequence)
+        len += snprintf(TERMBUF(cfg, size, len), TERMROOM(size, len),
+                        "(%c%s", LAMBDACHAR, t->v);
+        len += ccnl_lambdaTermToStrn(TERMBUF(cfg, size, len),
+                                     TERMROOM(size, len), t->m, 'a');
+        len += snprintf(TERMBUF(cfg, size, len), TERMROOM(size, len), ")");
+        return len;
+    }
+    if (t->v) { // (single) variable
+        len += snprintf(TERMBUF(cfg, size, len), TERMROOM(size, len),
+                        isalnum(last) ? " %s" : "%s", t->v);
+        return len;
+    }
+    // application (sequence)
+    len += ccnl_lambdaTermToStrn(TERMBUF(cfg, size, len),
+                                 TERMROOM(size, len), t->m, last);
+    if (t->n->v && !t->n->m) {
+        len += ccnl_lambdaTermToStrn(TERMBUF(cfg, size, len),
+                                     TERMROOM(size, len), t->n, 'a');
+    } else {
+        len += snprintf(TERMBUF(cfg, size, len), TERMROOM(size, len), " (");
+        len += ccnl_lambdaTermToStrn(TERMBUF(cfg, size, len),
+                                     TERMROOM(size, len), t->n, '(');
+        len += snprintf(TERMBUF(cfg, size, len), TERMROOM(size, len), ")");
+    }
+    return len;
+}
+
 void
 ccnl_lambdaFreeTerm(struct ccnl_lambdaTerm_s *t)
 {
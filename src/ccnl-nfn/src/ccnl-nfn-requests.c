@@ -551,8 +551,7 @@ nfn_request_RX_keepalive(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                     ccnl_prefix_to_path(i_it->keepalive_origin->pkt->pfx));
                 
                 // reset original interest
-                i_it->keepalive_origin->last_used = CCNL_NOW();
-                i_it->keepalive_origin->retries = 0;
+                ccnl_interest_refresh(i_it->keepalive_origin);
 
                 // remove keepalive interest
                 i_it->keepalive_origin->keepalive = NULL;
@@ -600,12 +599,11 @@ nfn_request_RX_intermediate(struct ccnl_relay_s *relay, struct ccnl_face_s *from
     packet->contlen = (*pkt)->contlen;
 
     struct ccnl_content_s *content = ccnl_content_new(&packet);
-    ccnl_content_add2cache(relay, content);
-    // ccnl_free(packet);
-    // ccnl_free(content);
 
     DEBUGMSG_CFWD(INFO, "data after caching intermediate result %.*s\n", 
     content->pkt->contlen, content->pkt->content);
+    if (ccnl_content_add2cache(relay, content) < 0)
+        ccnl_content_free(content);
 
     TRACEOUT();
     return 1;
@@ -32,6 +32,7 @@
 #include "ccnl-nfn-common.h"
 #include "ccnl-nfn-parse.h"
 #include "ccnl-nfn-krivine.h"
+#include "ccnl-nfn-memo.h"
 #include "ccnl-nfn-ops.h"
 
 
@@ -65,8 +66,7 @@ void ccnl_nfn_continue_computation(struct ccnl_relay_s *ccnl, int configid, int
     struct ccnl_interest_s *original_interest;
     for(original_interest = ccnl->pit; original_interest; original_interest = original_interest->next){
         if(!ccnl_prefix_cmp(config->prefix, 0, original_interest->pkt->pfx, CMP_EXACT)){
-            original_interest->last_used = CCNL_NOW();
-            original_interest->retries = 0;
+            ccnl_interest_refresh(original_interest);
             original_interest->from->last_used = CCNL_NOW();
             break;
         }
@@ -84,7 +84,7 @@ ccnl_nfn_nack_local_computation(struct ccnl_relay_s *ccnl,
 {
     DEBUGMSG(TRACE, "ccnl_nfn_nack_local_computation\n");
     (void)orig;
-    ccnl_nfn(ccnl, prefix, from, NULL, NULL, suite, 1);
+    ccnl_nfn(ccnl, ccnl_prefix_dup(prefix), from, NULL, NULL, suite, 1);
     TRACEOUT();
 }
 
@@ -137,7 +137,6 @@ ccnl_nfn(struct ccnl_relay_s *ccnl, // struct ccnl_buf_s *orig,
 {
     struct ccnl_buf_s *res = NULL;
     char str[CCNL_MAX_PACKET_SIZE];
-    int i, len = 0;
 
     DEBUGMSG(TRACE, "ccnl_nfn(%p, %s, %p, config=%p)\n",
              (void*)ccnl, ccnl_prefix_to_path(prefix),
@@ -182,33 +181,21 @@ ccnl_nfn(struct ccnl_relay_s *ccnl, // struct ccnl_buf_s *orig,
     }
 
     //put packet together
-#if defined(USE_SUITE_CCNTLV) || defined(USE_SUITE_CISTLV)
-    if (prefix->suite == CCNL_SUITE_CCNTLV ||
-                                        prefix->suite == CCNL_SUITE_CISTLV) {
-        len = prefix->complen[prefix->compcnt-1] - 4;
-        memcpy(str, prefix->comp[prefix->compcnt-1] + 4, len);
-        str[len] = '\0';
-    } else
-#endif
-    {
-        len = prefix->complen[prefix->compcnt-1];
-        memcpy(str, prefix->comp[prefix->compcnt-1], len);
-        str[len] = '\0';
-    }
-    if (prefix->compcnt > 1)
-        len += sprintf(str + len, " ");
-    for (i = 0; i < prefix->compcnt-1; i++) {
-#if defined(USE_SUITE_CCNTLV) || defined(USE_SUITE_CISTLV)
-        if (prefix->suite == CCNL_SUITE_CCNTLV ||
-                                      prefix->suite == CCNL_SUITE_CISTLV)
-            len += sprintf(str+len,"/%.*s",prefix->complen[i]-4,prefix->comp[i]+4);
-        else
-#endif
-            len += sprintf(str+len,"/%.*s",prefix->complen[i],prefix->comp[i]);
-    }
+    ccnl_nfnprefix_toExpr(prefix, str);
 
     DEBUGMSG(DEBUG, "expr is <%s>\n", str);
     //search for result here... if found return...
+    {
+        struct ccnl_content_s *c = ccnl_nfn_memo_content(ccnl, NULL, prefix);
+        if (c) {
+            DEBUGMSG(INFO, "Computation memoized: res: %.*s\n",
+                     c->pkt->contlen, c->pkt->content);
+            set_propagate_of_interests_to_1(ccnl, c->pkt->pfx);
+            ccnl_content_serve_pending(ccnl, c);
+            ccnl_prefix_free(prefix);
+            return 0;
+        }
+    }
 
     ++ccnl->km->numOfRunningComputations;
 restart:
@@ -222,13 +209,15 @@ restart:
         DEBUGMSG(INFO,"Computation finished: res: %.*s size: %d bytes. Running computations: %d\n",
                  (int) res->datalen, res->data, (int) res->datalen, ccnl->km->numOfRunningComputations);
 
+        ccnl_nfn_memo_add(ccnl, config->prefix, res->data, res->datalen);
         copy = ccnl_prefix_dup(config->prefix);
         c = ccnl_nfn_result2content(ccnl, &copy, res->data, res->datalen);
         c->flags = CCNL_CONTENT_FLAGS_STATIC;
 
         set_propagate_of_interests_to_1(ccnl, c->pkt->pfx);
         ccnl_content_serve_pending(ccnl,c);
-        ccnl_content_add2cache(ccnl, c);
+        if (ccnl_content_add2cache(ccnl, c) < 0)
+            ccnl_content_free(c);
         --ccnl->km->numOfRunningComputations;
 
         DBL_LINKED_LIST_REMOVE(ccnl->km->configuration_list, config);
@@ -307,7 +296,7 @@ ccnl_nfn_RX_result(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                    struct ccnl_content_s *c)
 {
     struct ccnl_interest_s *i_it = NULL;
-    int found = 0;
+    int found = 0, cached = -1;
     (void)from;
 
     DEBUGMSG_CFWD(INFO, "data in rx result %.*s\n", c->pkt->contlen, c->pkt->content);
@@ -332,16 +321,20 @@ ccnl_nfn_RX_result(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
 #ifdef USE_NFN_REQUESTS
             if (!ccnl_nfnprefix_isRequest(c->pkt->pfx)) {
 #endif
-                ccnl_content_add2cache(relay, c);
+                if (!ccnl_content_add2cache(relay, c))
+                    cached = 0;
 #ifdef USE_NFN_REQUESTS
             }
 #endif
             
 	        DEBUGMSG_CFWD(INFO, "data in rx resulti after add to cache %.*s\n", c->pkt->contlen, c->pkt->content);
+            if (!found)
+                ccnl_nfn_memo_add(relay, c->pkt->pfx, c->pkt->content,
+                                  c->pkt->contlen);
             DEBUGMSG(DEBUG, "Continue configuration for configid: %d with prefix: %s\n",
                   faceid, ccnl_prefix_to_path(c->pkt->pfx));
             i_it->flags |= CCNL_PIT_COREPROPAGATES;
-            i_it->from = NULL;
+            ccnl_interest_set_from(i_it, NULL);
 
 #ifdef USE_NFN_REQUESTS
             if (!ccnl_nfnprefix_isRequest(c->pkt->pfx)) {
@@ -358,6 +351,8 @@ ccnl_nfn_RX_result(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
             i_it = i_it->next;
         }
     }
+    if (found && cached < 0) // the computations have seen it
+        ccnl_content_free(c);
     TRACEOUT();
     return found > 0;
 }
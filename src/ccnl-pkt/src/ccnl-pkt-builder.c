@@ -224,7 +224,7 @@ ccnl_mkInterestObject(struct ccnl_prefix_s *name, ccnl_interest_opts_u *opts)
 {
     struct ccnl_interest_s *i = (struct ccnl_interest_s *) ccnl_calloc(1,
                                                                        sizeof(struct ccnl_interest_s));
-    i->pkt = (struct ccnl_pkt_s *) ccnl_calloc(1, sizeof(struct ccnl_pkt_s));
+    i->pkt = ccnl_pool_alloc(CCNL_POOL_PKT);
     i->pkt->buf = ccnl_mkSimpleInterest(name, opts);
     i->pkt->pfx = ccnl_prefix_dup(name);
     i->flags |= CCNL_PIT_COREPROPAGATES;
@@ -309,7 +309,7 @@ ccnl_mkContentObject(struct ccnl_prefix_s *name,
                      ccnl_data_opts_u *opts)
 {
     int dataoffset;
-    struct ccnl_pkt_s *c_p = ccnl_calloc(1, sizeof(struct ccnl_pkt_s));
+    struct ccnl_pkt_s *c_p = ccnl_pool_alloc(CCNL_POOL_PKT);
     c_p->buf = ccnl_mkSimpleContent(name, payload, paylen, &dataoffset, opts);
     c_p->pfx = ccnl_prefix_dup(name);
     c_p->content = c_p->buf->data + dataoffset;
@@ -350,6 +350,7 @@ ccnl_mkSimpleContent(struct ccnl_prefix_s *name,
     return buf;
 }
 
+// the packet is at tmp + *offs, the payload at *contentpos from there
 void
 ccnl_mkContent(struct ccnl_prefix_s *name, unsigned char *payload, int paylen, unsigned char *tmp,
                int *len, int *contentpos, int *offs, ccnl_data_opts_u *opts) {
@@ -365,6 +366,7 @@ ccnl_mkContent(struct ccnl_prefix_s *name, unsigned char *payload, int paylen, u
             unsigned int lcn = 0; // lastchunknum
             (*len) = ccnl_ccntlv_prependContentWithHdr(name, payload, paylen, &lcn,
                                                        contentpos, offs, tmp);
+            (*contentpos) -= (*offs);
             break;
         }
 #endif
@@ -373,6 +375,7 @@ ccnl_mkContent(struct ccnl_prefix_s *name, unsigned char *payload, int paylen, u
             (*len) = ccnl_cistlv_prependContentWithHdr(name, payload, paylen,
                                                        NULL, // lastchunknum
                                                        offs, contentpos, tmp);
+            (*contentpos) -= (*offs);
             break;
 #endif
 #ifdef USE_SUITE_IOTTLV
@@ -384,6 +387,7 @@ ccnl_mkContent(struct ccnl_prefix_s *name, unsigned char *payload, int paylen, u
             (*len) = rc;
             rc = ccnl_switch_prependCoding(CCNL_ENC_IOT2014, offs, tmp);
             (*len) = (rc <= 0) ? 0 : (*len) + rc;
+            (*contentpos) += (rc <= 0) ? 0 : rc;
             break;
         }
 #endif
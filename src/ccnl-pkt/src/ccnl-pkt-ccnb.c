@@ -130,7 +130,7 @@ ccnl_ccnb_bytes2pkt(unsigned char *start, unsigned char **data, int *datalen)
     DEBUGMSG(TRACE, "ccnl_ccnb_extract\n");
 
     //pkt = (struct ccnl_pkt_s *) ccnl_calloc(1, sizeof(*pkt));
-    pkt = (struct ccnl_pkt_s *) ccnl_calloc(1, sizeof(*pkt));
+    pkt = ccnl_pool_alloc(CCNL_POOL_PKT);
     if (!pkt)
         return NULL;
     pkt->suite = CCNL_SUITE_CCNB;
@@ -141,7 +141,7 @@ ccnl_ccnb_bytes2pkt(unsigned char *start, unsigned char **data, int *datalen)
 
     pkt->pfx = p = ccnl_prefix_new(CCNL_SUITE_CCNB, CCNL_MAX_NAME_COMP);
     if (!p) {
-        ccnl_free(pkt);
+        ccnl_pool_free(CCNL_POOL_PKT, pkt);
         return NULL;
     }
     p->compcnt = 0;
@@ -240,7 +240,7 @@ ccnl_ccnb_bytes2pkt(unsigned char *start, unsigned char **data, int *datalen)
         oldpos = *data - start;
     }
     pkt->pfx = p;
-    pkt->buf = ccnl_buf_new(start, *data - start);
+    pkt->buf = ccnl_buf_rx(start, *data - start);
     // carefully rebase ptrs to new buf because of 64bit pointers:
     if (pkt->content)
         pkt->content = pkt->buf->data + (pkt->content - start);
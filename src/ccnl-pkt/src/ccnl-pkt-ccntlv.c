@@ -132,13 +132,13 @@ ccnl_ccntlv_bytes2pkt(unsigned char *start, unsigned char **data, int *datalen)
 
     DEBUGMSG_PCNX(TRACE, "ccnl_ccntlv_bytes2pkt len=%d\n", *datalen);
 
-    pkt = (struct ccnl_pkt_s*) ccnl_calloc(1, sizeof(*pkt));
+    pkt = ccnl_pool_alloc(CCNL_POOL_PKT);
     if (!pkt)
         return NULL;
 
     pkt->pfx = p = ccnl_prefix_new(CCNL_SUITE_CCNTLV, CCNL_MAX_NAME_COMP);
     if (!p) {
-        ccnl_free(pkt);
+        ccnl_pool_free(CCNL_POOL_PKT, pkt);
         return NULL;
     }
     p->compcnt = 0;
@@ -271,7 +271,7 @@ ccnl_ccntlv_bytes2pkt(unsigned char *start, unsigned char **data, int *datalen)
         goto Bail;
 
     pkt->pfx = p;
-    pkt->buf = ccnl_buf_new(start, *data - start);
+    pkt->buf = ccnl_buf_rx(start, *data - start);
     if (!pkt->buf)
         goto Bail;
     // carefully rebase ptrs to new buf because of 64bit pointers:
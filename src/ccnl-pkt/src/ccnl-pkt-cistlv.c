@@ -99,13 +99,13 @@ ccnl_cistlv_bytes2pkt(unsigned char *start, unsigned char **data, int *datalen)
     DEBUGMSG(DEBUG, "extracting CISTLV packet (%d, %d bytes)\n",
              (int)(*data - start), *datalen);
 
-    pkt = (struct ccnl_pkt_s*) ccnl_calloc(1, sizeof(*pkt));
+    pkt = ccnl_pool_alloc(CCNL_POOL_PKT);
     if (!pkt)
         return NULL;
 
     pkt->pfx = p = ccnl_prefix_new(CCNL_SUITE_CISTLV, CCNL_MAX_NAME_COMP);
     if (!p) {
-        ccnl_free(pkt);
+        ccnl_pool_free(CCNL_POOL_PKT, pkt);
         return NULL;
     }
     p->compcnt = 0;
@@ -198,7 +198,7 @@ ccnl_cistlv_bytes2pkt(unsigned char *start, unsigned char **data, int *datalen)
         goto Bail;
 
     pkt->pfx = p;
-    pkt->buf = ccnl_buf_new(start, *data - start);
+    pkt->buf = ccnl_buf_rx(start, *data - start);
     if (!pkt->buf)
         goto Bail;
     // carefully rebase ptrs to new buf because of 64bit pointers:
@@ -171,7 +171,7 @@ ccnl_iottlv_bytes2pkt(int pkttype, unsigned char *start,
     }
     */
 
-    pkt = (struct ccnl_pkt_s*) ccnl_calloc(1, sizeof(*pkt));
+    pkt = ccnl_pool_alloc(CCNL_POOL_PKT);
     if (!pkt)
         return NULL;
     pkt->suite = CCNL_SUITE_IOTTLV;
@@ -311,7 +311,7 @@ ccnl_iottlv_bytes2pkt(int pkttype, unsigned char *start,
         start -= len2;
     } else
         len2 = 0;
-    pkt->buf = ccnl_buf_new(start, *data - start);
+    pkt->buf = ccnl_buf_rx(start, *data - start);
     if (!pkt->buf)
         goto Bail;
     if (pkt->buf && len2)
@@ -45,8 +45,9 @@
 int
 ccnl_ndntlv_varlenint(unsigned char **buf, int *len, int *val)
 {
-
-    if (**buf < 253 && *len >= 1) {
+    if (*len < 1)
+        return -1;
+    if (**buf < 253) {
         *val = **buf;
         *buf += 1;
         *len -= 1;
@@ -116,7 +117,7 @@ ccnl_ndntlv_bytes2pkt(unsigned int pkttype, unsigned char *start,
 
     DEBUGMSG(DEBUG, "ccnl_ndntlv_bytes2pkt len=%d\n", *datalen);
 
-    pkt = (struct ccnl_pkt_s*) ccnl_calloc(1, sizeof(struct ccnl_pkt_s));
+    pkt = ccnl_pool_alloc(CCNL_POOL_PKT);
     if (!pkt)
         return NULL;
     pkt->type = pkttype;
@@ -147,7 +148,7 @@ ccnl_ndntlv_bytes2pkt(unsigned int pkttype, unsigned char *start,
     pkt->s.ndntlv.maxsuffix = CCNL_MAX_NAME_COMP;
 
     /* set default lifetime, in case InterestLifetime guider is absent */
-    pkt->s.ndntlv.interestlifetime = CCNL_INTEREST_TIMEOUT;
+    pkt->s.ndntlv.interestlifetime = CCNL_INTEREST_TIMEOUT * 1000;
 
     oldpos = *data - start;
     while (ccnl_ndntlv_dehead(data, datalen, (int*) &typ, &len) == 0) {
@@ -311,7 +312,7 @@ ccnl_ndntlv_bytes2pkt(unsigned int pkttype, unsigned char *start,
         goto Bail;
 
     pkt->pfx = p;
-    pkt->buf = ccnl_buf_new(start, *data - start);
+    pkt->buf = ccnl_buf_rx(start, *data - start);
     if (!pkt->buf)
         goto Bail;
     // carefully rebase ptrs to new buf because of 64bit pointers:
@@ -346,7 +347,7 @@ ccnl_ndntlv_cMatch(struct ccnl_pkt_s *p, struct ccnl_content_s *c)
     if (!ccnl_i_prefixof_c(p->pfx, p->s.ndntlv.minsuffix, p->s.ndntlv.maxsuffix, c))
         return -1;
 
-    if (p->s.ndntlv.mbf && c->stale) {
+    if (p->s.ndntlv.mbf && ccnl_content_is_stale(c)) {
         DEBUGMSG(DEBUG, "ignore stale content\n");
         return -1;
     }
@@ -584,9 +585,6 @@ ccnl_ndntlv_prependContent(struct ccnl_prefix_s *name,
     int oldoffset = *offset, oldoffset2;
     unsigned char signatureType = NDN_VAL_SIGTYPE_DIGESTSHA256;
 
-    if (contentpos)
-        *contentpos = *offset - paylen;
-
     // fill in backwards
 
     // mandatory (empty for now)
@@ -611,6 +609,10 @@ ccnl_ndntlv_prependContent(struct ccnl_prefix_s *name,
     if (ccnl_ndntlv_prependTL(NDN_TLV_SignatureInfo, oldoffset2 - *offset, offset, buf) < 0)
         return -1;
 
+    // the payload ends where the signature begins
+    if (contentpos)
+        *contentpos = *offset - paylen;
+
     // mandatory
     if (ccnl_ndntlv_prependBlob(NDN_TLV_Content, payload, paylen,
                                 offset, buf) < 0)
@@ -72,6 +72,14 @@
 
 #include "ccn-lite-relay.h"
 #include "ccnl-unix.h"
+#include "ccnl-store.h"
+#ifdef USE_HTTP_STATUS
+#include "ccnl-http-status.h"
+#endif
+#ifdef USE_SHARDS
+#include "ccnl-shard.h"
+#include "ccnl-preload.h"
+#endif
 
 static int lasthour = -1;
 static int inter_ccn_interval = 0; // in usec
@@ -116,6 +124,9 @@ const char *compile_string = ""
 #ifdef USE_LOGGING
         "LOGGING, "
 #endif
+#ifdef USE_MALLOC_ACCT
+        "MALLOC_ACCT, "
+#endif
 #ifdef USE_MGMT
         "MGMT, "
 #endif
@@ -134,6 +145,9 @@ const char *compile_string = ""
 #ifdef USE_SCHEDULER
         "SCHEDULER, "
 #endif
+#ifdef USE_SHARDS
+        "SHARDS, "
+#endif
 #ifdef USE_SIGNATURES
         "SIGNATURES, "
 #endif
@@ -168,12 +182,15 @@ int
 main(int argc, char **argv)
 {
     int opt, max_cache_entries = -1, httpport = -1;
+    int cache_policy = CCNL_CACHE_LRU;
+    long max_cache_bytes = 0;
     int udpport1 = -1, udpport2 = -1;
     int udp6port1 = -1, udp6port2 = -1;
-    char *datadir = NULL, *ethdev = NULL, *crypto_sock_path = NULL;
+    char *datadir = NULL, *storedir = NULL, *ethdev = NULL;
+    char *crypto_sock_path = NULL;
     char *wpandev = NULL;
     int suite = CCNL_SUITE_DEFAULT;
-    struct ccnl_relay_s *theRelay = ccnl_malloc(sizeof(struct ccnl_relay_s));
+    struct ccnl_relay_s *theRelay = ccnl_calloc(1, sizeof(struct ccnl_relay_s));
 #ifdef USE_UNIXSOCKET
     char *uxpath = CCNL_DEFAULT_UNIXSOCKNAME;
 #else
@@ -182,6 +199,11 @@ main(int argc, char **argv)
 #ifdef USE_ECHO
     char *echopfx = NULL;
 #endif
+#ifdef USE_SHARDS
+    int shards = 1, loaders = CCNL_PRELOAD_LOADERS;
+#else
+    int loaders = 0;
+#endif
 
     time(&theRelay->startup_time);
     unsigned int seed = time(NULL) * getpid();
@@ -191,8 +213,16 @@ main(int argc, char **argv)
     srandom(seed);
 #endif
 
-    while ((opt = getopt(argc, argv, "hc:d:e:g:i:o:p:s:t:u:6:v:w:x:")) != -1) {
+    while ((opt = getopt(argc, argv, "ha:b:c:d:e:g:i:l:m:n:o:p:r:s:t:u:6:v:w:x:")) != -1) {
         switch (opt) {
+#ifdef USE_MALLOC_ACCT
+        case 'a':
+            acct_sample = atoi(optarg);
+            break;
+#endif
+        case 'b':
+            max_cache_bytes = atol(optarg);
+            break;
         case 'c':
             max_cache_entries = atoi(optarg);
             break;
@@ -208,6 +238,19 @@ main(int argc, char **argv)
         case 'i':
             inter_ccn_interval = atoi(optarg);
             break;
+#ifdef USE_SHARDS
+        case 'l':
+            loaders = atoi(optarg);
+            break;
+#endif
+        case 'm':
+            storedir = optarg;
+            break;
+#ifdef USE_SHARDS
+        case 'n':
+            shards = atoi(optarg);
+            break;
+#endif
 #ifdef USE_ECHO
         case 'o':
             echopfx = optarg;
@@ -216,6 +259,11 @@ main(int argc, char **argv)
         case 'p':
             crypto_sock_path = optarg;
             break;
+        case 'r':
+            cache_policy = ccnl_cache_str2policy(optarg);
+            if (cache_policy < 0)
+                goto usage;
+            break;
         case 's':
             suite = ccnl_str2suite(optarg);
             if (!ccnl_isSuite(suite))
@@ -257,16 +305,28 @@ main(int argc, char **argv)
 usage:
             fprintf(stderr,
                     "usage: %s [options]\n"
+#ifdef USE_MALLOC_ACCT
+                    "  -a N (backtrace of every Nth allocation, see 'debug memdump')\n"
+#endif
+                    "  -b MAX_CONTENT_BYTES (0: no limit)\n"
                     "  -c MAX_CONTENT_ENTRIES\n"
                     "  -d databasedir\n"
                     "  -e ethdev\n"
                     "  -g MIN_INTER_PACKET_INTERVAL\n"
                     "  -h\n"
                     "  -i MIN_INTER_CCNMSG_INTERVAL\n"
+#ifdef USE_SHARDS
+                    "  -l LOADERS (threads loading -d while running, default 4, 0: before)\n"
+#endif
+                    "  -m storedir (content repository below the cache, -d adds to it)\n"
+#ifdef USE_SHARDS
+                    "  -n SHARDS (relay threads, default 1)\n"
+#endif
 #ifdef USE_ECHO
                     "  -o echo_prefix\n"
 #endif
                     "  -p crypto_face_ux_socket\n"
+                    "  -r CACHE_POLICY (lru, slru, lfu)\n"
                     "  -s SUITE (ccnb, ccnx2015, cisco2015, iot2014, ndn2013)\n"
                     "  -t tcpport (for HTML status page)\n"
                     "  -u udpport (can be specified twice)\n"
@@ -305,7 +365,26 @@ usage:
     ccnl_relay_config(theRelay, ethdev, wpandev, udpport1, udpport2,
 		      udp6port1, udp6port2, httpport,
                       uxpath, suite, max_cache_entries, crypto_sock_path);
-    if (datadir)
+    ccnl_cache_set_policy(theRelay, cache_policy);
+    if (max_cache_bytes > 0)
+        theRelay->cache.max_bytes = max_cache_bytes;
+    // the store is filled before there are shard threads looking into it
+    if (storedir && ccnl_store_open(theRelay, storedir))
+        DEBUGMSG(WARNING, "running without a store\n");
+    if (datadir && ccnl_store_isopen()) {
+#ifdef USE_SHARDS
+        if (loaders > 0 && !ccnl_preload_start(theRelay, datadir, loaders))
+            ccnl_preload_wait(theRelay);
+        else
+#endif
+        ccnl_populate_cache(theRelay, datadir);
+    }
+#ifdef USE_SHARDS
+    if (shards > 1 && ccnl_shards_init(theRelay, shards,
+                                       uxpath ? uxpath : CCNL_DEFAULT_UNIXSOCKNAME))
+        DEBUGMSG(WARNING, "running unsharded\n");
+#endif
+    if (datadir && !ccnl_store_isopen() && loaders < 1)
         ccnl_populate_cache(theRelay, datadir);
 
 #ifdef USE_ECHO
@@ -320,17 +399,31 @@ usage:
     }
 #endif
 
+#ifdef USE_SHARDS
+    ccnl_shards_start(theRelay);
+    // the relay serves while the data directory is loaded
+    if (datadir && !ccnl_store_isopen() && loaders > 0)
+        ccnl_preload_start(theRelay, datadir, loaders);
+#endif
     ccnl_io_loop(theRelay);
-
-    while (eventqueue)
-        ccnl_rem_timer(eventqueue);
+#ifdef USE_SHARDS
+    ccnl_preload_stop();
+    ccnl_shards_stop(theRelay);
+#endif
 
     ccnl_core_cleanup(theRelay);
+    ccnl_store_close();
+    ccnl_timer_cleanup();
+    ccnl_pool_cleanup();
 #ifdef USE_HTTP_STATUS
     theRelay->http = ccnl_http_cleanup(theRelay->http);
 #endif
 #ifdef USE_DEBUG_MALLOC
     debug_memdump();
+#endif
+#ifdef USE_MALLOC_ACCT
+    if (debug_level >= INFO)
+        acct_memprint();
 #endif
     ccnl_free(theRelay);
     return 0;
@@ -177,6 +177,20 @@ int ccnl_wait_for_chunk(void *buf, size_t buf_len, uint64_t timeout);
  */
 void ccnl_set_cache_strategy_remove(ccnl_cache_strategy_func func);
 
+/**
+ * @brief Select the replacement policy and byte budget of the content store
+ *
+ * Content is replaced by @p policy when the cache is full and the function
+ * set by ccnl_set_cache_strategy_remove() removed nothing.
+ *
+ * @param[in] policy     CCNL_CACHE_LRU, CCNL_CACHE_SLRU or CCNL_CACHE_LFU
+ * @param[in] max_bytes  Maximum size of all cached packets, 0 for no limit
+ *
+ * @return 0 on success
+ * @return -1 if @p policy is unknown
+ */
+int ccnl_set_cache_policy(int policy, size_t max_bytes);
+
 #ifdef __cplusplus
 }
 #endif
@@ -45,11 +45,6 @@
 #include "ccnl-producer.h"
 #include "ccnl-pkt-builder.h"
 
-/**
- * @brief May be defined for a particular caching strategy
- */
-int cache_strategy_remove(struct ccnl_relay_s *relay, struct ccnl_content_s *c);
-
 /**
  * @brief RIOT specific local variables
  * @{
@@ -75,12 +70,6 @@ static kernel_pid_t _ccnl_event_loop_pid = KERNEL_PID_UNDEF;
  */
 static xtimer_t _ageing_timer = { .target = 0, .long_target = 0 };
 
-
-/**
- * caching strategy removal function
- */
-static ccnl_cache_strategy_func _cs_remove_func = NULL;
-
 /**
  * currently configured suite
  */
@@ -175,6 +164,9 @@ ccnl_buf_new(void *data, int len)
         return NULL;
     b->next = NULL;
     b->datalen = len;
+    b->data = (unsigned char*) (b + 1);
+    b->parent = NULL;
+    b->refcnt = 1;
     if (data)
         memcpy(b->data, data, len);
     return b;
@@ -451,12 +443,17 @@ void
                 reply.content.value = -ENOTSUP;
                 msg_reply(&m, &reply);
                 break;
-            case CCNL_MSG_AGEING:
+            case CCNL_MSG_AGEING: {
                 DEBUGMSG(VERBOSE, "ccn-lite: ageing timer\n");
                 ccnl_do_ageing(arg, NULL);
+                /* PIT and CS entries expire by ccnl_set_timer() */
+                int usec = ccnl_run_events();
+                if (usec < 0 || usec > (int) US_PER_SEC)
+                    usec = US_PER_SEC;
                 xtimer_remove(&_ageing_timer);
-                xtimer_set_msg(&_ageing_timer, US_PER_SEC, &reply, sched_active_pid);
+                xtimer_set_msg(&_ageing_timer, usec, &reply, sched_active_pid);
                 break;
+            }
             default:
                 DEBUGMSG(WARNING, "ccn-lite: unknown message type\n");
                 break;
@@ -600,14 +597,15 @@ ccnl_send_interest(struct ccnl_prefix_s *prefix, unsigned char *buf, int buf_len
 void
 ccnl_set_cache_strategy_remove(ccnl_cache_strategy_func func)
 {
-    _cs_remove_func = func;
+    ccnl_relay.cache.remove_func = func;
 }
 
 int
-cache_strategy_remove(struct ccnl_relay_s *relay, struct ccnl_content_s *c)
+ccnl_set_cache_policy(int policy, size_t max_bytes)
 {
-    if (_cs_remove_func) {
-        return _cs_remove_func(relay, c);
+    if (ccnl_cache_set_policy(&ccnl_relay, policy) < 0) {
+        return -1;
     }
+    ccnl_relay.cache.max_bytes = max_bytes;
     return 0;
 }
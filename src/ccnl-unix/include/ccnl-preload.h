@@ -0,0 +1,98 @@
+/*
+ * @f ccnl-preload.h
+ * @b CCN lite, loading the data directory with worker threads
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_PRELOAD_H
+#define CCNL_PRELOAD_H
+
+// relies on the per thread state of the core which comes with USE_SHARDS
+#ifdef USE_SHARDS
+
+#include "ccnl-relay.h"
+#include "ccnl-pkt.h"
+#include "ccnl-store.h"
+
+/**
+ * The files of the data directory (-d) are read and parsed by a pool of
+ * loader threads which share the directory stream. Parsed content objects
+ * are passed in batches to the thread owning them, which adds them to its
+ * CS: batches for shard 0 (or an unsharded relay) through a pipe polled by
+ * the IO loop, those for the other shards through their steering socket.
+ * The relay serves requests while the loaders are running.
+ *
+ * With a store open, all batches go to the thread which started the
+ * loaders and waits for them in @ref ccnl_preload_wait, as only one thread
+ * may add to the store. Files the store lists as imported are skipped.
+ */
+
+struct ccnl_preload_batch_s {
+    int count;
+    struct ccnl_pkt_s *pkt[CCNL_PRELOAD_BATCH];
+    struct ccnl_store_file_s file[CCNL_PRELOAD_BATCH];
+};
+
+/**
+ * @brief Start @p loaders threads loading directory @p path into @p ccnl
+ *        (and its shards) or into the store
+ *
+ * @return 0 on success, -1 on error
+ */
+int
+ccnl_preload_start(struct ccnl_relay_s *ccnl, char *path, int loaders);
+
+/**
+ * @brief The descriptor shard 0 has to watch for batches, -1 if there is
+ *        no loading going on
+ */
+int
+ccnl_preload_fd(void);
+
+/**
+ * @brief Add the batches waiting in the pipe to @p ccnl, called when
+ *        @ref ccnl_preload_fd is readable; the loaders are joined once
+ *        they are done
+ */
+void
+ccnl_preload_RX(struct ccnl_relay_s *ccnl);
+
+/**
+ * @brief Add the content objects of batch @p b to @p ccnl and free it
+ */
+void
+ccnl_preload_insert(struct ccnl_relay_s *ccnl, struct ccnl_preload_batch_s *b);
+
+/**
+ * @brief Add batches until the loaders are done
+ */
+void
+ccnl_preload_wait(struct ccnl_relay_s *ccnl);
+
+/**
+ * @brief Stop the loaders, what they did not pass on yet is dropped
+ *
+ * To be called before the shards are stopped.
+ */
+void
+ccnl_preload_stop(void);
+
+#endif // USE_SHARDS
+
+#endif // CCNL_PRELOAD_H
@@ -0,0 +1,153 @@
+/*
+ * @f ccnl-shard.h
+ * @b CCN lite, relay threads which partition PIT and CS by name
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_SHARD_H
+#define CCNL_SHARD_H
+
+#ifdef USE_SHARDS
+
+#include <pthread.h>
+#include <sys/un.h>
+
+#include "ccnl-relay.h"
+#include "ccnl-forward.h"
+
+/**
+ * A sharded relay consists of one ccnl_relay_s per thread. Shard 0 is the
+ * relay the user configured: it owns all sockets, reads every datagram and
+ * steers it by a hash over the first CCNL_SHARD_PREFIX_DEPTH name
+ * components to the shard owning that name, so each shard has its own PIT
+ * and CS. The other shards use copies of the interface table (same socket
+ * descriptors) to send.
+ *
+ * Management and the FIB stay with shard 0; every FIB change is published
+ * as a read-only route table which the other shards install. Interests of
+ * local origin (e.g. NFN) whose name belongs to another shard are handed
+ * over through a UNIX datagram "shard link" which every shard has at the
+ * same interface index.
+ */
+
+/**
+ * @brief One route of a published FIB
+ */
+struct ccnl_shard_route_s {
+    struct ccnl_prefix_s *prefix;
+    tapCallback tap;
+    int ifndx;
+    sockunion peer;
+};
+
+/**
+ * @brief Snapshot of the FIB of shard 0, freed by the last shard using it
+ */
+struct ccnl_shard_routes_s {
+    int refs;
+    int count;
+    struct ccnl_shard_route_s route[1];
+};
+
+struct ccnl_shard_s {
+    struct ccnl_relay_s *relay;
+    pthread_t thread;
+    int running;
+    int steer[2];               /**< socketpair, [0]: shard 0 writes, [1]: shard reads */
+    struct sockaddr_un link;    /**< address of the shard link */
+    uint32_t steered, dropped;  /**< datagrams passed to the shard, lost on overload */
+};
+
+struct ccnl_shardset_s {
+    int count;
+    int linkndx;                /**< interface index of the shard links */
+    int fib_gen;                /**< FIB generation last published */
+    pthread_mutex_t lock;       /**< protects the refs of route tables */
+    struct ccnl_shard_s shard[CCNL_MAX_SHARDS];
+};
+
+/**
+ * @brief Split @p ccnl into @p count shards
+ *
+ * Creates the relays of shards 1..count-1 and the shard links (named
+ * @p linkpath-shardN); the threads are started by @ref ccnl_shards_start.
+ * CS and PIT limits of @p ccnl are divided among the shards.
+ *
+ * @return 0 on success, -1 on error (@p ccnl remains unsharded)
+ */
+int
+ccnl_shards_init(struct ccnl_relay_s *ccnl, int count, char *linkpath);
+
+/**
+ * @brief Publish the FIB and start the threads of shards 1..count-1
+ */
+int
+ccnl_shards_start(struct ccnl_relay_s *ccnl);
+
+/**
+ * @brief Stop and join all shard threads and free their relays
+ */
+void
+ccnl_shards_stop(struct ccnl_relay_s *ccnl);
+
+/**
+ * @brief Index of the shard owning @p pfx
+ */
+int
+ccnl_shard_of(struct ccnl_shardset_s *shards, struct ccnl_prefix_s *pfx);
+
+/**
+ * @brief The relay of the shard owning @p pfx, @p ccnl if not sharded
+ *
+ * Only to be used before @ref ccnl_shards_start, e.g. to populate the CS.
+ */
+struct ccnl_relay_s*
+ccnl_shard_relay(struct ccnl_relay_s *ccnl, struct ccnl_prefix_s *pfx);
+
+/**
+ * @brief Pass a datagram received by shard 0 to the shard owning its name
+ *
+ * @return 1 if the datagram was passed on (or dropped), 0 if shard 0 has
+ *         to process it itself
+ */
+int
+ccnl_shard_steer(struct ccnl_relay_s *ccnl, int ifndx, unsigned char *data,
+                 int datalen, struct sockaddr *sa, int addrlen);
+
+struct ccnl_preload_batch_s;
+
+/**
+ * @brief Pass a batch of preloaded content objects to shard @p k, which
+ *        adds them to its CS
+ *
+ * @return 0 on success, -1 if the batch could not be passed on
+ */
+int
+ccnl_shard_preload(struct ccnl_relay_s *ccnl, int k,
+                   struct ccnl_preload_batch_s *b);
+
+/**
+ * @brief Publish the FIB of shard 0 to all shards if it changed
+ */
+void
+ccnl_shards_sync(struct ccnl_relay_s *ccnl);
+
+#endif // USE_SHARDS
+
+#endif // CCNL_SHARD_H
@@ -0,0 +1,133 @@
+/*
+ * @f ccnl-store.h
+ * @b CCN lite, content repository in memory mapped segment files
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_STORE_H
+#define CCNL_STORE_H
+
+#include <stdint.h>
+
+#include "ccnl-relay.h"
+#include "ccnl-pkt.h"
+
+/**
+ * The store is a directory holding content objects below the CS. Objects
+ * are appended to segment files (seg-NNNNN) of CCNL_STORE_SEGMENT_SIZE
+ * bytes which are mapped read-only, so a served object is a slice of the
+ * mapping and the page cache decides what stays in memory. The index file
+ * is an open addressing hash table from the name hash (see
+ * ccnl_nametree_hash) to segment, offset and length, which is mapped as
+ * well: opening the store reads nothing but the index header.
+ *
+ * The store is looked up by exact name when the CS has no match; a hit is
+ * added to the CS if caching is enabled. Adding objects is not thread safe,
+ * the store must be filled before shard threads are started: it holds the
+ * imported objects only, content received at run time goes to the CS.
+ *
+ * The files an object was imported from are listed in the file "files"
+ * (path hash, size and modification time), so importing the same
+ * directory again skips the unchanged files without reading them.
+ */
+
+#define CCNL_STORE_MAGIC        "CCNLST01"
+
+struct ccnl_store_hdr_s {
+    char magic[8];
+    uint32_t size;              /**< slots of the index, a power of two */
+    uint32_t count;             /**< objects in the store */
+    uint32_t segments;          /**< segment files in use */
+    uint32_t pad;
+    uint64_t tail;              /**< bytes used in the last segment */
+};
+
+struct ccnl_store_slot_s {
+    uint32_t hash;              /**< of the name, 0: empty slot */
+    uint32_t seg;
+    uint32_t off;
+    uint32_t len;
+};
+
+struct ccnl_store_file_s {
+    uint64_t name;              /**< hash of the path */
+    int64_t size;
+    int64_t mtime;              /**< nsec */
+};
+
+struct stat;
+
+/**
+ * @brief Open or create the store in directory @p dir and let @p ccnl
+ *        look up content in it
+ *
+ * @return 0 on success, -1 on error
+ */
+int
+ccnl_store_open(struct ccnl_relay_s *ccnl, char *dir);
+
+/**
+ * @brief Whether a store is open
+ */
+int
+ccnl_store_isopen(void);
+
+/**
+ * @brief Describe the file @p path with status @p s for the import list
+ */
+void
+ccnl_store_file(struct ccnl_store_file_s *f, char *path, struct stat *s);
+
+/**
+ * @brief Whether file @p f was imported before and did not change since
+ *
+ * Only files listed when the store was opened are known, so this can be
+ * asked from any thread while objects are added.
+ */
+int
+ccnl_store_imported(struct ccnl_store_file_s *f);
+
+/**
+ * @brief Append the content object @p pkt unless it is already stored
+ *
+ * If @p f is not NULL, the file is listed as imported.
+ *
+ * @return 0 if added, 1 if it was already there, -1 on error
+ */
+int
+ccnl_store_add(struct ccnl_pkt_s *pkt, struct ccnl_store_file_s *f);
+
+/**
+ * @brief Find content for interest @p pkt in the store
+ *
+ * @return the content, in the CS of @p ccnl unless it has no room (then
+ *         it is flagged CCNL_CONTENT_FLAGS_UNCACHED and the caller has to
+ *         free it), NULL if none
+ */
+struct ccnl_content_s*
+ccnl_store_lookup(struct ccnl_relay_s *ccnl, struct ccnl_pkt_s *pkt,
+                  int (*cMatch)(struct ccnl_pkt_s*, struct ccnl_content_s*));
+
+/**
+ * @brief Unmap and close the store
+ */
+void
+ccnl_store_close(void);
+
+#endif // CCNL_STORE_H
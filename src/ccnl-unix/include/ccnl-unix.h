@@ -97,6 +97,15 @@ void
 ccnl_ll_TX(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
            sockunion *dest, struct ccnl_buf_s *buf);
 
+#ifdef USE_BATCH_IO
+/**
+ * @brief Sends all queued datagrams of an interface, up to CCNL_IO_BATCH
+ *        per sendmmsg() call
+ */
+void
+ccnl_ll_TX_batch(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc);
+#endif
+
 void
 ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
                   int udpport1, int udpport2,
@@ -107,6 +116,29 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
 int
 ccnl_io_loop(struct ccnl_relay_s *ccnl);
 
+/**
+ * @brief Parse the content object of @p datalen bytes at @p data, as it is
+ *        found in a file of the data directory
+ *
+ * @return the packet, NULL if @p data holds no content object
+ */
+struct ccnl_pkt_s*
+ccnl_content_bytes2pkt(unsigned char *data, int datalen);
+
+/**
+ * @brief Read file @p fname of @p size bytes and parse its content object,
+ *        which keeps the buffer the file was read into
+ *
+ * @return the packet, NULL if the file could not be read or holds no
+ *         content object
+ */
+struct ccnl_pkt_s*
+ccnl_content_file2pkt(char *fname, int size);
+
+/**
+ * @brief Load the content objects in the files of directory @p path into
+ *        the CS as static content, or into the store if one is open
+ */
 void
 ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path);
 
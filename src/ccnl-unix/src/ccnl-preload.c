@@ -0,0 +1,305 @@
+/*
+ * @f ccnl-preload.c
+ * @b CCN lite, loading the data directory with worker threads
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifdef USE_SHARDS
+
+#define _DEFAULT_SOURCE // realpath
+
+#include "ccnl-preload.h"
+#include "ccnl-unix.h"
+#include "ccnl-shard.h"
+
+#include "ccnl-os-includes.h"
+#include <dirent.h>
+#include <limits.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "ccnl-core.h"
+
+#define CCNL_PRELOAD_MAX_LOADERS        64
+
+struct ccnl_preload_s {
+    struct ccnl_relay_s *ccnl;
+    char path[PATH_MAX];
+    DIR *dir;
+    pthread_mutex_t lock;       // the directory stream and what follows
+    int stop;
+    int running;                // loaders which did not finish yet
+    int loaded, skipped;
+    int loaders;
+    pthread_t thread[CCNL_PRELOAD_MAX_LOADERS];
+    int pipe[2];                // batches for shard 0, NULL when done
+    double started;
+};
+
+static struct ccnl_preload_s *preload;
+
+static void
+ccnl_preload_free(struct ccnl_preload_batch_s *b)
+{
+    int i;
+
+    for (i = 0; i < b->count; i++)
+        ccnl_pkt_free(b->pkt[i]);
+    ccnl_free(b);
+}
+
+static void
+ccnl_preload_pass(struct ccnl_preload_s *pl, int k,
+                  struct ccnl_preload_batch_s *b)
+{
+    int rc;
+
+    if (k > 0)
+        rc = ccnl_shard_preload(pl->ccnl, k, b);
+    else
+        rc = write(pl->pipe[1], &b, sizeof(b)) == sizeof(b) ? 0 : -1;
+    if (rc)
+        ccnl_preload_free(b);
+}
+
+static void*
+ccnl_preload_main(void *arg)
+{
+    struct ccnl_preload_s *pl = (struct ccnl_preload_s*) arg;
+    struct ccnl_shardset_s *shards = pl->ccnl->shards;
+    struct ccnl_preload_batch_s *batch[CCNL_MAX_SHARDS], *b;
+    char fname[PATH_MAX + 256];
+    struct ccnl_store_file_s f;
+    struct ccnl_pkt_s *pkt;
+    struct dirent *de;
+    struct stat s;
+    int loaded = 0, skipped = 0, done, k;
+
+    memset(batch, 0, sizeof(batch));
+    for (;;) {
+        pthread_mutex_lock(&pl->lock);
+        de = pl->stop ? NULL : readdir(pl->dir);
+        if (de)
+            snprintf(fname, sizeof(fname), "%s/%s", pl->path,
+                     de->d_name[0] == '.' ? "" : de->d_name);
+        pthread_mutex_unlock(&pl->lock);
+        if (!de)
+            break;
+
+        if (fname[strlen(fname) - 1] == '/' || stat(fname, &s) ||
+                                                S_ISDIR(s.st_mode))
+            continue;
+        ccnl_store_file(&f, fname, &s);
+        if (ccnl_store_imported(&f)) {
+            skipped++;
+            continue;
+        }
+        pkt = ccnl_content_file2pkt(fname, s.st_size);
+        if (!pkt)
+            continue;
+
+        k = shards ? ccnl_shard_of(shards, pkt->pfx) : 0;
+        if (!batch[k]) {
+            batch[k] = (struct ccnl_preload_batch_s*)
+                                        ccnl_calloc(1, sizeof(*batch[k]));
+            if (!batch[k]) {
+                ccnl_pkt_free(pkt);
+                continue;
+            }
+        }
+        b = batch[k];
+        b->pkt[b->count] = pkt;
+        b->file[b->count++] = f;
+        loaded++;
+        if (b->count == CCNL_PRELOAD_BATCH) {
+            ccnl_preload_pass(pl, k, b);
+            batch[k] = NULL;
+        }
+    }
+    for (k = 0; k < CCNL_MAX_SHARDS; k++)
+        if (batch[k])
+            ccnl_preload_pass(pl, k, batch[k]);
+
+    pthread_mutex_lock(&pl->lock);
+    pl->loaded += loaded;
+    pl->skipped += skipped;
+    done = --pl->running == 0;
+    pthread_mutex_unlock(&pl->lock);
+    if (done) {
+        b = NULL;
+        if (write(pl->pipe[1], &b, sizeof(b)) != sizeof(b))
+            perror("write");
+    }
+    ccnl_pool_cleanup();
+
+    return NULL;
+}
+
+int
+ccnl_preload_start(struct ccnl_relay_s *ccnl, char *path, int loaders)
+{
+    struct ccnl_preload_batch_s *b = NULL;
+    int k;
+
+    if (preload || loaders < 1)
+        return -1;
+    if (loaders > CCNL_PRELOAD_MAX_LOADERS)
+        loaders = CCNL_PRELOAD_MAX_LOADERS;
+    preload = (struct ccnl_preload_s*) ccnl_calloc(1, sizeof(*preload));
+    if (!preload)
+        return -1;
+    // imported files are listed by their full path
+    if (!realpath(path, preload->path) ||
+                        !(preload->dir = opendir(preload->path))) {
+        DEBUGMSG(ERROR, "could not open directory %s\n", path);
+        goto Error;
+    }
+    if (pipe(preload->pipe)) {
+        perror("pipe");
+        closedir(preload->dir);
+        goto Error;
+    }
+    fcntl(preload->pipe[0], F_SETFL, O_NONBLOCK);
+    pthread_mutex_init(&preload->lock, NULL);
+    preload->ccnl = ccnl;
+    preload->running = loaders;
+    preload->started = current_time();
+
+    DEBUGMSG(INFO, "loading %s from directory %s with %d threads\n",
+             ccnl_store_isopen() ? "store" : "cache", path, loaders);
+    for (k = 0; k < loaders; k++)
+        if (pthread_create(preload->thread + k, NULL, ccnl_preload_main,
+                           preload))
+            break;
+    preload->loaders = k;
+    if (k < loaders) {
+        DEBUGMSG(WARNING, "could only start %d loader threads\n", k);
+        pthread_mutex_lock(&preload->lock);
+        preload->running -= loaders - k;
+        if (!preload->running && write(preload->pipe[1], &b, sizeof(b)) < 0)
+            perror("write");
+        pthread_mutex_unlock(&preload->lock);
+    }
+    return 0;
+Error:
+    ccnl_free(preload);
+    preload = NULL;
+    return -1;
+}
+
+int
+ccnl_preload_fd(void)
+{
+    return preload ? preload->pipe[0] : -1;
+}
+
+// all loaders have passed on their last batch
+static void
+ccnl_preload_done(void)
+{
+    int k;
+
+    for (k = 0; k < preload->loaders; k++)
+        pthread_join(preload->thread[k], NULL);
+    DEBUGMSG(INFO, "%d content objects loaded in %.3f s\n", preload->loaded,
+             current_time() - preload->started);
+    if (preload->skipped)
+        DEBUGMSG(INFO, "%d files skipped, imported before\n",
+                 preload->skipped);
+    closedir(preload->dir);
+    close(preload->pipe[0]);
+    close(preload->pipe[1]);
+    pthread_mutex_destroy(&preload->lock);
+    ccnl_free(preload);
+    preload = NULL;
+}
+
+void
+ccnl_preload_insert(struct ccnl_relay_s *ccnl, struct ccnl_preload_batch_s *b)
+{
+    struct ccnl_content_s *c;
+    int i;
+
+    for (i = 0; i < b->count; i++) {
+        if (ccnl_store_isopen()) {
+            if (ccnl_store_add(b->pkt[i], b->file + i) < 0)
+                DEBUGMSG(WARNING, "could not store content\n");
+        } else if ((c = ccnl_content_new(b->pkt + i)) != NULL) {
+            c->flags |= CCNL_CONTENT_FLAGS_STATIC;
+            if (ccnl_content_add2cache(ccnl, c) < 0) // no room
+                ccnl_content_free(c);
+        }
+        ccnl_pkt_free(b->pkt[i]);
+    }
+    ccnl_free(b);
+}
+
+// takes the batches out of the pipe, they are dropped if ccnl is NULL
+static void
+ccnl_preload_drain(struct ccnl_relay_s *ccnl, int wait)
+{
+    struct ccnl_preload_batch_s *b;
+    struct pollfd pfd;
+
+    while (preload) {
+        if (read(preload->pipe[0], &b, sizeof(b)) != sizeof(b)) {
+            if (!wait)
+                return;
+            pfd.fd = preload->pipe[0];
+            pfd.events = POLLIN;
+            poll(&pfd, 1, -1);
+            continue;
+        }
+        if (!b)
+            ccnl_preload_done();
+        else if (ccnl)
+            ccnl_preload_insert(ccnl, b);
+        else
+            ccnl_preload_free(b);
+    }
+}
+
+void
+ccnl_preload_RX(struct ccnl_relay_s *ccnl)
+{
+    ccnl_preload_drain(ccnl, 0);
+}
+
+void
+ccnl_preload_wait(struct ccnl_relay_s *ccnl)
+{
+    ccnl_preload_drain(ccnl, 1);
+}
+
+void
+ccnl_preload_stop(void)
+{
+    if (!preload)
+        return;
+    pthread_mutex_lock(&preload->lock);
+    preload->stop = 1;
+    pthread_mutex_unlock(&preload->lock);
+    // no loader may be left blocked in the pipe
+    ccnl_preload_drain(NULL, 1);
+}
+
+#endif // USE_SHARDS
+
+// eof
@@ -0,0 +1,611 @@
+/*
+ * @f ccnl-shard.c
+ * @b CCN lite, relay threads which partition PIT and CS by name
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifdef USE_SHARDS
+
+#include "ccnl-shard.h"
+#include "ccnl-unix.h"
+#include "ccnl-preload.h"
+
+#include "ccnl-os-includes.h"
+
+#include <poll.h>
+
+#include "ccnl-core.h"
+#include "ccnl-pkt-ccntlv.h"
+#include "ccnl-pkt-cistlv.h"
+#include "ccnl-pkt-iottlv.h"
+#include "ccnl-pkt-ndntlv.h"
+#include "ccnl-dispatch.h"
+#ifdef USE_NFN
+#include "ccnl-nfn.h"
+#endif
+
+// what a shard finds in its steering socket, followed by the datagram
+struct ccnl_shard_msg_s {
+    int ifndx;          // receiving interface, or one of the following
+    int addrlen;
+    sockunion src;
+    struct ccnl_shard_routes_s *routes;
+    struct ccnl_preload_batch_s *batch;
+};
+
+#define CCNL_SHARD_MSG_ROUTES   -1
+#define CCNL_SHARD_MSG_HALT     -2
+#define CCNL_SHARD_MSG_CONTENT  -3
+
+int
+ccnl_shard_of(struct ccnl_shardset_s *shards, struct ccnl_prefix_s *pfx)
+{
+    uint32_t h;
+    int i;
+
+    if (!pfx || pfx->compcnt < 1)
+        return 0;
+    // management requests go where the FIB is maintained
+    if (pfx->complen[0] == 4 && !memcmp(pfx->comp[0], "ccnx", 4))
+        return 0;
+    h = ccnl_nametree_seed(pfx->suite);
+    for (i = 0; i < CCNL_SHARD_PREFIX_DEPTH && i < pfx->compcnt; i++)
+        h = ccnl_nametree_hash(h, pfx->comp[i], pfx->complen[i]);
+
+    return h % shards->count;
+}
+
+struct ccnl_relay_s*
+ccnl_shard_relay(struct ccnl_relay_s *ccnl, struct ccnl_prefix_s *pfx)
+{
+    if (!ccnl->shards)
+        return ccnl;
+    return ccnl->shards->shard[ccnl_shard_of(ccnl->shards, pfx)].relay;
+}
+
+// parses just enough of an interest or data packet to learn its name;
+// CCNB (management) and fragments are left to shard 0
+static struct ccnl_pkt_s*
+ccnl_shard_parse(unsigned char *data, int datalen)
+{
+    unsigned char *start;
+    int suite, skip, len;
+    unsigned int typ;
+
+    (void) typ;
+    (void) len;
+
+    suite = ccnl_pkt2suite(data, datalen, &skip);
+    start = data += skip;
+    datalen -= skip;
+
+    switch (suite) {
+#ifdef USE_SUITE_CCNTLV
+    case CCNL_SUITE_CCNTLV: {
+        struct ccnx_tlvhdr_ccnx2015_s *hp;
+
+        hp = (struct ccnx_tlvhdr_ccnx2015_s*) data;
+        if (datalen < (int) sizeof(*hp) ||
+            (hp->pkttype != CCNX_PT_Interest && hp->pkttype != CCNX_PT_Data))
+            return NULL;
+        len = ccnl_ccntlv_getHdrLen(data, datalen);
+        if (len <= 0)
+            return NULL;
+        data += len;
+        datalen -= len;
+        return ccnl_ccntlv_bytes2pkt(start, &data, &datalen);
+    }
+#endif
+#ifdef USE_SUITE_CISTLV
+    case CCNL_SUITE_CISTLV: {
+        struct cisco_tlvhdr_201501_s *hp;
+
+        hp = (struct cisco_tlvhdr_201501_s*) data;
+        if (datalen < (int) sizeof(*hp) ||
+            (hp->pkttype != CISCO_PT_Interest &&
+             hp->pkttype != CISCO_PT_Content))
+            return NULL;
+        len = ccnl_cistlv_getHdrLen(data, datalen);
+        if (len <= 0)
+            return NULL;
+        data += len;
+        datalen -= len;
+        return ccnl_cistlv_bytes2pkt(start, &data, &datalen);
+    }
+#endif
+#ifdef USE_SUITE_IOTTLV
+    case CCNL_SUITE_IOTTLV:
+        if (ccnl_iottlv_dehead(&data, &datalen, &typ, &len) ||
+            (typ != IOT_TLV_Request && typ != IOT_TLV_Reply))
+            return NULL;
+        return ccnl_iottlv_bytes2pkt(typ, start, &data, &datalen);
+#endif
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV:
+        if (ccnl_ndntlv_dehead(&data, &datalen, (int*) &typ, &len) ||
+            (typ != NDN_TLV_Interest && typ != NDN_TLV_Data))
+            return NULL;
+        return ccnl_ndntlv_bytes2pkt(typ, start, &data, &datalen);
+#endif
+    default:
+        return NULL;
+    }
+}
+
+int
+ccnl_shard_steer(struct ccnl_relay_s *ccnl, int ifndx, unsigned char *data,
+                 int datalen, struct sockaddr *sa, int addrlen)
+{
+    struct ccnl_shardset_s *shards = ccnl->shards;
+    struct ccnl_shard_msg_s msg;
+    struct ccnl_pkt_s *pkt;
+    struct iovec iov[2];
+    struct msghdr mh;
+    int k;
+
+    if (ifndx == shards->linkndx)
+        return 0;
+    pkt = ccnl_shard_parse(data, datalen);
+    if (!pkt)
+        return 0;
+    k = ccnl_shard_of(shards, pkt->pfx);
+    ccnl_pkt_free(pkt);
+    if (k == 0)
+        return 0;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.ifndx = ifndx;
+    msg.addrlen = addrlen;
+    memcpy(&msg.src, sa, addrlen);
+    iov[0].iov_base = &msg;
+    iov[0].iov_len = sizeof(msg);
+    iov[1].iov_base = data;
+    iov[1].iov_len = datalen;
+    memset(&mh, 0, sizeof(mh));
+    mh.msg_iov = iov;
+    mh.msg_iovlen = 2;
+    // a shard which cannot keep up loses datagrams, like a full socket
+    if (sendmsg(shards->shard[k].steer[0], &mh, MSG_DONTWAIT) < 0) {
+        DEBUGMSG(VERBOSE, "shard %d busy, datagram dropped\n", k);
+        shards->shard[k].dropped++;
+    } else
+        shards->shard[k].steered++;
+
+    return 1;
+}
+
+int
+ccnl_shard_preload(struct ccnl_relay_s *ccnl, int k,
+                   struct ccnl_preload_batch_s *b)
+{
+    struct ccnl_shard_msg_s msg;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.ifndx = CCNL_SHARD_MSG_CONTENT;
+    msg.batch = b;
+    // unlike datagrams, the loaders wait for a busy shard
+    return send(ccnl->shards->shard[k].steer[0], &msg, sizeof(msg), 0) < 0 ?
+                                                                    -1 : 0;
+}
+
+// hands interests of local origin to the shard owning the name
+static int
+ccnl_shard_handoff(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
+{
+    struct ccnl_shardset_s *shards = ccnl->shards;
+    struct ccnl_face_s *f;
+    int k;
+
+    k = ccnl_shard_of(shards, i->pkt->pfx);
+    if (k == ccnl->shard)
+        return 0;
+    f = ccnl_get_face_or_create(ccnl, shards->linkndx,
+                                (struct sockaddr*) &shards->shard[k].link,
+                                sizeof(struct sockaddr_un));
+    if (!f)
+        return 0;
+    DEBUGMSG(DEBUG, "  handing interest over to shard %d\n", k);
+    ccnl_send_pkt(ccnl, f, i->pkt);
+
+    return 1;
+}
+
+static void
+ccnl_shard_routes_release(struct ccnl_shardset_s *shards,
+                          struct ccnl_shard_routes_s *rt)
+{
+    int i, refs;
+
+    pthread_mutex_lock(&shards->lock);
+    refs = --rt->refs;
+    pthread_mutex_unlock(&shards->lock);
+    if (refs > 0)
+        return;
+    for (i = 0; i < rt->count; i++)
+        ccnl_prefix_free(rt->route[i].prefix);
+    ccnl_free(rt);
+}
+
+// replaces the FIB of a shard by a published route table
+static void
+ccnl_shard_routes_install(struct ccnl_relay_s *ccnl,
+                          struct ccnl_shard_routes_s *rt)
+{
+    struct ccnl_forward_s *fwd;
+    int i;
+
+    while (ccnl->fib) {
+        fwd = ccnl->fib;
+        if (fwd->face)
+            fwd->face->flags &= ~CCNL_FACE_FLAGS_STATIC;
+        ccnl_fib_unlink(ccnl, fwd);
+        ccnl_prefix_free(fwd->prefix);
+        ccnl_free(fwd);
+    }
+    for (i = 0; i < rt->count; i++) {
+        struct ccnl_shard_route_s *r = rt->route + i;
+
+        fwd = (struct ccnl_forward_s *) ccnl_calloc(1, sizeof(*fwd));
+        if (!fwd)
+            break;
+        fwd->prefix = ccnl_prefix_dup(r->prefix);
+        fwd->suite = r->prefix->suite;
+        fwd->tap = r->tap;
+        if (!r->tap) {
+            fwd->face = ccnl_get_face_or_create(ccnl, r->ifndx, &r->peer.sa,
+                                                sizeof(r->peer));
+            if (fwd->face)
+                fwd->face->flags |= CCNL_FACE_FLAGS_STATIC;
+        }
+        if (!fwd->prefix || (!fwd->tap && !fwd->face) ||
+                                                ccnl_fib_link(ccnl, fwd)) {
+            ccnl_prefix_free(fwd->prefix);
+            ccnl_free(fwd);
+        }
+    }
+    DEBUGMSG(DEBUG, "shard %d: installed %d routes\n", ccnl->shard, rt->count);
+    ccnl_shard_routes_release(ccnl->shards, rt);
+}
+
+void
+ccnl_shards_sync(struct ccnl_relay_s *ccnl)
+{
+    struct ccnl_shardset_s *shards = ccnl->shards;
+    struct ccnl_shard_routes_s *rt;
+    struct ccnl_shard_msg_s msg;
+    struct ccnl_forward_s *fwd;
+    int n = 0, k;
+
+    if (shards->fib_gen == ccnl->fib_gen)
+        return;
+    shards->fib_gen = ccnl->fib_gen;
+
+    for (fwd = ccnl->fib; fwd; fwd = fwd->next)
+        n++;
+    rt = (struct ccnl_shard_routes_s*) ccnl_calloc(1, sizeof(*rt) +
+                                        n * sizeof(struct ccnl_shard_route_s));
+    if (!rt)
+        return;
+    for (fwd = ccnl->fib; fwd; fwd = fwd->next) {
+        struct ccnl_shard_route_s *r = rt->route + rt->count;
+
+        // routes to local clients and to shards are not valid elsewhere
+        if (!fwd->tap && (!fwd->face || fwd->face->ifndx < 0 ||
+                                    fwd->face->ifndx == shards->linkndx))
+            continue;
+        r->prefix = ccnl_prefix_dup(fwd->prefix);
+        if (!r->prefix)
+            continue;
+        r->tap = fwd->tap;
+        if (fwd->face) {
+            r->ifndx = fwd->face->ifndx;
+            memcpy(&r->peer, &fwd->face->peer, sizeof(r->peer));
+        }
+        rt->count++;
+    }
+    rt->refs = shards->count - 1;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.ifndx = CCNL_SHARD_MSG_ROUTES;
+    msg.routes = rt;
+    for (k = 1; k < shards->count; k++)
+        if (send(shards->shard[k].steer[0], &msg, sizeof(msg), 0) < 0)
+            ccnl_shard_routes_release(shards, rt);
+}
+
+static void
+ccnl_shard_cleanup(struct ccnl_relay_s *ccnl)
+{
+    int i;
+
+    // the sockets belong to shard 0, except the shard link
+    for (i = 0; i < ccnl->ifcount; i++)
+        if (i != ccnl->shards->linkndx)
+            ccnl->ifs[i].sock = -1;
+    ccnl_core_cleanup(ccnl);
+}
+
+static void*
+ccnl_shard_main(void *arg)
+{
+    struct ccnl_shard_s *sh = (struct ccnl_shard_s*) arg;
+    struct ccnl_relay_s *ccnl = sh->relay;
+    int linkndx = ccnl->shards->linkndx, i;
+    struct pollfd pfd[2];
+    struct ccnl_shard_msg_s msg;
+    unsigned char buf[CCNL_MAX_PACKET_SIZE];
+    struct iovec iov[2];
+    struct msghdr mh;
+    sockunion src;
+    socklen_t addrlen;
+    int len;
+
+    DEBUGMSG(INFO, "shard %d started\n", ccnl->shard);
+    ccnl_set_timer(1000000, ccnl_ageing, ccnl, 0);
+
+    pfd[0].fd = sh->steer[1];
+    pfd[1].fd = ccnl->ifs[linkndx].sock;
+    pfd[0].events = pfd[1].events = POLLIN;
+
+    while (!ccnl->halt_flag) {
+        int usec = ccnl_run_events();
+
+#ifdef USE_BATCH_IO
+        for (i = 0; i < ccnl->ifcount; i++)
+            if (ccnl->ifs[i].txq.qlen > 0 && ccnl->ccnl_ll_TX_batch_ptr)
+                ccnl->ccnl_ll_TX_batch_ptr(ccnl, ccnl->ifs + i);
+#endif
+
+        if (poll(pfd, 2, usec < 0 ? -1 : (usec + 999) / 1000) < 0) {
+            if (errno == EINTR)
+                continue;
+            perror("poll");
+            break;
+        }
+
+        if (pfd[0].revents & POLLIN) {
+            for (;;) {
+                iov[0].iov_base = &msg;
+                iov[0].iov_len = sizeof(msg);
+                iov[1].iov_base = buf;
+                iov[1].iov_len = sizeof(buf);
+                memset(&mh, 0, sizeof(mh));
+                mh.msg_iov = iov;
+                mh.msg_iovlen = 2;
+                len = recvmsg(sh->steer[1], &mh, MSG_DONTWAIT);
+                if (len < (int) sizeof(msg))
+                    break;
+                len -= sizeof(msg);
+                if (msg.ifndx >= 0)
+                    ccnl_core_RX(ccnl, msg.ifndx, buf, len,
+                                 &msg.src.sa, msg.addrlen);
+                else if (msg.ifndx == CCNL_SHARD_MSG_ROUTES)
+                    ccnl_shard_routes_install(ccnl, msg.routes);
+                else if (msg.ifndx == CCNL_SHARD_MSG_CONTENT)
+                    ccnl_preload_insert(ccnl, msg.batch);
+                else if (msg.ifndx == CCNL_SHARD_MSG_HALT)
+                    ccnl->halt_flag = 1;
+            }
+        }
+
+        if (pfd[1].revents & POLLIN) {
+            for (;;) {
+                addrlen = sizeof(src);
+                len = recvfrom(pfd[1].fd, buf, sizeof(buf), MSG_DONTWAIT,
+                               &src.sa, &addrlen);
+                if (len < 0)
+                    break;
+                if (len > 0)
+                    ccnl_core_RX(ccnl, linkndx, buf, len,
+                                 &src.sa, sizeof(src.ux));
+            }
+        }
+    }
+
+    ccnl_shard_cleanup(ccnl);
+    ccnl_timer_cleanup();
+    ccnl_pool_cleanup();
+    DEBUGMSG(INFO, "shard %d stopped\n", ccnl->shard);
+
+    return NULL;
+}
+
+int
+ccnl_shards_init(struct ccnl_relay_s *ccnl, int count, char *linkpath)
+{
+    struct ccnl_shardset_s *shards;
+    struct ccnl_relay_s *r;
+    struct ccnl_if_s *i;
+    char path[sizeof(((struct sockaddr_un*)0)->sun_path)];
+    int k, n, bufsize = 64 * CCNL_MAX_PACKET_SIZE;
+    int max_cache = ccnl->max_cache_entries, max_pit = ccnl->max_pit_entries;
+    size_t max_bytes = ccnl->cache.max_bytes;
+
+    if (count < 2 || count > CCNL_MAX_SHARDS || !linkpath ||
+                                ccnl->ifcount >= CCNL_MAX_INTERFACES) {
+        DEBUGMSG(ERROR, "cannot run %d shards\n", count);
+        return -1;
+    }
+    shards = (struct ccnl_shardset_s*) ccnl_calloc(1, sizeof(*shards));
+    if (!shards)
+        return -1;
+    shards->count = count;
+    shards->linkndx = ccnl->ifcount;
+    shards->fib_gen = ccnl->fib_gen - 1;
+    pthread_mutex_init(&shards->lock, NULL);
+
+    if (max_cache > 0)
+        max_cache = (max_cache + count - 1) / count;
+    if (max_pit > 0)
+        max_pit = (max_pit + count - 1) / count;
+    max_bytes = (max_bytes + count - 1) / count;
+
+    for (k = 0; k < count; k++) {
+        struct ccnl_shard_s *sh = shards->shard + k;
+
+        if (k == 0)
+            r = ccnl;
+        else {
+            r = (struct ccnl_relay_s*) ccnl_calloc(1, sizeof(*r));
+            if (!r)
+                goto Error;
+            r->startup_time = ccnl->startup_time;
+            r->id = ccnl->id;
+            r->max_cache_entries = max_cache;
+            r->max_pit_entries = max_pit;
+            ccnl_cache_set_policy(r, ccnl->cache.policy);
+            r->cache.max_bytes = max_bytes;
+            r->ccnl_ll_TX_ptr = ccnl->ccnl_ll_TX_ptr;
+            r->ccnl_store_lookup_ptr = ccnl->ccnl_store_lookup_ptr;
+#ifdef USE_BATCH_IO
+            r->ccnl_ll_TX_batch_ptr = ccnl->ccnl_ll_TX_batch_ptr;
+#endif
+            for (n = 0; n < ccnl->ifcount; n++) {
+                r->ifs[n].sock = ccnl->ifs[n].sock;
+                memcpy(&r->ifs[n].addr, &ccnl->ifs[n].addr, sizeof(sockunion));
+                r->ifs[n].mtu = ccnl->ifs[n].mtu;
+                r->ifs[n].reflect = ccnl->ifs[n].reflect;
+                r->ifs[n].fwdalli = ccnl->ifs[n].fwdalli;
+            }
+            r->ifcount = ccnl->ifcount;
+#ifdef USE_NFN
+            r->km = ccnl_calloc(1, sizeof(struct ccnl_krivine_s));
+            if (!r->km) {
+                ccnl_free(r);
+                goto Error;
+            }
+            r->km->configid = -1;
+#endif
+            if (socketpair(AF_UNIX, SOCK_DGRAM, 0, sh->steer)) {
+                perror("socketpair");
+#ifdef USE_NFN
+                ccnl_free(r->km);
+#endif
+                ccnl_free(r);
+                goto Error;
+            }
+            setsockopt(sh->steer[0], SOL_SOCKET, SO_SNDBUF,
+                       &bufsize, sizeof(bufsize));
+        }
+        sh->relay = r;
+        r->shards = shards;
+        r->shard = k;
+        r->shard_handoff = ccnl_shard_handoff;
+
+        snprintf(path, sizeof(path), "%s-shard%d", linkpath, k);
+        i = r->ifs + shards->linkndx;
+        i->sock = ccnl_open_unixpath(path, &i->addr.ux);
+        if (i->sock < 0)
+            goto Error;
+        i->mtu = 4096;
+        memcpy(&sh->link, &i->addr.ux, sizeof(sh->link));
+        if (k == 0)
+            r->ifcount++;
+        else
+            r->ifcount = shards->linkndx + 1;
+    }
+    ccnl->max_cache_entries = max_cache;
+    ccnl->max_pit_entries = max_pit;
+    ccnl->cache.max_bytes = max_bytes;
+    DEBUGMSG(INFO, "%d shards configured, links at %s-shardN\n",
+             count, linkpath);
+
+    return 0;
+Error:
+    DEBUGMSG(ERROR, "could not set up shard %d\n", k);
+    // nothing runs yet, tear down what was built
+    for (n = k; n >= 0; n--) {
+        r = shards->shard[n].relay;
+        if (!r)
+            continue;
+        i = r->ifs + shards->linkndx;
+        if (n < k || i->sock >= 0)
+            ccnl_close_socket(i->sock);
+        if (n == 0) {
+            if (ccnl->ifcount > shards->linkndx)
+                ccnl->ifcount--;
+            r->shards = NULL;
+            r->shard_handoff = NULL;
+            continue;
+        }
+        close(shards->shard[n].steer[0]);
+        close(shards->shard[n].steer[1]);
+#ifdef USE_NFN
+        ccnl_free(r->km);
+#endif
+        ccnl_free(r);
+    }
+    pthread_mutex_destroy(&shards->lock);
+    ccnl_free(shards);
+    return -1;
+}
+
+int
+ccnl_shards_start(struct ccnl_relay_s *ccnl)
+{
+    struct ccnl_shardset_s *shards = ccnl->shards;
+    int k;
+
+    if (!shards)
+        return 0;
+    ccnl_shards_sync(ccnl);
+    for (k = 1; k < shards->count; k++) {
+        if (pthread_create(&shards->shard[k].thread, NULL, ccnl_shard_main,
+                           shards->shard + k)) {
+            DEBUGMSG(ERROR, "could not start shard %d\n", k);
+            return -1;
+        }
+        shards->shard[k].running = 1;
+    }
+
+    return 0;
+}
+
+void
+ccnl_shards_stop(struct ccnl_relay_s *ccnl)
+{
+    struct ccnl_shardset_s *shards = ccnl->shards;
+    struct ccnl_shard_msg_s msg;
+    int k;
+
+    if (!shards)
+        return;
+    memset(&msg, 0, sizeof(msg));
+    msg.ifndx = CCNL_SHARD_MSG_HALT;
+    for (k = 1; k < shards->count; k++) {
+        struct ccnl_shard_s *sh = shards->shard + k;
+
+        if (sh->running) {
+            send(sh->steer[0], &msg, sizeof(msg), 0);
+            pthread_join(sh->thread, NULL);
+        } else
+            ccnl_shard_cleanup(sh->relay);
+        close(sh->steer[0]);
+        close(sh->steer[1]);
+        ccnl_free(sh->relay);
+    }
+    ccnl->shards = NULL;
+    ccnl->shard_handoff = NULL;
+    pthread_mutex_destroy(&shards->lock);
+    ccnl_free(shards);
+}
+
+#endif // USE_SHARDS
+
+// eof
@@ -0,0 +1,437 @@
+/*
+ * @f ccnl-store.c
+ * @b CCN lite, content repository in memory mapped segment files
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#define _DEFAULT_SOURCE // ftruncate, pwrite
+
+#include "ccnl-store.h"
+#include "ccnl-unix.h"
+
+#include "ccnl-os-includes.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ccnl-core.h"
+
+#define CCNL_STORE_IDXLEN(size) (sizeof(struct ccnl_store_hdr_s) + \
+                                 (size_t) (size) * sizeof(struct ccnl_store_slot_s))
+#define CCNL_STORE_SLOTS(hdr)   ((struct ccnl_store_slot_s*) ((hdr) + 1))
+
+struct ccnl_store_s {
+    char *dir;
+    int idxfd;
+    struct ccnl_store_hdr_s *hdr;       // the mapped index
+    int segfd[CCNL_STORE_MAX_SEGMENTS];
+    unsigned char *seg[CCNL_STORE_MAX_SEGMENTS];
+    int filesfd;                        // list of imported files, appended
+    struct ccnl_store_file_s *files;    // as it was when opened, sorted
+    uint32_t filecount;
+};
+
+static struct ccnl_store_s *store;
+
+// whether slot s points into a mapped segment, the index is not trusted
+static int
+ccnl_store_inrange(struct ccnl_store_slot_s *s)
+{
+    return s->seg < store->hdr->segments && store->seg[s->seg] &&
+           s->off <= CCNL_STORE_SEGMENT_SIZE &&
+           s->len <= CCNL_STORE_SEGMENT_SIZE - s->off;
+}
+
+static uint32_t
+ccnl_store_hash(struct ccnl_prefix_s *pfx)
+{
+    uint32_t h = ccnl_nametree_seed(pfx->suite);
+    int i;
+
+    for (i = 0; i < pfx->compcnt; i++)
+        h = ccnl_nametree_hash(h, pfx->comp[i], pfx->complen[i]);
+    return h ? h : 1;
+}
+
+static struct ccnl_store_hdr_s*
+ccnl_store_new_index(char *fname, uint32_t size, int *fd)
+{
+    struct ccnl_store_hdr_s *hdr;
+
+    *fd = open(fname, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (*fd < 0)
+        return NULL;
+    if (ftruncate(*fd, CCNL_STORE_IDXLEN(size)))
+        goto Error;
+    hdr = mmap(NULL, CCNL_STORE_IDXLEN(size), PROT_READ | PROT_WRITE,
+               MAP_SHARED, *fd, 0);
+    if (hdr == MAP_FAILED)
+        goto Error;
+    memcpy(hdr->magic, CCNL_STORE_MAGIC, sizeof(hdr->magic));
+    hdr->size = size;
+    return hdr;
+Error:
+    close(*fd);
+    *fd = -1;
+    return NULL;
+}
+
+// maps segment file k, creating it if requested
+static int
+ccnl_store_segment(uint32_t k, int create)
+{
+    char fname[1000];
+    struct stat st;
+    unsigned char *p;
+    int fd;
+
+    snprintf(fname, sizeof(fname), "%s/seg-%05u", store->dir, k);
+    fd = open(fname, O_RDWR | (create ? O_CREAT | O_TRUNC : 0), 0644);
+    if (fd < 0) {
+        DEBUGMSG(ERROR, "could not open %s: %s\n", fname, strerror(errno));
+        return -1;
+    }
+    // sparse, it only grows on disk with what is appended
+    if (create && ftruncate(fd, CCNL_STORE_SEGMENT_SIZE))
+        goto Error;
+    if (fstat(fd, &st) || st.st_size != CCNL_STORE_SEGMENT_SIZE) {
+        DEBUGMSG(ERROR, "%s is not a segment of %d bytes\n", fname,
+                 CCNL_STORE_SEGMENT_SIZE);
+        goto Error;
+    }
+    p = mmap(NULL, CCNL_STORE_SEGMENT_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED)
+        goto Error;
+    store->segfd[k] = fd;
+    store->seg[k] = p;
+    return 0;
+Error:
+    close(fd);
+    return -1;
+}
+
+static int
+ccnl_store_filecmp(const void *a, const void *b)
+{
+    const struct ccnl_store_file_s *x = a, *y = b;
+
+    if (x->name != y->name)
+        return x->name < y->name ? -1 : 1;
+    if (x->size != y->size)
+        return x->size < y->size ? -1 : 1;
+    if (x->mtime != y->mtime)
+        return x->mtime < y->mtime ? -1 : 1;
+    return 0;
+}
+
+static int
+ccnl_store_files(void)
+{
+    char fname[1000];
+    struct stat st;
+    ssize_t len;
+
+    snprintf(fname, sizeof(fname), "%s/files", store->dir);
+    store->filesfd = open(fname, O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (store->filesfd < 0 || fstat(store->filesfd, &st))
+        return -1;
+    store->filecount = st.st_size / sizeof(struct ccnl_store_file_s);
+    if (!store->filecount)
+        return 0;
+    len = store->filecount * sizeof(struct ccnl_store_file_s);
+    store->files = (struct ccnl_store_file_s*) ccnl_malloc(len);
+    if (!store->files || pread(store->filesfd, store->files, len, 0) != len) {
+        store->filecount = 0;
+        return -1;
+    }
+    qsort(store->files, store->filecount, sizeof(struct ccnl_store_file_s),
+          ccnl_store_filecmp);
+    return 0;
+}
+
+int
+ccnl_store_open(struct ccnl_relay_s *ccnl, char *dir)
+{
+    char fname[1000];
+    struct stat st;
+    uint32_t k;
+
+    if (store)
+        return -1;
+    if (mkdir(dir, 0755) && errno != EEXIST) {
+        DEBUGMSG(ERROR, "could not create %s: %s\n", dir, strerror(errno));
+        return -1;
+    }
+    store = (struct ccnl_store_s*) ccnl_calloc(1, sizeof(*store));
+    if (!store)
+        return -1;
+    store->idxfd = store->filesfd = -1;
+    store->dir = ccnl_strdup(dir);
+    snprintf(fname, sizeof(fname), "%s/index", dir);
+    store->idxfd = open(fname, O_RDWR);
+    if (store->idxfd < 0) {
+        store->hdr = ccnl_store_new_index(fname, CCNL_STORE_INDEX_SLOTS,
+                                          &store->idxfd);
+        if (!store->hdr)
+            goto Error;
+    } else {
+        if (fstat(store->idxfd, &st) ||
+                    st.st_size < (off_t) sizeof(struct ccnl_store_hdr_s))
+            goto Invalid;
+        store->hdr = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE,
+                          MAP_SHARED, store->idxfd, 0);
+        if (store->hdr == MAP_FAILED) {
+            store->hdr = NULL;
+            goto Error;
+        }
+        if (memcmp(store->hdr->magic, CCNL_STORE_MAGIC, 8) ||
+            !store->hdr->size ||
+            (store->hdr->size & (store->hdr->size - 1)) ||
+            (off_t) CCNL_STORE_IDXLEN(store->hdr->size) != st.st_size ||
+            store->hdr->segments > CCNL_STORE_MAX_SEGMENTS) {
+            munmap(store->hdr, st.st_size);
+            store->hdr = NULL;
+            goto Invalid;
+        }
+    }
+    for (k = 0; k < store->hdr->segments; k++)
+        if (ccnl_store_segment(k, 0))
+            goto Error;
+    if (ccnl_store_files())
+        DEBUGMSG(WARNING, "no list of imported files in %s\n", dir);
+
+    ccnl->ccnl_store_lookup_ptr = ccnl_store_lookup;
+    DEBUGMSG(INFO, "store %s: %u content objects in %u segments\n",
+             dir, store->hdr->count, store->hdr->segments);
+    return 0;
+Invalid:
+    DEBUGMSG(ERROR, "%s is not a store index\n", fname);
+Error:
+    ccnl_store_close();
+    return -1;
+}
+
+int
+ccnl_store_isopen(void)
+{
+    return store != NULL;
+}
+
+// doubles the index, written to a new file which replaces the old one
+static int
+ccnl_store_grow(void)
+{
+    char fname[1000], tmpname[1000];
+    struct ccnl_store_hdr_s *old = store->hdr, *hdr;
+    struct ccnl_store_slot_s *from = CCNL_STORE_SLOTS(old), *to;
+    uint32_t i, j, mask;
+    int fd;
+
+    snprintf(fname, sizeof(fname), "%s/index", store->dir);
+    snprintf(tmpname, sizeof(tmpname), "%s/index.new", store->dir);
+    hdr = ccnl_store_new_index(tmpname, old->size * 2, &fd);
+    if (!hdr)
+        return -1;
+    to = CCNL_STORE_SLOTS(hdr);
+    mask = hdr->size - 1;
+    for (i = 0; i < old->size; i++) {
+        if (!from[i].hash)
+            continue;
+        for (j = from[i].hash & mask; to[j].hash; j = (j + 1) & mask);
+        to[j] = from[i];
+    }
+    hdr->count = old->count;
+    hdr->segments = old->segments;
+    hdr->tail = old->tail;
+    if (rename(tmpname, fname)) {
+        munmap(hdr, CCNL_STORE_IDXLEN(hdr->size));
+        close(fd);
+        return -1;
+    }
+    munmap(old, CCNL_STORE_IDXLEN(old->size));
+    close(store->idxfd);
+    store->hdr = hdr;
+    store->idxfd = fd;
+    return 0;
+}
+
+void
+ccnl_store_file(struct ccnl_store_file_s *f, char *path, struct stat *s)
+{
+    uint64_t h = 14695981039346656037ull; // FNV-1a
+
+    for (; *path; path++) {
+        h ^= (unsigned char) *path;
+        h *= 1099511628211ull;
+    }
+    f->name = h;
+    f->size = s->st_size;
+#if defined(__APPLE__)
+    f->mtime = (int64_t) s->st_mtimespec.tv_sec * 1000000000 +
+               s->st_mtimespec.tv_nsec;
+#elif defined(__linux__)
+    f->mtime = (int64_t) s->st_mtim.tv_sec * 1000000000 + s->st_mtim.tv_nsec;
+#else
+    f->mtime = (int64_t) s->st_mtime * 1000000000;
+#endif
+}
+
+int
+ccnl_store_imported(struct ccnl_store_file_s *f)
+{
+    return store && store->files &&
+           bsearch(f, store->files, store->filecount,
+                   sizeof(struct ccnl_store_file_s), ccnl_store_filecmp);
+}
+
+static void
+ccnl_store_listfile(struct ccnl_store_file_s *f)
+{
+    if (f && store->filesfd >= 0 &&
+            write(store->filesfd, f, sizeof(*f)) != (ssize_t) sizeof(*f))
+        DEBUGMSG(WARNING, "could not list imported file: %s\n",
+                 strerror(errno));
+}
+
+int
+ccnl_store_add(struct ccnl_pkt_s *pkt, struct ccnl_store_file_s *f)
+{
+    struct ccnl_store_hdr_s *hdr = store->hdr;
+    struct ccnl_store_slot_s *slot = CCNL_STORE_SLOTS(hdr);
+    uint32_t hash = ccnl_store_hash(pkt->pfx), mask = hdr->size - 1, i, k;
+    ssize_t len = pkt->buf->datalen;
+
+    if (len > CCNL_STORE_SEGMENT_SIZE)
+        return -1;
+    for (i = hash & mask; slot[i].hash; i = (i + 1) & mask)
+        if (slot[i].hash == hash && (ssize_t) slot[i].len == len &&
+            ccnl_store_inrange(slot + i) && !memcmp(store->seg[slot[i].seg] + slot[i].off, pkt->buf->data, len)) {
+            ccnl_store_listfile(f);
+            return 1;
+        }
+
+    if (!hdr->segments || hdr->tail + len > CCNL_STORE_SEGMENT_SIZE) {
+        if (hdr->segments == CCNL_STORE_MAX_SEGMENTS ||
+                                ccnl_store_segment(hdr->segments, 1))
+            return -1;
+        hdr->segments++;
+        hdr->tail = 0;
+    }
+    k = hdr->segments - 1;
+    if (pwrite(store->segfd[k], pkt->buf->data, len, hdr->tail) != len) {
+        DEBUGMSG(ERROR, "could not append to the store: %s\n",
+                 strerror(errno));
+        return -1;
+    }
+    slot[i].seg = k;
+    slot[i].off = hdr->tail;
+    slot[i].len = len;
+    hdr->tail += (len + 7) & ~7;
+    slot[i].hash = hash; // the slot is in use from now on
+    hdr->count++;
+    ccnl_store_listfile(f);
+
+    if (2 * hdr->count > hdr->size && ccnl_store_grow())
+        DEBUGMSG(WARNING, "could not grow the store index\n");
+    return 0;
+}
+
+// the object in slot s, a slice of the mapping if it is not small
+static struct ccnl_content_s*
+ccnl_store_load(struct ccnl_store_slot_s *s)
+{
+    struct ccnl_buf_s *seg, *prev;
+    struct ccnl_pkt_s *pkt;
+    struct ccnl_content_s *c;
+
+    if (!ccnl_store_inrange(s))
+        return NULL;
+    seg = (struct ccnl_buf_s*) ccnl_malloc(sizeof(*seg));
+    if (!seg)
+        return NULL;
+    seg->next = NULL;
+    seg->data = store->seg[s->seg] + s->off;
+    seg->datalen = s->len;
+    seg->parent = NULL;
+    seg->refcnt = 1;
+
+    prev = ccnl_buf_set_rx(seg);
+    pkt = ccnl_content_bytes2pkt(seg->data, seg->datalen);
+    ccnl_buf_set_rx(prev);
+    ccnl_buf_free(seg); // a slice of it keeps it
+    if (!pkt)
+        return NULL;
+    c = ccnl_content_new(&pkt);
+    ccnl_pkt_free(pkt);
+    return c;
+}
+
+struct ccnl_content_s*
+ccnl_store_lookup(struct ccnl_relay_s *ccnl, struct ccnl_pkt_s *pkt,
+                  int (*cMatch)(struct ccnl_pkt_s*, struct ccnl_content_s*))
+{
+    struct ccnl_store_slot_s *slot;
+    struct ccnl_content_s *c;
+    uint32_t hash, mask, i;
+
+    if (!store)
+        return NULL;
+    slot = CCNL_STORE_SLOTS(store->hdr);
+    hash = ccnl_store_hash(pkt->pfx);
+    mask = store->hdr->size - 1;
+    for (i = hash & mask; slot[i].hash; i = (i + 1) & mask) {
+        if (slot[i].hash != hash)
+            continue;
+        c = ccnl_store_load(slot + i);
+        if (!c)
+            continue;
+        if (!cMatch(pkt, c)) {
+            DEBUGMSG(DEBUG, "  found in the store (segment %u)\n", slot[i].seg);
+            if (ccnl->max_cache_entries == 0 || // it's set to -1 or a limit
+                ccnl_content_add2cache(ccnl, c) < 0)
+                c->flags |= CCNL_CONTENT_FLAGS_UNCACHED;
+            return c;
+        }
+        ccnl_content_free(c);
+    }
+    return NULL;
+}
+
+void
+ccnl_store_close(void)
+{
+    uint32_t k;
+
+    if (!store)
+        return;
+    for (k = 0; k < CCNL_STORE_MAX_SEGMENTS && store->seg[k]; k++) {
+        munmap(store->seg[k], CCNL_STORE_SEGMENT_SIZE);
+        close(store->segfd[k]);
+    }
+    if (store->hdr) {
+        munmap(store->hdr, CCNL_STORE_IDXLEN(store->hdr->size));
+        close(store->idxfd);
+    } else if (store->idxfd >= 0)
+        close(store->idxfd);
+    if (store->filesfd >= 0)
+        close(store->filesfd);
+    ccnl_free(store->files);
+    ccnl_free(store->dir);
+    ccnl_free(store);
+    store = NULL;
+}
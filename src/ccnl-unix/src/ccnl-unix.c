@@ -20,9 +20,17 @@
  * 2017-06-16 created
  */
 
- #include "ccnl-unix.h"
+#ifdef USE_BATCH_IO
+#define _GNU_SOURCE // recvmmsg, sendmmsg
+#else
+#define _DEFAULT_SOURCE // realpath
+#endif
+
+#include "ccnl-unix.h"
+#include "ccnl-store.h"
 
 #include "ccnl-os-includes.h"
+#include <limits.h>
 
 #include "ccnl-core.h"
 #include "ccnl-producer.h"
@@ -37,11 +45,24 @@
 
 #include "ccnl-nfn.h"
 
+#ifdef USE_HTTP_STATUS
+#include "ccnl-http-status.h"
+#endif
+
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#endif
+
+#ifdef USE_SHARDS
+#include "ccnl-shard.h"
+#include "ccnl-preload.h"
+#endif
+
 /**
  * TODO: The variables are never updated within the context of
  * ccnl_unix.c
  */
-static int lasthour = -1;
+static CCNL_THREAD_LOCAL int lasthour = -1;
 #ifdef USE_SCHEDULER
 static int inter_ccn_interval = 0; // in usec
 static int inter_pkt_interval = 0; // in usec
@@ -411,6 +432,115 @@ ccnl_ll_TX(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
     (void) rc; // just to silence a compiler warning (if USE_DEBUG is not set)
 }
 
+#ifdef USE_BATCH_IO
+// address length for sendmmsg, 0 if the destination cannot be batched
+static socklen_t
+ccnl_batch_namelen(sockunion *dst)
+{
+    switch (dst->sa.sa_family) {
+#ifdef USE_IPV4
+    case AF_INET:
+        return sizeof(struct sockaddr_in);
+#endif
+#ifdef USE_IPV6
+    case AF_INET6:
+        return sizeof(struct sockaddr_in6);
+#endif
+#ifdef USE_UNIXSOCKET
+    case AF_UNIX:
+        return sizeof(struct sockaddr_un);
+#endif
+#ifdef USE_LINKLAYER
+    case AF_PACKET: // framed by ccnl_ll_TX_batch, sent without an address
+        return sizeof(struct sockaddr_ll);
+#endif
+    default:
+        return 0;
+    }
+}
+
+void
+ccnl_ll_TX_batch(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc)
+{
+    struct mmsghdr msg[CCNL_IO_BATCH];
+    struct iovec iov[CCNL_IO_BATCH][2];
+#ifdef USE_LINKLAYER
+    unsigned char ethhdr[CCNL_IO_BATCH][14];
+    short type = htons(CCNL_ETH_TYPE);
+#endif
+    struct ccnl_txrequest_s *req[CCNL_IO_BATCH], *r;
+    int n = 0, k, rc, done;
+
+    for (;;) {
+        // refill the batch, what sendmmsg did not take stays at its front
+        while (n < CCNL_IO_BATCH && (r = ccnl_txq_dequeue(&ifc->txq))) {
+            if (!ccnl_batch_namelen(&r->dst)) { // e.g. WPAN, the classic way
+                ccnl->ccnl_ll_TX_ptr(ccnl, ifc, &r->dst, r->buf);
+#ifdef USE_STATS
+                ifc->tx_cnt++;
+#endif
+                ccnl_txq_release(r);
+                continue;
+            }
+            req[n++] = r;
+        }
+        if (n == 0)
+            break;
+
+        memset(msg, 0, sizeof(msg));
+        for (k = 0; k < n; k++) {
+            struct msghdr *h = &msg[k].msg_hdr;
+            r = req[k];
+            iov[k][0].iov_base = r->buf->data;
+            iov[k][0].iov_len = r->buf->datalen;
+            h->msg_iov = iov[k];
+            h->msg_iovlen = 1;
+            h->msg_name = &r->dst;
+            h->msg_namelen = ccnl_batch_namelen(&r->dst);
+#ifdef USE_LINKLAYER
+            if (r->dst.sa.sa_family == AF_PACKET) {
+                // same framing as ccnl_eth_sendto, without the copy
+                memcpy(ethhdr[k], r->dst.linklayer.sll_addr, 6);
+                memcpy(ethhdr[k]+6, ifc->addr.linklayer.sll_addr, 6);
+                memcpy(ethhdr[k]+12, &type, sizeof(type));
+                iov[k][1] = iov[k][0];
+                iov[k][0].iov_base = ethhdr[k];
+                iov[k][0].iov_len = 14;
+                h->msg_iovlen = 2;
+                h->msg_name = NULL;
+            }
+#endif
+        }
+
+        rc = sendmmsg(ifc->sock, msg, n, 0);
+        DEBUGMSG(DEBUG, "sendmmsg of %d datagrams returned %d\n", n, rc);
+        // a datagram which failed is dropped, like with sendto
+        done = rc < 0 ? 1 : (rc < n ? rc + 1 : n);
+#ifdef USE_STATS
+        ifc->tx_batches++;
+        if (n > ifc->tx_batch_max)
+            ifc->tx_batch_max = n;
+        ifc->tx_cnt += done;
+#endif
+        for (k = 0; k < done; k++)
+            ccnl_txq_release(req[k]);
+        n -= done;
+        memmove(req, req + done, n * sizeof(*req));
+    }
+}
+
+// sends what the last round of events left in the interface queues
+static void
+ccnl_io_flush(struct ccnl_relay_s *ccnl)
+{
+    int i;
+
+    for (i = 0; i < ccnl->ifcount; i++)
+        if (ccnl->ifs[i].txq.qlen > 0)
+            ccnl_ll_TX_batch(ccnl, ccnl->ifs + i);
+}
+#endif // USE_BATCH_IO
+
 void
 ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
                   int udpport1, int udpport2,
@@ -431,6 +561,9 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
     relay->max_cache_entries = max_cache_entries;
     relay->max_pit_entries = CCNL_DEFAULT_MAX_PIT_ENTRIES;
     relay->ccnl_ll_TX_ptr = &ccnl_ll_TX;
+#ifdef USE_BATCH_IO
+    relay->ccnl_ll_TX_batch_ptr = &ccnl_ll_TX_batch;
+#endif
 
 #ifdef USE_SCHEDULER
     relay->defaultFaceScheduler = ccnl_relay_defaultFaceScheduler;
@@ -553,12 +686,308 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
     ccnl_set_timer(1000000, ccnl_ageing, relay, 0);
 }
 
+// hands a received datagram to the core, depending on the address family
+static void
+ccnl_io_RX(struct ccnl_relay_s *ccnl, int ifndx, unsigned char *buf, int len,
+           sockunion *src_addr)
+{
+    int addrlen;
+
+    if (0) {}
+#ifdef USE_IPV4
+    else if (src_addr->sa.sa_family == AF_INET)
+        addrlen = sizeof(src_addr->ip4);
+#endif
+#ifdef USE_IPV6
+    else if (src_addr->sa.sa_family == AF_INET6)
+        addrlen = sizeof(src_addr->ip6);
+#endif
+#ifdef USE_LINKLAYER
+    else if (src_addr->sa.sa_family == AF_PACKET) {
+        if (len <= 14)
+            return;
+        buf += 14;
+        len -= 14;
+        addrlen = sizeof(src_addr->linklayer);
+    }
+#endif
+#ifdef USE_WPAN
+    else if (src_addr->sa.sa_family == AF_IEEE802154) {
+        if (len <= 14)
+            return;
+        addrlen = sizeof(src_addr->linklayer);
+    }
+#endif
+#ifdef USE_UNIXSOCKET
+    else if (src_addr->sa.sa_family == AF_UNIX)
+        addrlen = sizeof(src_addr->ux);
+#endif
+    else
+        return;
+
+#ifdef USE_SHARDS
+    if (ccnl->shards &&
+        ccnl_shard_steer(ccnl, ifndx, buf, len, &src_addr->sa, addrlen))
+        return;
+#endif
+    ccnl_core_RX(ccnl, ifndx, buf, len, &src_addr->sa, addrlen);
+}
+
+#ifdef USE_BATCH_IO
+
+// receive buffers, reused for every batch unless the core kept a slice of
+// the datagram (see ccnl_buf_rx), then a new one is allocated
+static struct ccnl_buf_s *rxbuf[CCNL_IO_BATCH];
+
+// reads up to CCNL_IO_BATCH datagrams with one syscall and hands them to
+// the core, returns the number of datagrams or -1
+static int
+ccnl_io_RX_batch(struct ccnl_relay_s *ccnl, int ifndx)
+{
+    struct mmsghdr msg[CCNL_IO_BATCH];
+    struct iovec iov[CCNL_IO_BATCH];
+    sockunion src_addr[CCNL_IO_BATCH];
+    int k, n;
+
+    memset(msg, 0, sizeof(msg));
+    for (k = 0; k < CCNL_IO_BATCH; k++) {
+        if (!rxbuf[k] &&
+                !(rxbuf[k] = ccnl_buf_new(NULL, CCNL_MAX_PACKET_SIZE)))
+            return -1;
+        iov[k].iov_base = rxbuf[k]->data;
+        iov[k].iov_len = CCNL_MAX_PACKET_SIZE;
+        msg[k].msg_hdr.msg_iov = iov + k;
+        msg[k].msg_hdr.msg_iovlen = 1;
+        msg[k].msg_hdr.msg_name = src_addr + k;
+        msg[k].msg_hdr.msg_namelen = sizeof(sockunion);
+    }
+    do {
+        n = recvmmsg(ccnl->ifs[ifndx].sock, msg, CCNL_IO_BATCH,
+                     MSG_DONTWAIT, NULL);
+    } while (n < 0 && (errno == EINTR || errno == ECONNREFUSED));
+    if (n <= 0)
+        return n;
+#ifdef USE_STATS
+    ccnl->ifs[ifndx].rx_batches++;
+    if (n > ccnl->ifs[ifndx].rx_batch_max)
+        ccnl->ifs[ifndx].rx_batch_max = n;
+#endif
+    for (k = 0; k < n; k++) {
+        if (msg[k].msg_len == 0)
+            continue;
+        rxbuf[k]->datalen = msg[k].msg_len;
+        ccnl_buf_set_rx(rxbuf[k]);
+        ccnl_io_RX(ccnl, ifndx, rxbuf[k]->data, msg[k].msg_len, src_addr + k);
+        ccnl_buf_set_rx(NULL);
+        if (rxbuf[k]->refcnt > 1) {
+            ccnl_buf_free(rxbuf[k]);
+            rxbuf[k] = NULL;
+        }
+    }
+
+    return n;
+}
+
+static void
+ccnl_io_RX_cleanup(void)
+{
+    int k;
+
+    for (k = 0; k < CCNL_IO_BATCH; k++) {
+        ccnl_buf_free(rxbuf[k]);
+        rxbuf[k] = NULL;
+    }
+}
+
+#endif // USE_BATCH_IO
+
+#ifdef USE_EPOLL
+
+// epoll user data: the interface index, or one of the following
+#define CCNL_EPOLL_HTTP_SERVER  CCNL_MAX_INTERFACES
+#define CCNL_EPOLL_HTTP_CLIENT  (CCNL_MAX_INTERFACES + 1)
+#define CCNL_EPOLL_PRELOAD      (CCNL_MAX_INTERFACES + 2)
+
+static int
+ccnl_epoll_ctl(int epfd, int op, int fd, uint32_t events, uint32_t tag)
+{
+    struct epoll_event ev;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.u32 = tag;
+    return epoll_ctl(epfd, op, fd, &ev);
+}
+
 int
 ccnl_io_loop(struct ccnl_relay_s *ccnl)
 {
-    int i, len, maxfd = -1, rc;
+    struct epoll_event events[CCNL_MAX_INTERFACES + 3];
+    uint32_t ifevents[CCNL_MAX_INTERFACES]; // as registered
+    int epfd, i, n, rc, registered = 0;
+#ifndef USE_BATCH_IO
+    int len;
+    unsigned char buf[CCNL_MAX_PACKET_SIZE];
+#endif
+#ifdef USE_HTTP_STATUS
+    uint32_t httpevents = 0;
+    int httpclient = 0;
+#endif
+
+    if (ccnl->ifcount == 0) {
+        DEBUGMSG(ERROR, "no socket to work with, not good, quitting\n");
+        exit(EXIT_FAILURE);
+    }
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd < 0) {
+        perror("epoll_create1(): ");
+        exit(EXIT_FAILURE);
+    }
+#ifdef USE_HTTP_STATUS
+    if (ccnl->http &&
+        ccnl_epoll_ctl(epfd, EPOLL_CTL_ADD, ccnl->http->server, EPOLLIN,
+                       CCNL_EPOLL_HTTP_SERVER)) {
+        perror("epoll_ctl(): ");
+        exit(EXIT_FAILURE);
+    }
+#endif
+#ifdef USE_SHARDS
+    // the pipe leaves the set when it is closed after loading
+    if (ccnl_preload_fd() >= 0 &&
+        ccnl_epoll_ctl(epfd, EPOLL_CTL_ADD, ccnl_preload_fd(), EPOLLIN,
+                       CCNL_EPOLL_PRELOAD)) {
+        perror("epoll_ctl(): ");
+        exit(EXIT_FAILURE);
+    }
+#endif
+
+    DEBUGMSG(INFO, "starting main event and IO loop (epoll)\n");
+    while (!ccnl->halt_flag) {
+        int usec, timeout = -1;
+
+        usec = ccnl_run_events();
+#ifdef USE_BATCH_IO
+        ccnl_io_flush(ccnl);
+#endif
+#ifdef USE_SHARDS
+        if (ccnl->shards)
+            ccnl_shards_sync(ccnl);
+#endif
+
+        // level triggered like select(), EPOLLOUT is only asked for while
+        // packets wait; mgmt may add interfaces at runtime
+        for (i = 0; i < ccnl->ifcount; i++) {
+            uint32_t want = EPOLLIN;
+            if (ccnl->ifs[i].txq.qlen > 0)
+                want |= EPOLLOUT;
+            if (i < registered && ifevents[i] == want)
+                continue;
+            if (ccnl_epoll_ctl(epfd, i < registered ? EPOLL_CTL_MOD :
+                               EPOLL_CTL_ADD, ccnl->ifs[i].sock, want, i)) {
+                perror("epoll_ctl(): ");
+                exit(EXIT_FAILURE);
+            }
+            ifevents[i] = want;
+        }
+        registered = ccnl->ifcount;
+#ifdef USE_HTTP_STATUS
+        if (ccnl->http && ccnl->http->client) {
+            uint32_t want = 0;
+            if (ccnl->http->inlen < sizeof(ccnl->http->in))
+                want |= EPOLLIN;
+            if (ccnl->http->outlen > 0)
+                want |= EPOLLOUT;
+            // a closed client socket left the set by itself, and its
+            // number may have been given to the next client already
+            if (ccnl->http->client != httpclient ||
+                (want != httpevents &&
+                 ccnl_epoll_ctl(epfd, EPOLL_CTL_MOD, ccnl->http->client,
+                                want, CCNL_EPOLL_HTTP_CLIENT) &&
+                 errno == ENOENT))
+                ccnl_epoll_ctl(epfd, EPOLL_CTL_ADD, ccnl->http->client,
+                               want, CCNL_EPOLL_HTTP_CLIENT);
+            httpclient = ccnl->http->client;
+            httpevents = want;
+        } else
+            httpclient = 0;
+#endif
+
+        if (usec >= 0)
+            timeout = (usec + 999) / 1000;
+        rc = epoll_wait(epfd, events, CCNL_MAX_INTERFACES + 3, timeout);
+        if (rc < 0) {
+            if (errno == EINTR)
+                continue;
+            perror("epoll_wait(): ");
+            exit(EXIT_FAILURE);
+        }
+
+        for (n = 0; n < rc; n++) {
+            uint32_t tag = events[n].data.u32;
+#ifdef USE_SHARDS
+            if (tag == CCNL_EPOLL_PRELOAD) {
+                ccnl_preload_RX(ccnl);
+                continue;
+            }
+#endif
+#ifdef USE_HTTP_STATUS
+            if (tag == CCNL_EPOLL_HTTP_SERVER || tag == CCNL_EPOLL_HTTP_CLIENT) {
+                ccnl_http_io(ccnl, ccnl->http, tag == CCNL_EPOLL_HTTP_SERVER,
+                             tag == CCNL_EPOLL_HTTP_CLIENT &&
+                                 (events[n].events & (EPOLLIN | EPOLLHUP)),
+                             tag == CCNL_EPOLL_HTTP_CLIENT &&
+                                 (events[n].events & EPOLLOUT));
+                continue;
+            }
+#endif
+            i = (int) tag;
+            if (events[n].events & (EPOLLIN | EPOLLERR)) {
+                // read until the socket is drained
+#ifdef USE_BATCH_IO
+                while (ccnl_io_RX_batch(ccnl, i) == CCNL_IO_BATCH);
+#else
+                for (;;) {
+                    sockunion src_addr;
+                    socklen_t addrlen = sizeof(sockunion);
+                    len = recvfrom(ccnl->ifs[i].sock, buf, sizeof(buf),
+                                   MSG_DONTWAIT,
+                                   (struct sockaddr*) &src_addr, &addrlen);
+                    if (len < 0) {
+                        if (errno == EINTR || errno == ECONNREFUSED)
+                            continue;
+                        break;
+                    }
+                    if (len > 0)
+                        ccnl_io_RX(ccnl, i, buf, len, &src_addr);
+                }
+#endif
+            }
+            if (events[n].events & EPOLLOUT)
+                ccnl_interface_CTS(ccnl, ccnl->ifs + i);
+        }
+    }
+    close(epfd);
+#ifdef USE_BATCH_IO
+    ccnl_io_RX_cleanup();
+#endif
+
+    return 0;
+}
+
+#else // USE_EPOLL
+
+int
+ccnl_io_loop(struct ccnl_relay_s *ccnl)
+{
+    int i, maxfd = -1, rc;
     fd_set readfs, writefs;
+#ifdef USE_SHARDS
+    int preloadfd;
+#endif
+#ifndef USE_BATCH_IO
+    int len;
     unsigned char buf[CCNL_MAX_PACKET_SIZE];
+#endif
 
     if (ccnl->ifcount == 0) {
         DEBUGMSG(ERROR, "no socket to work with, not good, quitting\n");
@@ -581,11 +1010,26 @@ ccnl_io_loop(struct ccnl_relay_s *ccnl)
 #endif
         for (i = 0; i < ccnl->ifcount; i++) {
             FD_SET(ccnl->ifs[i].sock, &readfs);
-            if (ccnl->ifs[i].qlen > 0)
+            if (ccnl->ifs[i].txq.qlen > 0)
                 FD_SET(ccnl->ifs[i].sock, &writefs);
         }
+#ifdef USE_SHARDS
+        preloadfd = ccnl_preload_fd();
+        if (preloadfd >= 0) {
+            FD_SET(preloadfd, &readfs);
+            if (preloadfd >= maxfd)
+                maxfd = preloadfd + 1;
+        }
+#endif
 
         usec = ccnl_run_events();
+#ifdef USE_BATCH_IO
+        ccnl_io_flush(ccnl);
+#endif
+#ifdef USE_SHARDS
+        if (ccnl->shards)
+            ccnl_shards_sync(ccnl);
+#endif
         if (usec >= 0) {
             struct timeval deadline;
             deadline.tv_sec = usec / 1000000;
@@ -601,47 +1045,22 @@ ccnl_io_loop(struct ccnl_relay_s *ccnl)
 
 #ifdef USE_HTTP_STATUS
         ccnl_http_postselect(ccnl, ccnl->http, &readfs, &writefs);
+#endif
+#ifdef USE_SHARDS
+        if (preloadfd >= 0 && FD_ISSET(preloadfd, &readfs))
+            ccnl_preload_RX(ccnl);
 #endif
         for (i = 0; i < ccnl->ifcount; i++) {
             if (FD_ISSET(ccnl->ifs[i].sock, &readfs)) {
+#ifdef USE_BATCH_IO
+                ccnl_io_RX_batch(ccnl, i);
+#else
                 sockunion src_addr;
                 socklen_t addrlen = sizeof(sockunion);
                 if ((len = recvfrom(ccnl->ifs[i].sock, buf, sizeof(buf), 0,
-                                (struct sockaddr*) &src_addr, &addrlen)) > 0) {
-                    if (0) {}
-#ifdef USE_IPV4
-                    else if (src_addr.sa.sa_family == AF_INET) {
-                        ccnl_core_RX(ccnl, i, buf, len,
-                                     &src_addr.sa, sizeof(src_addr.ip4));
-                    }
-#endif
-#ifdef USE_IPV6
-                    else if (src_addr.sa.sa_family == AF_INET6) {
-                        ccnl_core_RX(ccnl, i, buf, len,
-                                     &src_addr.sa, sizeof(src_addr.ip6));
-                    }
-#endif
-#ifdef USE_LINKLAYER
-                    else if (src_addr.sa.sa_family == AF_PACKET) {
-                        if (len > 14)
-                            ccnl_core_RX(ccnl, i, buf+14, len-14,
-                                         &src_addr.sa, sizeof(src_addr.linklayer));
-                    }
-#endif
-#ifdef USE_WPAN
-                    else if (src_addr.sa.sa_family == AF_IEEE802154) {
-                        if (len > 14)
-                            ccnl_core_RX(ccnl, i, buf, len,
-                                         &src_addr.sa, sizeof(src_addr.linklayer));
-                    }
-#endif
-#ifdef USE_UNIXSOCKET
-                    else if (src_addr.sa.sa_family == AF_UNIX) {
-                        ccnl_core_RX(ccnl, i, buf, len,
-                                     &src_addr.sa, sizeof(src_addr.ux));
-                    }
+                                (struct sockaddr*) &src_addr, &addrlen)) > 0)
+                    ccnl_io_RX(ccnl, i, buf, len, &src_addr);
 #endif
-                }
             }
 
             if (FD_ISSET(ccnl->ifs[i].sock, &writefs)) {
@@ -649,44 +1068,173 @@ ccnl_io_loop(struct ccnl_relay_s *ccnl)
             }
         }
     }
+#ifdef USE_BATCH_IO
+    ccnl_io_RX_cleanup();
+#endif
 
     return 0;
 }
 
+#endif // USE_EPOLL
+
+struct ccnl_pkt_s*
+ccnl_content_bytes2pkt(unsigned char *data, int datalen)
+{
+    struct ccnl_pkt_s *pk = NULL;
+    int suite, skip;
+#if defined(USE_SUITE_IOTTLV) || defined(USE_SUITE_NDNTLV)
+    unsigned int typ;
+    int len;
+#endif
+
+    if (datalen < 2)
+        return NULL;
+    suite = ccnl_pkt2suite(data, datalen, &skip);
+
+    switch (suite) {
+#ifdef USE_SUITE_CCNB
+    case CCNL_SUITE_CCNB: {
+        unsigned char *start;
+
+        data = start = data + skip;
+        datalen -= skip;
+
+        if (data[0] != 0x04 || data[1] != 0x82)
+            return NULL;
+        data += 2;
+        datalen -= 2;
+
+        pk = ccnl_ccnb_bytes2pkt(start, &data, &datalen);
+        break;
+    }
+#endif
+#ifdef USE_SUITE_CCNTLV
+    case CCNL_SUITE_CCNTLV: {
+        int hdrlen;
+        unsigned char *start;
+
+        data = start = data + skip;
+        datalen -=  skip;
+
+        hdrlen = ccnl_ccntlv_getHdrLen(data, datalen);
+        data += hdrlen;
+        datalen -= hdrlen;
+
+        pk = ccnl_ccntlv_bytes2pkt(start, &data, &datalen);
+        break;
+    }
+#endif
+#ifdef USE_SUITE_CISTLV
+    case CCNL_SUITE_CISTLV: {
+        int hdrlen;
+        unsigned char *start;
+
+        data = start = data + skip;
+        datalen -=  skip;
+
+        hdrlen = ccnl_cistlv_getHdrLen(data, datalen);
+        data += hdrlen;
+        datalen -= hdrlen;
+
+        pk = ccnl_cistlv_bytes2pkt(start, &data, &datalen);
+        break;
+    }
+#endif
+#ifdef USE_SUITE_IOTTLV
+    case CCNL_SUITE_IOTTLV: {
+        unsigned char *olddata;
+
+        data = olddata = data + skip;
+        datalen -= skip;
+        if (ccnl_iottlv_dehead(&data, &datalen, &typ, &len) ||
+                                                   typ != IOT_TLV_Reply)
+            return NULL;
+        pk = ccnl_iottlv_bytes2pkt(typ, olddata, &data, &datalen);
+        break;
+    }
+#endif
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV: {
+        unsigned char *olddata;
+
+        data = olddata = data + skip;
+        datalen -= skip;
+        if (ccnl_ndntlv_dehead(&data, &datalen, (int*) &typ, &len) ||
+                                                     typ != NDN_TLV_Data)
+            return NULL;
+        pk = ccnl_ndntlv_bytes2pkt(typ, olddata, &data, &datalen);
+        break;
+    }
+#endif
+    default:
+        break;
+    }
+    return pk;
+}
+
+struct ccnl_pkt_s*
+ccnl_content_file2pkt(char *fname, int size)
+{
+    struct ccnl_buf_s *buf, *prev;
+    struct ccnl_pkt_s *pk;
+    int fd, datalen = -1;
+
+    fd = open(fname, O_RDONLY);
+    if (fd < 0) {
+        perror("open");
+        return NULL;
+    }
+    buf = ccnl_buf_new(NULL, size);
+    if (buf)
+        datalen = read(fd, buf->data, size);
+    close(fd);
+
+    if (!buf || datalen != size || datalen < 2) {
+        DEBUGMSG(WARNING, "size mismatch for file %s, %d/%d bytes\n",
+                 fname, datalen, size);
+        ccnl_buf_free(buf);
+        return NULL;
+    }
+
+    // the packet is a slice of what was read, no copy
+    prev = ccnl_buf_set_rx(buf);
+    pk = ccnl_content_bytes2pkt(buf->data, datalen);
+    ccnl_buf_set_rx(prev);
+    ccnl_buf_free(buf);
+    if (!pk)
+        DEBUGMSG(WARNING, "not a content object (%s)\n", fname);
+    return pk;
+}
+
 void
 ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path)
 {
+    char dirname[PATH_MAX];
     DIR *dir;
     struct dirent *de;
+    int added = 0, skipped = 0;
 
-    dir = opendir(path);
+    // imported files are listed by their full path
+    dir = realpath(path, dirname) ? opendir(dirname) : NULL;
     if (!dir) {
         DEBUGMSG(ERROR, "could not open directory %s\n", path);
         return;
     }
 
-    DEBUGMSG(INFO, "populating cache from directory %s\n", path);
+    DEBUGMSG(INFO, "populating %s from directory %s\n",
+             ccnl_store_isopen() ? "store" : "cache", path);
 
     while ((de = readdir(dir))) {
-        char fname[1000];
+        char fname[PATH_MAX + 256];
         struct stat s;
-        struct ccnl_buf_s *buf = 0; // , *nonce=0, *ppkd=0, *pkt = 0;
+        struct ccnl_store_file_s f;
         struct ccnl_content_s *c = 0;
-        int fd, datalen, suite, skip;
-        unsigned char *data;
-        (void) data; // silence compiler warning (if any USE_SUITE_* is not set)
-#if defined(USE_SUITE_IOTTLV) || defined(USE_SUITE_NDNTLV)
-        unsigned int typ;
-        int len;
-#endif
         struct ccnl_pkt_s *pk;
 
         if (de->d_name[0] == '.')
             continue;
 
-        strcpy(fname, path);
-        strcat(fname, "/");
-        strcat(fname, de->d_name);
+        snprintf(fname, sizeof(fname), "%s/%s", dirname, de->d_name);
 
         if (stat(fname, &s)) {
             perror("stat");
@@ -694,113 +1242,24 @@ ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path)
         }
         if (S_ISDIR(s.st_mode))
             continue;
-
-        DEBUGMSG(INFO, "loading file %s, %d bytes\n", de->d_name,
-                 (int) s.st_size);
-
-        fd = open(fname, O_RDONLY);
-        if (!fd) {
-            perror("open");
+        ccnl_store_file(&f, fname, &s);
+        if (ccnl_store_imported(&f)) {
+            skipped++;
             continue;
         }
 
-        buf = (struct ccnl_buf_s *) ccnl_malloc(sizeof(*buf) + s.st_size);
-        if (buf)
-            datalen = read(fd, buf->data, s.st_size);
-        else
-            datalen = -1;
-        close(fd);
+        DEBUGMSG(INFO, "loading file %s, %d bytes\n", de->d_name,
+                 (int) s.st_size);
 
-        if (!buf || datalen != s.st_size || datalen < 2) {
-            DEBUGMSG(WARNING, "size mismatch for file %s, %d/%d bytes\n",
-                     de->d_name, datalen, (int) s.st_size);
+        pk = ccnl_content_file2pkt(fname, s.st_size);
+        if (!pk)
             continue;
-        }
-        buf->datalen = datalen;
-        suite = ccnl_pkt2suite(buf->data, datalen, &skip);
-
-        pk = NULL;
-        switch (suite) {
-#ifdef USE_SUITE_CCNB
-        case CCNL_SUITE_CCNB: {
-            unsigned char *start;
-
-            data = start = buf->data + skip;
-            datalen -= skip;
-
-            if (data[0] != 0x04 || data[1] != 0x82)
-                goto notacontent;
-            data += 2;
-            datalen -= 2;
-
-            pk = ccnl_ccnb_bytes2pkt(start, &data, &datalen);
-            break;
-        }
-#endif
-#ifdef USE_SUITE_CCNTLV
-        case CCNL_SUITE_CCNTLV: {
-            int hdrlen;
-            unsigned char *start;
-
-            data = start = buf->data + skip;
-            datalen -=  skip;
-
-            hdrlen = ccnl_ccntlv_getHdrLen(data, datalen);
-            data += hdrlen;
-            datalen -= hdrlen;
-
-            pk = ccnl_ccntlv_bytes2pkt(start, &data, &datalen);
-            break;
-        }
-#endif
-#ifdef USE_SUITE_CISTLV
-        case CCNL_SUITE_CISTLV: {
-            int hdrlen;
-            unsigned char *start;
-
-            data = start = buf->data + skip;
-            datalen -=  skip;
-
-            hdrlen = ccnl_cistlv_getHdrLen(data, datalen);
-            data += hdrlen;
-            datalen -= hdrlen;
-
-            pk = ccnl_cistlv_bytes2pkt(start, &data, &datalen);
-            break;
-        }
-#endif
-#ifdef USE_SUITE_IOTTLV
-        case CCNL_SUITE_IOTTLV: {
-            unsigned char *olddata;
-
-            data = olddata = buf->data + skip;
-            datalen -= skip;
-            if (ccnl_iottlv_dehead(&data, &datalen, &typ, &len) ||
-                                                       typ != IOT_TLV_Reply)
-                goto notacontent;
-            pk = ccnl_iottlv_bytes2pkt(typ, olddata, &data, &datalen);
-            break;
-        }
-#endif
-#ifdef USE_SUITE_NDNTLV
-        case CCNL_SUITE_NDNTLV: {
-            unsigned char *olddata;
-
-            data = olddata = buf->data + skip;
-            datalen -= skip;
-            if (ccnl_ndntlv_dehead(&data, &datalen, (int*) &typ, &len) ||
-                                                         typ != NDN_TLV_Data)
-                goto notacontent;
-            pk = ccnl_ndntlv_bytes2pkt(typ, olddata, &data, &datalen);
-            break;
-        }
-#endif
-        default:
-            DEBUGMSG(WARNING, "unknown packet format (%s)\n", de->d_name);
-            goto Done;
-        }
-        if (!pk) {
-            DEBUGMSG(DEBUG, "  parsing error in %s\n", de->d_name);
+        if (ccnl_store_isopen()) {
+            if (ccnl_store_add(pk, &f) < 0)
+                DEBUGMSG(WARNING, "could not store content (%s)\n",
+                         de->d_name);
+            else
+                added++;
             goto Done;
         }
         c = ccnl_content_new(&pk);
@@ -808,19 +1267,23 @@ ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path)
             DEBUGMSG(WARNING, "could not create content (%s)\n", de->d_name);
             goto Done;
         }
-        ccnl_content_add2cache(ccnl, c);
         c->flags |= CCNL_CONTENT_FLAGS_STATIC;
+#ifdef USE_SHARDS
+        if (ccnl_content_add2cache(ccnl_shard_relay(ccnl, c->pkt->pfx), c) < 0) {
+#else
+        if (ccnl_content_add2cache(ccnl, c) < 0) { // no room
+#endif
+            ccnl_content_free(c);
+            goto Done;
+        }
+        added++;
 Done:
         ccnl_pkt_free(pk);
-        ccnl_free(buf);
-        continue;
-#if defined(USE_SUITE_CCNB) || defined(USE_SUITE_IOTTLV) || defined(USE_SUITE_NDNTLV)
-notacontent:
-        DEBUGMSG(WARNING, "not a content object (%s)\n", de->d_name);
-        ccnl_free(buf);
-#endif
     }
 
     closedir(dir);
+    if (skipped)
+        DEBUGMSG(INFO, "%d files skipped, imported before\n", skipped);
+    DEBUGMSG(INFO, "%d content objects loaded\n", added);
 }
 
@@ -963,6 +963,30 @@ make_next_seg_debug_interest(int num, char *out)
 
 }
 
+// further parts of a reply come in a content object named /mgmt/seqnum-N,
+// sets buf and len to its content
+int
+unwrap_next_seg(unsigned char **buf, int *len)
+{
+    int num, typ;
+
+    if (ccnl_ccnb_dehead(buf, len, &num, &typ) ||
+                            typ != CCN_TT_DTAG || num != CCN_DTAG_CONTENTOBJ)
+        return -1;
+    while (ccnl_ccnb_dehead(buf, len, &num, &typ) == 0) {
+        if (typ == CCN_TT_DTAG && num == CCN_DTAG_CONTENT) {
+            if (ccnl_ccnb_dehead(buf, len, &num, &typ) || typ != CCN_TT_BLOB ||
+                                                                num > *len)
+                return -1;
+            *len = num;
+            return 0;
+        }
+        if (ccnl_ccnb_consume(typ, num, buf, len, 0, 0) < 0)
+            return -1;
+    }
+    return -1;
+}
+
 int
 handle_ccn_signature(unsigned char **buf, int *buflen, char *relay_public_key)
 {
@@ -1131,6 +1155,7 @@ help:
        "  debug         dump\n"
        "  debug         halt\n"
        "  debug         dump+halt\n"
+       "  debug         memdump\n"
        "  addContentToCache             ccn-file\n"
        "  removeContentFromCache        ccn-path\n"
        "where FRAG in one of (none, seqd2012, ccnx2013)\n"
@@ -1252,6 +1277,7 @@ help:
     if (len > 0 && !msgOnly) {
         unsigned int slen = 0; int num = 1; int len2 = 0;
         int hasNext = 0;
+        unsigned char *part;
 
         // socket for receiving
         sprintf(mysockname, "/tmp/.ccn-light-ctrl-%d.sock", getpid());
@@ -1294,7 +1320,12 @@ help:
            else
                 len = recvfrom(sock, out, sizeof(out), 0,
                                 (struct sockaddr *)&si, &slen);
-           hasNext =  check_has_next(out+2, len-2, (char**)&recvbuffer,
+           part = out;
+           if (unwrap_next_seg(&part, &len) < 0) {
+               part = out + 2;
+               len -= 2;
+           }
+           hasNext =  check_has_next(part, len, (char**)&recvbuffer,
                                 &recvbufferlen, relay_public_key, &verified_i);
            if (!verified_i)
                verified = 0;
@@ -269,7 +269,7 @@ usage:
     if (!argv[optind])
         goto usage;
 
-    srandom(time(NULL));
+    srandom(time(NULL) * getpid());
 
     if (ccnl_parseUdp(udp, suite, &addr, &port) != 0) {
         exit(-1);
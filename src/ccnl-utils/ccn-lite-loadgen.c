@@ -0,0 +1,524 @@
+/*
+ * @f util/ccn-lite-loadgen.c
+ * @b load generator: consumer and producer driving a relay on localhost
+ *
+ * Copyright (C) 2026, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+/*
+ * The consumer sends interests to the relay at a fixed rate, keeping at
+ * most WINDOW of them outstanding. A share of them (-H) asks for one of
+ * NAMES catalog names, picked with a Zipf popularity; once fetched, the
+ * relay can answer these from its CS. The others ask for names never used
+ * before, which the relay has to forward. The producer answers what the
+ * relay forwards to it; the relay needs a route to it, e.g.
+ *
+ *   ccn-lite-relay -s ndn2013 -u 9000 -x /tmp/mgmt -c 10000 &
+ *   FACE=$(ccn-lite-ctrl -x /tmp/mgmt newUDPface any 127.0.0.1 9100 \
+ *          | ccn-lite-ccnb2xml | grep FACEID | sed -e 's/[^0-9]//g')
+ *   ccn-lite-ctrl -x /tmp/mgmt prefixreg /load $FACE ndn2013
+ *   ccn-lite-loadgen -s ndn2013 -u 127.0.0.1/9000 -p 9100 -r 5000 -t 10
+ */
+
+#include "ccnl-common.c"
+#include <math.h>
+#include <poll.h>
+
+// ----------------------------------------------------------------------
+
+struct loadgen_slot_s {
+    long id;                    // catalog names: 0..NAMES-1, -1: unused
+    double sent;
+};
+
+static int names = 1000, window = 256, size = 1024;
+static double zipf = 0.8, hit = 0.9, rate = 1000, duration = 10, wait = 1;
+static char *prefix = "/load";
+static int suite = CCNL_SUITE_NDNTLV;
+
+static struct loadgen_slot_s *slot;
+static double *cdf;
+static double *lat;             // latencies of the answered interests
+static long latcnt, latmax;
+static long sent, answered, lost, unmatched, produced;
+static long fresh;              // names never used before
+
+static double
+loadgen_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int
+loadgen_zipf(void)
+{
+    double u = (double) random() / RAND_MAX * cdf[names - 1];
+    int lo = 0, hi = names - 1, mid;
+
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (cdf[mid] < u)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// catalog names end in c<id>, fresh ones in f<pid>-<count>
+static long
+loadgen_name2id(struct ccnl_prefix_s *pfx)
+{
+    char s[CCNL_MAX_PREFIX_SIZE], *cp;
+
+    ccnl_prefix_to_str(pfx, s, sizeof(s));
+    cp = strrchr(s, '/');
+    if (!cp || strncmp(s, prefix, strlen(prefix)))
+        return -2;
+    if (cp[1] == 'c')
+        return atol(cp + 2);
+    return cp[1] == 'f' ? names + atol(strchr(cp, '-') + 1) : -2;
+}
+
+static struct ccnl_pkt_s*
+loadgen_parse(unsigned char *data, int datalen)
+{
+    unsigned char *start;
+    int skip;
+
+    if (ccnl_pkt2suite(data, datalen, &skip) != suite)
+        return NULL;
+    start = data += skip;
+    datalen -= skip;
+
+    switch (suite) {
+#ifdef USE_SUITE_CCNTLV
+    case CCNL_SUITE_CCNTLV: {
+        int hdrlen = ccnl_ccntlv_getHdrLen(data, datalen);
+
+        if (hdrlen <= 0)
+            return NULL;
+        data += hdrlen;
+        datalen -= hdrlen;
+        return ccnl_ccntlv_bytes2pkt(start, &data, &datalen);
+    }
+#endif
+#ifdef USE_SUITE_CISTLV
+    case CCNL_SUITE_CISTLV: {
+        int hdrlen = ccnl_cistlv_getHdrLen(data, datalen);
+
+        if (hdrlen <= 0)
+            return NULL;
+        data += hdrlen;
+        datalen -= hdrlen;
+        return ccnl_cistlv_bytes2pkt(start, &data, &datalen);
+    }
+#endif
+#ifdef USE_SUITE_IOTTLV
+    case CCNL_SUITE_IOTTLV: {
+        unsigned int typ;
+        int len;
+
+        if (ccnl_iottlv_dehead(&data, &datalen, &typ, &len))
+            return NULL;
+        return ccnl_iottlv_bytes2pkt(typ, start - skip, &data, &datalen);
+    }
+#endif
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV: {
+        int typ, len;
+
+        if (ccnl_ndntlv_dehead(&data, &datalen, &typ, &len))
+            return NULL;
+        return ccnl_ndntlv_bytes2pkt(typ, start, &data, &datalen);
+    }
+#endif
+    default:
+        return NULL;
+    }
+}
+
+// ----------------------------------------------------------------------
+
+static int
+loadgen_send(int sock, struct sockaddr *sa, int salen, double now)
+{
+    char uri[CCNL_MAX_PREFIX_SIZE];
+    struct ccnl_prefix_s *pfx;
+    struct ccnl_buf_s *buf;
+    ccnl_interest_opts_u opts;
+    long id;
+    int k;
+
+    for (k = 0; k < window && slot[k].id >= 0; k++);
+    if (k == window)
+        return -1;
+    if ((double) random() / RAND_MAX < hit) {
+        id = loadgen_zipf();
+        snprintf(uri, sizeof(uri), "%s/c%ld", prefix, id);
+    } else {
+        id = names + fresh;
+        snprintf(uri, sizeof(uri), "%s/f%d-%ld", prefix, getpid(), fresh++);
+    }
+    pfx = ccnl_URItoPrefix(uri, suite, NULL, NULL);
+    if (!pfx)
+        return -1;
+    memset(&opts, 0, sizeof(opts));
+#ifdef USE_SUITE_NDNTLV
+    opts.ndntlv.nonce = random();
+#endif
+    buf = ccnl_mkSimpleInterest(pfx, &opts);
+    ccnl_prefix_free(pfx);
+    if (!buf)
+        return -1;
+    if (sendto(sock, buf->data, buf->datalen, 0, sa, salen) < 0)
+        perror("sendto");
+    ccnl_buf_free(buf);
+    slot[k].id = id;
+    slot[k].sent = now;
+    sent++;
+    return 0;
+}
+
+// the relay returns one data per name, answering all interests for it
+static int
+loadgen_consumer_RX(int sock, double now)
+{
+    unsigned char data[CCNL_MAX_PACKET_SIZE];
+    struct ccnl_pkt_s *pkt;
+    int len, k, matched = 0;
+    long id;
+
+    len = recv(sock, data, sizeof(data), MSG_DONTWAIT);
+    if (len <= 0 || !(pkt = loadgen_parse(data, len)))
+        return len;
+    id = pkt->content ? loadgen_name2id(pkt->pfx) : -2;
+    ccnl_pkt_free(pkt);
+    if (id < 0)
+        return len;
+    for (k = 0; k < window; k++) {
+        if (slot[k].id != id)
+            continue;
+        if (latcnt == latmax) {
+            latmax = latmax ? 2 * latmax : 4096;
+            lat = (double*) realloc(lat, latmax * sizeof(double));
+        }
+        lat[latcnt++] = now - slot[k].sent;
+        slot[k].id = -1;
+        answered++;
+        matched++;
+    }
+    if (!matched)
+        unmatched++; // duplicate, or after the timeout
+    return len;
+}
+
+static int
+loadgen_producer_RX(int sock)
+{
+    unsigned char data[CCNL_MAX_PACKET_SIZE];
+    unsigned char payload[CCNL_MAX_PACKET_SIZE];
+    struct sockaddr_storage from;
+    socklen_t fromlen = sizeof(from);
+    struct ccnl_pkt_s *pkt;
+    struct ccnl_buf_s *buf;
+    ccnl_data_opts_u opts;
+    int len;
+
+    len = recvfrom(sock, data, sizeof(data), MSG_DONTWAIT,
+                   (struct sockaddr*) &from, &fromlen);
+    if (len <= 0 || !(pkt = loadgen_parse(data, len)))
+        return len;
+    if (pkt->content) { // not an interest
+        ccnl_pkt_free(pkt);
+        return len;
+    }
+    memset(payload, 'x', size);
+    memset(&opts, 0, sizeof(opts));
+#ifdef USE_SUITE_NDNTLV
+    opts.ndntlv.finalblockid = UINT32_MAX;
+#endif
+    buf = ccnl_mkSimpleContent(pkt->pfx, payload, size, NULL, &opts);
+    ccnl_pkt_free(pkt);
+    if (!buf)
+        return len;
+    if (sendto(sock, buf->data, buf->datalen, 0, (struct sockaddr*) &from,
+               fromlen) < 0)
+        perror("sendto");
+    ccnl_buf_free(buf);
+    produced++;
+    return len;
+}
+
+static void
+loadgen_timeouts(double now)
+{
+    int k;
+
+    for (k = 0; k < window; k++)
+        if (slot[k].id >= 0 && now - slot[k].sent > wait) {
+            slot[k].id = -1;
+            lost++;
+        }
+}
+
+// ----------------------------------------------------------------------
+
+static int
+loadgen_producer_open(char *where)
+{
+    int sock, bufsize = 64 * CCNL_MAX_PACKET_SIZE;
+    char *end;
+    long port = strtol(where, &end, 10);
+
+    if (*end) { // UNIX path
+        struct sockaddr_un su;
+
+        sock = socket(AF_UNIX, SOCK_DGRAM, 0);
+        memset(&su, 0, sizeof(su));
+        su.sun_family = AF_UNIX;
+        strncpy(su.sun_path, where, sizeof(su.sun_path) - 1);
+        unlink(where);
+        if (sock < 0 || bind(sock, (struct sockaddr*) &su, sizeof(su))) {
+            perror("producer socket");
+            return -1;
+        }
+    } else {
+        struct sockaddr_in si;
+
+        sock = socket(PF_INET, SOCK_DGRAM, 0);
+        memset(&si, 0, sizeof(si));
+        si.sin_family = PF_INET;
+        si.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        si.sin_port = htons(port);
+        if (sock < 0 || bind(sock, (struct sockaddr*) &si, sizeof(si))) {
+            perror("producer socket");
+            return -1;
+        }
+    }
+    setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &bufsize, sizeof(bufsize));
+    setsockopt(sock, SOL_SOCKET, SO_SNDBUF, &bufsize, sizeof(bufsize));
+    return sock;
+}
+
+static int
+loadgen_cmp(const void *a, const void *b)
+{
+    double x = *(const double*) a, y = *(const double*) b;
+
+    return x < y ? -1 : x > y;
+}
+
+static double
+loadgen_percentile(double p)
+{
+    long k = (long) ceil(p * latcnt) - 1;
+
+    if (!latcnt)
+        return 0;
+    return lat[k < 0 ? 0 : k] * 1000;
+}
+
+static void
+loadgen_report(double elapsed)
+{
+    qsort(lat, latcnt, sizeof(double), loadgen_cmp);
+    printf("sent %ld interests in %.2f s (%.0f/s)\n", sent, elapsed,
+           sent / elapsed);
+    printf("received %ld data (%.0f/s), %ld lost (%.2f%%), %ld unmatched\n",
+           answered, answered / elapsed, lost,
+           sent ? 100.0 * lost / sent : 0.0, unmatched);
+    if (produced >= 0)
+        printf("produced %ld data, hit ratio %.3f\n", produced,
+               answered ? 1 - (double) produced / answered : 0.0);
+    printf("latency ms: p50 %.3f p99 %.3f p999 %.3f max %.3f\n",
+           loadgen_percentile(0.5), loadgen_percentile(0.99),
+           loadgen_percentile(0.999), loadgen_percentile(1));
+}
+
+int
+main(int argc, char *argv[])
+{
+    char *udp = NULL, *ux = NULL, *addr = NULL, *producer = NULL;
+    int opt, port, sock, psock = -1, salen, k;
+    struct sockaddr_storage sa;
+    struct pollfd pfd[2];
+    double start, now, next, last = 0;
+
+    while ((opt = getopt(argc, argv, "hH:n:p:P:r:S:s:t:u:v:W:w:x:z:")) != -1) {
+        switch (opt) {
+        case 'H':
+            hit = atof(optarg);
+            break;
+        case 'n':
+            names = atoi(optarg);
+            break;
+        case 'p':
+            producer = optarg;
+            break;
+        case 'P':
+            prefix = optarg;
+            break;
+        case 'r':
+            rate = atof(optarg);
+            break;
+        case 'S':
+            size = atoi(optarg);
+            break;
+        case 's':
+            suite = ccnl_str2suite(optarg);
+            if (!ccnl_isSuite(suite) || suite == CCNL_SUITE_CCNB)
+                goto usage;
+            break;
+        case 't':
+            duration = atof(optarg);
+            break;
+        case 'u':
+            udp = optarg;
+            break;
+        case 'v':
+#ifdef USE_LOGGING
+            if (isdigit(optarg[0]))
+                debug_level = atoi(optarg);
+            else
+                debug_level = ccnl_debug_str2level(optarg);
+#endif
+            break;
+        case 'W':
+            window = atoi(optarg);
+            break;
+        case 'w':
+            wait = atof(optarg);
+            break;
+        case 'x':
+            ux = optarg;
+            break;
+        case 'z':
+            zipf = atof(optarg);
+            break;
+        case 'h':
+        default:
+usage:
+            fprintf(stderr, "usage: %s [options]\n"
+            "  -H RATIO         share of interests for catalog names (default 0.9)\n"
+            "  -n NAMES         catalog size (default 1000)\n"
+            "  -p PORT|PATH     answer forwarded interests on this UDP port\n"
+            "                   or UNIX path (default: no producer)\n"
+            "  -P PREFIX        of all names (default /load)\n"
+            "  -r RATE          interests per second (default 1000, 0: no limit)\n"
+            "  -S SIZE          content bytes (default 1024)\n"
+            "  -s SUITE         (ccnx2015, cisco2015, iot2014, ndn2013)\n"
+            "  -t SECONDS       duration (default 10)\n"
+            "  -u a.b.c.d/port  UDP address of the relay (default is suite-dependent)\n"
+#ifdef USE_LOGGING
+            "  -v DEBUG_LEVEL (fatal, error, warning, info, debug, verbose, trace)\n"
+#endif
+            "  -W WINDOW        max outstanding interests (default 256)\n"
+            "  -w timeout       in sec (float), interests not answered are lost\n"
+            "  -x ux_path_name  UNIX IPC: use this instead of UDP\n"
+            "  -z ZIPF          exponent of the catalog popularity (default 0.8)\n",
+            argv[0]);
+            exit(1);
+        }
+    }
+    if (names < 1 || window < 1 || size < 0 || duration <= 0 ||
+                                        size > CCNL_MAX_PACKET_SIZE / 2) {
+        DEBUGMSG(ERROR, "invalid parameters\n");
+        goto usage;
+    }
+
+    srandom(time(NULL) * getpid());
+    cdf = (double*) malloc(names * sizeof(double));
+    for (k = 0; k < names; k++)
+        cdf[k] = (k ? cdf[k - 1] : 0) + 1.0 / pow(k + 1, zipf);
+    slot = (struct loadgen_slot_s*) malloc(window * sizeof(*slot));
+    for (k = 0; k < window; k++)
+        slot[k].id = -1;
+
+    memset(&sa, 0, sizeof(sa));
+    if (ux) {
+        struct sockaddr_un *su = (struct sockaddr_un*) &sa;
+        su->sun_family = AF_UNIX;
+        strncpy(su->sun_path, ux, sizeof(su->sun_path) - 1);
+        salen = sizeof(struct sockaddr_un);
+        sock = ux_open();
+    } else {
+        struct sockaddr_in *si = (struct sockaddr_in*) &sa;
+        if (ccnl_parseUdp(udp, suite, &addr, &port) != 0)
+            exit(-1);
+        si->sin_family = PF_INET;
+        si->sin_addr.s_addr = inet_addr(addr);
+        si->sin_port = htons(port);
+        salen = sizeof(struct sockaddr_in);
+        sock = udp_open();
+    }
+    k = 64 * CCNL_MAX_PACKET_SIZE;
+    setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &k, sizeof(k));
+    if (producer && (psock = loadgen_producer_open(producer)) < 0)
+        myexit(1);
+    if (psock < 0)
+        produced = -1;
+
+    pfd[0].fd = sock;
+    pfd[1].fd = psock;
+    pfd[0].events = pfd[1].events = POLLIN;
+    start = next = loadgen_now();
+    for (;;) {
+        now = loadgen_now();
+        if (now - start < duration) {
+            // catch up after a stall, but do not burst more than a window
+            if (rate > 0 && next < now - window / rate)
+                next = now - window / rate;
+            while ((rate <= 0 || next <= now) &&
+                                !loadgen_send(sock, (struct sockaddr*) &sa,
+                                              salen, now))
+                next += rate > 0 ? 1 / rate : 0;
+        } else if (answered + lost == sent) {
+            break;
+        }
+        if (now - last > 0.001) {
+            loadgen_timeouts(now);
+            last = now;
+        }
+        k = rate > 0 && next > now ? (int) ((next - now) * 1000) : 1;
+        if (poll(pfd, psock < 0 ? 1 : 2, k > 0 ? k : 0) <= 0)
+            continue;
+        now = loadgen_now();
+        if (psock >= 0 && (pfd[1].revents & POLLIN))
+            for (k = 0; k < 64 && loadgen_producer_RX(psock) > 0; k++);
+        if (pfd[0].revents & POLLIN)
+            for (k = 0; k < 64 && loadgen_consumer_RX(sock, now) > 0; k++);
+    }
+    loadgen_report(now - start);
+
+    close(sock);
+    if (psock >= 0)
+        close(psock);
+    if (producer && strtol(producer, NULL, 10) == 0)
+        unlink(producer);
+    free(lat);
+    free(slot);
+    free(cdf);
+    myexit(0);
+    return 0;
+}
+
+// eof
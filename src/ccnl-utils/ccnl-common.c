@@ -68,12 +68,12 @@
 #include "ccnl-pkt-builder.h"
 
 int debug_level = WARNING;
-#ifndef USE_DEBUG_MALLOC
+#if !defined(USE_DEBUG_MALLOC) && !defined(USE_MALLOC_ACCT)
 #define ccnl_malloc(s)                  malloc(s)
 #define ccnl_calloc(n,s)                calloc(n,s)
 #define ccnl_realloc(p,s)               realloc(p,s)
 #define ccnl_free(p)                    free(p)
-#endif //USE_DEBUG_MALLOC
+#endif //USE_DEBUG_MALLOC, USE_MALLOC_ACCT
 #define free_2ptr_list(a,b)     ccnl_free(a), ccnl_free(b)
 
 struct ccnl_prefix_s* ccnl_prefix_new(int suite, int cnt);